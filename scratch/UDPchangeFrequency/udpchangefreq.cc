@@ -11,6 +11,8 @@
 #include "ns3/buildings-module.h"
 #include "ns3/global-value.h"
 #include "ns3/command-line.h"
+#include "ns3/replication-runner.h"
+#include "ns3/rng-seed-manager.h"
 #include <ns3/random-variable-stream.h>
 #include <ns3/lte-ue-net-device.h>
 #include <iostream>
@@ -63,6 +65,13 @@ static ns3::GlobalValue g_outageThreshold ("outageTh", "Outage threshold",
                                            ns3::DoubleValue (-5), ns3::MakeDoubleChecker<double> ());
 static ns3::GlobalValue g_lteUplink ("lteUplink", "If true, always use LTE for uplink signalling",
                                      ns3::BooleanValue (false), ns3::MakeBooleanChecker ());
+static ns3::GlobalValue g_replications ("replications",
+                                        "Number of replications, with consecutive run numbers from RngRun, forked after "
+                                        "the transient. If 0, the scenario runs once",
+                                        ns3::UintegerValue (0), ns3::MakeUintegerChecker<uint32_t> ());
+static ns3::GlobalValue g_workers ("workers",
+                                   "Maximum number of replications running at a time. If 0, the number of processors",
+                                   ns3::UintegerValue (0), ns3::MakeUintegerChecker<uint32_t> ());
 
 void ChangeSpeed (Ptr<Node> n, Vector speed)
 {
@@ -73,6 +82,8 @@ uint32_t g_rx1Packets; // total number of received packets
 uint32_t g_tx1Packets; // total number of transmitted packets
 uint32_t g_rx2Packets; // total number of received packets
 uint32_t g_tx2Packets; // total number of transmitted packets
+ApplicationContainer g_clientApps; // clients of the descriptions D1 and D2
+ApplicationContainer g_serverApps; // servers of the descriptions D1 and D2
 static void Rx1 (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   g_rx1Packets++;
@@ -115,6 +126,27 @@ static void Tx2 (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
                         << "," << p->GetSize () << "," << Simulator::Now ().GetMilliSeconds ()
                         << std::endl;
 }
+/**
+ * Connect the traces of the mmWave stack and of the applications in
+ * g_clientApps and g_serverApps to files in the current directory
+ */
+static void
+EnableTraces (Ptr<MmWaveHelper> mmwaveHelper)
+{
+  mmwaveHelper->EnableTraces ();
+
+  AsciiTraceHelper asciiTraceHelper;
+  Ptr<OutputStreamWrapper> stream_tx1 = asciiTraceHelper.CreateFileStream ("TX-mmwave-1.txt");
+  Ptr<OutputStreamWrapper> stream_tx2 = asciiTraceHelper.CreateFileStream ("TX-mmwave-2.txt");
+  g_clientApps.Get (0)->TraceConnectWithoutContext ("Tx", MakeBoundCallback (&Tx1, stream_tx1));
+  g_clientApps.Get (1)->TraceConnectWithoutContext ("Tx", MakeBoundCallback (&Tx2, stream_tx2));
+
+  Ptr<OutputStreamWrapper> stream_rx1 = asciiTraceHelper.CreateFileStream ("RX-mmwave-1.txt");
+  Ptr<OutputStreamWrapper> stream_rx2 = asciiTraceHelper.CreateFileStream ("RX-mmwave-2.txt");
+  g_serverApps.Get (0)->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&Rx1, stream_rx1));
+  g_serverApps.Get (1)->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&Rx2, stream_rx2));
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -402,7 +434,6 @@ main (int argc, char *argv[])
   uint16_t ulPort = 4000;
   ApplicationContainer serverApps;
   ApplicationContainer clientApps;
-  mmwaveHelper->EnableTraces ();
 
   UdpTraceClientHelper client_transmitter_D1 (remoteHostAddr, ulPort, "D1trace.txt");
   UdpTraceClientHelper client_transmitter_D2 (remoteHostAddr, ulPort+1, "D2trace.txt");
@@ -411,15 +442,9 @@ main (int argc, char *argv[])
   client_transmitter_D2.SetAttribute ("MaxPacketSize", UintegerValue (1450));
   client_transmitter_D2.SetAttribute ("TraceLoop", ns3::BooleanValue (false));
 
-  AsciiTraceHelper asciiTraceHelper_tx1;
-  Ptr<OutputStreamWrapper> stream_tx1 = asciiTraceHelper_tx1.CreateFileStream ("TX-mmwave-1.txt");
-  AsciiTraceHelper asciiTraceHelper_tx2;
-  Ptr<OutputStreamWrapper> stream_tx2 = asciiTraceHelper_tx2.CreateFileStream ("TX-mmwave-2.txt");
   // Two Antena on the car
   clientApps.Add (client_transmitter_D1.Install (ueNodes.Get (0)));
   clientApps.Add (client_transmitter_D2.Install (ueNodes.Get (1)));
-  clientApps.Get (0)->TraceConnectWithoutContext ("Tx", MakeBoundCallback (&Tx1, stream_tx1));
-  clientApps.Get (1)->TraceConnectWithoutContext ("Tx", MakeBoundCallback (&Tx2, stream_tx2));
 
   //Server D1 and D2 of MDC
   UdpServerHelper serverD1 (ulPort);
@@ -427,12 +452,8 @@ main (int argc, char *argv[])
   UdpServerHelper serverD2 (ulPort + 1);
   serverApps.Add (serverD2.Install (remoteHost));
 
-
-  AsciiTraceHelper asciiTraceHelper;
-  Ptr<OutputStreamWrapper> stream_rx1 = asciiTraceHelper.CreateFileStream ("RX-mmwave-1.txt");
-  serverApps.Get (0)->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&Rx1, stream_rx1));
-  Ptr<OutputStreamWrapper> stream_rx2 = asciiTraceHelper.CreateFileStream ("RX-mmwave-2.txt");
-  serverApps.Get (0)->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&Rx2, stream_rx2));
+  g_clientApps = clientApps;
+  g_serverApps = serverApps;
 
   //p2ph.EnablePcapAll ("mmwave-streaming.pcap");
   // Transient Duration, time to etablish the connection between ue and station
@@ -440,8 +461,39 @@ main (int argc, char *argv[])
   clientApps.Start (Seconds (transientDuration));
   // Simulator::Schedule (Seconds (transientDuration), &ChangeSpeed, ueNodes.Get (0), Vector (ueSpeed, 0, 0)); // start UE movement after Seconds(0.5)
   // Simulator::Schedule (Seconds (transientDuration), &ChangeSpeed, ueNodes.Get (1), Vector (ueSpeed, 0, 0)); // start UE movement after Seconds(0.5)
-  Simulator::Stop (Seconds (simTime));
-  Simulator::Run ();
+  GlobalValue::GetValueByName ("replications", uintegerValue);
+  uint32_t replications = uintegerValue.Get ();
+  if (replications > 0)
+    {
+      // run the transient once, then each replication in its own process,
+      // which writes the traces in the directory of the replication
+      GlobalValue::GetValueByName ("workers", uintegerValue);
+      Ptr<ReplicationRunner> runner = CreateObject<ReplicationRunner> ();
+      runner->SetAttribute ("MaxWorkers", uintegerValue);
+      runner->SetAttribute ("WarmUpTime", TimeValue (Seconds (transientDuration)));
+      runner->SetAttribute ("StopTime", TimeValue (Seconds (simTime)));
+      for (uint32_t i = 0; i < replications; i++)
+        {
+          runner->AddReplication (RngSeedManager::GetRun () + i);
+        }
+      runner->SetWorkerCallback (MakeBoundCallback (&EnableTraces, mmwaveHelper));
+      if (!runner->Run ())
+        {
+          Simulator::Destroy ();
+          if (runner->GetNFailed () > 0)
+            {
+              NS_LOG_UNCOND ("Failed replications: " << runner->GetNFailed ());
+              return 1;
+            }
+          return 0;
+        }
+    }
+  else
+    {
+      EnableTraces (mmwaveHelper);
+      Simulator::Stop (Seconds (simTime));
+      Simulator::Run ();
+    }
   Simulator::Destroy ();
   NS_LOG_UNCOND("Total packets dropped (D1 Server): " << serverD1.GetServer()->GetLost()<<std::endl);
   NS_LOG_UNCOND("Total packets dropped (D2 Server): " << serverD2.GetServer()->GetLost()<<std::endl);
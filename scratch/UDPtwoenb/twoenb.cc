@@ -29,6 +29,8 @@
 #include "ns3/buildings-module.h"
 #include "ns3/global-value.h"
 #include "ns3/command-line.h"
+#include "ns3/replication-runner.h"
+#include "ns3/rng-seed-manager.h"
 #include <ns3/random-variable-stream.h>
 #include <ns3/lte-ue-net-device.h>
 #include <iostream>
@@ -294,6 +296,13 @@ static ns3::GlobalValue g_outageThreshold ("outageTh", "Outage threshold",
                                            ns3::DoubleValue (-5), ns3::MakeDoubleChecker<double> ());
 static ns3::GlobalValue g_lteUplink ("lteUplink", "If true, always use LTE for uplink signalling",
                                      ns3::BooleanValue (false), ns3::MakeBooleanChecker ());
+static ns3::GlobalValue g_replications ("replications",
+                                        "Number of replications, with consecutive run numbers from RngRun, forked after "
+                                        "the transient. If 0, the scenario runs once",
+                                        ns3::UintegerValue (0), ns3::MakeUintegerChecker<uint32_t> ());
+static ns3::GlobalValue g_workers ("workers",
+                                   "Maximum number of replications running at a time. If 0, the number of processors",
+                                   ns3::UintegerValue (0), ns3::MakeUintegerChecker<uint32_t> ());
 
 int
 main (int argc, char *argv[])
@@ -657,7 +666,8 @@ main (int argc, char *argv[])
       Simulator::Schedule (Seconds (i * simTime / numPrints), &PrintPosition, ueNodes.Get (0));
     }
 
-  mmwaveHelper->EnableTraces ();
+  GlobalValue::GetValueByName ("replications", uintegerValue);
+  uint32_t replications = uintegerValue.Get ();
 
   // set to true if you want to print the map of buildings, ues and enbs
   bool print = false;
@@ -667,8 +677,30 @@ main (int argc, char *argv[])
       PrintGnuplottableUeListToFile ("ues.txt");
       PrintGnuplottableEnbListToFile ("enbs.txt");
     }
+  else if (replications > 0)
+    {
+      // run the transient once, then each replication in its own process,
+      // which writes the traces in the directory of the replication
+      GlobalValue::GetValueByName ("workers", uintegerValue);
+      Ptr<ReplicationRunner> runner = CreateObject<ReplicationRunner> ();
+      runner->SetAttribute ("MaxWorkers", uintegerValue);
+      runner->SetAttribute ("WarmUpTime", TimeValue (Seconds (transientDuration)));
+      runner->SetAttribute ("StopTime", TimeValue (Seconds (simTime)));
+      for (uint32_t i = 0; i < replications; i++)
+        {
+          runner->AddReplication (RngSeedManager::GetRun () + i);
+        }
+      runner->SetWorkerCallback (MakeCallback (&MmWaveHelper::EnableTraces, mmwaveHelper));
+      if (!runner->Run () && runner->GetNFailed () > 0)
+        {
+          NS_LOG_UNCOND ("Failed replications: " << runner->GetNFailed ());
+          Simulator::Destroy ();
+          return 1;
+        }
+    }
   else
     {
+      mmwaveHelper->EnableTraces ();
       Simulator::Stop (Seconds (simTime));
       Simulator::Run ();
     }
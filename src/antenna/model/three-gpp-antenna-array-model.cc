@@ -30,10 +30,14 @@ NS_LOG_COMPONENT_DEFINE ("ThreeGppAntennaArrayModel");
 
 NS_OBJECT_ENSURE_REGISTERED (ThreeGppAntennaArrayModel);
 
+/// Last identifier assigned to a beamforming vector
+static uint64_t g_lastBeamformingVectorId = 0;
+
 ThreeGppAntennaArrayModel::ThreeGppAntennaArrayModel (void)
 {
   NS_LOG_FUNCTION (this);
   m_isOmniTx = false;
+  m_beamformingVectorId = 0;
 }
 
 ThreeGppAntennaArrayModel::~ThreeGppAntennaArrayModel (void)
@@ -110,7 +114,11 @@ ThreeGppAntennaArrayModel::SetBeamformingVector (const ComplexVector &beamformin
 {
   NS_LOG_FUNCTION (this);
   m_isOmniTx = false;
-  m_beamformingVector = beamformingVector;
+  if (m_beamformingVectorId == 0 || beamformingVector != m_beamformingVector)
+    {
+      m_beamformingVector = beamformingVector;
+      m_beamformingVectorId = ++g_lastBeamformingVectorId;
+    }
 }
 
 const ThreeGppAntennaArrayModel::ComplexVector &
@@ -120,6 +128,12 @@ ThreeGppAntennaArrayModel::GetBeamformingVector(void) const
   return m_beamformingVector;
 }
 
+uint64_t
+ThreeGppAntennaArrayModel::GetBeamformingVectorId (void) const
+{
+  return m_beamformingVectorId;
+}
+
 std::pair<double, double>
 ThreeGppAntennaArrayModel::GetElementFieldPattern (Angles a) const
 {
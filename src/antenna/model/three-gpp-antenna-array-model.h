@@ -108,6 +108,17 @@ public:
    */
   const ComplexVector & GetBeamformingVector (void) const;
 
+  /**
+   * Returns the identifier of the beamforming vector that is currently being
+   * used. A new identifier, unique among all the antenna arrays, is assigned
+   * every time SetBeamformingVector changes the beamforming vector, so that
+   * users can check whether the vector changed without comparing its
+   * elements.
+   * \return the identifier of the current beamforming vector, 0 if it has
+   *         never been set
+   */
+  uint64_t GetBeamformingVectorId (void) const;
+
 private:
   /**
    * Returns the radiation power pattern of a single antenna element in dB,
@@ -120,6 +131,7 @@ private:
 
   bool m_isOmniTx; //!< true if the antenna is configured for omni transmissions
   ComplexVector m_beamformingVector; //!< the beamforming vector in use
+  uint64_t m_beamformingVectorId; //!< the identifier of the beamforming vector in use
   uint32_t m_numColumns; //!< number of columns
   uint32_t m_numRows; //!< number of rows
   double m_disV; //!< antenna spacing in the vertical direction in multiples of wave length
@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Network topology
+//
+//       n0 -------------- n1
+//          point-to-point
+//
+// - a video with multiple descriptions is streamed from n0 to n1, each
+//   description on its own UDP port
+// - the statistics of the frames and of the descriptions are written at the
+//   end of the simulation
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MdcVideoExample");
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t numDescriptions = 2;
+  uint32_t minDescriptions = 1;
+  double playoutDelayMs = 100;
+  std::string dataRate = "2Mbps";
+  std::string traceFile = "";
+  double simTime = 10;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("numDescriptions", "Number of descriptions of each frame", numDescriptions);
+  cmd.AddValue ("minDescriptions", "Number of descriptions needed to decode a frame", minDescriptions);
+  cmd.AddValue ("playoutDelay", "Playout delay of the frames (ms)", playoutDelayMs);
+  cmd.AddValue ("dataRate", "Data rate of the link", dataRate);
+  cmd.AddValue ("traceFile", "Trace of the frames, the default trace is used if empty", traceFile);
+  cmd.AddValue ("simTime", "Simulation time (s)", simTime);
+  cmd.Parse (argc, argv);
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue (dataRate));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("10ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  uint16_t port = 5000;
+  MdcVideoServerHelper server (port);
+  server.SetAttribute ("NumDescriptions", UintegerValue (numDescriptions));
+  server.SetAttribute ("MinDescriptions", UintegerValue (minDescriptions));
+  server.SetAttribute ("PlayoutDelay", TimeValue (MilliSeconds (playoutDelayMs)));
+  server.SetAttribute ("FrameStatsFilename", StringValue ("MdcFrameStats.txt"));
+  server.SetAttribute ("DescriptionStatsFilename", StringValue ("MdcDescriptionStats.txt"));
+  ApplicationContainer serverApps = server.Install (nodes.Get (1));
+  serverApps.Start (Seconds (0.5));
+  serverApps.Stop (Seconds (simTime));
+
+  MdcVideoClientHelper client (interfaces.GetAddress (1), port, traceFile);
+  client.SetAttribute ("NumDescriptions", UintegerValue (numDescriptions));
+  ApplicationContainer clientApps = client.Install (nodes.Get (0));
+  clientApps.Start (Seconds (1.0));
+  clientApps.Stop (Seconds (simTime - 1));
+
+  Simulator::Stop (Seconds (simTime));
+  Simulator::Run ();
+
+  Ptr<MdcVideoServer> mdcServer = server.GetServer ();
+  std::cout << "Decodable frames: " << mdcServer->GetDecodableFrames ()
+            << "/" << mdcServer->GetFrameStats ().size () << std::endl;
+  mdcServer->WriteDescriptionStats (std::cout);
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "mdc-video-helper.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+
+namespace ns3 {
+
+MdcVideoServerHelper::MdcVideoServerHelper ()
+{
+  m_factory.SetTypeId (MdcVideoServer::GetTypeId ());
+}
+
+MdcVideoServerHelper::MdcVideoServerHelper (uint16_t port)
+{
+  m_factory.SetTypeId (MdcVideoServer::GetTypeId ());
+  SetAttribute ("Port", UintegerValue (port));
+}
+
+void
+MdcVideoServerHelper::SetAttribute (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+ApplicationContainer
+MdcVideoServerHelper::Install (NodeContainer c)
+{
+  ApplicationContainer apps;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      m_server = m_factory.Create<MdcVideoServer> ();
+      node->AddApplication (m_server);
+      apps.Add (m_server);
+    }
+  return apps;
+}
+
+Ptr<MdcVideoServer>
+MdcVideoServerHelper::GetServer (void)
+{
+  return m_server;
+}
+
+MdcVideoClientHelper::MdcVideoClientHelper ()
+{
+  m_factory.SetTypeId (MdcVideoClient::GetTypeId ());
+}
+
+MdcVideoClientHelper::MdcVideoClientHelper (Address address, uint16_t port, std::string filename)
+{
+  m_factory.SetTypeId (MdcVideoClient::GetTypeId ());
+  SetAttribute ("RemoteAddress", AddressValue (address));
+  SetAttribute ("RemotePort", UintegerValue (port));
+  SetAttribute ("TraceFilename", StringValue (filename));
+}
+
+void
+MdcVideoClientHelper::SetAttribute (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+ApplicationContainer
+MdcVideoClientHelper::Install (NodeContainer c)
+{
+  ApplicationContainer apps;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      Ptr<MdcVideoClient> client = m_factory.Create<MdcVideoClient> ();
+      node->AddApplication (client);
+      apps.Add (client);
+    }
+  return apps;
+}
+
+} // namespace ns3
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MDC_VIDEO_HELPER_H
+#define MDC_VIDEO_HELPER_H
+
+#include <stdint.h>
+#include "ns3/application-container.h"
+#include "ns3/node-container.h"
+#include "ns3/object-factory.h"
+#include "ns3/address.h"
+#include "ns3/mdc-video-server.h"
+#include "ns3/mdc-video-client.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mdcvideo
+ * \brief Create a MdcVideoServer application, which receives the
+ *        descriptions of a video and computes the statistics of their
+ *        delivery.
+ */
+class MdcVideoServerHelper
+{
+public:
+  /**
+   * Create a MdcVideoServerHelper
+   */
+  MdcVideoServerHelper ();
+  /**
+   * Create a MdcVideoServerHelper
+   *
+   * \param port The port on which the first description is received
+   */
+  MdcVideoServerHelper (uint16_t port);
+  /**
+   * Record an attribute to be set in each Application after it is is created.
+   *
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set
+   */
+  void SetAttribute (std::string name, const AttributeValue &value);
+  /**
+   * Create one MdcVideoServer application on each of the Nodes in the
+   * NodeContainer.
+   *
+   * \param c The nodes on which to create the Applications.
+   * \returns The applications created, one Application per Node in the
+   *          NodeContainer.
+   */
+  ApplicationContainer Install (NodeContainer c);
+  /**
+   * \brief Return the last created server.
+   *
+   * \returns a Ptr to the last created server application
+   */
+  Ptr<MdcVideoServer> GetServer (void);
+private:
+  ObjectFactory m_factory; //!< Object factory.
+  Ptr<MdcVideoServer> m_server; //!< The last created server application
+};
+
+/**
+ * \ingroup mdcvideo
+ * \brief Create a MdcVideoClient application, which sends the descriptions
+ *        of the frames of a video trace over separate UDP flows.
+ */
+class MdcVideoClientHelper
+{
+public:
+  /**
+   * Create a MdcVideoClientHelper
+   */
+  MdcVideoClientHelper ();
+  /**
+   * Create a MdcVideoClientHelper
+   *
+   * \param ip The IP address of the remote MdcVideoServer
+   * \param port The port of the first description
+   * \param filename the file from which the frames will be loaded, the
+   *        default trace is used if empty
+   */
+  MdcVideoClientHelper (Address ip, uint16_t port, std::string filename = "");
+  /**
+   * Record an attribute to be set in each Application after it is is created.
+   *
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set
+   */
+  void SetAttribute (std::string name, const AttributeValue &value);
+  /**
+   * Create one MdcVideoClient application on each of the input nodes
+   *
+   * \param c the nodes
+   * \returns the applications created, one application per input node.
+   */
+  ApplicationContainer Install (NodeContainer c);
+private:
+  ObjectFactory m_factory; //!< Object factory.
+};
+
+} // namespace ns3
+
+#endif /* MDC_VIDEO_HELPER_H */
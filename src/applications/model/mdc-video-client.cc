@@ -0,0 +1,328 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
+#include "ns3/nstime.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/socket.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "mdc-video-header.h"
+#include "mdc-video-client.h"
+#include <algorithm>
+#include <fstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MdcVideoClient");
+
+NS_OBJECT_ENSURE_REGISTERED (MdcVideoClient);
+
+/**
+ * \brief Default trace to send, the same of UdpTraceClient
+ */
+static const struct
+{
+  uint32_t time; //!< Generation time of the frame (ms)
+  uint32_t size; //!< Size of the frame
+  char frameType; //!< Frame type (I, P or B)
+} g_mdcDefaultEntries[] = {
+  { 0, 534, 'I'},
+  { 40, 1542, 'P'},
+  { 120, 134, 'B'},
+  { 80, 390, 'B'},
+  { 240, 765, 'P'},
+  { 160, 407, 'B'},
+  { 200, 504, 'B'},
+  { 360, 903, 'P'},
+  { 280, 421, 'B'},
+  { 320, 587, 'B'}
+};
+
+TypeId
+MdcVideoClient::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MdcVideoClient")
+    .SetParent<Application> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<MdcVideoClient> ()
+    .AddAttribute ("RemoteAddress",
+                   "The destination Address of the outbound packets",
+                   AddressValue (),
+                   MakeAddressAccessor (&MdcVideoClient::m_peerAddress),
+                   MakeAddressChecker ())
+    .AddAttribute ("RemotePort",
+                   "The destination port of the first description, the description d "
+                   "is sent to the port RemotePort + d",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&MdcVideoClient::m_peerPort),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("NumDescriptions",
+                   "The number of descriptions of each frame",
+                   UintegerValue (2),
+                   MakeUintegerAccessor (&MdcVideoClient::m_numDescriptions),
+                   MakeUintegerChecker<uint8_t> (1))
+    .AddAttribute ("MaxPacketSize",
+                   "The maximum size of a packet (including the MdcVideoHeader, 18 bytes).",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&MdcVideoClient::m_maxPacketSize),
+                   MakeUintegerChecker<uint32_t> (19))
+    .AddAttribute ("TraceFilename",
+                   "Name of file to load a trace from. By default, uses a hardcoded trace.",
+                   StringValue (""),
+                   MakeStringAccessor (&MdcVideoClient::SetTraceFile),
+                   MakeStringChecker ())
+    .AddAttribute ("TraceLoop",
+                   "Loops through the trace file, starting again once it is over.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&MdcVideoClient::m_traceLoop),
+                   MakeBooleanChecker ())
+    .AddTraceSource ("Tx", "A packet has been sent",
+                     MakeTraceSourceAccessor (&MdcVideoClient::m_txTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+MdcVideoClient::MdcVideoClient ()
+  : m_peerPort (100),
+    m_numDescriptions (2),
+    m_maxPacketSize (1024),
+    m_traceLoop (true),
+    m_currentEntry (0),
+    m_sentFrames (0)
+{
+  NS_LOG_FUNCTION (this);
+  LoadDefaultTrace ();
+}
+
+MdcVideoClient::~MdcVideoClient ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MdcVideoClient::SetRemote (Address ip, uint16_t port)
+{
+  NS_LOG_FUNCTION (this << ip << port);
+  m_peerAddress = ip;
+  m_peerPort = port;
+}
+
+void
+MdcVideoClient::SetTraceFile (std::string traceFile)
+{
+  NS_LOG_FUNCTION (this << traceFile);
+  if (traceFile == "")
+    {
+      LoadDefaultTrace ();
+    }
+  else
+    {
+      LoadTrace (traceFile);
+    }
+}
+
+uint32_t
+MdcVideoClient::GetSentFrames (void) const
+{
+  return m_sentFrames;
+}
+
+void
+MdcVideoClient::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_sockets.clear ();
+  Application::DoDispose ();
+}
+
+void
+MdcVideoClient::LoadTrace (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ifstream ifTraceFile (filename.c_str (), std::ifstream::in);
+  if (!ifTraceFile.good ())
+    {
+      NS_LOG_WARN ("Cannot open " << filename << ", using the default trace");
+      LoadDefaultTrace ();
+      return;
+    }
+
+  m_entries.clear ();
+  uint32_t index;
+  uint32_t oldIndex = 0;
+  TraceEntry entry;
+  while (ifTraceFile >> index >> entry.frameType >> entry.time >> entry.size)
+    {
+      NS_LOG_INFO ("LoadTrace: " << index << " " << entry.frameType << " " << entry.time << " " << entry.size);
+      if (!m_entries.empty () && index == oldIndex)
+        {
+          continue;
+        }
+      m_entries.push_back (entry);
+      oldIndex = index;
+    }
+  NS_LOG_INFO ("Loaded trace file: " << m_entries.size () << " entries");
+  NS_ABORT_MSG_IF (m_entries.empty (), "The trace file " << filename << " has no frames");
+  m_currentEntry = 0;
+}
+
+void
+MdcVideoClient::LoadDefaultTrace (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_entries.clear ();
+  for (const auto &defaultEntry : g_mdcDefaultEntries)
+    {
+      TraceEntry entry;
+      entry.time = defaultEntry.time;
+      entry.size = defaultEntry.size;
+      entry.frameType = defaultEntry.frameType;
+      m_entries.push_back (entry);
+    }
+  m_currentEntry = 0;
+}
+
+void
+MdcVideoClient::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_sockets.empty ())
+    {
+      TypeId tid = TypeId::LookupByName ("ns3::UdpSocketFactory");
+      for (uint8_t d = 0; d < m_numDescriptions; ++d)
+        {
+          Ptr<Socket> socket = Socket::CreateSocket (GetNode (), tid);
+          uint16_t port = m_peerPort + d;
+          if (Ipv4Address::IsMatchingType (m_peerAddress))
+            {
+              if (socket->Bind () == -1)
+                {
+                  NS_FATAL_ERROR ("Failed to bind socket");
+                }
+              socket->Connect (InetSocketAddress (Ipv4Address::ConvertFrom (m_peerAddress), port));
+            }
+          else if (Ipv6Address::IsMatchingType (m_peerAddress))
+            {
+              if (socket->Bind6 () == -1)
+                {
+                  NS_FATAL_ERROR ("Failed to bind socket");
+                }
+              socket->Connect (Inet6SocketAddress (Ipv6Address::ConvertFrom (m_peerAddress), port));
+            }
+          else
+            {
+              NS_FATAL_ERROR ("Incompatible address type: " << m_peerAddress);
+            }
+          socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+          m_sockets.push_back (socket);
+        }
+    }
+
+  m_currentEntry = 0;
+  m_loopStart = Simulator::Now ();
+  m_sendEvent = Simulator::ScheduleNow (&MdcVideoClient::SendFrame, this);
+}
+
+void
+MdcVideoClient::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_sendEvent);
+}
+
+void
+MdcVideoClient::SendFrame (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  const TraceEntry &entry = m_entries[m_currentEntry];
+  NS_LOG_INFO ("Frame " << m_sentFrames << " type " << entry.frameType << " size " << entry.size);
+
+  // split the frame into descriptions of (almost) equal size
+  for (uint8_t d = 0; d < m_numDescriptions; ++d)
+    {
+      uint32_t size = entry.size / m_numDescriptions + (d < entry.size % m_numDescriptions ? 1 : 0);
+      SendDescription (d, size);
+    }
+  ++m_sentFrames;
+
+  // schedule the next frame
+  ++m_currentEntry;
+  if (m_currentEntry >= m_entries.size ())
+    {
+      if (!m_traceLoop)
+        {
+          return;
+        }
+      // the next loop starts one mean frame interval after the last frame
+      uint32_t maxTime = 0;
+      for (const auto &e : m_entries)
+        {
+          maxTime = std::max (maxTime, e.time);
+        }
+      uint32_t interval = m_entries.size () > 1 ? maxTime / (m_entries.size () - 1) : 0;
+      m_loopStart += MilliSeconds (maxTime + std::max (interval, 1U));
+      m_currentEntry = 0;
+    }
+  // frames generated before the previous one in the trace are sent at once
+  Time next = m_loopStart + MilliSeconds (m_entries[m_currentEntry].time);
+  m_sendEvent = Simulator::Schedule (Max (next - Simulator::Now (), Seconds (0)),
+                                     &MdcVideoClient::SendFrame, this);
+}
+
+void
+MdcVideoClient::SendDescription (uint8_t description, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << +description << size);
+
+  MdcVideoHeader header;
+  uint32_t maxPayload = m_maxPacketSize - header.GetSerializedSize ();
+  uint32_t numFragments = std::max ((size + maxPayload - 1) / maxPayload, 1U);
+  NS_ABORT_MSG_IF (numFragments > 0xffff, "Too many fragments, increase MaxPacketSize");
+
+  for (uint32_t fragment = 0; fragment < numFragments; ++fragment)
+    {
+      uint32_t payload = std::min (maxPayload, size - fragment * maxPayload);
+      Ptr<Packet> p = Create<Packet> (payload);
+      header.SetFrame (m_sentFrames);
+      header.SetDescription (description, m_numDescriptions);
+      header.SetFragment (fragment, numFragments);
+      header.SetFrameTs (Simulator::Now ());
+      p->AddHeader (header);
+
+      if (m_sockets[description]->Send (p) >= 0)
+        {
+          m_txTrace (p);
+        }
+      else
+        {
+          NS_LOG_INFO ("Error while sending fragment " << fragment << " of description "
+                       << +description << " of frame " << m_sentFrames);
+        }
+    }
+}
+
+} // namespace ns3
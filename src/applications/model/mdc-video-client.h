@@ -0,0 +1,153 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MDC_VIDEO_CLIENT_H
+#define MDC_VIDEO_CLIENT_H
+
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/ptr.h"
+#include "ns3/address.h"
+#include "ns3/traced-callback.h"
+#include <vector>
+
+namespace ns3 {
+
+class Socket;
+class Packet;
+
+/**
+ * \ingroup applications
+ * \defgroup mdcvideo MdcVideo
+ *
+ * Streaming of a video encoded with multiple description coding (MDC).
+ * Each frame is split into several descriptions, which are sent over
+ * separate UDP flows, so that they can be mapped to different bearers or
+ * paths. The receiver can decode a frame from any subset of its
+ * descriptions, with a quality which increases with the number of
+ * descriptions.
+ */
+
+/**
+ * \ingroup mdcvideo
+ *
+ * \brief Trace based streamer of a video with multiple descriptions
+ *
+ * The frames are read from a trace file with the format of the one of
+ * UdpTraceClient, i.e., with 4 columns:
+ * \li -1- the frame index
+ * \li -2- the type of the frame: I, P or B
+ * \li -3- the time on which the frame was generated by the encoder (integer, milliseconds)
+ * \li -4- the frame size in byte
+ *
+ * If no trace file is provided, the default trace of UdpTraceClient is used.
+ *
+ * Each frame is split into NumDescriptions descriptions of (almost) equal
+ * size. The description d is sent to the port RemotePort + d, and is
+ * fragmented into packets of at most MaxPacketSize bytes, each starting
+ * with a MdcVideoHeader. The frames are sent in the order of the trace, at
+ * the time indicated by the trace, or immediately if that time is already
+ * past.
+ */
+class MdcVideoClient : public Application
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MdcVideoClient ();
+  virtual ~MdcVideoClient ();
+
+  /**
+   * \brief set the remote address and the port of the first description
+   * \param ip remote IP address
+   * \param port remote port of the first description
+   */
+  void SetRemote (Address ip, uint16_t port);
+
+  /**
+   * \brief Set the trace file to be used by the application
+   * \param filename a path to a trace file with the format of UdpTraceClient
+   */
+  void SetTraceFile (std::string filename);
+
+  /**
+   * \return the number of frames sent
+   */
+  uint32_t GetSentFrames (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /**
+   * \brief Load a trace file
+   * \param filename the trace file path
+   */
+  void LoadTrace (std::string filename);
+  /**
+   * \brief Load the default trace
+   */
+  void LoadDefaultTrace (void);
+
+  /**
+   * \brief Send the current frame and schedule the next one
+   */
+  void SendFrame (void);
+
+  /**
+   * \brief Send a description of the current frame
+   * \param description the index of the description
+   * \param size the size of the description
+   */
+  void SendDescription (uint8_t description, uint32_t size);
+
+  /**
+   * \brief Entry of the trace, representing a frame
+   */
+  struct TraceEntry
+  {
+    uint32_t time; //!< Generation time of the frame (ms)
+    uint32_t size; //!< Size of the frame
+    char frameType; //!< Frame type (I, P or B)
+  };
+
+  std::vector<Ptr<Socket> > m_sockets; //!< Socket of each description
+  Address m_peerAddress; //!< Remote peer address
+  uint16_t m_peerPort; //!< Remote peer port of the first description
+  uint8_t m_numDescriptions; //!< Number of descriptions of each frame
+  uint32_t m_maxPacketSize; //!< Maximum packet size (including the MdcVideoHeader)
+  bool m_traceLoop; //!< Loop through the trace file
+  EventId m_sendEvent; //!< Event to send the next frame
+
+  std::vector<TraceEntry> m_entries; //!< Entries of the trace
+  uint32_t m_currentEntry; //!< Index of the next entry to send
+  Time m_loopStart; //!< Time at which the current loop of the trace started
+  uint32_t m_sentFrames; //!< Number of frames sent, used as frame number
+
+  /// Callbacks for tracing the packet Tx events
+  TracedCallback<Ptr<const Packet> > m_txTrace;
+};
+
+} // namespace ns3
+
+#endif /* MDC_VIDEO_CLIENT_H */
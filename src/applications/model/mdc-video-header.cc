@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "mdc-video-header.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MdcVideoHeader");
+
+NS_OBJECT_ENSURE_REGISTERED (MdcVideoHeader);
+
+MdcVideoHeader::MdcVideoHeader ()
+  : m_frame (0),
+    m_description (0),
+    m_numDescriptions (1),
+    m_fragment (0),
+    m_numFragments (1),
+    m_frameTs (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MdcVideoHeader::SetFrame (uint32_t frame)
+{
+  NS_LOG_FUNCTION (this << frame);
+  m_frame = frame;
+}
+
+uint32_t
+MdcVideoHeader::GetFrame (void) const
+{
+  return m_frame;
+}
+
+void
+MdcVideoHeader::SetDescription (uint8_t description, uint8_t numDescriptions)
+{
+  NS_LOG_FUNCTION (this << +description << +numDescriptions);
+  NS_ASSERT (description < numDescriptions);
+  m_description = description;
+  m_numDescriptions = numDescriptions;
+}
+
+uint8_t
+MdcVideoHeader::GetDescription (void) const
+{
+  return m_description;
+}
+
+uint8_t
+MdcVideoHeader::GetNumDescriptions (void) const
+{
+  return m_numDescriptions;
+}
+
+void
+MdcVideoHeader::SetFragment (uint16_t fragment, uint16_t numFragments)
+{
+  NS_LOG_FUNCTION (this << fragment << numFragments);
+  NS_ASSERT (fragment < numFragments);
+  m_fragment = fragment;
+  m_numFragments = numFragments;
+}
+
+uint16_t
+MdcVideoHeader::GetFragment (void) const
+{
+  return m_fragment;
+}
+
+uint16_t
+MdcVideoHeader::GetNumFragments (void) const
+{
+  return m_numFragments;
+}
+
+void
+MdcVideoHeader::SetFrameTs (Time ts)
+{
+  NS_LOG_FUNCTION (this << ts);
+  m_frameTs = ts.GetTimeStep ();
+}
+
+Time
+MdcVideoHeader::GetFrameTs (void) const
+{
+  return TimeStep (m_frameTs);
+}
+
+TypeId
+MdcVideoHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MdcVideoHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<MdcVideoHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+MdcVideoHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+MdcVideoHeader::Print (std::ostream &os) const
+{
+  os << "(frame=" << m_frame
+     << " description=" << +m_description << "/" << +m_numDescriptions
+     << " fragment=" << m_fragment << "/" << m_numFragments
+     << " time=" << TimeStep (m_frameTs).As (Time::S) << ")";
+}
+
+uint32_t
+MdcVideoHeader::GetSerializedSize (void) const
+{
+  return 4 + 1 + 1 + 2 + 2 + 8;
+}
+
+void
+MdcVideoHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+  i.WriteHtonU32 (m_frame);
+  i.WriteU8 (m_description);
+  i.WriteU8 (m_numDescriptions);
+  i.WriteHtonU16 (m_fragment);
+  i.WriteHtonU16 (m_numFragments);
+  i.WriteHtonU64 (m_frameTs);
+}
+
+uint32_t
+MdcVideoHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  m_frame = i.ReadNtohU32 ();
+  m_description = i.ReadU8 ();
+  m_numDescriptions = i.ReadU8 ();
+  m_fragment = i.ReadNtohU16 ();
+  m_numFragments = i.ReadNtohU16 ();
+  m_frameTs = i.ReadNtohU64 ();
+  return GetSerializedSize ();
+}
+
+} // namespace ns3
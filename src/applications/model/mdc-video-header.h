@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MDC_VIDEO_HEADER_H
+#define MDC_VIDEO_HEADER_H
+
+#include "ns3/header.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mdcvideo
+ *
+ * \brief Packet header of the MdcVideoClient and MdcVideoServer applications
+ *
+ * The header identifies the fragment of a description of a video frame:
+ * \li the frame number (32 bits)
+ * \li the description index and the number of descriptions (8 bits each)
+ * \li the fragment index and the number of fragments of the description
+ *     (16 bits each)
+ * \li the time at which the frame was generated (64 bits)
+ *
+ * The header is 18 bytes long.
+ */
+class MdcVideoHeader : public Header
+{
+public:
+  MdcVideoHeader ();
+
+  /**
+   * \param frame the frame number
+   */
+  void SetFrame (uint32_t frame);
+  /**
+   * \return the frame number
+   */
+  uint32_t GetFrame (void) const;
+  /**
+   * \param description the index of the description
+   * \param numDescriptions the number of descriptions of the frame
+   */
+  void SetDescription (uint8_t description, uint8_t numDescriptions);
+  /**
+   * \return the index of the description
+   */
+  uint8_t GetDescription (void) const;
+  /**
+   * \return the number of descriptions of the frame
+   */
+  uint8_t GetNumDescriptions (void) const;
+  /**
+   * \param fragment the index of the fragment
+   * \param numFragments the number of fragments of the description
+   */
+  void SetFragment (uint16_t fragment, uint16_t numFragments);
+  /**
+   * \return the index of the fragment
+   */
+  uint16_t GetFragment (void) const;
+  /**
+   * \return the number of fragments of the description
+   */
+  uint16_t GetNumFragments (void) const;
+  /**
+   * \param ts the time at which the frame was generated
+   */
+  void SetFrameTs (Time ts);
+  /**
+   * \return the time at which the frame was generated
+   */
+  Time GetFrameTs (void) const;
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+private:
+  uint32_t m_frame; //!< Frame number
+  uint8_t m_description; //!< Index of the description
+  uint8_t m_numDescriptions; //!< Number of descriptions of the frame
+  uint16_t m_fragment; //!< Index of the fragment
+  uint16_t m_numFragments; //!< Number of fragments of the description
+  uint64_t m_frameTs; //!< Generation time of the frame
+};
+
+} // namespace ns3
+
+#endif /* MDC_VIDEO_HEADER_H */
@@ -0,0 +1,381 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/socket.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "mdc-video-header.h"
+#include "mdc-video-server.h"
+#include <algorithm>
+#include <fstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MdcVideoServer");
+
+NS_OBJECT_ENSURE_REGISTERED (MdcVideoServer);
+
+TypeId
+MdcVideoServer::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MdcVideoServer")
+    .SetParent<Application> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<MdcVideoServer> ()
+    .AddAttribute ("Port",
+                   "Port on which the first description is received, the description d "
+                   "is received on the port Port + d",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&MdcVideoServer::m_port),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("NumDescriptions",
+                   "The number of descriptions of each frame",
+                   UintegerValue (2),
+                   MakeUintegerAccessor (&MdcVideoServer::m_numDescriptions),
+                   MakeUintegerChecker<uint8_t> (1))
+    .AddAttribute ("MinDescriptions",
+                   "The number of descriptions received on time needed to decode a frame",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&MdcVideoServer::m_minDescriptions),
+                   MakeUintegerChecker<uint8_t> (1))
+    .AddAttribute ("NumFrames",
+                   "The number of frames sent by the client, so that the frames after the last "
+                   "frame received are accounted as lost. If 0, the frames are accounted up to "
+                   "the last frame received",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MdcVideoServer::m_numFrames),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("PlayoutDelay",
+                   "The delay between the generation and the playout of a frame",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&MdcVideoServer::m_playoutDelay),
+                   MakeTimeChecker ())
+    .AddAttribute ("FrameStatsFilename",
+                   "Name of the file where the statistics of the frames are written "
+                   "at the end of the simulation, no file is written if empty",
+                   StringValue (""),
+                   MakeStringAccessor (&MdcVideoServer::m_frameStatsFilename),
+                   MakeStringChecker ())
+    .AddAttribute ("DescriptionStatsFilename",
+                   "Name of the file where the statistics of the descriptions are written "
+                   "at the end of the simulation, no file is written if empty",
+                   StringValue (""),
+                   MakeStringAccessor (&MdcVideoServer::m_descriptionStatsFilename),
+                   MakeStringChecker ())
+    .AddTraceSource ("Rx", "A packet has been received",
+                     MakeTraceSourceAccessor (&MdcVideoServer::m_rxTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+MdcVideoServer::MdcVideoServer ()
+  : m_port (100),
+    m_numDescriptions (2),
+    m_minDescriptions (1),
+    m_numFrames (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MdcVideoServer::~MdcVideoServer ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MdcVideoServer::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  // the statistics are exported once, at the end of the simulation
+  WriteStatsFile (m_frameStatsFilename, true);
+  WriteStatsFile (m_descriptionStatsFilename, false);
+  m_sockets.clear ();
+  m_frames.clear ();
+  Application::DoDispose ();
+}
+
+void
+MdcVideoServer::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_rxPackets.resize (m_numDescriptions, 0);
+  m_rxBytes.resize (m_numDescriptions, 0);
+  if (m_sockets.empty ())
+    {
+      TypeId tid = TypeId::LookupByName ("ns3::UdpSocketFactory");
+      for (uint8_t d = 0; d < m_numDescriptions; ++d)
+        {
+          Ptr<Socket> socket = Socket::CreateSocket (GetNode (), tid);
+          if (socket->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_port + d)) == -1)
+            {
+              NS_FATAL_ERROR ("Failed to bind socket");
+            }
+          m_sockets.push_back (socket);
+
+          Ptr<Socket> socket6 = Socket::CreateSocket (GetNode (), tid);
+          if (socket6->Bind (Inet6SocketAddress (Ipv6Address::GetAny (), m_port + d)) == -1)
+            {
+              NS_FATAL_ERROR ("Failed to bind socket");
+            }
+          m_sockets.push_back (socket6);
+        }
+    }
+
+  for (auto &socket : m_sockets)
+    {
+      socket->SetRecvCallback (MakeCallback (&MdcVideoServer::HandleRead, this));
+    }
+}
+
+void
+MdcVideoServer::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  for (auto &socket : m_sockets)
+    {
+      socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+    }
+}
+
+void
+MdcVideoServer::HandleRead (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      m_rxTrace (packet);
+      uint32_t size = packet->GetSize ();
+      MdcVideoHeader header;
+      if (size < header.GetSerializedSize ())
+        {
+          continue;
+        }
+      packet->RemoveHeader (header);
+      uint8_t description = header.GetDescription ();
+      if (description >= m_numDescriptions)
+        {
+          NS_LOG_WARN ("Description " << +description << " of frame " << header.GetFrame ()
+                       << " ignored, only " << +m_numDescriptions << " are expected");
+          continue;
+        }
+      NS_LOG_INFO ("Received " << size << " bytes of " << header);
+      m_rxPackets[description]++;
+      m_rxBytes[description] += size;
+
+      uint32_t frame = header.GetFrame ();
+      if (frame >= m_frames.size ())
+        {
+          m_frames.resize (frame + 1);
+        }
+      FrameRecord &frameRecord = m_frames[frame];
+      if (!frameRecord.m_seen)
+        {
+          frameRecord.m_seen = true;
+          frameRecord.m_generated = header.GetFrameTs ();
+          frameRecord.m_descriptions.resize (m_numDescriptions);
+        }
+      DescriptionRecord &record = frameRecord.m_descriptions[description];
+      if (record.m_numFragments == 0)
+        {
+          record.m_numFragments = header.GetNumFragments ();
+          record.m_fragments.resize (record.m_numFragments, false);
+        }
+      uint16_t fragment = header.GetFragment ();
+      if (fragment >= record.m_numFragments || record.m_fragments[fragment])
+        {
+          // a duplicate must not complete a description with missing fragments
+          NS_LOG_LOGIC ("Fragment " << fragment << " ignored");
+          continue;
+        }
+      record.m_fragments[fragment] = true;
+      record.m_received++;
+      if (record.m_received == record.m_numFragments)
+        {
+          record.m_complete = Simulator::Now ();
+        }
+    }
+}
+
+uint32_t
+MdcVideoServer::GetNumFrames (void) const
+{
+  return std::max<uint32_t> (m_frames.size (), m_numFrames);
+}
+
+std::vector<MdcVideoServer::FrameStats>
+MdcVideoServer::GetFrameStats (void) const
+{
+  // the frames after the last one received are not in m_frames
+  const FrameRecord notReceived;
+  std::vector<FrameStats> stats;
+  stats.reserve (GetNumFrames ());
+  for (uint32_t frame = 0; frame < GetNumFrames (); ++frame)
+    {
+      const FrameRecord &frameRecord = frame < m_frames.size () ? m_frames[frame] : notReceived;
+      FrameStats frameStats;
+      frameStats.m_frame = frame;
+      frameStats.m_generated = frameRecord.m_generated;
+      frameStats.m_onTime = 0;
+      frameStats.m_late = 0;
+      frameStats.m_lost = m_numDescriptions;
+      if (frameRecord.m_seen)
+        {
+          Time deadline = frameRecord.m_generated + m_playoutDelay;
+          for (const DescriptionRecord &record : frameRecord.m_descriptions)
+            {
+              if (record.m_numFragments > 0 && record.m_received >= record.m_numFragments)
+                {
+                  --frameStats.m_lost;
+                  if (record.m_complete <= deadline)
+                    {
+                      ++frameStats.m_onTime;
+                    }
+                  else
+                    {
+                      ++frameStats.m_late;
+                    }
+                }
+            }
+        }
+      frameStats.m_decodable = frameStats.m_onTime >= m_minDescriptions;
+      stats.push_back (frameStats);
+    }
+  return stats;
+}
+
+std::vector<MdcVideoServer::DescriptionStats>
+MdcVideoServer::GetDescriptionStats (void) const
+{
+  std::vector<DescriptionStats> stats (m_numDescriptions);
+  for (uint8_t d = 0; d < m_numDescriptions; ++d)
+    {
+      stats[d].m_rxPackets = d < m_rxPackets.size () ? m_rxPackets[d] : 0;
+      stats[d].m_rxBytes = d < m_rxBytes.size () ? m_rxBytes[d] : 0;
+      stats[d].m_onTime = 0;
+      stats[d].m_late = 0;
+      stats[d].m_lost = 0;
+    }
+  // the frames after the last one received are lost
+  uint32_t notReceived = GetNumFrames () - m_frames.size ();
+  for (uint8_t d = 0; d < m_numDescriptions; ++d)
+    {
+      stats[d].m_lost += notReceived;
+    }
+  for (const FrameRecord &frameRecord : m_frames)
+    {
+      for (uint8_t d = 0; d < m_numDescriptions; ++d)
+        {
+          if (!frameRecord.m_seen || frameRecord.m_descriptions[d].m_numFragments == 0
+              || frameRecord.m_descriptions[d].m_received < frameRecord.m_descriptions[d].m_numFragments)
+            {
+              stats[d].m_lost++;
+              continue;
+            }
+          const DescriptionRecord &record = frameRecord.m_descriptions[d];
+          if (record.m_complete <= frameRecord.m_generated + m_playoutDelay)
+            {
+              stats[d].m_onTime++;
+            }
+          else
+            {
+              stats[d].m_late++;
+            }
+          stats[d].m_delaySum += record.m_complete - frameRecord.m_generated;
+        }
+    }
+  return stats;
+}
+
+uint32_t
+MdcVideoServer::GetDecodableFrames (void) const
+{
+  uint32_t decodable = 0;
+  for (const FrameStats &frameStats : GetFrameStats ())
+    {
+      decodable += frameStats.m_decodable ? 1 : 0;
+    }
+  return decodable;
+}
+
+void
+MdcVideoServer::WriteFrameStats (std::ostream &os) const
+{
+  os << "frame\tgenerated[s]\tonTime\tlate\tlost\tdecodable" << std::endl;
+  for (const FrameStats &frameStats : GetFrameStats ())
+    {
+      os << frameStats.m_frame << "\t"
+         << frameStats.m_generated.GetSeconds () << "\t"
+         << +frameStats.m_onTime << "\t"
+         << +frameStats.m_late << "\t"
+         << +frameStats.m_lost << "\t"
+         << frameStats.m_decodable << std::endl;
+    }
+}
+
+void
+MdcVideoServer::WriteDescriptionStats (std::ostream &os) const
+{
+  os << "description\trxPackets\trxBytes\tonTime\tlate\tlost\tmeanDelay[s]" << std::endl;
+  std::vector<DescriptionStats> stats = GetDescriptionStats ();
+  for (uint8_t d = 0; d < stats.size (); ++d)
+    {
+      uint32_t received = stats[d].m_onTime + stats[d].m_late;
+      os << +d << "\t"
+         << stats[d].m_rxPackets << "\t"
+         << stats[d].m_rxBytes << "\t"
+         << stats[d].m_onTime << "\t"
+         << stats[d].m_late << "\t"
+         << stats[d].m_lost << "\t"
+         << (received > 0 ? stats[d].m_delaySum.GetSeconds () / received : 0.0) << std::endl;
+    }
+}
+
+void
+MdcVideoServer::WriteStatsFile (std::string filename, bool frames) const
+{
+  if (filename.empty ())
+    {
+      return;
+    }
+  std::ofstream outFile (filename.c_str ());
+  if (!outFile.is_open ())
+    {
+      NS_LOG_ERROR ("Can't open file " << filename);
+      return;
+    }
+  if (frames)
+    {
+      WriteFrameStats (outFile);
+    }
+  else
+    {
+      WriteDescriptionStats (outFile);
+    }
+}
+
+} // namespace ns3
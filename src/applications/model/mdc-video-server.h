@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MDC_VIDEO_SERVER_H
+#define MDC_VIDEO_SERVER_H
+
+#include "ns3/application.h"
+#include "ns3/ptr.h"
+#include "ns3/address.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+#include <ostream>
+#include <vector>
+
+namespace ns3 {
+
+class Socket;
+class Packet;
+
+/**
+ * \ingroup mdcvideo
+ *
+ * \brief Receiver of a video with multiple descriptions sent by a
+ * MdcVideoClient
+ *
+ * The description d is received on the port Port + d. A description of a
+ * frame is on time if all its fragments are received before the playout
+ * deadline of the frame, i.e., PlayoutDelay after the frame was generated,
+ * late if they are all received after the deadline, and lost otherwise. A
+ * frame is decodable if at least MinDescriptions of its descriptions are on
+ * time.
+ *
+ * The state of each frame is kept in memory, and the statistics are
+ * computed when requested, or written once to FrameStatsFilename and
+ * DescriptionStatsFilename when the application is disposed, at the end of
+ * the simulation. The frames are numbered by the client, so that the frames
+ * of which no packet is received are accounted as lost, up to the last
+ * frame received, or up to NumFrames if it is larger, so that the frames
+ * lost at the end of the video are accounted too.
+ */
+class MdcVideoServer : public Application
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MdcVideoServer ();
+  virtual ~MdcVideoServer ();
+
+  /**
+   * \brief Statistics of a frame
+   */
+  struct FrameStats
+  {
+    uint32_t m_frame; //!< Frame number
+    Time m_generated; //!< Generation time of the frame, if any packet was received
+    uint8_t m_onTime; //!< Number of descriptions received before the deadline
+    uint8_t m_late; //!< Number of descriptions received after the deadline
+    uint8_t m_lost; //!< Number of descriptions not received
+    bool m_decodable; //!< True if at least MinDescriptions descriptions are on time
+  };
+
+  /**
+   * \brief Statistics of a description, over all the frames
+   */
+  struct DescriptionStats
+  {
+    uint64_t m_rxPackets; //!< Number of packets received
+    uint64_t m_rxBytes; //!< Number of bytes received, including the headers
+    uint32_t m_onTime; //!< Number of frames for which the description was on time
+    uint32_t m_late; //!< Number of frames for which the description was late
+    uint32_t m_lost; //!< Number of frames for which the description was lost
+    Time m_delaySum; //!< Sum of the delays of the received descriptions
+  };
+
+  /**
+   * \return the statistics of the frames received so far
+   */
+  std::vector<FrameStats> GetFrameStats (void) const;
+
+  /**
+   * \return the statistics of each description
+   */
+  std::vector<DescriptionStats> GetDescriptionStats (void) const;
+
+  /**
+   * \return the number of decodable frames
+   */
+  uint32_t GetDecodableFrames (void) const;
+
+  /**
+   * \brief Write the statistics of the frames, one line per frame
+   * \param os the output stream
+   */
+  void WriteFrameStats (std::ostream &os) const;
+
+  /**
+   * \brief Write the statistics of the descriptions, one line per description
+   * \param os the output stream
+   */
+  void WriteDescriptionStats (std::ostream &os) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /**
+   * \brief Handle a packet reception.
+   *
+   * This function is called by lower layers.
+   *
+   * \param socket the socket the packet was received to.
+   */
+  void HandleRead (Ptr<Socket> socket);
+
+  /**
+   * \brief Reception state of a description of a frame
+   */
+  struct DescriptionRecord
+  {
+    uint16_t m_numFragments = 0; //!< Number of fragments, 0 if none was received
+    uint16_t m_received = 0; //!< Number of distinct fragments received
+    std::vector<bool> m_fragments; //!< True for each fragment received
+    Time m_complete; //!< Time at which the last fragment was received
+  };
+
+  /**
+   * \brief Reception state of a frame
+   */
+  struct FrameRecord
+  {
+    bool m_seen = false; //!< True if any packet of the frame was received
+    Time m_generated; //!< Generation time of the frame
+    std::vector<DescriptionRecord> m_descriptions; //!< State of each description
+  };
+
+  /**
+   * \brief Write the statistics to the given file
+   * \param filename the file name
+   * \param frames true to write the statistics of the frames, false for
+   *        the ones of the descriptions
+   */
+  void WriteStatsFile (std::string filename, bool frames) const;
+
+  /**
+   * \return the number of frames accounted in the statistics, the frames
+   *         after the last one received included
+   */
+  uint32_t GetNumFrames (void) const;
+
+  uint16_t m_port; //!< Port of the first description
+  uint8_t m_numDescriptions; //!< Number of descriptions of each frame
+  uint8_t m_minDescriptions; //!< Number of descriptions needed to decode a frame
+  uint32_t m_numFrames; //!< Number of frames sent by the client, 0 if unknown
+  Time m_playoutDelay; //!< Playout delay of the frames
+  std::string m_frameStatsFilename; //!< File of the frame statistics
+  std::string m_descriptionStatsFilename; //!< File of the description statistics
+  std::vector<Ptr<Socket> > m_sockets; //!< IPv4 and IPv6 sockets of each description
+
+  std::vector<FrameRecord> m_frames; //!< State of the frames, indexed by frame number
+  std::vector<uint64_t> m_rxPackets; //!< Number of packets received for each description
+  std::vector<uint64_t> m_rxBytes; //!< Number of bytes received for each description
+
+  /// Callbacks for tracing the packet Rx events
+  TracedCallback<Ptr<const Packet> > m_rxTrace;
+};
+
+} // namespace ns3
+
+#endif /* MDC_VIDEO_SERVER_H */
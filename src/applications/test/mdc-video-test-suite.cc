@@ -0,0 +1,381 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/packet.h"
+#include "ns3/error-model.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/mdc-video-header.h"
+#include "ns3/mdc-video-helper.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Test the serialization of the MdcVideoHeader
+ */
+class MdcVideoHeaderTestCase : public TestCase
+{
+public:
+  MdcVideoHeaderTestCase ();
+  virtual ~MdcVideoHeaderTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MdcVideoHeaderTestCase::MdcVideoHeaderTestCase ()
+  : TestCase ("Test the serialization of the MdcVideoHeader")
+{
+}
+
+MdcVideoHeaderTestCase::~MdcVideoHeaderTestCase ()
+{
+}
+
+void
+MdcVideoHeaderTestCase::DoRun (void)
+{
+  MdcVideoHeader header;
+  header.SetFrame (123456);
+  header.SetDescription (2, 4);
+  header.SetFragment (7, 300);
+  header.SetFrameTs (MilliSeconds (1500));
+
+  Ptr<Packet> p = Create<Packet> (100);
+  p->AddHeader (header);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 118, "Wrong size of the header");
+
+  MdcVideoHeader received;
+  p->RemoveHeader (received);
+  NS_TEST_ASSERT_MSG_EQ (received.GetFrame (), 123456, "Wrong frame");
+  NS_TEST_ASSERT_MSG_EQ (+received.GetDescription (), 2, "Wrong description");
+  NS_TEST_ASSERT_MSG_EQ (+received.GetNumDescriptions (), 4, "Wrong number of descriptions");
+  NS_TEST_ASSERT_MSG_EQ (received.GetFragment (), 7, "Wrong fragment");
+  NS_TEST_ASSERT_MSG_EQ (received.GetNumFragments (), 300, "Wrong number of fragments");
+  NS_TEST_ASSERT_MSG_EQ (received.GetFrameTs (), MilliSeconds (1500), "Wrong frame time");
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Test that the descriptions sent by a MdcVideoClient are received by a
+ * MdcVideoServer, and accounted as on time or late with respect to the
+ * playout deadline
+ */
+class MdcVideoClientServerTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param channelDelay the delay of the channel
+   * \param playoutDelay the playout delay of the server
+   */
+  MdcVideoClientServerTestCase (Time channelDelay, Time playoutDelay);
+  virtual ~MdcVideoClientServerTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  Time m_channelDelay; //!< the delay of the channel
+  Time m_playoutDelay; //!< the playout delay of the server
+};
+
+MdcVideoClientServerTestCase::MdcVideoClientServerTestCase (Time channelDelay, Time playoutDelay)
+  : TestCase ("Test the delivery of the descriptions with channel delay " + std::to_string (channelDelay.GetMilliSeconds ())
+              + " ms and playout delay " + std::to_string (playoutDelay.GetMilliSeconds ()) + " ms"),
+    m_channelDelay (channelDelay),
+    m_playoutDelay (playoutDelay)
+{
+}
+
+MdcVideoClientServerTestCase::~MdcVideoClientServerTestCase ()
+{
+}
+
+void
+MdcVideoClientServerTestCase::DoRun (void)
+{
+  NodeContainer n;
+  n.Create (2);
+
+  InternetStackHelper internet;
+  internet.Install (n);
+
+  // link the two nodes, without ARP so that the first frame is not delayed
+  Ptr<SimpleNetDevice> txDev = CreateObjectWithAttributes<SimpleNetDevice> ("PointToPointMode", BooleanValue (true));
+  Ptr<SimpleNetDevice> rxDev = CreateObjectWithAttributes<SimpleNetDevice> ("PointToPointMode", BooleanValue (true));
+  n.Get (0)->AddDevice (txDev);
+  n.Get (1)->AddDevice (rxDev);
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (m_channelDelay));
+  rxDev->SetChannel (channel);
+  txDev->SetChannel (channel);
+  NetDeviceContainer d;
+  d.Add (txDev);
+  d.Add (rxDev);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer i = ipv4.Assign (d);
+
+  uint16_t port = 4000;
+  uint8_t numDescriptions = 3;
+  uint32_t maxPacketSize = 200;
+  MdcVideoServerHelper server (port);
+  server.SetAttribute ("NumDescriptions", UintegerValue (numDescriptions));
+  server.SetAttribute ("MinDescriptions", UintegerValue (2));
+  server.SetAttribute ("PlayoutDelay", TimeValue (m_playoutDelay));
+  ApplicationContainer apps = server.Install (n.Get (1));
+  apps.Start (Seconds (1.0));
+  apps.Stop (Seconds (10.0));
+
+  // send the default trace once
+  MdcVideoClientHelper client (i.GetAddress (1), port);
+  client.SetAttribute ("NumDescriptions", UintegerValue (numDescriptions));
+  client.SetAttribute ("MaxPacketSize", UintegerValue (maxPacketSize));
+  client.SetAttribute ("TraceLoop", BooleanValue (false));
+  apps = client.Install (n.Get (0));
+  apps.Start (Seconds (2.0));
+  apps.Stop (Seconds (10.0));
+
+  Simulator::Run ();
+
+  // the default trace has 10 frames, which are split in descriptions of
+  // (almost) equal size, each one fragmented into packets of 182 bytes of
+  // payload
+  uint32_t frameSizes[] = {534, 1542, 134, 390, 765, 407, 504, 903, 421, 587};
+  std::vector<uint64_t> expectedPackets (numDescriptions, 0);
+  for (uint32_t size : frameSizes)
+    {
+      for (uint8_t desc = 0; desc < numDescriptions; ++desc)
+        {
+          uint32_t descriptionSize = size / numDescriptions + (desc < size % numDescriptions ? 1 : 0);
+          expectedPackets[desc] += (descriptionSize + maxPacketSize - 18 - 1) / (maxPacketSize - 18);
+        }
+    }
+
+  bool onTime = m_channelDelay <= m_playoutDelay;
+  Ptr<MdcVideoServer> mdcServer = server.GetServer ();
+  std::vector<MdcVideoServer::FrameStats> frameStats = mdcServer->GetFrameStats ();
+  NS_TEST_ASSERT_MSG_EQ (frameStats.size (), 10, "Wrong number of frames");
+  for (const auto &stats : frameStats)
+    {
+      NS_TEST_ASSERT_MSG_EQ (+stats.m_onTime, onTime ? numDescriptions : 0, "Wrong number of descriptions on time");
+      NS_TEST_ASSERT_MSG_EQ (+stats.m_late, onTime ? 0 : numDescriptions, "Wrong number of late descriptions");
+      NS_TEST_ASSERT_MSG_EQ (+stats.m_lost, 0, "No description should be lost");
+      NS_TEST_ASSERT_MSG_EQ (stats.m_decodable, onTime, "Wrong decodability of frame " << stats.m_frame);
+    }
+  NS_TEST_ASSERT_MSG_EQ (mdcServer->GetDecodableFrames (), onTime ? 10 : 0, "Wrong number of decodable frames");
+
+  std::vector<MdcVideoServer::DescriptionStats> descriptionStats = mdcServer->GetDescriptionStats ();
+  NS_TEST_ASSERT_MSG_EQ (descriptionStats.size (), numDescriptions, "Wrong number of descriptions");
+  for (uint8_t desc = 0; desc < numDescriptions; ++desc)
+    {
+      NS_TEST_ASSERT_MSG_EQ (descriptionStats[desc].m_rxPackets, expectedPackets[desc], "Wrong number of packets of description " << +desc);
+      NS_TEST_ASSERT_MSG_EQ (descriptionStats[desc].m_onTime, onTime ? 10 : 0, "Wrong number of frames on time");
+      NS_TEST_ASSERT_MSG_EQ (descriptionStats[desc].m_late, onTime ? 0 : 10, "Wrong number of late frames");
+      NS_TEST_ASSERT_MSG_EQ (descriptionStats[desc].m_delaySum, m_channelDelay * 10, "Wrong delay");
+    }
+
+  // one line per frame, plus the header
+  std::ostringstream oss;
+  mdcServer->WriteFrameStats (oss);
+  std::istringstream iss (oss.str ());
+  std::string line;
+  uint32_t lines = 0;
+  while (std::getline (iss, line))
+    {
+      ++lines;
+    }
+  NS_TEST_ASSERT_MSG_EQ (lines, 11, "Wrong number of lines of the frame statistics");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Test that the MdcVideoServer accounts the descriptions of which packets
+ * are dropped as lost, the frames being decodable only with MinDescriptions
+ * descriptions, and that the frames lost at the end of the video are
+ * accounted when the server knows the number of frames sent
+ */
+class MdcVideoLossTestCase : public TestCase
+{
+public:
+  MdcVideoLossTestCase ();
+  virtual ~MdcVideoLossTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MdcVideoLossTestCase::MdcVideoLossTestCase ()
+  : TestCase ("Test the accounting of the descriptions lost")
+{
+}
+
+MdcVideoLossTestCase::~MdcVideoLossTestCase ()
+{
+}
+
+void
+MdcVideoLossTestCase::DoRun (void)
+{
+  NodeContainer n;
+  n.Create (2);
+
+  InternetStackHelper internet;
+  internet.Install (n);
+
+  Ptr<SimpleNetDevice> txDev = CreateObjectWithAttributes<SimpleNetDevice> ("PointToPointMode", BooleanValue (true));
+  Ptr<SimpleNetDevice> rxDev = CreateObjectWithAttributes<SimpleNetDevice> ("PointToPointMode", BooleanValue (true));
+  n.Get (0)->AddDevice (txDev);
+  n.Get (1)->AddDevice (rxDev);
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (10)));
+  rxDev->SetChannel (channel);
+  txDev->SetChannel (channel);
+  NetDeviceContainer d;
+  d.Add (txDev);
+  d.Add (rxDev);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer i = ipv4.Assign (d);
+
+  // the packets are sent frame by frame, and description by description
+  // within a frame, so that the index of each packet received is known.
+  // Drop the description 0 of frame 1 partially, the description 1 of
+  // frame 3, the descriptions 0 and 2 of frame 5 and the whole frame 9, the
+  // last one
+  uint8_t numDescriptions = 3;
+  uint32_t maxPacketSize = 200;
+  uint32_t numFrames = 10;
+  uint32_t frameSizes[] = {534, 1542, 134, 390, 765, 407, 504, 903, 421, 587};
+  std::vector<uint64_t> expectedPackets (numDescriptions, 0);
+  std::list<uint32_t> dropped;
+  uint32_t index = 0;
+  for (uint32_t frame = 0; frame < numFrames; ++frame)
+    {
+      for (uint8_t desc = 0; desc < numDescriptions; ++desc)
+        {
+          uint32_t descriptionSize = frameSizes[frame] / numDescriptions
+            + (desc < frameSizes[frame] % numDescriptions ? 1 : 0);
+          uint32_t numFragments = (descriptionSize + maxPacketSize - 18 - 1) / (maxPacketSize - 18);
+          for (uint32_t fragment = 0; fragment < numFragments; ++fragment, ++index)
+            {
+              if ((frame == 1 && desc == 0 && fragment == 1) || (frame == 3 && desc == 1)
+                  || (frame == 5 && desc != 1) || frame == 9)
+                {
+                  dropped.push_back (index);
+                }
+              else
+                {
+                  expectedPackets[desc]++;
+                }
+            }
+        }
+    }
+  Ptr<ReceiveListErrorModel> errorModel = CreateObject<ReceiveListErrorModel> ();
+  errorModel->SetList (dropped);
+  rxDev->SetReceiveErrorModel (errorModel);
+
+  uint16_t port = 4000;
+  MdcVideoServerHelper server (port);
+  server.SetAttribute ("NumDescriptions", UintegerValue (numDescriptions));
+  server.SetAttribute ("MinDescriptions", UintegerValue (2));
+  server.SetAttribute ("NumFrames", UintegerValue (numFrames));
+  ApplicationContainer apps = server.Install (n.Get (1));
+  apps.Start (Seconds (1.0));
+  apps.Stop (Seconds (10.0));
+
+  MdcVideoClientHelper client (i.GetAddress (1), port);
+  client.SetAttribute ("NumDescriptions", UintegerValue (numDescriptions));
+  client.SetAttribute ("MaxPacketSize", UintegerValue (maxPacketSize));
+  client.SetAttribute ("TraceLoop", BooleanValue (false));
+  apps = client.Install (n.Get (0));
+  apps.Start (Seconds (2.0));
+  apps.Stop (Seconds (10.0));
+
+  Simulator::Run ();
+
+  // descriptions lost of each frame
+  uint8_t lost[] = {0, 1, 0, 1, 0, 2, 0, 0, 0, 3};
+  Ptr<MdcVideoServer> mdcServer = server.GetServer ();
+  std::vector<MdcVideoServer::FrameStats> frameStats = mdcServer->GetFrameStats ();
+  NS_TEST_ASSERT_MSG_EQ (frameStats.size (), numFrames, "The frames lost at the end should be accounted");
+  for (const auto &stats : frameStats)
+    {
+      NS_TEST_ASSERT_MSG_EQ (+stats.m_lost, +lost[stats.m_frame], "Wrong number of descriptions lost of frame " << stats.m_frame);
+      NS_TEST_ASSERT_MSG_EQ (+stats.m_onTime, numDescriptions - lost[stats.m_frame], "Wrong number of descriptions on time of frame " << stats.m_frame);
+      NS_TEST_ASSERT_MSG_EQ (+stats.m_late, 0, "No description should be late");
+      NS_TEST_ASSERT_MSG_EQ (stats.m_decodable, (numDescriptions - lost[stats.m_frame] >= 2), "Wrong decodability of frame " << stats.m_frame);
+    }
+  NS_TEST_ASSERT_MSG_EQ (mdcServer->GetDecodableFrames (), 8, "Wrong number of decodable frames");
+
+  // description 0 is lost in frames 1, 5 and 9, description 1 in frames 3
+  // and 9, and description 2 in frames 5 and 9
+  uint32_t lostFrames[] = {3, 2, 2};
+  std::vector<MdcVideoServer::DescriptionStats> descriptionStats = mdcServer->GetDescriptionStats ();
+  NS_TEST_ASSERT_MSG_EQ (descriptionStats.size (), numDescriptions, "Wrong number of descriptions");
+  for (uint8_t desc = 0; desc < numDescriptions; ++desc)
+    {
+      NS_TEST_ASSERT_MSG_EQ (descriptionStats[desc].m_rxPackets, expectedPackets[desc], "Wrong number of packets of description " << +desc);
+      NS_TEST_ASSERT_MSG_EQ (descriptionStats[desc].m_lost, lostFrames[desc], "Wrong number of frames lost of description " << +desc);
+      NS_TEST_ASSERT_MSG_EQ (descriptionStats[desc].m_onTime, numFrames - lostFrames[desc], "Wrong number of frames on time of description " << +desc);
+      NS_TEST_ASSERT_MSG_EQ (descriptionStats[desc].m_late, 0, "No frame should be late");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief MdcVideo TestSuite
+ */
+class MdcVideoTestSuite : public TestSuite
+{
+public:
+  MdcVideoTestSuite ();
+};
+
+MdcVideoTestSuite::MdcVideoTestSuite ()
+  : TestSuite ("mdc-video", UNIT)
+{
+  AddTestCase (new MdcVideoHeaderTestCase, TestCase::QUICK);
+  AddTestCase (new MdcVideoClientServerTestCase (MilliSeconds (10), MilliSeconds (100)), TestCase::QUICK);
+  AddTestCase (new MdcVideoClientServerTestCase (MilliSeconds (10), MilliSeconds (5)), TestCase::QUICK);
+  AddTestCase (new MdcVideoLossTestCase, TestCase::QUICK);
+}
+
+static MdcVideoTestSuite mdcVideoTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,190 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Compares the cost of BuildingsChannelConditionModel::GetChannelCondition
+ * with and without the grid index over the BuildingList, in a scenario with
+ * randomly deployed buildings, outdoor UEs and elevated eNBs. The cache of
+ * the channel conditions is disabled for these two runs, and evaluated
+ * separately on top of the grid index.
+ *
+ * Example: ./waf --run "buildings-channel-condition-profiler --numBuildings=5000"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/buildings-module.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Evaluate the channel condition of all the eNB-UE pairs
+ *
+ * \param model the channel condition model
+ * \param enbs the mobility models of the eNBs
+ * \param ues the mobility models of the UEs
+ * \param los filled with the LOS condition of each pair
+ * \return the elapsed wall-clock time in seconds
+ */
+static double
+RunQueries (Ptr<BuildingsChannelConditionModel> model,
+            const std::vector<Ptr<MobilityModel> > &enbs,
+            const std::vector<Ptr<MobilityModel> > &ues,
+            std::vector<bool> &los)
+{
+  los.clear ();
+  auto start = std::chrono::steady_clock::now ();
+  for (const auto &enb : enbs)
+    {
+      for (const auto &ue : ues)
+        {
+          Ptr<ChannelCondition> cond = model->GetChannelCondition (enb, ue);
+          los.push_back (cond->IsLos ());
+        }
+    }
+  auto stop = std::chrono::steady_clock::now ();
+  return std::chrono::duration<double> (stop - start).count ();
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t numBuildings = 2000;
+  uint32_t numUes = 200;
+  uint32_t numEnbs = 4;
+  double areaSize = 2000.0;
+  double maxBuildingSize = 20.0;
+  uint32_t runs = 3;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("numBuildings", "Number of buildings", numBuildings);
+  cmd.AddValue ("numUes", "Number of outdoor UEs", numUes);
+  cmd.AddValue ("numEnbs", "Number of eNBs", numEnbs);
+  cmd.AddValue ("areaSize", "Side of the square area in which buildings and nodes are deployed [m]", areaSize);
+  cmd.AddValue ("maxBuildingSize", "Maximum side of a building [m]", maxBuildingSize);
+  cmd.AddValue ("runs", "Number of times each eNB-UE pair is evaluated", runs);
+  cmd.Parse (argc, argv);
+
+  Ptr<UniformRandomVariable> pos = CreateObject<UniformRandomVariable> ();
+  pos->SetAttribute ("Min", DoubleValue (0));
+  pos->SetAttribute ("Max", DoubleValue (areaSize));
+  Ptr<UniformRandomVariable> size = CreateObject<UniformRandomVariable> ();
+  size->SetAttribute ("Min", DoubleValue (1));
+  size->SetAttribute ("Max", DoubleValue (maxBuildingSize));
+  Ptr<UniformRandomVariable> height = CreateObject<UniformRandomVariable> ();
+  height->SetAttribute ("Min", DoubleValue (1.6));
+  height->SetAttribute ("Max", DoubleValue (40));
+
+  for (uint32_t i = 0; i < numBuildings; ++i)
+    {
+      double xMin = pos->GetValue ();
+      double yMin = pos->GetValue ();
+      Ptr<Building> building = CreateObject<Building> ();
+      building->SetBoundaries (Box (xMin, xMin + size->GetValue (),
+                                    yMin, yMin + size->GetValue (),
+                                    0.0, height->GetValue ()));
+    }
+
+  NodeContainer enbNodes;
+  enbNodes.Create (numEnbs);
+  NodeContainer ueNodes;
+  ueNodes.Create (numUes);
+  std::vector<Ptr<MobilityModel> > enbs;
+  std::vector<Ptr<MobilityModel> > ues;
+  for (uint32_t i = 0; i < numEnbs; ++i)
+    {
+      Ptr<MobilityModel> mm = CreateObject<ConstantPositionMobilityModel> ();
+      enbNodes.Get (i)->AggregateObject (mm);
+      enbs.push_back (mm);
+    }
+  for (uint32_t i = 0; i < numUes; ++i)
+    {
+      Ptr<MobilityModel> mm = CreateObject<ConstantPositionMobilityModel> ();
+      ueNodes.Get (i)->AggregateObject (mm);
+      ues.push_back (mm);
+    }
+  BuildingsHelper::Install (enbNodes);
+  BuildingsHelper::Install (ueNodes);
+
+  // place the nodes outdoor, so that every query performs a LOS check
+  for (auto mm : enbs)
+    {
+      do
+        {
+          mm->SetPosition (Vector (pos->GetValue (), pos->GetValue (), 45.0));
+        }
+      while (mm->GetObject<MobilityBuildingInfo> ()->IsIndoor ());
+    }
+  for (auto mm : ues)
+    {
+      do
+        {
+          mm->SetPosition (Vector (pos->GetValue (), pos->GetValue (), 1.5));
+        }
+      while (mm->GetObject<MobilityBuildingInfo> ()->IsIndoor ());
+    }
+
+  Ptr<BuildingsChannelConditionModel> linear = CreateObject<BuildingsChannelConditionModel> ();
+  linear->SetAttribute ("UseSpatialIndex", BooleanValue (false));
+  linear->SetAttribute ("CacheConditions", BooleanValue (false));
+  Ptr<BuildingsChannelConditionModel> indexed = CreateObject<BuildingsChannelConditionModel> ();
+  indexed->SetAttribute ("UseSpatialIndex", BooleanValue (true));
+  indexed->SetAttribute ("CacheConditions", BooleanValue (false));
+  Ptr<BuildingsChannelConditionModel> cached = CreateObject<BuildingsChannelConditionModel> ();
+
+  std::vector<bool> losLinear;
+  std::vector<bool> losIndexed;
+  std::vector<bool> losCached;
+  double linearTime = 0;
+  double indexedTime = 0;
+  double cachedTime = 0;
+  for (uint32_t r = 0; r < runs; ++r)
+    {
+      linearTime += RunQueries (linear, enbs, ues, losLinear);
+      indexedTime += RunQueries (indexed, enbs, ues, losIndexed);
+      cachedTime += RunQueries (cached, enbs, ues, losCached);
+    }
+
+  uint32_t mismatches = 0;
+  uint32_t nLos = 0;
+  for (uint32_t i = 0; i < losLinear.size (); ++i)
+    {
+      mismatches += (losLinear [i] != losIndexed [i]) + (losLinear [i] != losCached [i]);
+      nLos += losLinear [i];
+    }
+
+  uint64_t nQueries = static_cast<uint64_t> (runs) * numEnbs * numUes;
+  std::cout << "buildings " << numBuildings
+            << " queries " << nQueries
+            << " LOS fraction " << static_cast<double> (nLos) / losLinear.size () << std::endl;
+  std::cout << "linear scan: " << linearTime << " s, "
+            << linearTime / nQueries * 1e6 << " us/query" << std::endl;
+  std::cout << "grid index:  " << indexedTime << " s, "
+            << indexedTime / nQueries * 1e6 << " us/query" << std::endl;
+  std::cout << "cached:      " << cachedTime << " s, "
+            << cachedTime / nQueries * 1e6 << " us/query, "
+            << cached->GetCacheHits () << " hits, "
+            << cached->GetCacheMisses () << " misses" << std::endl;
+  std::cout << "speedup " << linearTime / indexedTime
+            << ", mismatches " << mismatches << std::endl;
+
+  Simulator::Destroy ();
+  return (mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,339 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "building-grid-index.h"
+#include "building-list.h"
+#include "building.h"
+
+#include <ns3/log.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BuildingGridIndex");
+
+/// Maximum number of cells along each axis
+static const uint32_t MAX_CELLS_PER_AXIS = 1024;
+
+/**
+ * Tolerance used to register the buildings also in the cells they only
+ * touch, and to detect segments crossing a grid corner
+ */
+static const double GRID_EPSILON = 1e-9;
+
+BuildingGridIndex::BuildingGridIndex ()
+  : m_generation (0),
+    m_built (false),
+    m_query (0),
+    m_xMin (0),
+    m_xMax (0),
+    m_yMin (0),
+    m_yMax (0),
+    m_cellSizeX (1),
+    m_cellSizeY (1),
+    m_nCellsX (0),
+    m_nCellsY (0)
+{
+}
+
+bool
+BuildingGridIndex::IsUpToDate (void) const
+{
+  return m_built && m_generation == BuildingList::GetGeneration ();
+}
+
+void
+BuildingGridIndex::Update (void)
+{
+  if (!IsUpToDate ())
+    {
+      Build ();
+    }
+}
+
+uint32_t
+BuildingGridIndex::GetNBuildings (void) const
+{
+  return m_boxes.size ();
+}
+
+uint32_t
+BuildingGridIndex::GetNCellsX (void) const
+{
+  return m_nCellsX;
+}
+
+uint32_t
+BuildingGridIndex::GetNCellsY (void) const
+{
+  return m_nCellsY;
+}
+
+void
+BuildingGridIndex::Build (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_generation = BuildingList::GetGeneration ();
+  m_built = true;
+
+  m_boxes.clear ();
+  for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+    {
+      m_boxes.push_back ((*bit)->GetBoundaries ());
+    }
+  m_stamp.assign (m_boxes.size (), 0);
+  m_query = 0;
+  m_cellStart.clear ();
+  m_cellItems.clear ();
+  m_nCellsX = 0;
+  m_nCellsY = 0;
+
+  if (m_boxes.empty ())
+    {
+      return;
+    }
+
+  m_xMin = std::numeric_limits<double>::max ();
+  m_xMax = std::numeric_limits<double>::lowest ();
+  m_yMin = std::numeric_limits<double>::max ();
+  m_yMax = std::numeric_limits<double>::lowest ();
+  double extentSum = 0;
+  for (const Box &box : m_boxes)
+    {
+      m_xMin = std::min (m_xMin, box.xMin);
+      m_xMax = std::max (m_xMax, box.xMax);
+      m_yMin = std::min (m_yMin, box.yMin);
+      m_yMax = std::max (m_yMax, box.yMax);
+      extentSum += std::max (box.xMax - box.xMin, box.yMax - box.yMin);
+    }
+
+  // aim at about one building per cell, but do not use cells smaller than the
+  // average building, otherwise each building would be registered in many cells
+  double width = std::max (m_xMax - m_xMin, GRID_EPSILON);
+  double height = std::max (m_yMax - m_yMin, GRID_EPSILON);
+  double cellSize = std::sqrt (width * height / m_boxes.size ());
+  cellSize = std::max (cellSize, extentSum / m_boxes.size ());
+  cellSize = std::max (cellSize, GRID_EPSILON);
+
+  m_nCellsX = std::min<uint32_t> (std::max (1.0, std::ceil (width / cellSize)), MAX_CELLS_PER_AXIS);
+  m_nCellsY = std::min<uint32_t> (std::max (1.0, std::ceil (height / cellSize)), MAX_CELLS_PER_AXIS);
+  m_cellSizeX = width / m_nCellsX;
+  m_cellSizeY = height / m_nCellsY;
+
+  // two passes, first count the buildings of each cell, then fill the cells
+  m_cellStart.assign (m_nCellsX * m_nCellsY + 1, 0);
+  for (uint32_t pass = 0; pass < 2; ++pass)
+    {
+      for (uint32_t k = 0; k < m_boxes.size (); ++k)
+        {
+          const Box &box = m_boxes.at (k);
+          uint32_t ix0 = GetCellX (box.xMin - GRID_EPSILON);
+          uint32_t ix1 = GetCellX (box.xMax + GRID_EPSILON);
+          uint32_t iy0 = GetCellY (box.yMin - GRID_EPSILON);
+          uint32_t iy1 = GetCellY (box.yMax + GRID_EPSILON);
+          for (uint32_t iy = iy0; iy <= iy1; ++iy)
+            {
+              for (uint32_t ix = ix0; ix <= ix1; ++ix)
+                {
+                  uint32_t cell = iy * m_nCellsX + ix;
+                  if (pass == 0)
+                    {
+                      ++m_cellStart [cell + 1];
+                    }
+                  else
+                    {
+                      m_cellItems [m_stamp [cell]++] = k;
+                    }
+                }
+            }
+        }
+
+      if (pass == 0)
+        {
+          for (uint32_t cell = 0; cell < m_nCellsX * m_nCellsY; ++cell)
+            {
+              m_cellStart [cell + 1] += m_cellStart [cell];
+            }
+          m_cellItems.resize (m_cellStart.back ());
+          // m_stamp is used as the write cursor of each cell while filling
+          m_stamp.assign (m_cellStart.begin (), m_cellStart.end () - 1);
+        }
+    }
+  m_stamp.assign (m_boxes.size (), 0);
+
+  NS_LOG_DEBUG ("Indexed " << m_boxes.size () << " buildings in a "
+                           << m_nCellsX << "x" << m_nCellsY << " grid, "
+                           << m_cellItems.size () << " entries");
+}
+
+uint32_t
+BuildingGridIndex::GetCellX (double x) const
+{
+  double cell = std::floor ((x - m_xMin) / m_cellSizeX);
+  return static_cast<uint32_t> (std::min (std::max (cell, 0.0), m_nCellsX - 1.0));
+}
+
+uint32_t
+BuildingGridIndex::GetCellY (double y) const
+{
+  double cell = std::floor ((y - m_yMin) / m_cellSizeY);
+  return static_cast<uint32_t> (std::min (std::max (cell, 0.0), m_nCellsY - 1.0));
+}
+
+bool
+BuildingGridIndex::TestCell (int64_t ix, int64_t iy, const Vector &l1, const Vector &l2)
+{
+  if (ix < 0 || iy < 0 || ix >= m_nCellsX || iy >= m_nCellsY)
+    {
+      return false;
+    }
+  uint32_t cell = iy * m_nCellsX + ix;
+  for (uint32_t i = m_cellStart [cell]; i < m_cellStart [cell + 1]; ++i)
+    {
+      uint32_t k = m_cellItems [i];
+      if (m_stamp [k] != m_query)
+        {
+          m_stamp [k] = m_query;
+          if (m_boxes [k].IsIntersect (l1, l2))
+            {
+              return true;
+            }
+        }
+    }
+  return false;
+}
+
+bool
+BuildingGridIndex::IsIntersect (const Vector &l1, const Vector &l2)
+{
+  Update ();
+  if (m_boxes.empty ())
+    {
+      return false;
+    }
+
+  if (++m_query == 0)
+    {
+      // the query identifier wrapped around, forget the previous stamps
+      std::fill (m_stamp.begin (), m_stamp.end (), 0);
+      m_query = 1;
+    }
+
+  // clip the projection of the segment to the grid (Liang-Barsky), since no
+  // building can be intersected outside of it
+  double dx = l2.x - l1.x;
+  double dy = l2.y - l1.y;
+  double t0 = 0;
+  double t1 = 1;
+  const double p[4] = {-dx, dx, -dy, dy};
+  const double q[4] = {l1.x - (m_xMin - GRID_EPSILON), (m_xMax + GRID_EPSILON) - l1.x,
+                       l1.y - (m_yMin - GRID_EPSILON), (m_yMax + GRID_EPSILON) - l1.y};
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      if (p[i] == 0)
+        {
+          if (q[i] < 0)
+            {
+              return false;
+            }
+        }
+      else
+        {
+          double t = q[i] / p[i];
+          if (p[i] < 0)
+            {
+              t0 = std::max (t0, t);
+            }
+          else
+            {
+              t1 = std::min (t1, t);
+            }
+        }
+    }
+  if (t0 > t1)
+    {
+      return false;
+    }
+
+  double startX = l1.x + t0 * dx;
+  double startY = l1.y + t0 * dy;
+  int64_t ix = GetCellX (startX);
+  int64_t iy = GetCellY (startY);
+  int64_t ixEnd = GetCellX (l1.x + t1 * dx);
+  int64_t iyEnd = GetCellY (l1.y + t1 * dy);
+
+  // traverse the cells crossed by the segment, parametrized by t in [t0, t1]
+  int64_t stepX = (dx > 0) ? 1 : -1;
+  int64_t stepY = (dy > 0) ? 1 : -1;
+  double inf = std::numeric_limits<double>::infinity ();
+  double tDeltaX = (dx != 0) ? m_cellSizeX / std::abs (dx) : inf;
+  double tDeltaY = (dy != 0) ? m_cellSizeY / std::abs (dy) : inf;
+  double tMaxX = inf;
+  double tMaxY = inf;
+  if (dx != 0)
+    {
+      double boundary = m_xMin + (ix + (dx > 0 ? 1 : 0)) * m_cellSizeX;
+      tMaxX = (boundary - l1.x) / dx;
+    }
+  if (dy != 0)
+    {
+      double boundary = m_yMin + (iy + (dy > 0 ? 1 : 0)) * m_cellSizeY;
+      tMaxY = (boundary - l1.y) / dy;
+    }
+
+  uint64_t maxSteps = static_cast<uint64_t> (m_nCellsX) + m_nCellsY + 2;
+  for (uint64_t n = 0; n < maxSteps; ++n)
+    {
+      if (TestCell (ix, iy, l1, l2))
+        {
+          return true;
+        }
+      if ((ix == ixEnd && iy == iyEnd) || std::min (tMaxX, tMaxY) > t1)
+        {
+          break;
+        }
+      if (std::abs (tMaxX - tMaxY) <= GRID_EPSILON * std::max (tDeltaX, tDeltaY))
+        {
+          // the segment crosses (or grazes) a grid corner, test both
+          // neighbours before moving diagonally
+          if (TestCell (ix + stepX, iy, l1, l2) || TestCell (ix, iy + stepY, l1, l2))
+            {
+              return true;
+            }
+          ix += stepX;
+          iy += stepY;
+          tMaxX += tDeltaX;
+          tMaxY += tDeltaY;
+        }
+      else if (tMaxX < tMaxY)
+        {
+          ix += stepX;
+          tMaxX += tDeltaX;
+        }
+      else
+        {
+          iy += stepY;
+          tMaxY += tDeltaY;
+        }
+    }
+
+  // guard against rounding errors in the traversal
+  return TestCell (ixEnd, iyEnd, l1, l2);
+}
+
+} // namespace ns3
@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BUILDING_GRID_INDEX_H
+#define BUILDING_GRID_INDEX_H
+
+#include <ns3/box.h>
+#include <ns3/vector.h>
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup buildings
+ *
+ * \brief Uniform 2D grid over the footprints of the buildings in the
+ * BuildingList
+ *
+ * Each building is registered in every grid cell its footprint overlaps.
+ * A segment query walks only the cells crossed by the projection of the
+ * segment on the XY plane (Amanatides-Woo traversal) and runs the exact
+ * Box::IsIntersect test on the buildings registered there, so that the
+ * result is the same as a linear scan of the BuildingList.
+ *
+ * The index is rebuilt lazily, the first time it is queried after a
+ * building is added to the BuildingList or its boundaries change (see
+ * BuildingList::GetGeneration).
+ */
+class BuildingGridIndex
+{
+public:
+  /**
+   * Constructor
+   */
+  BuildingGridIndex ();
+
+  /**
+   * \return true if the index reflects the current content of the BuildingList
+   */
+  bool IsUpToDate (void) const;
+
+  /**
+   * Rebuild the index from the BuildingList, if it is not up to date
+   */
+  void Update (void);
+
+  /**
+   * \brief Checks if the line-segment between position l1 and position l2
+   *        intersects at least one of the buildings.
+   *
+   * \param l1 position
+   * \param l2 position
+   * \return true if there is an intersection, false otherwise
+   */
+  bool IsIntersect (const Vector &l1, const Vector &l2);
+
+  /**
+   * \return the number of buildings in the index
+   */
+  uint32_t GetNBuildings (void) const;
+
+  /**
+   * \return the number of cells along the X axis
+   */
+  uint32_t GetNCellsX (void) const;
+
+  /**
+   * \return the number of cells along the Y axis
+   */
+  uint32_t GetNCellsY (void) const;
+
+private:
+  /**
+   * Rebuild the index from scratch
+   */
+  void Build (void);
+
+  /**
+   * \param x the X coordinate
+   * \return the index of the column containing x, clamped to the grid
+   */
+  uint32_t GetCellX (double x) const;
+
+  /**
+   * \param y the Y coordinate
+   * \return the index of the row containing y, clamped to the grid
+   */
+  uint32_t GetCellY (double y) const;
+
+  /**
+   * Test the segment against the buildings registered in a cell which
+   * have not been tested yet during the current query
+   *
+   * \param ix the column of the cell
+   * \param iy the row of the cell
+   * \param l1 position
+   * \param l2 position
+   * \return true if one of the buildings intersects the segment
+   */
+  bool TestCell (int64_t ix, int64_t iy, const Vector &l1, const Vector &l2);
+
+  uint64_t m_generation; //!< BuildingList generation the index was built from
+  bool m_built; //!< true if Build has been called at least once
+
+  std::vector<Box> m_boxes; //!< boundaries of the indexed buildings
+  std::vector<uint32_t> m_cellStart; //!< offset in m_cellItems of the first building of each cell
+  std::vector<uint32_t> m_cellItems; //!< building indexes, grouped by cell
+  std::vector<uint32_t> m_stamp; //!< last query in which each building was tested
+  uint32_t m_query; //!< identifier of the current query
+
+  double m_xMin; //!< lower X bound of the grid
+  double m_xMax; //!< upper X bound of the grid
+  double m_yMin; //!< lower Y bound of the grid
+  double m_yMax; //!< upper Y bound of the grid
+  double m_cellSizeX; //!< size of a cell along the X axis
+  double m_cellSizeY; //!< size of a cell along the Y axis
+  uint32_t m_nCellsX; //!< number of cells along the X axis
+  uint32_t m_nCellsY; //!< number of cells along the Y axis
+};
+
+} // namespace ns3
+
+#endif /* BUILDING_GRID_INDEX_H */
@@ -47,6 +47,8 @@ public:
   BuildingList::Iterator End (void) const;
   Ptr<Building> GetBuilding (uint32_t n);
   uint32_t GetNBuildings (void);
+  static uint64_t GetGeneration (void);
+  static void NotifyBuildingChanged (void);
 
   static Ptr<BuildingListPriv> Get (void);
 
@@ -55,8 +57,16 @@ private:
   static Ptr<BuildingListPriv> *DoGet (void);
   static void Delete (void);
   std::vector<Ptr<Building> > m_buildings;
+  /**
+   * Incremented on every change of the building geometry. It is not reset
+   * when the list is destroyed, so that an index built during a previous
+   * simulation is never mistaken for an up-to-date one.
+   */
+  static uint64_t m_generation;
 };
 
+uint64_t BuildingListPriv::m_generation = 0;
+
 NS_OBJECT_ENSURE_REGISTERED (BuildingListPriv);
 
 TypeId
@@ -96,6 +106,7 @@ BuildingListPriv::Delete (void)
   NS_LOG_FUNCTION_NOARGS ();
   Config::UnregisterRootNamespaceObject (Get ());
   (*DoGet ()) = 0;
+  ++m_generation;
 }
 
 
@@ -127,6 +138,7 @@ BuildingListPriv::Add (Ptr<Building> building)
 {
   uint32_t index = m_buildings.size ();
   m_buildings.push_back (building);
+  ++m_generation;
   Simulator::ScheduleWithContext (index, TimeStep (0), &Building::Initialize, building);
   return index;
 
@@ -147,6 +159,18 @@ BuildingListPriv::GetNBuildings (void)
   return m_buildings.size ();
 }
 
+uint64_t
+BuildingListPriv::GetGeneration (void)
+{
+  return m_generation;
+}
+
+void
+BuildingListPriv::NotifyBuildingChanged (void)
+{
+  ++m_generation;
+}
+
 Ptr<Building>
 BuildingListPriv::GetBuilding (uint32_t n)
 {
@@ -189,5 +213,15 @@ BuildingList::GetNBuildings (void)
 {
   return BuildingListPriv::Get ()->GetNBuildings ();
 }
+uint64_t
+BuildingList::GetGeneration (void)
+{
+  return BuildingListPriv::GetGeneration ();
+}
+void
+BuildingList::NotifyBuildingChanged (void)
+{
+  BuildingListPriv::NotifyBuildingChanged ();
+}
 
 } // namespace ns3
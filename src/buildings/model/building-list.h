@@ -62,6 +62,21 @@ public:
    * \returns the number of buildings currently in the list.
    */
   static uint32_t GetNBuildings (void);
+  /**
+   * \returns a counter that is incremented every time a building is added
+   *          to the list or the boundaries of a building change.
+   *
+   * Spatial indexes over the building list (e.g., BuildingGridIndex) use
+   * this value to detect when they need to be rebuilt.
+   */
+  static uint64_t GetGeneration (void);
+  /**
+   * Notify the list that the geometry of one of its buildings changed.
+   *
+   * This method is called automatically from Building::SetBoundaries so
+   * the user has little reason to call it himself.
+   */
+  static void NotifyBuildingChanged (void);
 };
 
 } // namespace ns3
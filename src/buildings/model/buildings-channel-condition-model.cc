@@ -24,6 +24,9 @@
 #include "ns3/mobility-building-info.h"
 #include "ns3/building-list.h"
 #include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/node.h"
 
 namespace ns3 {
 
@@ -38,17 +41,129 @@ BuildingsChannelConditionModel::GetTypeId (void)
     .SetParent<ChannelConditionModel> ()
     .SetGroupName ("Buildings")
     .AddConstructor<BuildingsChannelConditionModel> ()
+    .AddAttribute ("UseSpatialIndex",
+                   "If true, the line of sight is checked only against the buildings "
+                   "found in the cells of a grid index crossed by the segment. "
+                   "If false, all the buildings in the BuildingList are checked.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&BuildingsChannelConditionModel::m_useSpatialIndex),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CacheConditions",
+                   "If true, the channel condition of each pair of nodes is cached "
+                   "and recomputed only when one of the two nodes moves.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&BuildingsChannelConditionModel::m_cacheConditions),
+                   MakeBooleanChecker ())
+    .AddAttribute ("UpdateDistance",
+                   "A cached channel condition is recomputed when one of the two "
+                   "nodes moved by more than this distance [m] since it was computed. "
+                   "If 0, any change of position triggers an update. In any case, "
+                   "the condition is recomputed when the CourseChange trace of one "
+                   "of the two MobilityModels is fired.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&BuildingsChannelConditionModel::m_updateDistance),
+                   MakeDoubleChecker<double> (0.0))
   ;
   return tid;
 }
 
 BuildingsChannelConditionModel::BuildingsChannelConditionModel ()
-  : ChannelConditionModel ()
+  : ChannelConditionModel (),
+    m_cacheHits (0),
+    m_cacheMisses (0)
 {
 }
 
 BuildingsChannelConditionModel::~BuildingsChannelConditionModel ()
 {
+  DisconnectMobilityModels ();
+}
+
+void
+BuildingsChannelConditionModel::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_INFO ("Channel condition cache: " << m_cacheHits << " hits, "
+                                           << m_cacheMisses << " misses");
+  DisconnectMobilityModels ();
+  ChannelConditionModel::DoDispose ();
+}
+
+void
+BuildingsChannelConditionModel::DisconnectMobilityModels (void)
+{
+  for (auto &tracked : m_trackedMobility)
+    {
+      Ptr<MobilityModel> mobility = ConstCast<MobilityModel> (tracked.second.m_mobility);
+      mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                               MakeCallback (&BuildingsChannelConditionModel::CourseChanged, this));
+    }
+  m_trackedMobility.clear ();
+  m_channelConditionMap.clear ();
+}
+
+uint64_t
+BuildingsChannelConditionModel::TrackMobilityModel (uint32_t nodeId, Ptr<const MobilityModel> mobility) const
+{
+  auto it = m_trackedMobility.find (nodeId);
+  if (it != m_trackedMobility.end () && it->second.m_mobility == mobility)
+    {
+      return it->second.m_courseChanges;
+    }
+
+  if (it != m_trackedMobility.end ())
+    {
+      // a different mobility model has been aggregated to the node
+      Ptr<MobilityModel> old = ConstCast<MobilityModel> (it->second.m_mobility);
+      old->TraceDisconnectWithoutContext ("CourseChange",
+                                          MakeCallback (&BuildingsChannelConditionModel::CourseChanged,
+                                                        const_cast<BuildingsChannelConditionModel*> (this)));
+    }
+
+  // the cache is only a local optimization, for this reason you see a const_cast
+  ConstCast<MobilityModel> (mobility)->TraceConnectWithoutContext ("CourseChange",
+                                                                   MakeCallback (&BuildingsChannelConditionModel::CourseChanged,
+                                                                                 const_cast<BuildingsChannelConditionModel*> (this)));
+  TrackedMobility tracked;
+  tracked.m_mobility = mobility;
+  // start from a value which differs from the one stored by any cached item
+  tracked.m_courseChanges = (it != m_trackedMobility.end ()) ? it->second.m_courseChanges + 1 : 0;
+  m_trackedMobility [nodeId] = tracked;
+  return tracked.m_courseChanges;
+}
+
+void
+BuildingsChannelConditionModel::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  Ptr<Node> node = mobility->GetObject<Node> ();
+  if (node)
+    {
+      auto it = m_trackedMobility.find (node->GetId ());
+      if (it != m_trackedMobility.end ())
+        {
+          ++it->second.m_courseChanges;
+        }
+    }
+}
+
+uint32_t
+BuildingsChannelConditionModel::GetKey (uint32_t x1, uint32_t x2)
+{
+  // use the cantor function to obtain the key
+  return (((x1 + x2) * (x1 + x2 + 1)) / 2) + x2;
+}
+
+uint64_t
+BuildingsChannelConditionModel::GetCacheHits (void) const
+{
+  return m_cacheHits;
+}
+
+uint64_t
+BuildingsChannelConditionModel::GetCacheMisses (void) const
+{
+  return m_cacheMisses;
 }
 
 Ptr<ChannelCondition>
@@ -56,6 +171,59 @@ BuildingsChannelConditionModel::GetChannelCondition (Ptr<const MobilityModel> a,
                                                      Ptr<const MobilityModel> b) const
 {
   NS_LOG_FUNCTION (this);
+
+  Ptr<Node> nodeA = a->GetObject<Node> ();
+  Ptr<Node> nodeB = b->GetObject<Node> ();
+  if (!m_cacheConditions || !nodeA || !nodeB)
+    {
+      // the key of the cache is based on the node ids
+      ++m_cacheMisses;
+      return ComputeChannelCondition (a, b);
+    }
+
+  // sort the mobility models by node id, so that the cache is reciprocal
+  if (nodeA->GetId () > nodeB->GetId ())
+    {
+      std::swap (a, b);
+      std::swap (nodeA, nodeB);
+    }
+  uint64_t courseChanges1 = TrackMobilityModel (nodeA->GetId (), a);
+  uint64_t courseChanges2 = TrackMobilityModel (nodeB->GetId (), b);
+  Vector position1 = a->GetPosition ();
+  Vector position2 = b->GetPosition ();
+  uint64_t buildingsGeneration = BuildingList::GetGeneration ();
+
+  uint32_t key = GetKey (nodeA->GetId (), nodeB->GetId ());
+  auto mapItem = m_channelConditionMap.find (key);
+  if (mapItem != m_channelConditionMap.end ()
+      && mapItem->second.m_courseChanges1 == courseChanges1
+      && mapItem->second.m_courseChanges2 == courseChanges2
+      && mapItem->second.m_buildingsGeneration == buildingsGeneration
+      && CalculateDistance (mapItem->second.m_position1, position1) <= m_updateDistance
+      && CalculateDistance (mapItem->second.m_position2, position2) <= m_updateDistance)
+    {
+      NS_LOG_DEBUG ("found the channel condition in the cache");
+      ++m_cacheHits;
+      return mapItem->second.m_condition;
+    }
+
+  ++m_cacheMisses;
+  Item item;
+  item.m_condition = ComputeChannelCondition (a, b);
+  item.m_position1 = position1;
+  item.m_position2 = position2;
+  item.m_courseChanges1 = courseChanges1;
+  item.m_courseChanges2 = courseChanges2;
+  item.m_buildingsGeneration = buildingsGeneration;
+  m_channelConditionMap [key] = item;
+  return item.m_condition;
+}
+
+Ptr<ChannelCondition>
+BuildingsChannelConditionModel::ComputeChannelCondition (Ptr<const MobilityModel> a,
+                                                         Ptr<const MobilityModel> b) const
+{
+  NS_LOG_FUNCTION (this);
   Ptr<MobilityBuildingInfo> a1 = a->GetObject<MobilityBuildingInfo> ();
   Ptr<MobilityBuildingInfo> b1 = b->GetObject<MobilityBuildingInfo> ();
   NS_ASSERT_MSG ((a1 != nullptr) && (b1 != nullptr),
@@ -117,6 +285,11 @@ BuildingsChannelConditionModel::GetChannelCondition (Ptr<const MobilityModel> a,
 bool
 BuildingsChannelConditionModel::IsLineOfSightBlocked (const ns3::Vector &l1, const ns3::Vector &l2) const
 {
+  if (m_useSpatialIndex)
+    {
+      return m_buildingIndex.IsIntersect (l1, l2);
+    }
+
   for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
     {
       if ((*bit)->IsIntersect (l1, l2))
@@ -23,6 +23,8 @@
 #define BUILDINGS_CHANNEL_CONDITION_MODEL_H
 
 #include "ns3/channel-condition-model.h"
+#include "ns3/building-grid-index.h"
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -34,6 +36,11 @@ class MobilityModel;
  * \brief Determines the channel condition based on the buildings deployed in the
  * scenario
  *
+ * The channel condition of each pair of nodes is stored in a local cache and
+ * recomputed only if one of the two MobilityModels fired its CourseChange
+ * trace, if one of the two nodes moved by more than the "UpdateDistance"
+ * attribute, or if the buildings changed since it was computed.
+ *
  * Code adapted from MmWave3gppBuildingsPropagationLossModel
  */
 class BuildingsChannelConditionModel : public ChannelConditionModel
@@ -60,12 +67,26 @@ public:
   /**
    * Computes the condition of the channel between a and b.
    *
+   * If the condition is present in the cache and neither a nor b moved since
+   * it was computed, the cached condition is returned.
+   *
    * \param a mobility model
    * \param b mobility model
    * \return the condition of the channel between a and b
    */
   virtual Ptr<ChannelCondition> GetChannelCondition (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b) const override;
 
+  /**
+   * \return the number of calls to GetChannelCondition served by the cache
+   */
+  uint64_t GetCacheHits (void) const;
+
+  /**
+   * \return the number of calls to GetChannelCondition which required the
+   *         computation of the channel condition
+   */
+  uint64_t GetCacheMisses (void) const;
+
   /**
    * If this model uses objects of type RandomVariableStream,
    * set the stream numbers to the integers starting with the offset
@@ -77,7 +98,52 @@ public:
    */
   virtual int64_t AssignStreams (int64_t stream) override;
 
+protected:
+  virtual void DoDispose () override;
+
 private:
+  /**
+   * Computes the condition of the channel between a and b, without using
+   * the cache
+   *
+   * \param a mobility model
+   * \param b mobility model
+   * \return the condition of the channel between a and b
+   */
+  Ptr<ChannelCondition> ComputeChannelCondition (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b) const;
+
+  /**
+   * Connect to the CourseChange trace of a mobility model, if not done yet
+   *
+   * \param nodeId the id of the node the mobility model is aggregated to
+   * \param mobility the mobility model
+   * \return the number of course changes notified by the mobility model
+   */
+  uint64_t TrackMobilityModel (uint32_t nodeId, Ptr<const MobilityModel> mobility) const;
+
+  /**
+   * Callback connected to the CourseChange trace of the mobility models
+   *
+   * \param mobility the mobility model whose course changed
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+
+  /**
+   * Disconnect from the CourseChange trace of all the tracked mobility models
+   * and clear the cache
+   */
+  void DisconnectMobilityModels (void);
+
+  /**
+   * \brief Returns a unique and reciprocal key for the channel between the
+   * nodes with id x1 and x2, with x1 <= x2.
+   * \param x1 the lower node id
+   * \param x2 the higher node id
+   * \return channel key
+   */
+  static uint32_t GetKey (uint32_t x1, uint32_t x2);
+
+
   /**
    * \brief Checks if the line of sight between position l1 and position l2 is
    *        blocked by a building.
@@ -87,6 +153,38 @@ private:
    * \return true if the line of sight is blocked, false otherwise
    */
   bool IsLineOfSightBlocked (const Vector &l1, const Vector &l2) const;
+
+  /**
+   * Struct to store the channel condition in the m_channelConditionMap
+   */
+  struct Item
+  {
+    Ptr<ChannelCondition> m_condition; //!< the channel condition
+    Vector m_position1; //!< the position of the node with the lower id
+    Vector m_position2; //!< the position of the node with the higher id
+    uint64_t m_courseChanges1; //!< course changes of the node with the lower id
+    uint64_t m_courseChanges2; //!< course changes of the node with the higher id
+    uint64_t m_buildingsGeneration; //!< the BuildingList generation
+  };
+
+  /**
+   * Struct to store the mobility models connected to CourseChanged
+   */
+  struct TrackedMobility
+  {
+    Ptr<const MobilityModel> m_mobility; //!< the mobility model
+    uint64_t m_courseChanges; //!< the number of course changes notified
+  };
+
+  bool m_useSpatialIndex; //!< if true, use m_buildingIndex instead of a linear scan of the BuildingList
+  mutable BuildingGridIndex m_buildingIndex; //!< spatial index over the BuildingList
+
+  bool m_cacheConditions; //!< if true, cache the channel condition of each pair of nodes
+  double m_updateDistance; //!< distance [m] a node has to move to trigger an update
+  mutable std::unordered_map<uint32_t, Item> m_channelConditionMap; //!< map to store the channel conditions
+  mutable std::unordered_map<uint32_t, TrackedMobility> m_trackedMobility; //!< mobility models, indexed by node id
+  mutable uint64_t m_cacheHits; //!< number of conditions served by the cache
+  mutable uint64_t m_cacheMisses; //!< number of conditions computed
 };
 
 } // end ns3 namespace
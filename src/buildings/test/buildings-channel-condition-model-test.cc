@@ -25,6 +25,10 @@
 #include "ns3/buildings-module.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/building-grid-index.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/boolean.h"
 
 using namespace ns3;
 
@@ -139,6 +143,199 @@ BuildingsChannelConditionModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * Test case for the class BuildingGridIndex. It checks that the index returns
+ * the same result as a linear scan of the BuildingList for random segments,
+ * including axis-aligned, vertical and degenerate ones, and that the index is
+ * rebuilt when buildings are added or moved
+ */
+class BuildingGridIndexTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  BuildingGridIndexTestCase ();
+
+private:
+  /**
+   * Builds the simulation scenario and perform the tests
+   */
+  virtual void DoRun (void);
+
+  /**
+   * Checks if a segment intersects a building with a linear scan of the
+   * BuildingList
+   *
+   * \param l1 position
+   * \param l2 position
+   * \return true if there is an intersection, false otherwise
+   */
+  static bool LinearScan (const Vector &l1, const Vector &l2);
+};
+
+BuildingGridIndexTestCase::BuildingGridIndexTestCase ()
+  : TestCase ("Test case for the BuildingGridIndex")
+{
+}
+
+bool
+BuildingGridIndexTestCase::LinearScan (const Vector &l1, const Vector &l2)
+{
+  for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+    {
+      if ((*bit)->IsIntersect (l1, l2))
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+BuildingGridIndexTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  BuildingGridIndex index;
+  NS_TEST_ASSERT_MSG_EQ (index.IsIntersect (Vector (0, 0, 1), Vector (100, 100, 1)), false,
+                         "No buildings, the segment cannot be blocked");
+
+  // buildings aligned on a 10 m lattice, so that the grid boundaries and the
+  // building walls coincide, plus a set of randomly placed ones
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      Ptr<Building> building = CreateObject<Building> ();
+      building->SetBoundaries (Box (i * 20.0, i * 20.0 + 10.0, i * 20.0, i * 20.0 + 10.0, 0.0, 10.0));
+    }
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  uniform->SetStream (1);
+  for (uint32_t i = 0; i < 200; ++i)
+    {
+      double x = uniform->GetValue (0, 500);
+      double y = uniform->GetValue (0, 500);
+      Ptr<Building> building = CreateObject<Building> ();
+      building->SetBoundaries (Box (x, x + uniform->GetValue (1, 20), y, y + uniform->GetValue (1, 20),
+                                    0.0, uniform->GetValue (2, 30)));
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (index.IsUpToDate (), false, "The index should be stale");
+  index.Update ();
+  NS_TEST_ASSERT_MSG_EQ (index.GetNBuildings (), BuildingList::GetNBuildings (), "Wrong number of indexed buildings");
+
+  std::vector<std::pair<Vector, Vector> > segments;
+  // diagonal through the lattice corners, axis-aligned and vertical segments
+  segments.push_back (std::make_pair (Vector (-10, -10, 1), Vector (600, 600, 1)));
+  segments.push_back (std::make_pair (Vector (10, 0, 5), Vector (10, 200, 5)));
+  segments.push_back (std::make_pair (Vector (0, 15, 5), Vector (300, 15, 5)));
+  segments.push_back (std::make_pair (Vector (5, 5, 1), Vector (5, 5, 50)));
+  segments.push_back (std::make_pair (Vector (5, 5, 20), Vector (5, 5, 20)));
+  segments.push_back (std::make_pair (Vector (-100, -50, 1), Vector (-10, 700, 1)));
+  for (uint32_t i = 0; i < 2000; ++i)
+    {
+      segments.push_back (std::make_pair (Vector (uniform->GetValue (-50, 550), uniform->GetValue (-50, 550), uniform->GetValue (0, 40)),
+                                          Vector (uniform->GetValue (-50, 550), uniform->GetValue (-50, 550), uniform->GetValue (0, 40))));
+    }
+
+  for (const auto &segment : segments)
+    {
+      NS_TEST_ASSERT_MSG_EQ (index.IsIntersect (segment.first, segment.second),
+                             LinearScan (segment.first, segment.second),
+                             "The index and the linear scan disagree for segment "
+                             << segment.first << " - " << segment.second);
+    }
+
+  // moving a building must invalidate the index
+  Vector l1 (1000, 1000, 1);
+  Vector l2 (1100, 1000, 1);
+  NS_TEST_ASSERT_MSG_EQ (index.IsIntersect (l1, l2), false, "The segment should not be blocked");
+  BuildingList::GetBuilding (0)->SetBoundaries (Box (1040, 1050, 990, 1010, 0, 10));
+  NS_TEST_ASSERT_MSG_EQ (index.IsUpToDate (), false, "The index should be stale");
+  NS_TEST_ASSERT_MSG_EQ (index.IsIntersect (l1, l2), true, "The segment should be blocked by the moved building");
+
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (index.IsIntersect (l1, l2), false, "The buildings were destroyed, the segment should not be blocked");
+}
+
+/**
+ * Test case for the cache of the class BuildingsChannelConditionModel. It
+ * checks that the cached condition is reused while the nodes do not move, and
+ * that it is recomputed when a node moves or the buildings change
+ */
+class BuildingsChannelConditionModelCacheTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  BuildingsChannelConditionModelCacheTestCase ();
+
+private:
+  /**
+   * Builds the simulation scenario and perform the tests
+   */
+  virtual void DoRun (void);
+};
+
+BuildingsChannelConditionModelCacheTestCase::BuildingsChannelConditionModelCacheTestCase ()
+  : TestCase ("Test case for the cache of the BuildingsChannelConditionModel")
+{
+}
+
+void
+BuildingsChannelConditionModelCacheTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  nodes.Get (0)->AggregateObject (a);
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  nodes.Get (1)->AggregateObject (b);
+  BuildingsHelper::Install (nodes);
+
+  Ptr<Building> building = CreateObject<Building> ();
+  building->SetBoundaries (Box (0.0, 10.0, 0.0, 10.0, 0.0, 5.0));
+
+  a->SetPosition (Vector (-5.0, 5.0, 1.5));
+  b->SetPosition (Vector (20.0, 5.0, 1.5));
+
+  Ptr<BuildingsChannelConditionModel> condModel = CreateObject<BuildingsChannelConditionModel> ();
+  Ptr<ChannelCondition> cond = condModel->GetChannelCondition (a, b);
+  NS_TEST_ASSERT_MSG_EQ (cond->GetLosCondition (), ChannelCondition::LosConditionValue::NLOS, "Got unexpected channel condition");
+  NS_TEST_ASSERT_MSG_EQ (condModel->GetCacheMisses (), 1, "The first query should be a miss");
+
+  // the cache is reciprocal
+  Ptr<ChannelCondition> cachedCond = condModel->GetChannelCondition (b, a);
+  NS_TEST_ASSERT_MSG_EQ (cachedCond, cond, "The cached condition should be returned");
+  NS_TEST_ASSERT_MSG_EQ (condModel->GetCacheHits (), 1, "The second query should be a hit");
+
+  // moving a node fires CourseChange and invalidates the condition
+  b->SetPosition (Vector (-5.0, 20.0, 1.5));
+  cond = condModel->GetChannelCondition (a, b);
+  NS_TEST_ASSERT_MSG_EQ (cond->GetLosCondition (), ChannelCondition::LosConditionValue::LOS, "Got unexpected channel condition");
+  NS_TEST_ASSERT_MSG_EQ (condModel->GetCacheMisses (), 2, "Moving a node should invalidate the cache");
+
+  // adding a building invalidates the condition
+  Ptr<Building> building2 = CreateObject<Building> ();
+  building2->SetBoundaries (Box (-8.0, -2.0, 12.0, 14.0, 0.0, 5.0));
+  cond = condModel->GetChannelCondition (a, b);
+  NS_TEST_ASSERT_MSG_EQ (cond->GetLosCondition (), ChannelCondition::LosConditionValue::NLOS, "Got unexpected channel condition");
+  NS_TEST_ASSERT_MSG_EQ (condModel->GetCacheMisses (), 3, "Adding a building should invalidate the cache");
+  cond = condModel->GetChannelCondition (a, b);
+  NS_TEST_ASSERT_MSG_EQ (condModel->GetCacheHits (), 2, "The condition should be cached");
+
+  // the cache can be disabled
+  condModel->SetAttribute ("CacheConditions", BooleanValue (false));
+  cond = condModel->GetChannelCondition (a, b);
+  NS_TEST_ASSERT_MSG_EQ (condModel->GetCacheHits (), 2, "The cache should be disabled");
+  NS_TEST_ASSERT_MSG_EQ (condModel->GetCacheMisses (), 4, "The cache should be disabled");
+
+  Simulator::Destroy ();
+}
+
 /**
  * Test suite for the buildings channel condition model
  */
@@ -152,6 +349,8 @@ BuildingsChannelConditionModelsTestSuite::BuildingsChannelConditionModelsTestSui
   : TestSuite ("buildings-channel-condition-model", UNIT)
 {
   AddTestCase (new BuildingsChannelConditionModelTestCase, TestCase::QUICK);
+  AddTestCase (new BuildingGridIndexTestCase, TestCase::QUICK);
+  AddTestCase (new BuildingsChannelConditionModelCacheTestCase, TestCase::QUICK);
 }
 
 static BuildingsChannelConditionModelsTestSuite BuildingsChannelConditionModelsTestSuite;
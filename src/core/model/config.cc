@@ -26,6 +26,9 @@
 #include "pointer.h"
 #include "log.h"
 
+#include <algorithm>
+#include <limits>
+#include <memory>
 #include <sstream>
 
 /**
@@ -182,6 +185,9 @@ MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &
 /**
  * \ingroup config-impl
  * Helper to test if an array entry matches a config path specification.
+ *
+ * The specification is parsed once, in the constructor, into the ranges
+ * of the indices that it matches.
  */
 class ArrayMatcher
 {
@@ -199,8 +205,23 @@ public:
    * \returns \c true if the index matches the Config Path.
    */
   bool Matches (std::size_t i) const;
+  /**
+   * Get the indices matched by the Config path specification, if it is
+   * made only of explicit indices, such as "3" or "1|4".
+   *
+   * \param [out] indices The matched indices, in increasing order.
+   * \returns \c true if the specification is made only of explicit indices.
+   */
+  bool GetIndices (std::vector<std::size_t> *indices) const;
 
 private:
+  /**
+   * Parse a Config path specification, or one of its alternatives,
+   * and add the ranges of the indices that it matches.
+   *
+   * \param [in] element The Config path specification.
+   */
+  void Parse (std::string element);
   /**
    * Convert a string to an \c uint32_t.
    *
@@ -211,6 +232,8 @@ private:
   bool StringToUint32 (std::string str, uint32_t *value) const;
   /** The Config path element. */
   std::string m_element;
+  /** The ranges [first, second] of the matched indices. */
+  std::vector<std::pair<std::size_t, std::size_t> > m_ranges;
 
 };  // class ArrayMatcher
 
@@ -219,70 +242,83 @@ ArrayMatcher::ArrayMatcher (std::string element)
   : m_element (element)
 {
   NS_LOG_FUNCTION (this << element);
+  Parse (element);
 }
-bool
-ArrayMatcher::Matches (std::size_t i) const
+void
+ArrayMatcher::Parse (std::string element)
 {
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  NS_LOG_FUNCTION (this << element);
+  if (element == "*")
     {
-      NS_LOG_DEBUG ("Array " << i << " matches *");
-      return true;
+      m_ranges.push_back (std::make_pair (0, std::numeric_limits<std::size_t>::max ()));
+      return;
     }
   std::string::size_type tmp;
-  tmp = m_element.find ("|");
+  tmp = element.find ("|");
   if (tmp != std::string::npos)
     {
-      std::string left = m_element.substr (0, tmp - 0);
-      std::string right = m_element.substr (tmp + 1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array " << i << " matches " << left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array " << i << " matches " << right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array " << i << " does not match " << m_element);
-      return false;
+      Parse (element.substr (0, tmp - 0));
+      Parse (element.substr (tmp + 1, element.size () - (tmp + 1)));
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1
       && dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
       if (StringToUint32 (lowerBound, &min)
           && StringToUint32 (upperBound, &max)
-          && i >= min && i <= max)
-        {
-          NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
-          return true;
-        }
-      else
+          && min <= max)
         {
-          NS_LOG_DEBUG ("Array " << i << " does not " << m_element);
-          return false;
+          m_ranges.push_back (std::make_pair (min, max));
         }
+      return;
     }
   uint32_t value;
-  if (StringToUint32 (m_element, &value)
-      && i == value)
+  if (StringToUint32 (element, &value))
+    {
+      m_ranges.push_back (std::make_pair (value, value));
+    }
+}
+bool
+ArrayMatcher::Matches (std::size_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  for (std::vector<std::pair<std::size_t, std::size_t> >::const_iterator it = m_ranges.begin ();
+       it != m_ranges.end (); ++it)
     {
-      NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
-      return true;
+      if (i >= it->first && i <= it->second)
+        {
+          NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
+          return true;
+        }
     }
   NS_LOG_DEBUG ("Array " << i << " does not match " << m_element);
   return false;
 }
+bool
+ArrayMatcher::GetIndices (std::vector<std::size_t> *indices) const
+{
+  NS_LOG_FUNCTION (this << indices);
+  indices->clear ();
+  for (std::vector<std::pair<std::size_t, std::size_t> >::const_iterator it = m_ranges.begin ();
+       it != m_ranges.end (); ++it)
+    {
+      if (it->first != it->second)
+        {
+          return false;
+        }
+      indices->push_back (it->first);
+    }
+  std::sort (indices->begin (), indices->end ());
+  indices->erase (std::unique (indices->begin (), indices->end ()), indices->end ());
+  return true;
+}
 
 bool
 ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
@@ -294,9 +330,133 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
   return !iss.bad () && !iss.fail ();
 }
 
+/**
+ * \ingroup config-impl
+ * Index of the attributes of each TypeId that a Config path can go
+ * through, i.e., the attributes that hold a pointer to an Object or a
+ * container of Objects.
+ *
+ * The entry of a TypeId is added the first time that an object of that
+ * TypeId is found on a Config path, so that the Resolver does not look at
+ * all the attributes of all the objects that it walks through.
+ */
+class PathAttributeIndex : public Singleton<PathAttributeIndex>
+{
+public:
+  /** An attribute that a Config path can go through. */
+  struct PathAttribute
+  {
+    std::string name;                        //!< The attribute name.
+    bool isContainer;                        //!< \c true for a container of Objects, \c false for a pointer.
+    uint32_t flags;                          //!< The flags of the attribute returned by a lookup by name.
+    Ptr<const AttributeAccessor> accessor;   //!< The accessor of the attribute returned by a lookup by name.
+  };
+  /** The attributes of a TypeId that a Config path can go through. */
+  typedef std::vector<PathAttribute> PathAttributes;
+
+  /**
+   * Get the attributes of a TypeId and of its parents that a Config path
+   * can go through, in the order in which the Resolver looks them up.
+   *
+   * \param [in] tid The TypeId.
+   * \returns The attributes.
+   */
+  std::shared_ptr<const PathAttributes> Lookup (TypeId tid);
+
+private:
+  /** The attributes of a TypeId, and the number of attributes of the TypeId and its parents. */
+  typedef std::pair<std::size_t, std::shared_ptr<const PathAttributes> > Entry;
+  /**
+   * Count the attributes of a TypeId and of its parents.
+   *
+   * \param [in] tid The TypeId.
+   * \returns The number of attributes.
+   */
+  static std::size_t GetAttributeN (TypeId tid);
+
+  /** The attributes by TypeId uid. */
+  std::map<uint16_t, Entry> m_entries;
+
+};  // class PathAttributeIndex
+
+std::size_t
+PathAttributeIndex::GetAttributeN (TypeId tid)
+{
+  std::size_t n = 0;
+  TypeId nextTid = tid;
+  do
+    {
+      tid = nextTid;
+      n += tid.GetAttributeN ();
+      nextTid = tid.GetParent ();
+    }
+  while (nextTid != tid);
+  return n;
+}
+
+std::shared_ptr<const PathAttributeIndex::PathAttributes>
+PathAttributeIndex::Lookup (TypeId tid)
+{
+  NS_LOG_FUNCTION (this << tid);
+  std::size_t attributeN = GetAttributeN (tid);
+  std::map<uint16_t, Entry>::const_iterator it = m_entries.find (tid.GetUid ());
+  // rebuild the entry if attributes were added to the TypeId after it was indexed
+  if (it != m_entries.end () && it->second.first == attributeN)
+    {
+      return it->second.second;
+    }
+
+  NS_LOG_DEBUG ("Indexing the attributes of " << tid.GetName ());
+  std::shared_ptr<PathAttributes> attributes = std::make_shared<PathAttributes> ();
+  TypeId instanceTid = tid;
+  TypeId nextTid = tid;
+  do
+    {
+      tid = nextTid;
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+          PathAttribute attribute;
+          if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.isContainer = false;
+            }
+          else if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.isContainer = true;
+            }
+          else
+            {
+              // this could be anything else and we don't know what to do with it.
+              continue;
+            }
+          attribute.name = info.name;
+          // the value is read through ObjectBase::GetAttribute, which looks the
+          // name up from the instance TypeId
+          struct TypeId::AttributeInformation lookupInfo;
+          instanceTid.LookupAttributeByName (info.name, &lookupInfo);
+          attribute.flags = lookupInfo.flags;
+          attribute.accessor = lookupInfo.accessor;
+          attributes->push_back (attribute);
+        }
+      nextTid = tid.GetParent ();
+    }
+  while (nextTid != tid);
+
+  m_entries[instanceTid.GetUid ()] = Entry (attributeN, attributes);
+  return attributes;
+}
+
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
+ *
+ * The path is split into its segments once, in the constructor. The
+ * attributes of the objects on the path are looked up in the
+ * PathAttributeIndex, and the instances of a container are looked up by
+ * index when the path specifies explicit indices, so that the cost of
+ * resolving a path grows with the number of matches rather than with the
+ * size of the containers.
  */
 class Resolver
 {
@@ -325,18 +485,30 @@ private:
   /**
    * Parse the next element in the Config path.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] segment The index of the next element in the Config path.
    * \param [in] root The object corresponding to the current position
    *                  in the Config path.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolve (std::size_t segment, Ptr<Object> root);
   /**
    * Parse an index on the Config path.
    *
-   * \param [in] path The remaining Config path.
+   * \param [in] segment The index of the index element in the Config path.
    * \param [in,out] vector The resulting list of matching objects.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoArrayResolve (std::size_t segment, const ObjectPtrContainerValue &vector);
+  /**
+   * Parse the explicit indices of a container on the Config path, looking
+   * up only the matching instances of the container.
+   *
+   * \param [in] segment The index of the index element in the Config path.
+   * \param [in] root The object holding the container.
+   * \param [in] attribute The container attribute.
+   * \returns \c false if the indices are not explicit or the container
+   *          cannot be looked up by index.
+   */
+  bool DoIndexResolve (std::size_t segment, Ptr<Object> root,
+                       const PathAttributeIndex::PathAttribute &attribute);
   /**
    * Handle one object found on the path.
    *
@@ -361,6 +533,8 @@ private:
   std::vector<std::string> m_workStack;
   /** The Config path. */
   std::string m_path;
+  /** The elements of the Config path. */
+  std::vector<std::string> m_segments;
 
 };  // class Resolver
 
@@ -369,6 +543,14 @@ Resolver::Resolver (std::string path)
 {
   NS_LOG_FUNCTION (this << path);
   Canonicalize ();
+  // split "/a/b/" into "a" and "b"
+  std::string::size_type start = 1;
+  std::string::size_type next;
+  while ((next = m_path.find ("/", start)) != std::string::npos)
+    {
+      m_segments.push_back (m_path.substr (start, next - start));
+      start = next + 1;
+    }
 }
 Resolver::~Resolver ()
 {
@@ -399,7 +581,7 @@ Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
@@ -425,13 +607,11 @@ Resolver::DoResolveOne (Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (std::size_t segment, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << segment << root);
 
-  if (next == std::string::npos)
+  if (segment == m_segments.size ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name
@@ -447,8 +627,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next - 1);
-  std::string pathLeft = path.substr (next, path.size () - next);
+  const std::string &item = m_segments[segment];
 
   //
   // If root is zero, we're beginning to see if we can use the object name
@@ -459,11 +638,10 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
+      if (item.compare (0, 5, "Names") == 0)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (segment + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -480,7 +658,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (segment + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -510,68 +688,67 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (segment + 1, object);
       m_workStack.pop_back ();
     }
   else
     {
       // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
+      std::shared_ptr<const PathAttributeIndex::PathAttributes> attributes =
+        PathAttributeIndex::Get ()->Lookup (root->GetInstanceTypeId ());
       bool foundMatch = false;
 
-      do
+      for (PathAttributeIndex::PathAttributes::const_iterator it = attributes->begin ();
+           it != attributes->end (); ++it)
         {
-          tid = nextTid;
-
-          for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+          const PathAttributeIndex::PathAttribute &attribute = *it;
+          if (attribute.name != item && item != "*")
+            {
+              continue;
+            }
+          if (!attribute.isContainer)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute (i);
-              if (info.name != item && item != "*")
+              NS_LOG_DEBUG ("GetAttribute(ptr)=" << attribute.name << " on path=" << GetResolvedPath ());
+              PointerValue pValue;
+              if (!(attribute.flags & TypeId::ATTR_GET)
+                  || !attribute.accessor->HasGetter ()
+                  || !attribute.accessor->Get (PeekPointer (root), pValue))
+                {
+                  // let ObjectBase report the error
+                  root->GetAttribute (attribute.name, pValue);
+                }
+              Ptr<Object> object = pValue.Get<Object> ();
+              if (object == 0)
                 {
+                  NS_LOG_ERROR ("Requested object name=\"" << item <<
+                                "\" exists on path=\"" << GetResolvedPath () << "\""
+                                " but is null.");
                   continue;
                 }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *pChecker = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (pChecker != 0)
+              foundMatch = true;
+              m_workStack.push_back (attribute.name);
+              DoResolve (segment + 1, object);
+              m_workStack.pop_back ();
+            }
+          else
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)=" << attribute.name << " on path=" << GetResolvedPath ());
+              foundMatch = true;
+              if (segment + 1 == m_segments.size ())
                 {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)=" << info.name << " on path=" << GetResolvedPath ());
-                  PointerValue pValue;
-                  root->GetAttribute (info.name, pValue);
-                  Ptr<Object> object = pValue.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\"" << item <<
-                                    "\" exists on path=\"" << GetResolvedPath () << "\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
+                  // the path ends with the container, not with one of its instances
+                  continue;
                 }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker =
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
+              m_workStack.push_back (attribute.name);
+              if (!DoIndexResolve (segment + 1, root, attribute))
                 {
-                  NS_LOG_DEBUG ("GetAttribute(vector)=" << info.name << " on path=" << GetResolvedPath () << pathLeft);
-                  foundMatch = true;
                   ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
+                  root->GetAttribute (attribute.name, vector);
+                  DoArrayResolve (segment + 1, vector);
                 }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              m_workStack.pop_back ();
             }
-
-          nextTid = tid.GetParent ();
         }
-      while (nextTid != tid);
 
       if (!foundMatch)
         {
@@ -581,30 +758,61 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     }
 }
 
-void
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+bool
+Resolver::DoIndexResolve (std::size_t segment, Ptr<Object> root,
+                          const PathAttributeIndex::PathAttribute &attribute)
 {
-  NS_LOG_FUNCTION (this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION (this << segment << root << attribute.name);
+  std::vector<std::size_t> indices;
+  ArrayMatcher matcher = ArrayMatcher (m_segments[segment]);
+  if (!matcher.GetIndices (&indices))
     {
-      return;
+      return false;
     }
-  std::string item = path.substr (1, next - 1);
-  std::string pathLeft = path.substr (next, path.size () - next);
+  const ObjectPtrContainerAccessor *accessor =
+    dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (attribute.accessor));
+  if (accessor == 0 || !(attribute.flags & TypeId::ATTR_GET))
+    {
+      return false;
+    }
+  std::vector<Ptr<Object> > objects;
+  for (std::vector<std::size_t>::const_iterator it = indices.begin (); it != indices.end (); ++it)
+    {
+      Ptr<Object> object;
+      if (!accessor->GetByIndex (PeekPointer (root), *it, &object))
+        {
+          return false;
+        }
+      objects.push_back (object);
+    }
+  NS_LOG_DEBUG ("Looked up " << indices.size () << " indices of " << attribute.name << " on path=" << GetResolvedPath ());
+  for (std::size_t i = 0; i < indices.size (); i++)
+    {
+      if (objects[i] == 0)
+        {
+          continue;
+        }
+      m_workStack.push_back (std::to_string (indices[i]));
+      DoResolve (segment + 1, objects[i]);
+      m_workStack.pop_back ();
+    }
+  return true;
+}
+
+void
+Resolver::DoArrayResolve (std::size_t segment, const ObjectPtrContainerValue &container)
+{
+  NS_LOG_FUNCTION (this << segment << &container);
+  NS_ASSERT (segment < m_segments.size ());
 
-  ArrayMatcher matcher = ArrayMatcher (item);
+  ArrayMatcher matcher = ArrayMatcher (m_segments[segment]);
   ObjectPtrContainerValue::Iterator it;
   for (it = container.Begin (); it != container.End (); ++it)
     {
       if (matcher.Matches ((*it).first))
         {
-          std::ostringstream oss;
-          oss << (*it).first;
-          m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
+          m_workStack.push_back (std::to_string ((*it).first));
+          DoResolve (segment + 1, (*it).second);
           m_workStack.pop_back ();
         }
     }
@@ -110,6 +110,22 @@ MakeObjectMapAccessor (U T::*memberVector)
       // quiet compiler.
       return 0;
     }
+    virtual Ptr<Object> DoFind (const ObjectBase *object, std::size_t n, std::size_t index) const
+    {
+      const T *obj = static_cast<const T *> (object);
+      typename U::key_type key = static_cast<typename U::key_type> (index);
+      if (static_cast<std::size_t> (key) != index)
+        {
+          // the index does not fit the type of the keys
+          return 0;
+        }
+      typename U::const_iterator it = (obj->*m_memberVector).find (key);
+      if (it == (obj->*m_memberVector).end ())
+        {
+          return 0;
+        }
+      return (*it).second;
+    }
     U T::*m_memberVector;
   } *spec = new MemberStdContainer ();
   spec->m_memberVector = memberVector;
@@ -128,6 +128,34 @@ ObjectPtrContainerAccessor::Get (const ObjectBase * object, AttributeValue &valu
   return true;
 }
 bool
+ObjectPtrContainerAccessor::GetByIndex (const ObjectBase * object, std::size_t index, Ptr<Object> *instance) const
+{
+  NS_LOG_FUNCTION (this << object << index);
+  std::size_t n;
+  bool ok = DoGetN (object, &n);
+  if (!ok)
+    {
+      return false;
+    }
+  *instance = DoFind (object, n, index);
+  return true;
+}
+Ptr<Object>
+ObjectPtrContainerAccessor::DoFind (const ObjectBase * object, std::size_t n, std::size_t index) const
+{
+  NS_LOG_FUNCTION (this << object << n << index);
+  for (std::size_t i = 0; i < n; i++)
+    {
+      std::size_t k;
+      Ptr<Object> o = DoGet (object, i, &k);
+      if (k == index)
+        {
+          return o;
+        }
+    }
+  return 0;
+}
+bool
 ObjectPtrContainerAccessor::HasGetter (void) const
 {
   NS_LOG_FUNCTION (this);
@@ -229,6 +229,18 @@ public:
   virtual bool HasGetter (void) const;
   virtual bool HasSetter (void) const;
 
+  /**
+   * Get the instance of the container with the given index, without
+   * getting the other instances of the container.
+   *
+   * \param [in] object The container object.
+   * \param [in] index The index of the instance.
+   * \param [out] instance The instance, or null if the container has no
+   *              instance with this index.
+   * \returns true if the container could be read.
+   */
+  bool GetByIndex (const ObjectBase * object, std::size_t index, Ptr<Object> *instance) const;
+
 private:
   /**
    * Get the number of instances in the container.
@@ -247,6 +259,19 @@ private:
    * \returns The index requested.
    */
   virtual Ptr<Object> DoGet (const ObjectBase *object, std::size_t i, std::size_t *index) const = 0;
+  /**
+   * Find the instance of the container with the given index.
+   *
+   * The default implementation scans the container with DoGet();
+   * the accessors of indexed containers look the index up directly.
+   *
+   * \param [in] object The container object.
+   * \param [in] n The number of instances in the container.
+   * \param [in] index The index of the instance.
+   * \returns The instance, or null if the container has no instance
+   *          with this index.
+   */
+  virtual Ptr<Object> DoFind (const ObjectBase *object, std::size_t n, std::size_t index) const;
 };
 
 template <typename T, typename U, typename INDEX>
@@ -272,6 +297,15 @@ MakeObjectPtrContainerAccessor (Ptr<U> (T::*get)(INDEX) const,
       *index = i;
       return (obj->*m_get)(i);
     }
+    virtual Ptr<Object> DoFind (const ObjectBase *object, std::size_t n, std::size_t index) const
+    {
+      if (index >= n)
+        {
+          return 0;
+        }
+      const T *obj = static_cast<const T *> (object);
+      return (obj->*m_get)(index);
+    }
     Ptr<U> (T::*m_get)(INDEX) const;
     INDEX (T::*m_getN)(void) const;
   } *spec = new MemberGetters ();
@@ -24,6 +24,7 @@
 #include "ptr.h"
 #include "attribute.h"
 #include "object-ptr-container.h"
+#include <iterator>
 
 /**
  * \file
@@ -95,21 +96,19 @@ MakeObjectVectorAccessor (U T::*memberVector)
     virtual Ptr<Object> DoGet (const ObjectBase *object, std::size_t i, std::size_t *index) const
     {
       const T *obj = static_cast<const T *> (object);
-      typename U::const_iterator begin = (obj->*m_memberVector).begin ();
-      typename U::const_iterator end = (obj->*m_memberVector).end ();
-      std::size_t k = 0;
-      for (typename U::const_iterator j = begin; j != end; j++, k++)
+      NS_ASSERT (i < (obj->*m_memberVector).size ());
+      *index = i;
+      // constant time for the random access containers
+      return *std::next ((obj->*m_memberVector).begin (), i);
+    }
+    virtual Ptr<Object> DoFind (const ObjectBase *object, std::size_t n, std::size_t index) const
+    {
+      if (index >= n)
         {
-          if (k == i)
-            {
-              *index = k;
-              return *j;
-              break;
-            }
+          return 0;
         }
-      NS_ASSERT (false);
-      // quiet compiler.
-      return 0;
+      const T *obj = static_cast<const T *> (object);
+      return *std::next ((obj->*m_memberVector).begin (), index);
     }
     U T::*m_memberVector;
   } *spec = new MemberStdContainer ();
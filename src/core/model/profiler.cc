@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup profiler
+ * ns3::Profiler and ns3::ProfilerEntry implementations.
+ */
+
+#include "profiler.h"
+#include "system-mutex.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <vector>
+
+namespace ns3 {
+
+ProfilerEntry::ProfilerEntry (const std::string &name)
+  : m_name (name),
+    m_calls (0),
+    m_timeNs (0),
+    m_count (0)
+{
+}
+
+std::string
+ProfilerEntry::GetName (void) const
+{
+  return m_name;
+}
+
+uint64_t
+ProfilerEntry::GetCalls (void) const
+{
+  return m_calls.load (std::memory_order_relaxed);
+}
+
+uint64_t
+ProfilerEntry::GetTimeNs (void) const
+{
+  return m_timeNs.load (std::memory_order_relaxed);
+}
+
+uint64_t
+ProfilerEntry::GetCount (void) const
+{
+  return m_count.load (std::memory_order_relaxed);
+}
+
+void
+ProfilerEntry::Reset (void)
+{
+  m_calls.store (0, std::memory_order_relaxed);
+  m_timeNs.store (0, std::memory_order_relaxed);
+  m_count.store (0, std::memory_order_relaxed);
+}
+
+/**
+ * \ingroup profiler
+ * Get the list of the entries. A list is used since the addresses of its
+ * elements do not change when new entries are added.
+ * \return the list of the entries
+ */
+static std::list<ProfilerEntry> &
+GetEntries (void)
+{
+  static std::list<ProfilerEntry> entries;
+  return entries;
+}
+
+/**
+ * \ingroup profiler
+ * Get the mutex protecting the list of the entries.
+ * \return the mutex
+ */
+static SystemMutex &
+GetEntriesMutex (void)
+{
+  static SystemMutex mutex;
+  return mutex;
+}
+
+ProfilerEntry *
+Profiler::GetEntry (const std::string &name)
+{
+  CriticalSection cs (GetEntriesMutex ());
+  std::list<ProfilerEntry> &entries = GetEntries ();
+  for (ProfilerEntry &entry : entries)
+    {
+      if (entry.GetName () == name)
+        {
+          return &entry;
+        }
+    }
+  entries.emplace_back (name);
+  return &entries.back ();
+}
+
+void
+Profiler::Print (std::ostream &os)
+{
+  CriticalSection cs (GetEntriesMutex ());
+  std::vector<const ProfilerEntry *> used;
+  std::size_t nameWidth = 9;
+  for (const ProfilerEntry &entry : GetEntries ())
+    {
+      if (entry.GetCalls () > 0 || entry.GetCount () > 0)
+        {
+          used.push_back (&entry);
+          nameWidth = std::max (nameWidth, entry.GetName ().size ());
+        }
+    }
+  std::stable_sort (used.begin (), used.end (),
+                    [] (const ProfilerEntry *a, const ProfilerEntry *b)
+                    { return a->GetTimeNs () > b->GetTimeNs (); });
+
+  std::ios_base::fmtflags flags = os.flags ();
+  std::streamsize precision = os.precision ();
+  os << std::left << std::setw (nameWidth) << "component" << std::right
+     << std::setw (14) << "calls"
+     << std::setw (14) << "time [s]"
+     << std::setw (14) << "mean [us]"
+     << std::setw (14) << "count" << std::endl;
+  for (const ProfilerEntry *entry : used)
+    {
+      uint64_t calls = entry->GetCalls ();
+      double seconds = entry->GetTimeNs () * 1e-9;
+      os << std::left << std::setw (nameWidth) << entry->GetName () << std::right
+         << std::setw (14) << calls
+         << std::setw (14) << std::fixed << std::setprecision (6) << seconds
+         << std::setw (14) << std::setprecision (3) << (calls > 0 ? seconds * 1e6 / calls : 0.0)
+         << std::setw (14) << entry->GetCount () << std::endl;
+    }
+  os.flags (flags);
+  os.precision (precision);
+}
+
+void
+Profiler::Reset (void)
+{
+  CriticalSection cs (GetEntriesMutex ());
+  for (ProfilerEntry &entry : GetEntries ())
+    {
+      entry.Reset ();
+    }
+}
+
+void
+Profiler::Report (void)
+{
+  bool used = false;
+  {
+    CriticalSection cs (GetEntriesMutex ());
+    for (const ProfilerEntry &entry : GetEntries ())
+      {
+        used |= (entry.GetCalls () > 0 || entry.GetCount () > 0);
+      }
+  }
+  if (used)
+    {
+      std::clog << "Profiler summary, the time of the nested scopes is also "
+                << "included in the enclosing ones" << std::endl;
+      Print (std::clog);
+      Reset ();
+    }
+}
+
+bool
+Profiler::IsEnabled (void)
+{
+#ifdef ENABLE_PROFILER
+  return true;
+#else
+  return false;
+#endif
+}
+
+} // namespace ns3
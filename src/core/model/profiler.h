@@ -0,0 +1,255 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_PROFILER_H
+#define NS3_PROFILER_H
+
+/**
+ * \file
+ * \ingroup profiler
+ * ns3::Profiler, ns3::ProfilerEntry and ns3::ProfilerScope declarations,
+ * and the NS_PROFILE_SCOPE and NS_PROFILE_COUNT macros.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+
+/**
+ * \ingroup core
+ * \defgroup profiler Profiler
+ *
+ * \brief Wall-clock time and call counts of the components of a simulation.
+ *
+ * Code paths of interest are instrumented with NS_PROFILE_SCOPE, which
+ * measures the time spent in the enclosing scope, and NS_PROFILE_COUNT,
+ * which adds to a counter. Samples with the same name are aggregated in a
+ * single ProfilerEntry, and a summary of all the entries is printed to
+ * std::clog by Simulator::Destroy.
+ *
+ * The macros are compiled only when ns-3 is configured with
+ * \c --enable-profiler, which defines \c ENABLE_PROFILER. Otherwise they
+ * expand to empty statements and have no cost.
+ *
+ * The time of nested scopes is also included in the time of the enclosing
+ * scopes. The entries are updated atomically, so that scopes can be
+ * used also by code running in worker threads.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup profiler
+ *
+ * Aggregated time, calls and count of a profiled component
+ */
+class ProfilerEntry
+{
+public:
+  /**
+   * Constructor
+   * \param name the name of the component
+   */
+  ProfilerEntry (const std::string &name);
+
+  /**
+   * \return the name of the component
+   */
+  std::string GetName (void) const;
+
+  /**
+   * Add a call to the component
+   * \param ns the duration of the call in nanoseconds
+   */
+  void AddSample (uint64_t ns)
+  {
+    m_calls.fetch_add (1, std::memory_order_relaxed);
+    m_timeNs.fetch_add (ns, std::memory_order_relaxed);
+  }
+
+  /**
+   * Add to the counter of the component
+   * \param n the value to add
+   */
+  void AddCount (uint64_t n)
+  {
+    m_count.fetch_add (n, std::memory_order_relaxed);
+  }
+
+  /**
+   * \return the number of calls
+   */
+  uint64_t GetCalls (void) const;
+
+  /**
+   * \return the total duration of the calls in nanoseconds
+   */
+  uint64_t GetTimeNs (void) const;
+
+  /**
+   * \return the value of the counter
+   */
+  uint64_t GetCount (void) const;
+
+  /**
+   * Set the calls, the time and the counter to zero
+   */
+  void Reset (void);
+
+private:
+  std::string m_name; //!< the name of the component
+  std::atomic<uint64_t> m_calls; //!< the number of calls
+  std::atomic<uint64_t> m_timeNs; //!< the total duration of the calls
+  std::atomic<uint64_t> m_count; //!< the counter
+};
+
+/**
+ * \ingroup profiler
+ *
+ * Registry of the ProfilerEntry instances
+ */
+class Profiler
+{
+public:
+  /**
+   * Get the entry of a component, creating it if needed. The entries are
+   * never deleted, so the pointer can be cached by the caller.
+   * \param name the name of the component
+   * \return the entry
+   */
+  static ProfilerEntry * GetEntry (const std::string &name);
+
+  /**
+   * Print the time, the calls and the count of the entries that were used,
+   * sorted by decreasing time
+   * \param os the output stream
+   */
+  static void Print (std::ostream &os);
+
+  /**
+   * Reset all the entries
+   */
+  static void Reset (void);
+
+  /**
+   * Print the summary to std::clog, if any entry was used, and reset the
+   * entries. Called by Simulator::Destroy when the profiler is enabled.
+   */
+  static void Report (void);
+
+  /**
+   * \return true if ns-3 was configured with \c --enable-profiler
+   */
+  static bool IsEnabled (void);
+};
+
+/**
+ * \ingroup profiler
+ *
+ * Adds the time elapsed between its construction and its destruction to a
+ * ProfilerEntry
+ */
+class ProfilerScope
+{
+public:
+  /**
+   * Start the measurement
+   * \param entry the entry of the measured component
+   */
+  explicit ProfilerScope (ProfilerEntry *entry)
+    : m_entry (entry),
+      m_start (std::chrono::steady_clock::now ())
+  {
+  }
+
+  /**
+   * Stop the measurement and add it to the entry
+   */
+  ~ProfilerScope ()
+  {
+    auto elapsed = std::chrono::steady_clock::now () - m_start;
+    m_entry->AddSample (std::chrono::duration_cast<std::chrono::nanoseconds> (elapsed).count ());
+  }
+
+private:
+  ProfilerEntry *m_entry; //!< the entry of the measured component
+  std::chrono::steady_clock::time_point m_start; //!< the start of the measurement
+};
+
+} // namespace ns3
+
+/**
+ * \ingroup profiler
+ * Concatenate a prefix and the current line number.
+ * \param prefix the prefix
+ */
+#define NS_PROFILE_UNIQUE(prefix) NS_PROFILE_UNIQUE_INTERNAL (prefix, __LINE__)
+/**
+ * \ingroup profiler
+ * Implementation of NS_PROFILE_UNIQUE, which expands __LINE__ first.
+ * \param prefix the prefix
+ * \param line the line number
+ */
+#define NS_PROFILE_UNIQUE_INTERNAL(prefix, line) NS_PROFILE_UNIQUE_CONCAT (prefix, line)
+/**
+ * \ingroup profiler
+ * Token pasting for NS_PROFILE_UNIQUE.
+ * \param prefix the prefix
+ * \param line the line number
+ */
+#define NS_PROFILE_UNIQUE_CONCAT(prefix, line) prefix ## line
+
+#ifdef ENABLE_PROFILER
+
+/**
+ * \ingroup profiler
+ * Measure the time spent from this point until the end of the enclosing
+ * scope, and add it to the entry of the component.
+ * \param name the name of the component
+ */
+#define NS_PROFILE_SCOPE(name)                                            \
+  static ns3::ProfilerEntry * NS_PROFILE_UNIQUE (ns3ProfilerEntry) =     \
+    ns3::Profiler::GetEntry (name);                                       \
+  ns3::ProfilerScope NS_PROFILE_UNIQUE (ns3ProfilerScope) (NS_PROFILE_UNIQUE (ns3ProfilerEntry))
+
+/**
+ * \ingroup profiler
+ * Add a value to the counter of the component.
+ * \param name the name of the component
+ * \param n the value to add
+ */
+#define NS_PROFILE_COUNT(name, n)                                         \
+  do                                                                      \
+    {                                                                     \
+      static ns3::ProfilerEntry *ns3ProfilerEntry =                       \
+        ns3::Profiler::GetEntry (name);                                   \
+      ns3ProfilerEntry->AddCount (n);                                     \
+    }                                                                     \
+  while (false)
+
+#else /* ENABLE_PROFILER */
+
+#define NS_PROFILE_SCOPE(name) \
+  do { } while (false)
+
+#define NS_PROFILE_COUNT(name, n) \
+  do { } while (false)
+
+#endif /* ENABLE_PROFILER */
+
+#endif /* NS3_PROFILER_H */
@@ -73,8 +73,17 @@ RandomVariableStream::GetTypeId (void)
   return tid;
 }
 
+/**
+ * \ingroup randomvariable
+ * The generation counter, incremented by
+ * RandomVariableStream::ResetAllStreams().
+ */
+static uint32_t g_streamGeneration = 0;
+
 RandomVariableStream::RandomVariableStream ()
-  : m_rng (0)
+  : m_rng (0),
+    m_rngStream (0),
+    m_generation (g_streamGeneration)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -84,6 +93,13 @@ RandomVariableStream::~RandomVariableStream ()
   delete m_rng;
 }
 
+void
+RandomVariableStream::ResetAllStreams (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_streamGeneration++;
+}
+
 void
 RandomVariableStream::SetAntithetic (bool isAntithetic)
 {
@@ -112,6 +128,8 @@ RandomVariableStream::SetStream (int64_t stream)
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              nextStream,
                              RngSeedManager::GetRun ());
+      m_rngStream = nextStream;
+      m_generation = g_streamGeneration;
     }
   else
     {
@@ -122,6 +140,8 @@ RandomVariableStream::SetStream (int64_t stream)
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              target,
                              RngSeedManager::GetRun ());
+      m_rngStream = target;
+      m_generation = g_streamGeneration;
     }
   m_stream = stream;
 }
@@ -136,6 +156,15 @@ RngStream *
 RandomVariableStream::Peek (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_generation != g_streamGeneration)
+    {
+      // restart on the substream of the current run, see ResetAllStreams ()
+      delete m_rng;
+      m_rng = new RngStream (RngSeedManager::GetSeed (),
+                             m_rngStream,
+                             RngSeedManager::GetRun ());
+      m_generation = g_streamGeneration;
+    }
   return m_rng;
 }
 
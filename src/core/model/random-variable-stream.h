@@ -137,6 +137,20 @@ public:
    */
   bool IsAntithetic (void) const;
 
+  /**
+   * \brief Restart all the existing streams with the current seed and
+   * run number.
+   *
+   * The streams keep their stream number, and restart from the
+   * beginning of the substream of the current run number, as if they
+   * had been created with it.  This is used to start independent
+   * replications from a shared state, e.g. after a fork().
+   *
+   * The streams are not tracked: each of them restarts when it draws
+   * its next value.
+   */
+  static void ResetAllStreams (void);
+
   /**
    * \brief Get the next random value as a double drawn from the distribution.
    * \return A floating point random value.
@@ -178,8 +192,8 @@ private:
    */
   RandomVariableStream &operator = (const RandomVariableStream &o);
 
-  /** Pointer to the underlying RngStream. */
-  RngStream *m_rng;
+  /** Pointer to the underlying RngStream, restarted by Peek() after ResetAllStreams(). */
+  mutable RngStream *m_rng;
 
   /** Indicates if antithetic values should be generated by this RNG stream. */
   bool m_isAntithetic;
@@ -187,6 +201,12 @@ private:
   /** The stream number for the RngStream. */
   int64_t m_stream;
 
+  /** The index of the RngStream, automatically allocated or not. */
+  uint64_t m_rngStream;
+
+  /** The value of the generation counter of ResetAllStreams() when m_rng was created. */
+  mutable uint32_t m_generation;
+
 };  // class RandomVariableStream
 
 
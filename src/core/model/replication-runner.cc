@@ -0,0 +1,344 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "replication-runner.h"
+#include "simulator.h"
+#include "config.h"
+#include "global-value.h"
+#include "string.h"
+#include "uinteger.h"
+#include "boolean.h"
+#include "rng-seed-manager.h"
+#include "random-variable-stream.h"
+#include "system-path.h"
+#include "abort.h"
+#include "log.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::ReplicationRunner implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ReplicationRunner");
+
+NS_OBJECT_ENSURE_REGISTERED (ReplicationRunner);
+
+TypeId
+ReplicationRunner::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ReplicationRunner")
+    .SetParent<Object> ()
+    .SetGroupName ("Core")
+    .AddConstructor<ReplicationRunner> ()
+    .AddAttribute ("MaxWorkers",
+                   "The maximum number of workers running at a time; "
+                   "0 means the number of online processors.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&ReplicationRunner::m_maxWorkers),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("WarmUpTime",
+                   "The simulation time run once, before the workers are forked.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&ReplicationRunner::m_warmUpTime),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("StopTime",
+                   "The simulation time at which the replications stop.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&ReplicationRunner::m_stopTime),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("OutputDirectory",
+                   "The directory of the index of the replications, and of "
+                   "the directories of their result files.",
+                   StringValue ("replications"),
+                   MakeStringAccessor (&ReplicationRunner::m_outputDirectory),
+                   MakeStringChecker ())
+    .AddAttribute ("ChangeDirectory",
+                   "If true, each worker changes to the directory of its replication.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&ReplicationRunner::m_changeDirectory),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+ReplicationRunner::ReplicationRunner ()
+  : m_ran (false),
+    m_worker (false),
+    m_replication (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ReplicationRunner::~ReplicationRunner ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ReplicationRunner::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_workerCallback = MakeNullCallback<void> ();
+  Object::DoDispose ();
+}
+
+uint32_t
+ReplicationRunner::AddReplication (uint64_t run, const Settings &settings)
+{
+  NS_LOG_FUNCTION (this << run);
+  NS_ASSERT_MSG (!m_ran, "replications added after Run ()");
+  Replication replication;
+  replication.run = run;
+  replication.settings = settings;
+  replication.exitStatus = -1;
+  m_replications.push_back (replication);
+  return m_replications.size () - 1;
+}
+
+uint32_t
+ReplicationRunner::GetNReplications (void) const
+{
+  return m_replications.size ();
+}
+
+void
+ReplicationRunner::SetWorkerCallback (Callback<void> cb)
+{
+  NS_LOG_FUNCTION (this);
+  m_workerCallback = cb;
+}
+
+bool
+ReplicationRunner::IsWorker (void) const
+{
+  return m_worker;
+}
+
+uint32_t
+ReplicationRunner::GetReplication (void) const
+{
+  NS_ASSERT_MSG (m_worker, "not a worker");
+  return m_replication;
+}
+
+std::string
+ReplicationRunner::GetReplicationDirectory (uint32_t i) const
+{
+  NS_ASSERT (i < m_replications.size ());
+  std::ostringstream oss;
+  oss << "replication-" << i;
+  return SystemPath::Append (m_outputDirectory, oss.str ());
+}
+
+int
+ReplicationRunner::GetExitStatus (uint32_t i) const
+{
+  NS_ASSERT (i < m_replications.size ());
+  return m_replications[i].exitStatus;
+}
+
+uint32_t
+ReplicationRunner::GetNFailed (void) const
+{
+  uint32_t failed = 0;
+  for (std::vector<Replication>::const_iterator it = m_replications.begin (); it != m_replications.end (); ++it)
+    {
+      if (it->exitStatus != 0)
+        {
+          failed++;
+        }
+    }
+  return failed;
+}
+
+bool
+ReplicationRunner::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (m_ran, "ReplicationRunner::Run () called twice");
+  NS_ABORT_MSG_IF (m_stopTime <= m_warmUpTime,
+                   "the StopTime " << m_stopTime.As (Time::S) <<
+                   " is not after the WarmUpTime " << m_warmUpTime.As (Time::S));
+  m_ran = true;
+
+  if (m_warmUpTime > Simulator::Now ())
+    {
+      NS_LOG_INFO ("Warm-up until " << m_warmUpTime.As (Time::S));
+      Simulator::Stop (m_warmUpTime - Simulator::Now ());
+      Simulator::Run ();
+    }
+
+  uint32_t maxWorkers = m_maxWorkers;
+  if (maxWorkers == 0)
+    {
+      long processors = sysconf (_SC_NPROCESSORS_ONLN);
+      maxWorkers = processors > 0 ? processors : 1;
+    }
+  for (uint32_t i = 0; i < m_replications.size (); i++)
+    {
+      SystemPath::MakeDirectories (GetReplicationDirectory (i));
+    }
+
+  // the replications by process id of their worker
+  std::map<int, uint32_t> workers;
+  for (uint32_t i = 0; i < m_replications.size (); i++)
+    {
+      while (workers.size () >= maxWorkers)
+        {
+          WaitWorker (workers);
+        }
+      int pid = Fork (i);
+      if (pid == 0)
+        {
+          StartWorker (i);
+          Simulator::Stop (m_stopTime - Simulator::Now ());
+          Simulator::Run ();
+          return true;
+        }
+      NS_LOG_INFO ("Replication " << i << " (run " << m_replications[i].run << ") in process " << pid);
+      workers[pid] = i;
+    }
+  while (!workers.empty ())
+    {
+      WaitWorker (workers);
+    }
+
+  WriteIndex ();
+  return false;
+}
+
+int
+ReplicationRunner::Fork (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+  // the buffered output would be written by the workers too
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::clog.flush ();
+  std::fflush (0);
+
+  pid_t pid = fork ();
+  NS_ABORT_MSG_IF (pid < 0, "fork () failed: " << std::strerror (errno));
+  return pid;
+}
+
+void
+ReplicationRunner::StartWorker (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+  const Replication &replication = m_replications[i];
+  m_worker = true;
+  m_replication = i;
+
+  if (m_changeDirectory)
+    {
+      std::string directory = GetReplicationDirectory (i);
+      NS_ABORT_MSG_IF (chdir (directory.c_str ()) != 0,
+                       "cannot change to " << directory << ": " << std::strerror (errno));
+    }
+
+  RngSeedManager::SetRun (replication.run);
+  RandomVariableStream::ResetAllStreams ();
+
+  for (Settings::const_iterator it = replication.settings.begin (); it != replication.settings.end (); ++it)
+    {
+      NS_LOG_DEBUG ("Replication " << i << ": " << it->first << "=" << it->second);
+      if (it->first.find ('/') == 0)
+        {
+          Config::Set (it->first, StringValue (it->second));
+        }
+      else if (it->first.find ("::") != std::string::npos)
+        {
+          Config::SetDefault (it->first, StringValue (it->second));
+        }
+      else
+        {
+          GlobalValue::Bind (it->first, StringValue (it->second));
+        }
+    }
+
+  if (!m_workerCallback.IsNull ())
+    {
+      m_workerCallback ();
+    }
+}
+
+void
+ReplicationRunner::WaitWorker (std::map<int, uint32_t> &workers)
+{
+  NS_LOG_FUNCTION (this);
+  int status;
+  pid_t pid = waitpid (-1, &status, 0);
+  if (pid < 0 && errno == EINTR)
+    {
+      return;
+    }
+  NS_ABORT_MSG_IF (pid < 0, "waitpid () failed: " << std::strerror (errno));
+  std::map<int, uint32_t>::iterator it = workers.find (pid);
+  if (it == workers.end ())
+    {
+      // a child process that the scenario forked itself
+      return;
+    }
+  Replication &replication = m_replications[it->second];
+  if (WIFEXITED (status))
+    {
+      replication.exitStatus = WEXITSTATUS (status);
+    }
+  else if (WIFSIGNALED (status))
+    {
+      replication.exitStatus = 128 + WTERMSIG (status);
+    }
+  NS_LOG_INFO ("Replication " << it->second << " (run " << replication.run << ") exited with status " << replication.exitStatus);
+  workers.erase (it);
+}
+
+void
+ReplicationRunner::WriteIndex (void) const
+{
+  NS_LOG_FUNCTION (this);
+  std::string fileName = SystemPath::Append (m_outputDirectory, "replications.txt");
+  std::ofstream index (fileName.c_str ());
+  NS_ABORT_MSG_IF (!index.is_open (), "cannot open " << fileName);
+  index << "replication\trun\tstatus\tdirectory\tsettings\n";
+  for (uint32_t i = 0; i < m_replications.size (); i++)
+    {
+      const Replication &replication = m_replications[i];
+      index << i << "\t" << replication.run << "\t" << replication.exitStatus
+            << "\t" << GetReplicationDirectory (i) << "\t";
+      for (Settings::const_iterator it = replication.settings.begin (); it != replication.settings.end (); ++it)
+        {
+          index << (it == replication.settings.begin () ? "" : " ") << it->first << "=" << it->second;
+        }
+      index << "\n";
+    }
+}
+
+} // namespace ns3
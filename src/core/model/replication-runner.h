@@ -0,0 +1,217 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef REPLICATION_RUNNER_H
+#define REPLICATION_RUNNER_H
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::ReplicationRunner declaration.
+ */
+
+#include "object.h"
+#include "nstime.h"
+#include "callback.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ *
+ * Run the replications of a campaign in worker processes forked from a
+ * scenario that is built once.
+ *
+ * The scenario builds its topology as usual, then adds the replications
+ * and calls Run() instead of Simulator::Run().  Run() runs the simulation
+ * until the WarmUpTime, which is shared by all the replications, then
+ * forks a worker for each replication, with at most MaxWorkers workers
+ * at a time.  The workers share the memory of the scenario, copy on
+ * write, so that each replication pays only for the pages it changes.
+ *
+ * Each worker
+ * - changes to the directory of its replication, so that the files that
+ *   the scenario opens with relative names are written there,
+ * - sets the run number of its replication and restarts all the
+ *   existing random variable streams with it (see
+ *   RandomVariableStream::ResetAllStreams()),
+ * - applies the settings of its replication,
+ * - calls the worker callback, where the scenario connects its traces,
+ * - runs the simulation until the StopTime.
+ *
+ * The settings are name-value pairs, applied with Config::Set() if the
+ * name is a Config path, i.e., it starts with '/', with
+ * Config::SetDefault() if the name is an attribute name, e.g.
+ * "ns3::UdpClient::Interval", and with GlobalValue::Bind() otherwise.
+ * Defaults and global values affect only the objects created, or the
+ * values read, in the worker.
+ *
+ * Run() returns \c true in the workers, after the simulation, so that
+ * the scenario writes its results and returns from \c main as it does in
+ * a single run.  It returns \c false in the scenario process, after all
+ * the workers exited, and after writing the index of the replications,
+ * with their exit status, in the OutputDirectory:
+ *
+ * \code
+ *   Ptr<ReplicationRunner> runner = CreateObject<ReplicationRunner> ();
+ *   runner->SetAttribute ("WarmUpTime", TimeValue (Seconds (transientDuration)));
+ *   runner->SetAttribute ("StopTime", TimeValue (Seconds (simTime)));
+ *   for (uint64_t run = 1; run <= 10; run++)
+ *     {
+ *       runner->AddReplication (run);
+ *     }
+ *   runner->SetWorkerCallback (MakeCallback (&MmWaveHelper::EnableTraces, mmwaveHelper));
+ *   bool worker = runner->Run ();
+ *   Simulator::Destroy ();
+ * \endcode
+ *
+ * Files and sockets opened before Run() are shared by all the workers,
+ * so the traces that write to files must be connected in the worker
+ * callback.
+ *
+ * fork() copies only the calling thread, so the process must have a
+ * single thread when it forks: the real time and distributed simulators
+ * are not supported, and the models that keep threads across events must
+ * stop them before a fork, e.g. with pthread_atfork().  The
+ * ChannelUpdateThreadPool of ThreeGppChannelModel, used if ParallelUpdate
+ * is true, does so and starts its threads again in each worker at the next
+ * channel update.  The random variables are restarted lazily, when they
+ * draw their next value.
+ */
+class ReplicationRunner : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /** The settings of a replication, as name-value pairs. */
+  typedef std::vector<std::pair<std::string, std::string> > Settings;
+
+  ReplicationRunner ();
+  virtual ~ReplicationRunner ();
+
+  /**
+   * Add a replication.
+   *
+   * \param [in] run The run number of the replication.
+   * \param [in] settings The settings of the replication.
+   * \returns The index of the replication.
+   */
+  uint32_t AddReplication (uint64_t run, const Settings &settings = Settings ());
+  /**
+   * \returns The number of replications.
+   */
+  uint32_t GetNReplications (void) const;
+
+  /**
+   * Set the callback called in each worker, after the settings of its
+   * replication are applied and before the simulation resumes.
+   *
+   * \param [in] cb The callback.
+   */
+  void SetWorkerCallback (Callback<void> cb);
+
+  /**
+   * Run the shared warm-up, then the replications in worker processes.
+   *
+   * \returns \c true in a worker, after its replication ran until the
+   *          StopTime, and \c false in the calling process, after all
+   *          the workers exited.
+   */
+  bool Run (void);
+
+  /**
+   * \returns \c true in a worker.
+   */
+  bool IsWorker (void) const;
+  /**
+   * \returns The index of the replication of a worker.
+   */
+  uint32_t GetReplication (void) const;
+  /**
+   * \param [in] i The index of a replication.
+   * \returns The directory of the result files of the replication.
+   */
+  std::string GetReplicationDirectory (uint32_t i) const;
+  /**
+   * \param [in] i The index of a replication.
+   * \returns The exit status of the worker of the replication, or 128
+   *          plus the number of the signal that terminated it.
+   */
+  int GetExitStatus (uint32_t i) const;
+  /**
+   * \returns The number of replications whose worker did not exit with
+   *          status 0.
+   */
+  uint32_t GetNFailed (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /** A replication of the campaign. */
+  struct Replication
+  {
+    uint64_t run;        //!< The run number.
+    Settings settings;   //!< The settings.
+    int exitStatus;      //!< The exit status of the worker.
+  };
+
+  /**
+   * Fork the worker of a replication.
+   *
+   * \param [in] i The index of the replication.
+   * \returns The process id of the worker, or 0 in the worker.
+   */
+  int Fork (uint32_t i);
+  /**
+   * Prepare the worker of a replication, in the worker.
+   *
+   * \param [in] i The index of the replication.
+   */
+  void StartWorker (uint32_t i);
+  /**
+   * Wait for a worker to exit, and record its exit status.
+   *
+   * \param [in,out] workers The replications of the running workers, by process id.
+   */
+  void WaitWorker (std::map<int, uint32_t> &workers);
+  /** Write the index of the replications in the OutputDirectory. */
+  void WriteIndex (void) const;
+
+  std::vector<Replication> m_replications;   //!< The replications.
+  Callback<void> m_workerCallback;           //!< The callback called in each worker.
+  uint32_t m_maxWorkers;                     //!< The maximum number of workers at a time.
+  Time m_warmUpTime;                         //!< The end of the shared warm-up.
+  Time m_stopTime;                           //!< The end of the replications.
+  std::string m_outputDirectory;             //!< The directory of the results.
+  bool m_changeDirectory;                    //!< Whether the workers change to the directory of their replication.
+  bool m_ran;                                //!< Whether Run() was called.
+  bool m_worker;                             //!< Whether this is a worker.
+  uint32_t m_replication;                    //!< The replication of the worker.
+};
+
+} // namespace ns3
+
+#endif /* REPLICATION_RUNNER_H */
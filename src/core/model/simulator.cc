@@ -24,6 +24,7 @@
 #include "map-scheduler.h"
 #include "event-impl.h"
 #include "des-metrics.h"
+#include "profiler.h"
 
 #include "ptr.h"
 #include "string.h"
@@ -137,6 +138,10 @@ Simulator::Destroy (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
+#ifdef ENABLE_PROFILER
+  Profiler::Report ();
+#endif
+
   SimulatorImpl **pimpl = PeekImpl ();
   if (*pimpl == 0)
     {
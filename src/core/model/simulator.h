@@ -119,6 +119,9 @@ public:
    * After this method has been invoked, it is actually possible
    * to restart a new simulation with a set of calls to Simulator::Run,
    * Simulator::Schedule and Simulator::ScheduleWithContext.
+   *
+   * If ns-3 was configured with \c --enable-profiler, this method
+   * also prints the summary of the Profiler.
    */
   static void Destroy (void);
 
@@ -27,6 +27,7 @@
 #include "ns3/singleton.h"
 #include "ns3/object.h"
 #include "ns3/object-vector.h"
+#include "ns3/object-map.h"
 #include "ns3/names.h"
 #include "ns3/pointer.h"
 #include "ns3/log.h"
@@ -615,6 +616,131 @@ ObjectVectorConfigTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (iv.Get (), -16, "Object Attribute \"A\" not set as expected");
 }
 
+/**
+ * \ingroup config-tests
+ * An object with a map of objects, indexed by a narrow key.
+ */
+class ConfigMapTestObject : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * Add an object to the map
+   * \param key the key of the object
+   * \param object the object
+   */
+  void AddNode (uint16_t key, Ptr<ConfigTestObject> object);
+
+private:
+  std::map<uint16_t, Ptr<ConfigTestObject> > m_nodes; //!< NodeMap attribute target.
+};
+
+TypeId
+ConfigMapTestObject::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ConfigMapTestObject")
+    .SetParent<Object> ()
+    .AddAttribute ("NodeMap", "",
+                   ObjectMapValue (),
+                   MakeObjectMapAccessor (&ConfigMapTestObject::m_nodes),
+                   MakeObjectMapChecker<ConfigTestObject> ())
+  ;
+  return tid;
+}
+
+void
+ConfigMapTestObject::AddNode (uint16_t key, Ptr<ConfigTestObject> object)
+{
+  m_nodes[key] = object;
+}
+
+/**
+ * \ingroup config-tests
+ * Test that the paths with explicit indices match the same objects
+ * when the resolver looks the indices up in the containers.
+ */
+class IndexedContainerConfigTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  IndexedContainerConfigTestCase ();
+  /** Destructor. */
+  virtual ~IndexedContainerConfigTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+};
+
+IndexedContainerConfigTestCase::IndexedContainerConfigTestCase ()
+  : TestCase ("Check that explicit indices of vectors and maps of Object are looked up")
+{}
+
+void
+IndexedContainerConfigTestCase::DoRun (void)
+{
+  IntegerValue iv;
+
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  std::vector<Ptr<ConfigTestObject> > nodes;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      nodes.push_back (CreateObject<ConfigTestObject> ());
+      root->AddNodeA (nodes.back ());
+    }
+
+  //
+  // Explicit indices, in any order and repeated, match each object once.
+  //
+  Config::MatchContainer matches = Config::LookupMatches ("/NodesA/3|1|3");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 2, "Wrong number of matches");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (0), nodes[1], "Wrong first match");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (0), "/NodesA/1/", "Wrong first matched path");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (1), nodes[3], "Wrong second match");
+
+  //
+  // Indices out of the vector match nothing.
+  //
+  matches = Config::LookupMatches ("/NodesA/4");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 0, "Index out of the vector matched");
+  Config::Set ("/NodesA/2|7/A", IntegerValue (-3));
+  nodes[2]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), -3, "Object Attribute \"A\" not set as expected");
+  nodes[3]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 10, "Object Attribute \"A\" unexpectedly set");
+
+  //
+  // The indices of a map are its keys; 70000 does not fit the keys of the
+  // map, and must not match the key 70000 % 65536 = 4464.
+  //
+  Ptr<ConfigMapTestObject> map = CreateObject<ConfigMapTestObject> ();
+  nodes[0]->AggregateObject (map);
+  Ptr<ConfigTestObject> obj5 = CreateObject<ConfigTestObject> ();
+  Ptr<ConfigTestObject> obj4464 = CreateObject<ConfigTestObject> ();
+  map->AddNode (5, obj5);
+  map->AddNode (4464, obj4464);
+
+  matches = Config::LookupMatches ("/NodesA/0/$ConfigMapTestObject/NodeMap/5");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 1, "Wrong number of matches");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (0), obj5, "Wrong match");
+  matches = Config::LookupMatches ("/NodesA/0/$ConfigMapTestObject/NodeMap/0|1");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 0, "Missing key matched");
+  matches = Config::LookupMatches ("/NodesA/0/$ConfigMapTestObject/NodeMap/70000");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 0, "Key out of the range of the keys matched");
+  matches = Config::LookupMatches ("/NodesA/0/$ConfigMapTestObject/NodeMap/[5-5000]");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 2, "Wrong number of matches of a range");
+  matches = Config::LookupMatches ("/NodesA/*/$ConfigMapTestObject/NodeMap/*");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 2, "Wrong number of matches of a wildcard");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (1), "/NodesA/0/$ConfigMapTestObject/NodeMap/4464/",
+                         "Wrong matched path");
+}
+
 /**
  * \ingroup config-tests
  * Test for the ability to trace configure with vectors of objects.
@@ -857,6 +983,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new RootNamespaceConfigTestCase);
   AddTestCase (new UnderRootNamespaceConfigTestCase);
   AddTestCase (new ObjectVectorConfigTestCase);
+  AddTestCase (new IndexedContainerConfigTestCase);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase);
 }
 
@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/profiler.h"
+#include "ns3/test.h"
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup profiler
+ * \ingroup profiler-tests
+ * Profiler test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup profiler-tests Profiler test suite
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup profiler-tests
+ * Check the aggregation of the samples and of the counters
+ */
+class ProfilerEntryTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  ProfilerEntryTestCase ();
+  virtual void DoRun (void);
+};
+
+ProfilerEntryTestCase::ProfilerEntryTestCase ()
+  : TestCase ("Check that samples and counters are aggregated per component")
+{}
+
+void
+ProfilerEntryTestCase::DoRun (void)
+{
+  ProfilerEntry *entry = Profiler::GetEntry ("ProfilerTest::Entry");
+  entry->Reset ();
+  NS_TEST_ASSERT_MSG_EQ (Profiler::GetEntry ("ProfilerTest::Entry"), entry,
+                         "The same name should return the same entry");
+  NS_TEST_ASSERT_MSG_NE (Profiler::GetEntry ("ProfilerTest::Other"), entry,
+                         "Different names should return different entries");
+
+  entry->AddSample (1000);
+  entry->AddSample (500);
+  entry->AddCount (7);
+  NS_TEST_ASSERT_MSG_EQ (entry->GetCalls (), 2, "Wrong number of calls");
+  NS_TEST_ASSERT_MSG_EQ (entry->GetTimeNs (), 1500, "Wrong total time");
+  NS_TEST_ASSERT_MSG_EQ (entry->GetCount (), 7, "Wrong count");
+
+  {
+    ProfilerScope scope (entry);
+    std::this_thread::sleep_for (std::chrono::milliseconds (2));
+  }
+  NS_TEST_ASSERT_MSG_EQ (entry->GetCalls (), 3, "The scope should add a call");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (entry->GetTimeNs (), 1500 + 2000000, "The scope should add its duration");
+
+  std::ostringstream oss;
+  Profiler::Print (oss);
+  NS_TEST_ASSERT_MSG_NE (oss.str ().find ("ProfilerTest::Entry"), std::string::npos,
+                         "The used entry should be printed");
+  NS_TEST_ASSERT_MSG_EQ (oss.str ().find ("ProfilerTest::Other"), std::string::npos,
+                         "The unused entry should not be printed");
+
+  entry->Reset ();
+  NS_TEST_ASSERT_MSG_EQ (entry->GetCalls () + entry->GetTimeNs () + entry->GetCount (), 0,
+                         "The entry should be reset");
+}
+
+
+/**
+ * \ingroup profiler-tests
+ * Check that the macros update the entries only if the profiler is enabled
+ */
+class ProfilerMacrosTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  ProfilerMacrosTestCase ();
+  virtual void DoRun (void);
+};
+
+ProfilerMacrosTestCase::ProfilerMacrosTestCase ()
+  : TestCase ("Check the NS_PROFILE_SCOPE and NS_PROFILE_COUNT macros")
+{}
+
+void
+ProfilerMacrosTestCase::DoRun (void)
+{
+  ProfilerEntry *scopeEntry = Profiler::GetEntry ("ProfilerTest::Scope");
+  ProfilerEntry *countEntry = Profiler::GetEntry ("ProfilerTest::Count");
+  scopeEntry->Reset ();
+  countEntry->Reset ();
+
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      NS_PROFILE_SCOPE ("ProfilerTest::Scope");
+      NS_PROFILE_COUNT ("ProfilerTest::Count", 3);
+    }
+
+  uint64_t expectedCalls = Profiler::IsEnabled () ? 10 : 0;
+  uint64_t expectedCount = Profiler::IsEnabled () ? 30 : 0;
+  NS_TEST_ASSERT_MSG_EQ (scopeEntry->GetCalls (), expectedCalls, "Wrong number of calls");
+  NS_TEST_ASSERT_MSG_EQ (countEntry->GetCount (), expectedCount, "Wrong count");
+  scopeEntry->Reset ();
+  countEntry->Reset ();
+}
+
+
+/**
+ * \ingroup profiler-tests
+ *  Profiler test suite
+ */
+class ProfilerTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  ProfilerTestSuite ()
+    : TestSuite ("profiler")
+  {
+    AddTestCase (new ProfilerEntryTestCase ());
+    AddTestCase (new ProfilerMacrosTestCase ());
+  }
+};
+
+/**
+ * \ingroup profiler-tests
+ * ProfilerTestSuite instance variable.
+ */
+static ProfilerTestSuite g_profilerTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
@@ -0,0 +1,191 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/replication-runner.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/system-path.h"
+
+#include <cstdlib>
+#include <fstream>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * ReplicationRunner test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+/**
+ * \ingroup core-tests
+ * Global value overridden by the replications.
+ */
+static GlobalValue g_replicationRunnerTestValue ("ReplicationRunnerTestValue",
+                                                 "Global value of the ReplicationRunner test",
+                                                 UintegerValue (7),
+                                                 MakeUintegerChecker<uint32_t> ());
+
+/**
+ * \ingroup core-tests
+ * Runs three replications, two of them with the same run number, after a
+ * shared warm-up, and checks the result files that the workers write in
+ * the directories of their replications.
+ */
+class ReplicationRunnerTestCase : public TestCase
+{
+public:
+  ReplicationRunnerTestCase ();
+  virtual ~ReplicationRunnerTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+  /** Draw a value during the shared warm-up. */
+  void WarmUp (void);
+  /** Called in the workers, before the simulation resumes. */
+  void StartWorker (void);
+  /** Write the values of the worker in its result file. */
+  void WriteResult (void);
+
+  Ptr<UniformRandomVariable> m_random;   //!< Random variable created before the fork.
+  double m_warmUpValue;                  //!< The value drawn during the warm-up.
+  bool m_workerCalled;                   //!< Whether the worker callback was called.
+};
+
+ReplicationRunnerTestCase::ReplicationRunnerTestCase ()
+  : TestCase ("Check the replications forked after a shared warm-up"),
+    m_warmUpValue (0),
+    m_workerCalled (false)
+{}
+
+void
+ReplicationRunnerTestCase::WarmUp (void)
+{
+  m_warmUpValue = m_random->GetValue ();
+}
+
+void
+ReplicationRunnerTestCase::StartWorker (void)
+{
+  m_workerCalled = true;
+}
+
+void
+ReplicationRunnerTestCase::WriteResult (void)
+{
+  UintegerValue value;
+  GlobalValue::GetValueByName ("ReplicationRunnerTestValue", value);
+  std::ofstream result ("result.txt");
+  result.precision (17);
+  result << RngSeedManager::GetRun () << " " << value.Get () << " "
+         << m_random->GetValue () << " " << m_warmUpValue << " "
+         << m_workerCalled << " " << Simulator::Now ().GetSeconds () << std::endl;
+}
+
+void
+ReplicationRunnerTestCase::DoRun (void)
+{
+  uint64_t run = RngSeedManager::GetRun ();
+  m_random = CreateObject<UniformRandomVariable> ();
+  Simulator::Schedule (Seconds (0.5), &ReplicationRunnerTestCase::WarmUp, this);
+  Simulator::Schedule (Seconds (1.5), &ReplicationRunnerTestCase::WriteResult, this);
+
+  std::string directory = CreateTempDirFilename ("replications");
+  Ptr<ReplicationRunner> runner = CreateObject<ReplicationRunner> ();
+  runner->SetAttribute ("MaxWorkers", UintegerValue (2));
+  runner->SetAttribute ("WarmUpTime", TimeValue (Seconds (1)));
+  runner->SetAttribute ("StopTime", TimeValue (Seconds (2)));
+  runner->SetAttribute ("OutputDirectory", StringValue (directory));
+  ReplicationRunner::Settings settings;
+  settings.push_back (std::make_pair ("ReplicationRunnerTestValue", "11"));
+  runner->AddReplication (3, settings);
+  settings[0].second = "12";
+  runner->AddReplication (4, settings);
+  runner->AddReplication (3);
+  runner->SetWorkerCallback (MakeCallback (&ReplicationRunnerTestCase::StartWorker, this));
+
+  if (runner->Run ())
+    {
+      // the worker must not return to the test framework
+      Simulator::Destroy ();
+      std::_Exit (0);
+    }
+  Simulator::Destroy ();
+  RngSeedManager::SetRun (run);
+
+  NS_TEST_ASSERT_MSG_EQ (runner->GetNFailed (), 0, "failed replications");
+  NS_TEST_ASSERT_MSG_EQ (m_workerCalled, false, "worker callback called in the calling process");
+  std::vector<double> values;
+  for (uint32_t i = 0; i < runner->GetNReplications (); i++)
+    {
+      std::ifstream result (SystemPath::Append (runner->GetReplicationDirectory (i), "result.txt").c_str ());
+      NS_TEST_ASSERT_MSG_EQ (result.is_open (), true, "no result file for replication " << i);
+      uint64_t resultRun;
+      uint32_t value;
+      double random;
+      double warmUpValue;
+      bool workerCalled;
+      double now;
+      result >> resultRun >> value >> random >> warmUpValue >> workerCalled >> now;
+      NS_TEST_ASSERT_MSG_EQ (resultRun, (i == 1 ? 4 : 3), "wrong run number in replication " << i);
+      NS_TEST_ASSERT_MSG_EQ (value, (i == 0 ? 11 : i == 1 ? 12 : 7), "wrong global value in replication " << i);
+      NS_TEST_ASSERT_MSG_EQ (warmUpValue, m_warmUpValue, "warm-up not shared by replication " << i);
+      NS_TEST_ASSERT_MSG_EQ (workerCalled, true, "worker callback not called in replication " << i);
+      NS_TEST_ASSERT_MSG_EQ_TOL (now, 1.5, 1e-9, "wrong time in replication " << i);
+      values.push_back (random);
+    }
+  NS_TEST_ASSERT_MSG_EQ (values[0], values[2], "replications with the same run differ");
+  NS_TEST_ASSERT_MSG_NE (values[0], values[1], "replications with different runs are equal");
+
+  std::ifstream index (SystemPath::Append (directory, "replications.txt").c_str ());
+  uint32_t lines = 0;
+  std::string line;
+  while (std::getline (index, line))
+    {
+      lines++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (lines, 4, "wrong number of lines in the index of the replications");
+}
+
+/**
+ * \ingroup core-tests
+ * ReplicationRunner test suite.
+ */
+class ReplicationRunnerTestSuite : public TestSuite
+{
+public:
+  ReplicationRunnerTestSuite ();
+};
+
+ReplicationRunnerTestSuite::ReplicationRunnerTestSuite ()
+  : TestSuite ("replication-runner")
+{
+  AddTestCase (new ReplicationRunnerTestCase);
+}
+
+static ReplicationRunnerTestSuite g_replicationRunnerTestSuite; //!< Static variable for test initialization
+
+}    // namespace tests
+
+}  // namespace ns3
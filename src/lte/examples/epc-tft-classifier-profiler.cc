@@ -0,0 +1,168 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Measures the classification rate of EpcTftClassifier::Classify for downlink
+ * IPv4/UDP packets, as the number of dedicated bearers of a UE grows. Each
+ * dedicated bearer has a TFT with a single local port ("single" filters,
+ * which are indexed by port) or with a range of local ports ("range"
+ * filters, which are matched linearly). The rate of a linear search over the
+ * TFTs on a copy of the packet, i.e., the previous implementation of
+ * Classify, is reported as a reference.
+ *
+ * Example: ./waf --run "epc-tft-classifier-profiler --packets=1000000"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/packet.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/udp-header.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/epc-tft.h"
+#include "ns3/epc-tft-classifier.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * Linear search over the TFTs, on a copy of the packet
+ *
+ * \param tfts the TFTs, by identifier
+ * \param p the packet
+ * \return the identifier of the matching TFT, 0 if no TFT matches
+ */
+static uint32_t
+LinearClassify (const std::map<uint32_t, Ptr<EpcTft> > &tfts, Ptr<Packet> p)
+{
+  Ptr<Packet> pCopy = p->Copy ();
+  Ipv4Header ipv4Header;
+  pCopy->RemoveHeader (ipv4Header);
+  UdpHeader udpHeader;
+  pCopy->RemoveHeader (udpHeader);
+  for (auto it = tfts.rbegin (); it != tfts.rend (); ++it)
+    {
+      if (it->second->Matches (EpcTft::DOWNLINK, ipv4Header.GetSource (), ipv4Header.GetDestination (),
+                               udpHeader.GetSourcePort (), udpHeader.GetDestinationPort (), ipv4Header.GetTos ()))
+        {
+          return it->first;
+        }
+    }
+  return 0;
+}
+
+/**
+ * Profile the classification of packets for a UE with numBearers dedicated
+ * bearers
+ *
+ * \param numBearers the number of dedicated bearers
+ * \param range if true, the TFTs have a range of ports, otherwise a single one
+ * \param packets the number of packets to classify
+ * \return the sum of the TFT identifiers, to avoid that the calls are optimized away
+ */
+static uint64_t
+Profile (uint32_t numBearers, bool range, uint32_t packets)
+{
+  Ptr<EpcTftClassifier> classifier = Create<EpcTftClassifier> ();
+  std::map<uint32_t, Ptr<EpcTft> > tfts;
+  tfts[1] = EpcTft::Default ();
+  for (uint32_t b = 0; b < numBearers; ++b)
+    {
+      Ptr<EpcTft> tft = Create<EpcTft> ();
+      EpcTft::PacketFilter pf;
+      pf.localPortStart = 1000 + 100 * b;
+      pf.localPortEnd = range ? pf.localPortStart + 9 : pf.localPortStart;
+      tft->Add (pf);
+      tfts[b + 2] = tft;
+    }
+  for (const auto &tft : tfts)
+    {
+      classifier->Add (tft.second, tft.first);
+    }
+
+  // one packet for each dedicated bearer, plus one for the default bearer
+  std::vector<Ptr<Packet> > input;
+  for (uint32_t b = 0; b <= numBearers; ++b)
+    {
+      Ptr<Packet> p = Create<Packet> (1000);
+      UdpHeader udpHeader;
+      udpHeader.SetSourcePort (80);
+      udpHeader.SetDestinationPort (b < numBearers ? 1000 + 100 * b : 9);
+      p->AddHeader (udpHeader);
+      Ipv4Header ipv4Header;
+      ipv4Header.SetSource (Ipv4Address ("1.0.0.2"));
+      ipv4Header.SetDestination (Ipv4Address ("7.0.0.2"));
+      ipv4Header.SetProtocol (17);
+      ipv4Header.SetPayloadSize (p->GetSize ());
+      p->AddHeader (ipv4Header);
+      input.push_back (p);
+    }
+
+  uint64_t sum = 0;
+  auto start = std::chrono::steady_clock::now ();
+  for (uint32_t i = 0; i < packets; ++i)
+    {
+      sum += classifier->Classify (input[i % input.size ()], EpcTft::DOWNLINK, Ipv4L3Protocol::PROT_NUMBER);
+    }
+  auto stop = std::chrono::steady_clock::now ();
+  double seconds = std::chrono::duration<double> (stop - start).count ();
+
+  uint64_t linearSum = 0;
+  start = std::chrono::steady_clock::now ();
+  for (uint32_t i = 0; i < packets; ++i)
+    {
+      linearSum += LinearClassify (tfts, input[i % input.size ()]);
+    }
+  stop = std::chrono::steady_clock::now ();
+  double linearSeconds = std::chrono::duration<double> (stop - start).count ();
+  NS_ABORT_MSG_IF (sum != linearSum, "The classifications differ from the ones of the linear search");
+
+  std::cout << std::setw (8) << numBearers
+            << std::setw (8) << (range ? "range" : "single")
+            << std::setw (16) << static_cast<uint64_t> (packets / seconds) << " pkt/s"
+            << std::setw (16) << static_cast<uint64_t> (packets / linearSeconds) << " pkt/s" << std::endl;
+  return sum;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t packets = 200000;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("packets", "Number of packets classified for each configuration", packets);
+  cmd.Parse (argc, argv);
+
+  std::cout << std::setw (8) << "bearers"
+            << std::setw (8) << "filters"
+            << std::setw (22) << "classifier"
+            << std::setw (22) << "linear search" << std::endl;
+  uint64_t sum = 0;
+  for (bool range : {false, true})
+    {
+      // at most 16 TFTs per UE, including the default one
+      for (uint32_t numBearers : {1, 2, 4, 8, 15})
+        {
+          sum += Profile (numBearers, range, packets);
+        }
+    }
+  std::cout << "checksum " << sum << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -29,8 +29,6 @@
 #include "ns3/packet.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/ipv6-header.h"
-#include "ns3/udp-header.h"
-#include "ns3/tcp-header.h"
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/udp-l4-protocol.h"
@@ -55,6 +53,8 @@ EpcTftClassifier::Add (Ptr<EpcTft> tft, uint32_t id)
 
   // simple sanity check: there shouldn't be more than 16 bearers (hence TFTs) per UE
   NS_ASSERT (m_tftMap.size () <= 16);
+
+  BuildIndex ();
 }
 
 void
@@ -62,6 +62,106 @@ EpcTftClassifier::Delete (uint32_t id)
 {
   NS_LOG_FUNCTION (this << id);
   m_tftMap.erase (id);
+
+  BuildIndex ();
+}
+
+uint32_t
+EpcTftClassifier::GetPortKey (EpcTft::Direction direction, uint16_t port)
+{
+  return (static_cast<uint32_t> (direction) << 16) | port;
+}
+
+void
+EpcTftClassifier::BuildIndex ()
+{
+  NS_LOG_FUNCTION (this);
+  m_localPortIndex.clear ();
+  m_remotePortIndex.clear ();
+  m_wildcardFilters.clear ();
+
+  // visit the TFTs by decreasing identifier, so that all the lists are
+  // sorted by decreasing identifier
+  for (auto it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it)
+    {
+      for (const EpcTft::PacketFilter &f : it->second->GetPacketFilters ())
+        {
+          IndexedFilter indexed = {it->first, f};
+          if (f.localPortStart != f.localPortEnd && f.remotePortStart != f.remotePortEnd)
+            {
+              m_wildcardFilters.push_back (indexed);
+              continue;
+            }
+          for (EpcTft::Direction d : {EpcTft::DOWNLINK, EpcTft::UPLINK})
+            {
+              if (!(f.direction & d))
+                {
+                  continue;
+                }
+              if (f.localPortStart == f.localPortEnd)
+                {
+                  m_localPortIndex[GetPortKey (d, f.localPortStart)].push_back (indexed);
+                }
+              else
+                {
+                  m_remotePortIndex[GetPortKey (d, f.remotePortStart)].push_back (indexed);
+                }
+            }
+        }
+    }
+  NS_LOG_LOGIC ("indexed " << m_localPortIndex.size () << " local ports, "
+                           << m_remotePortIndex.size () << " remote ports, "
+                           << m_wildcardFilters.size () << " wildcard filters");
+}
+
+template <class ADDRESS>
+void
+EpcTftClassifier::Match (const FilterList &list, EpcTft::Direction direction,
+                         ADDRESS remoteAddress, ADDRESS localAddress,
+                         uint16_t remotePort, uint16_t localPort, uint8_t tos,
+                         bool &found, uint32_t &id)
+{
+  for (const IndexedFilter &f : list)
+    {
+      if (found && f.id <= id)
+        {
+          // the TFTs of the remaining filters have a lower priority
+          return;
+        }
+      if (f.filter.Matches (direction, remoteAddress, localAddress, remotePort, localPort, tos))
+        {
+          NS_LOG_LOGIC ("matches with TFT ID = " << f.id);
+          found = true;
+          id = f.id;
+          return;
+        }
+    }
+}
+
+/**
+ * Read the source and destination ports of the UDP or TCP header which
+ * follows the IP header, without copying the packet. Both headers start
+ * with the source and the destination port, in network byte order.
+ *
+ * \param p the packet
+ * \param offset the size of the IP header
+ * \param sourcePort the source port
+ * \param destinationPort the destination port
+ * \return false if the packet is too short to contain the ports
+ */
+static bool
+PeekPorts (Ptr<const Packet> p, uint32_t offset, uint16_t &sourcePort, uint16_t &destinationPort)
+{
+  // the largest IP header is an IPv4 header with 40 bytes of options
+  uint8_t buffer[64];
+  if (offset + 4 > sizeof (buffer) || p->GetSize () < offset + 4)
+    {
+      return false;
+    }
+  p->CopyData (buffer, offset + 4);
+  sourcePort = (static_cast<uint16_t> (buffer[offset]) << 8) | buffer[offset + 1];
+  destinationPort = (static_cast<uint16_t> (buffer[offset + 2]) << 8) | buffer[offset + 3];
+  return true;
 }
 
 uint32_t
@@ -69,8 +169,6 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
 {
   NS_LOG_FUNCTION (this << p << p->GetSize () << direction);
 
-  Ptr<Packet> pCopy = p->Copy ();
-
   Ipv4Address localAddressIpv4;
   Ipv4Address remoteAddressIpv4;
 
@@ -82,11 +180,13 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
 
   uint16_t localPort = 0;
   uint16_t remotePort = 0;
+  uint16_t sourcePort = 0;
+  uint16_t destinationPort = 0;
 
   if (protocolNumber == Ipv4L3Protocol::PROT_NUMBER)
     {
       Ipv4Header ipv4Header;
-      pCopy->RemoveHeader (ipv4Header);
+      uint32_t headerSize = p->PeekHeader (ipv4Header);
 
       if (direction ==  EpcTft::UPLINK)
         {
@@ -117,19 +217,19 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
       // i.e. it is the first one but it is not the last one
       if (fragmentOffset == 0)
         {
-          if (protocol == UdpL4Protocol::PROT_NUMBER && payloadSize >= 8)
+          if (((protocol == UdpL4Protocol::PROT_NUMBER && payloadSize >= 8)
+               || (protocol == TcpL4Protocol::PROT_NUMBER && payloadSize >= 20))
+              && PeekPorts (p, headerSize, sourcePort, destinationPort))
             {
-              UdpHeader udpHeader;
-              pCopy->RemoveHeader (udpHeader);
               if (direction ==  EpcTft::UPLINK)
                 {
-                  localPort = udpHeader.GetSourcePort ();
-                  remotePort = udpHeader.GetDestinationPort ();
+                  localPort = sourcePort;
+                  remotePort = destinationPort;
                 }
               else
                 {
-                  remotePort = udpHeader.GetSourcePort ();
-                  localPort = udpHeader.GetDestinationPort ();
+                  remotePort = sourcePort;
+                  localPort = destinationPort;
                 }
               if (!isLastFragment)
                 {
@@ -142,32 +242,6 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
                   m_classifiedIpv4Fragments[fragmentKey] = std::make_pair (localPort, remotePort);
                 }
             }
-          else if (protocol == TcpL4Protocol::PROT_NUMBER && payloadSize >= 20)
-            {
-              TcpHeader tcpHeader;
-              pCopy->RemoveHeader (tcpHeader);
-              if (direction ==  EpcTft::UPLINK)
-                {
-                  localPort = tcpHeader.GetSourcePort ();
-                  remotePort = tcpHeader.GetDestinationPort ();
-                }
-              else
-                {
-                  remotePort = tcpHeader.GetSourcePort ();
-                  localPort = tcpHeader.GetDestinationPort ();
-                }
-
-              if (!isLastFragment)
-                {
-                  std::tuple<uint32_t, uint32_t, uint8_t, uint16_t> fragmentKey =
-                      std::make_tuple (ipv4Header.GetSource ().Get (),
-                                       ipv4Header.GetDestination ().Get (),
-                                       protocol,
-                                       ipv4Header.GetIdentification ());
-
-                  m_classifiedIpv4Fragments[fragmentKey] = std::make_pair (localPort, remotePort);
-                }
-            }
 
           // else
           //   First fragment but not enough data for port info or not UDP/TCP protocol.
@@ -202,7 +276,7 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
   else if (protocolNumber == Ipv6L3Protocol::PROT_NUMBER)
     {
       Ipv6Header ipv6Header;
-      pCopy->RemoveHeader (ipv6Header);
+      uint32_t headerSize = p->PeekHeader (ipv6Header);
 
       if (direction ==  EpcTft::UPLINK)
         {
@@ -220,35 +294,18 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
       protocol = ipv6Header.GetNextHeader ();
       tos = ipv6Header.GetTrafficClass ();
 
-      if (protocol == UdpL4Protocol::PROT_NUMBER)
-        {
-          UdpHeader udpHeader;
-          pCopy->RemoveHeader (udpHeader);
-
-          if (direction ==  EpcTft::UPLINK)
-            {
-              localPort = udpHeader.GetSourcePort ();
-              remotePort = udpHeader.GetDestinationPort ();
-            }
-          else
-            {
-              remotePort = udpHeader.GetSourcePort ();
-              localPort = udpHeader.GetDestinationPort ();
-            }
-        }
-      else if (protocol == TcpL4Protocol::PROT_NUMBER)
+      if ((protocol == UdpL4Protocol::PROT_NUMBER || protocol == TcpL4Protocol::PROT_NUMBER)
+          && PeekPorts (p, headerSize, sourcePort, destinationPort))
         {
-          TcpHeader tcpHeader;
-          pCopy->RemoveHeader (tcpHeader);
           if (direction ==  EpcTft::UPLINK)
             {
-              localPort = tcpHeader.GetSourcePort ();
-              remotePort = tcpHeader.GetDestinationPort ();
+              localPort = sourcePort;
+              remotePort = destinationPort;
             }
           else
             {
-              remotePort = tcpHeader.GetSourcePort ();
-              localPort = tcpHeader.GetDestinationPort ();
+              remotePort = sourcePort;
+              localPort = destinationPort;
             }
         }
     }
@@ -257,6 +314,16 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
       NS_ABORT_MSG ("EpcTftClassifier::Classify - Unknown IP type...");
     }
 
+  // now it is possible to classify the packet!
+  // Filter priority is not implemented properly: as with a reverse iteration
+  // over the TFT map, the TFT with the highest identifier among the ones that
+  // match is selected. This way, since the default bearer is expected to be
+  // added first, it will be evaluated last.
+  NS_LOG_LOGIC ("TFT MAP size: " << m_tftMap.size ());
+  bool found = false;
+  uint32_t id = 0;
+  auto localIt = m_localPortIndex.find (GetPortKey (direction, localPort));
+  auto remoteIt = m_remotePortIndex.find (GetPortKey (direction, remotePort));
 
   if (protocolNumber == Ipv4L3Protocol::PROT_NUMBER)
     {
@@ -267,25 +334,17 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
           << " remotePort=" << remotePort
           << " tos=0x" << (uint16_t) tos );
 
-      // now it is possible to classify the packet!
-      // we use a reverse iterator since filter priority is not implemented properly.
-      // This way, since the default bearer is expected to be added first, it will be evaluated last.
-      std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
-      NS_LOG_LOGIC ("TFT MAP size: " << m_tftMap.size ());
-
-      for (it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it)
+      if (localIt != m_localPortIndex.end ())
         {
-          NS_LOG_LOGIC ("TFT id: " << it->first );
-          NS_LOG_LOGIC (" Ptr<EpcTft>: " << it->second);
-          Ptr<EpcTft> tft = it->second;
-          if (tft->Matches (direction, remoteAddressIpv4, localAddressIpv4, remotePort, localPort, tos))
-            {
-              NS_LOG_LOGIC ("matches with TFT ID = " << it->first);
-              return it->first; // the id of the matching TFT
-            }
+          Match (localIt->second, direction, remoteAddressIpv4, localAddressIpv4, remotePort, localPort, tos, found, id);
+        }
+      if (remoteIt != m_remotePortIndex.end ())
+        {
+          Match (remoteIt->second, direction, remoteAddressIpv4, localAddressIpv4, remotePort, localPort, tos, found, id);
         }
+      Match (m_wildcardFilters, direction, remoteAddressIpv4, localAddressIpv4, remotePort, localPort, tos, found, id);
     }
-  else if (protocolNumber == Ipv6L3Protocol::PROT_NUMBER)
+  else
     {
       NS_LOG_INFO ("Classifying packet:"
           << " localAddr="  << localAddressIpv6
@@ -294,27 +353,22 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
           << " remotePort=" << remotePort
           << " tos=0x" << (uint16_t) tos );
 
-      // now it is possible to classify the packet!
-      // we use a reverse iterator since filter priority is not implemented properly.
-      // This way, since the default bearer is expected to be added first, it will be evaluated last.
-      std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
-      NS_LOG_LOGIC ("TFT MAP size: " << m_tftMap.size ());
-
-      for (it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it)
+      if (localIt != m_localPortIndex.end ())
         {
-          NS_LOG_LOGIC ("TFT id: " << it->first );
-          NS_LOG_LOGIC (" Ptr<EpcTft>: " << it->second);
-          Ptr<EpcTft> tft = it->second;
-          if (tft->Matches (direction, remoteAddressIpv6, localAddressIpv6, remotePort, localPort, tos))
-            {
-              NS_LOG_LOGIC ("matches with TFT ID = " << it->first);
-              return it->first; // the id of the matching TFT
-            }
+          Match (localIt->second, direction, remoteAddressIpv6, localAddressIpv6, remotePort, localPort, tos, found, id);
         }
+      if (remoteIt != m_remotePortIndex.end ())
+        {
+          Match (remoteIt->second, direction, remoteAddressIpv6, localAddressIpv6, remotePort, localPort, tos, found, id);
+        }
+      Match (m_wildcardFilters, direction, remoteAddressIpv6, localAddressIpv6, remotePort, localPort, tos, found, id);
     }
-  NS_LOG_LOGIC ("no match");
-  return 0;  // no match
-}
 
+  if (!found)
+    {
+      NS_LOG_LOGIC ("no match");
+    }
+  return id;
+}
 
 } // namespace ns3
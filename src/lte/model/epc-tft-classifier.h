@@ -28,6 +28,8 @@
 #include "ns3/epc-tft.h"
 
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 
 namespace ns3 {
@@ -50,6 +52,16 @@ class Packet;
  *
  * When we cannot cache the port info, the TFT of the default bearer is used. This may happen
  * if there is reordering or losses of IP packets.
+ *
+ * The headers are peeked in place, without copying the packet. The packet
+ * filters of the TFTs are indexed when a TFT is added or deleted: the
+ * filters with a single local (or, otherwise, remote) port are stored in a
+ * hash table, keyed by direction and port, and the other filters in a
+ * wildcard list. A packet is thus matched only against the filters of its
+ * ports and the wildcard ones. The result is the same as the one of a
+ * linear search over the TFTs, i.e., the TFT with the highest identifier
+ * among the ones that match. Since the index is built when the TFT is
+ * added, the packet filters of a TFT must not be changed afterwards.
  */
 class EpcTftClassifier : public SimpleRefCount<EpcTftClassifier>
 {
@@ -87,8 +99,58 @@ public:
 
 protected:
 
+  /**
+   * A packet filter, with the identifier of its TFT
+   */
+  struct IndexedFilter
+  {
+    uint32_t id;                  ///< the identifier of the TFT
+    EpcTft::PacketFilter filter;  ///< the packet filter
+  };
+
+  /// Packet filters, sorted by decreasing TFT identifier
+  typedef std::vector<IndexedFilter> FilterList;
+
+  /**
+   * Rebuild the index of the packet filters from the TFT map
+   */
+  void BuildIndex ();
+
+  /**
+   * \param direction the direction (uplink or downlink)
+   * \param port the port
+   * \return the key of the port indexes
+   */
+  static uint32_t GetPortKey (EpcTft::Direction direction, uint16_t port);
+
+  /**
+   * Search the first packet filter of a list that matches, among the ones of
+   * TFTs with an identifier higher than the one already found
+   *
+   * \param list the packet filters
+   * \param direction the direction
+   * \param remoteAddress the remote address
+   * \param localAddress the local address
+   * \param remotePort the remote port
+   * \param localPort the local port
+   * \param tos the type of service
+   * \param found whether a matching TFT was already found, set to true if a
+   *        TFT matches
+   * \param id the identifier of the matching TFT, updated if a TFT with an
+   *        higher identifier matches
+   */
+  template <class ADDRESS>
+  static void Match (const FilterList &list, EpcTft::Direction direction,
+                     ADDRESS remoteAddress, ADDRESS localAddress,
+                     uint16_t remotePort, uint16_t localPort, uint8_t tos,
+                     bool &found, uint32_t &id);
+
   std::map <uint32_t, Ptr<EpcTft> > m_tftMap; ///< TFT map
 
+  std::unordered_map<uint32_t, FilterList> m_localPortIndex; ///< filters with a single local port, by direction and local port
+  std::unordered_map<uint32_t, FilterList> m_remotePortIndex; ///< filters with a single remote port (and a range of local ports), by direction and remote port
+  FilterList m_wildcardFilters; ///< filters with a range of both local and remote ports
+
   std::map < std::tuple<uint32_t, uint32_t, uint8_t, uint16_t>,
              std::pair<uint32_t, uint32_t> >
       m_classifiedIpv4Fragments; ///< Map with already classified IPv4 Fragments
@@ -103,7 +103,7 @@ EpcTft::PacketFilter::Matches (Direction d,
                                Ipv4Address la,
                                uint16_t rp,
                                uint16_t lp,
-                               uint8_t tos)
+                               uint8_t tos) const
 {
   NS_LOG_FUNCTION (this << d << ra << la << rp << lp << (uint16_t) tos);
   if (d & direction)
@@ -164,7 +164,7 @@ EpcTft::PacketFilter::Matches (Direction d,
                                Ipv6Address la,
                                uint16_t rp,
                                uint16_t lp,
-                               uint8_t tos)
+                               uint8_t tos) const
 {
   NS_LOG_FUNCTION (this << d << ra << la << rp << lp << (uint16_t) tos);
   if (d & direction)
@@ -253,6 +253,13 @@ EpcTft::Add (PacketFilter f)
   return (m_numFilters - 1);
 }
 
+std::list<EpcTft::PacketFilter>
+EpcTft::GetPacketFilters () const
+{
+  NS_LOG_FUNCTION (this);
+  return m_filters;
+}
+
 bool
 EpcTft::Matches (Direction direction,
                  Ipv4Address remoteAddress,
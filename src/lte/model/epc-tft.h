@@ -92,7 +92,7 @@ public:
 		  Ipv4Address la,
 		  uint16_t rp,
 		  uint16_t lp,
-		  uint8_t tos);
+		  uint8_t tos) const;
 
     /**
      *
@@ -111,7 +111,7 @@ public:
 		  Ipv6Address la,
 		  uint16_t rp,
 		  uint16_t lp,
-		  uint8_t tos);
+		  uint8_t tos) const;
 
 
 
@@ -155,6 +155,12 @@ public:
    */
   uint8_t Add (PacketFilter f);
 
+  /**
+   * \return the packet filters of the TFT, in the order in which they
+   * were added
+   */
+  std::list<PacketFilter> GetPacketFilters () const;
+
 
     /**
      *
@@ -25,6 +25,10 @@
 #include "ns3/log.h"
 #include "ns3/epc-x2-header.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 
 namespace ns3 {
 
@@ -2651,6 +2655,217 @@ EpcX2UeImsiSinrUpdateHeader::unpack754(uint64_t i)
 
 /////////////////////////////////////////////////////////////////////
 
+/**
+ * \param value the value to encode
+ * \return the number of bytes of the variable length encoding of value
+ */
+static uint32_t
+GetVarintSize (uint64_t value)
+{
+  uint32_t size = 1;
+  while (value >= 0x80)
+    {
+      value >>= 7;
+      size++;
+    }
+  return size;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (EpcX2UeImsiSinrDeltaUpdateHeader);
+
+EpcX2UeImsiSinrDeltaUpdateHeader::EpcX2UeImsiSinrDeltaUpdateHeader ()
+  : m_numberOfIes (1 + 1 + 1),
+    m_headerLength (2 + 4 + 2),
+    m_quantizationStep (0.1),
+    m_sourceCellId (0)
+{
+}
+
+EpcX2UeImsiSinrDeltaUpdateHeader::~EpcX2UeImsiSinrDeltaUpdateHeader ()
+{
+  m_numberOfIes = 0;
+  m_headerLength = 0;
+  m_map.clear ();
+}
+
+TypeId
+EpcX2UeImsiSinrDeltaUpdateHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::EpcX2UeImsiSinrDeltaUpdateHeader")
+    .SetParent<Header> ()
+    .SetGroupName("Lte")
+    .AddConstructor<EpcX2UeImsiSinrDeltaUpdateHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+EpcX2UeImsiSinrDeltaUpdateHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+EpcX2UeImsiSinrDeltaUpdateHeader::GetSerializedSize (void) const
+{
+  return m_headerLength;
+}
+
+void
+EpcX2UeImsiSinrDeltaUpdateHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+
+  i.WriteHtonU16 (m_sourceCellId);
+  // the step is sent in micro dB
+  i.WriteHtonU32 (static_cast<uint32_t> (std::round (m_quantizationStep * 1e6)));
+  i.WriteHtonU16 (m_map.size ());
+
+  uint64_t previousImsi = 0;
+  for (std::map<uint64_t, double>::const_iterator iter = m_map.begin (); iter != m_map.end (); ++iter)
+    {
+      uint64_t delta = iter->first - previousImsi;
+      previousImsi = iter->first;
+      while (delta >= 0x80)
+        {
+          i.WriteU8 (static_cast<uint8_t> (delta & 0x7f) | 0x80);
+          delta >>= 7;
+        }
+      i.WriteU8 (static_cast<uint8_t> (delta));
+      i.WriteHtonU16 (static_cast<uint16_t> (QuantizeSinr (iter->second, m_quantizationStep)));
+    }
+}
+
+uint32_t
+EpcX2UeImsiSinrDeltaUpdateHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+
+  m_map.clear ();
+  m_sourceCellId = i.ReadNtohU16 ();
+  m_quantizationStep = i.ReadNtohU32 () / 1e6;
+  m_headerLength = 2 + 4 + 2;
+  m_numberOfIes = 1 + 1 + 1;
+
+  uint16_t sz = i.ReadNtohU16 ();
+  uint64_t imsi = 0;
+  for (uint16_t j = 0; j < sz; j++)
+    {
+      uint64_t delta = 0;
+      uint8_t byte;
+      uint32_t shift = 0;
+      do
+        {
+          byte = i.ReadU8 ();
+          delta |= static_cast<uint64_t> (byte & 0x7f) << shift;
+          shift += 7;
+          m_headerLength++;
+        }
+      while (byte & 0x80);
+      imsi += delta;
+      m_map[imsi] = DequantizeSinr (static_cast<int16_t> (i.ReadNtohU16 ()), m_quantizationStep);
+      m_headerLength += 2;
+    }
+  m_numberOfIes += sz;
+
+  return GetSerializedSize ();
+}
+
+void
+EpcX2UeImsiSinrDeltaUpdateHeader::Print (std::ostream &os) const
+{
+  os << "SourceCellId " << m_sourceCellId << " QuantizationStep " << m_quantizationStep;
+  for (std::map<uint64_t, double>::const_iterator iter = m_map.begin (); iter != m_map.end (); ++iter)
+    {
+      os << " Imsi " << iter->first << " sinr " << 10 * std::log10 (iter->second);
+    }
+}
+
+std::map <uint64_t, double>
+EpcX2UeImsiSinrDeltaUpdateHeader::GetUeImsiSinrMap () const
+{
+  return m_map;
+}
+
+void
+EpcX2UeImsiSinrDeltaUpdateHeader::SetUeImsiSinrMap (const std::map <uint64_t, double> &map)
+{
+  m_map = map;
+
+  m_headerLength = 2 + 4 + 2;
+  m_numberOfIes = 1 + 1 + 1 + m_map.size ();
+  uint64_t previousImsi = 0;
+  for (std::map<uint64_t, double>::const_iterator iter = m_map.begin (); iter != m_map.end (); ++iter)
+    {
+      m_headerLength += GetVarintSize (iter->first - previousImsi) + 2;
+      previousImsi = iter->first;
+    }
+}
+
+double
+EpcX2UeImsiSinrDeltaUpdateHeader::GetQuantizationStep () const
+{
+  return m_quantizationStep;
+}
+
+void
+EpcX2UeImsiSinrDeltaUpdateHeader::SetQuantizationStep (double step)
+{
+  NS_ASSERT_MSG (step > 0, "The quantization step must be positive");
+  // use the value that the receiver will decode
+  m_quantizationStep = std::round (step * 1e6) / 1e6;
+}
+
+uint16_t
+EpcX2UeImsiSinrDeltaUpdateHeader::GetSourceCellId () const
+{
+  return m_sourceCellId;
+}
+
+void
+EpcX2UeImsiSinrDeltaUpdateHeader::SetSourceCellId (uint16_t cellId)
+{
+  m_sourceCellId = cellId;
+}
+
+uint32_t
+EpcX2UeImsiSinrDeltaUpdateHeader::GetLengthOfIes () const
+{
+  return m_headerLength;
+}
+
+uint32_t
+EpcX2UeImsiSinrDeltaUpdateHeader::GetNumberOfIes () const
+{
+  return m_numberOfIes;
+}
+
+int16_t
+EpcX2UeImsiSinrDeltaUpdateHeader::QuantizeSinr (double sinr, double step)
+{
+  if (sinr <= 0)
+    {
+      return std::numeric_limits<int16_t>::min ();
+    }
+  double value = std::round (10 * std::log10 (sinr) / step);
+  // the minimum value is reserved to the 0 SINR
+  value = std::max (value, static_cast<double> (std::numeric_limits<int16_t>::min () + 1));
+  value = std::min (value, static_cast<double> (std::numeric_limits<int16_t>::max ()));
+  return static_cast<int16_t> (value);
+}
+
+double
+EpcX2UeImsiSinrDeltaUpdateHeader::DequantizeSinr (int16_t value, double step)
+{
+  if (value == std::numeric_limits<int16_t>::min ())
+    {
+      return 0;
+    }
+  return std::pow (10, value * step / 10);
+}
+
+/////////////////////////////////////////////////////////////////////
+
 NS_OBJECT_ENSURE_REGISTERED (EpcX2ConnectionSwitchHeader);
 
 EpcX2ConnectionSwitchHeader::EpcX2ConnectionSwitchHeader ()
@@ -101,7 +101,8 @@ public:
     NotifyMmWaveLteHandover = 16,
     NotifyCoordinatorHandoverFailed = 17,
     SwitchConnection        = 18,
-    SecondaryCellHandoverCompleted = 19
+    SecondaryCellHandoverCompleted = 19,
+    UpdateUeSinrDelta       = 20
 
   };
 
@@ -908,6 +909,98 @@ private:
   uint16_t m_sourceCellId;
 };
 
+/**
+ * \brief Compact version of EpcX2UeImsiSinrUpdateHeader
+ *
+ * The SINR values are sent in dB, quantized with the step carried in the
+ * header, as 16-bit signed integers. The IMSIs are sent in increasing
+ * order, each one as the variable length (7 bits per byte) difference with
+ * the previous one. A typical entry thus takes 3 bytes instead of 16.
+ * A SINR of 0 (-inf dB) is encoded with the minimum value.
+ */
+class EpcX2UeImsiSinrDeltaUpdateHeader : public Header
+{
+public:
+  EpcX2UeImsiSinrDeltaUpdateHeader ();
+  virtual ~EpcX2UeImsiSinrDeltaUpdateHeader ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual void Print (std::ostream &os) const;
+
+  /**
+   * Get the SINR map. After deserialization, the values are the
+   * dequantized ones
+   * \returns the SINR (linear) of each IMSI
+   */
+  std::map <uint64_t, double> GetUeImsiSinrMap () const;
+  /**
+   * Set the SINR map. Must be called after SetQuantizationStep
+   * \param map the SINR (linear) of each IMSI
+   */
+  void SetUeImsiSinrMap (const std::map<uint64_t, double> &map);
+
+  /**
+   * \returns the quantization step [dB]
+   */
+  double GetQuantizationStep () const;
+  /**
+   * \param step the quantization step [dB], must be positive
+   */
+  void SetQuantizationStep (double step);
+
+  /**
+   * \returns the source cell ID
+   */
+  uint16_t GetSourceCellId () const;
+  /**
+   * \param sourceCellId the source cell ID
+   */
+  void SetSourceCellId (uint16_t sourceCellId);
+
+  /**
+   * Get length of IEs function
+   * \returns the length of IEs
+   */
+  uint32_t GetLengthOfIes () const;
+  /**
+   * Get number of IEs function
+   * \returns the number of IEs
+   */
+  uint32_t GetNumberOfIes () const;
+
+  /**
+   * Quantize a SINR value
+   * \param sinr the SINR (linear)
+   * \param step the quantization step [dB]
+   * \returns the SINR in dB divided by step, rounded and saturated to the
+   *          int16_t range
+   */
+  static int16_t QuantizeSinr (double sinr, double step);
+  /**
+   * Dequantize a SINR value
+   * \param value the quantized SINR
+   * \param step the quantization step [dB]
+   * \returns the SINR (linear)
+   */
+  static double DequantizeSinr (int16_t value, double step);
+
+private:
+  uint32_t          m_numberOfIes; ///< number of IEs
+  uint32_t          m_headerLength; ///< header length
+
+  std::map <uint64_t, double> m_map; ///< the SINR of each IMSI
+  double m_quantizationStep; ///< the quantization step [dB]
+  uint16_t m_sourceCellId; ///< source cell ID
+};
+
 class EpcX2ConnectionSwitchHeader : public Header
 {
 public:
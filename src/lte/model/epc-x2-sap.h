@@ -381,6 +381,9 @@ public:
     uint16_t    sourceCellId;
     uint16_t    targetCellId;
     std::map<uint64_t, double> ueImsiSinrMap;
+    // if positive, ueImsiSinrMap is sent with EpcX2UeImsiSinrDeltaUpdateHeader,
+    // i.e., as dB values quantized with this step [dB]
+    double      quantizationStep;
   };
 
   struct HandoverFailedParams
@@ -501,8 +501,26 @@ EpcX2::RecvFromX2cSocket (Ptr<Socket> socket)
       params.ueImsiSinrMap = x2ueSinrUpdateHeader.GetUeImsiSinrMap();
       params.sourceCellId = x2ueSinrUpdateHeader.GetSourceCellId();
 
+      params.quantizationStep = 0;
+
       m_x2SapUser->RecvUeSinrUpdate(params);  
     }
+  else if(procedureCode == EpcX2Header::UpdateUeSinrDelta)
+    {
+      NS_LOG_LOGIC ("Recv X2 message: UPDATE UE SINR DELTA");
+
+      EpcX2UeImsiSinrDeltaUpdateHeader x2ueSinrUpdateHeader;
+      packet->RemoveHeader(x2ueSinrUpdateHeader);
+
+      NS_LOG_INFO ("X2 SinrDeltaUpdateHeader header: " << x2ueSinrUpdateHeader);
+
+      EpcX2SapUser::UeImsiSinrParams params;
+      params.ueImsiSinrMap = x2ueSinrUpdateHeader.GetUeImsiSinrMap();
+      params.sourceCellId = x2ueSinrUpdateHeader.GetSourceCellId();
+      params.quantizationStep = x2ueSinrUpdateHeader.GetQuantizationStep();
+
+      m_x2SapUser->RecvUeSinrUpdate(params);
+    }
   else if (procedureCode == EpcX2Header::RequestMcHandover)
     {
       NS_LOG_LOGIC ("Recv X2 message: REQUEST MC HANDOVER");
@@ -1295,22 +1313,39 @@ EpcX2::DoSendUeSinrUpdate(EpcX2Sap::UeImsiSinrParams params)
   NS_LOG_LOGIC ("targetIpAddr = " << targetIpAddr);
 
   // Build the X2 message
-  EpcX2UeImsiSinrUpdateHeader x2imsiSinrHeader;
-  x2imsiSinrHeader.SetUeImsiSinrMap (params.ueImsiSinrMap);
-  x2imsiSinrHeader.SetSourceCellId (params.sourceCellId);
-
+  Ptr<Packet> packet = Create <Packet> ();
   EpcX2Header x2Header;
   x2Header.SetMessageType (EpcX2Header::InitiatingMessage);
-  x2Header.SetProcedureCode (EpcX2Header::UpdateUeSinr);
-  x2Header.SetLengthOfIes (x2imsiSinrHeader.GetLengthOfIes ());
-  x2Header.SetNumberOfIes (x2imsiSinrHeader.GetNumberOfIes ());
+  if (params.quantizationStep > 0)
+    {
+      EpcX2UeImsiSinrDeltaUpdateHeader x2imsiSinrHeader;
+      x2imsiSinrHeader.SetQuantizationStep (params.quantizationStep);
+      x2imsiSinrHeader.SetUeImsiSinrMap (params.ueImsiSinrMap);
+      x2imsiSinrHeader.SetSourceCellId (params.sourceCellId);
 
+      x2Header.SetProcedureCode (EpcX2Header::UpdateUeSinrDelta);
+      x2Header.SetLengthOfIes (x2imsiSinrHeader.GetLengthOfIes ());
+      x2Header.SetNumberOfIes (x2imsiSinrHeader.GetNumberOfIes ());
+
+      NS_LOG_INFO ("X2 UeImsiSinrDeltaUpdate header: " << x2imsiSinrHeader);
+      packet->AddHeader (x2imsiSinrHeader);
+    }
+  else
+    {
+      EpcX2UeImsiSinrUpdateHeader x2imsiSinrHeader;
+      x2imsiSinrHeader.SetUeImsiSinrMap (params.ueImsiSinrMap);
+      x2imsiSinrHeader.SetSourceCellId (params.sourceCellId);
+
+      x2Header.SetProcedureCode (EpcX2Header::UpdateUeSinr);
+      x2Header.SetLengthOfIes (x2imsiSinrHeader.GetLengthOfIes ());
+      x2Header.SetNumberOfIes (x2imsiSinrHeader.GetNumberOfIes ());
+
+      NS_LOG_INFO ("X2 UeImsiSinrUpdate header: " << x2imsiSinrHeader);
+      packet->AddHeader (x2imsiSinrHeader);
+    }
   NS_LOG_INFO ("X2 header: " << x2Header);
-  NS_LOG_INFO ("X2 UeImsiSinrUpdate header: " << x2imsiSinrHeader);
 
   // Build the X2 packet
-  Ptr<Packet> packet = Create <Packet> ();
-  packet->AddHeader (x2imsiSinrHeader);
   packet->AddHeader (x2Header);
   NS_LOG_INFO ("packetLen = " << packet->GetSize ());
 
@@ -56,7 +56,10 @@
 #include <ns3/mc-enb-pdcp.h>
 #include "ns3/lte-pdcp-tag.h"
 #include <ns3/lte-rlc-sap.h>
+#include <ns3/epc-x2-header.h>
 
+#include <algorithm>
+#include <chrono>
 
 
 namespace ns3 {
@@ -666,6 +669,7 @@ UeManager::ScheduleRrcConnectionReconfiguration ()
         msg.radioResourceConfigDedicated.physicalConfigDedicated.havePdschConfigDedicated = false;
         m_rrc->m_rrcSapUser->SendRrcConnectionReconfiguration (m_rnti, msg);
         RecordDataRadioBearersToBeStarted ();
+        m_forwardingStartTime = Simulator::Now ();
         SwitchToState (MC_CONNECTION_RECONFIGURATION);
       }
       break;
@@ -685,6 +689,7 @@ UeManager::PrepareHandover (uint16_t cellId)
     case CONNECTED_NORMALLY:
       {
         m_targetCellId = cellId;
+        m_forwardingStartTime = Simulator::Now ();
         EpcX2SapProvider::HandoverRequestParams params;
         params.oldEnbUeX2apId = m_rnti;
         params.cause          = EpcX2SapProvider::HandoverDesirableForRadioReason;
@@ -748,12 +753,13 @@ UeManager::PrepareHandover (uint16_t cellId)
  * Merge 2 buffers of RlcAmPdus into 1 vector with increment order of Pdus
  */
 std::vector < LteRlcAm::RetxPdu >
-UeManager::MergeBuffers(std::vector < LteRlcAm::RetxPdu > first, std::vector < LteRlcAm::RetxPdu > second)
+UeManager::MergeBuffers(const std::vector < LteRlcAm::RetxPdu > &first, const std::vector < LteRlcAm::RetxPdu > &second)
 {
   LteRlcAmHeader rlcamHeader_1, rlcamHeader_2;
   std::vector < LteRlcAm::RetxPdu> result;
-  std::vector < LteRlcAm::RetxPdu>::iterator it_1 = first.begin();
-  std::vector < LteRlcAm::RetxPdu>::iterator it_2 = second.begin();
+  result.reserve (first.size () + second.size ());
+  std::vector < LteRlcAm::RetxPdu>::const_iterator it_1 = first.begin();
+  std::vector < LteRlcAm::RetxPdu>::const_iterator it_2 = second.begin();
   bool end_1_reached = false;
   bool end_2_reached = false;
   while (it_1 != first.end() && it_2 != second.end()){
@@ -905,19 +911,23 @@ UeManager::RecvHandoverRequestAck (EpcX2SapUser::HandoverRequestAckParams params
 void
 UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTeid, bool mcLteToMmWaveForwarding, bool mcMmToMmWaveForwarding, uint8_t bid)
 {
+  auto wallClockStart = std::chrono::steady_clock::now ();
+  uint32_t forwardedSdus = 0;
+  uint32_t forwardedBytes = 0;
+
   // RlcBuffers forwarding only for RlcAm bearers.
   if (0 != rlc->GetObject<LteRlcAm> ())
   {
     //Copy lte-rlc-am.m_txOnBuffer to X2 forwarding buffer.
     Ptr<LteRlcAm> rlcAm = rlc->GetObject<LteRlcAm>();
     uint32_t txonBufferSize = rlcAm->GetTxBufferSize();
-    std::vector < Ptr<Packet> > txonBuffer = rlcAm->GetTxBuffer();
+    LteRlc::TxBuffer txonBuffer = rlcAm->GetTxBuffer();
     //m_x2forwardingBufferSize =  drbIt->second->m_rlc->GetObject<LteRlcAm>()->GetTxBufferSize();
     //m_x2forwardingBuffer = drbIt->second->m_rlc->GetObject<LteRlcAm>()->GetTxBuffer();
     uint32_t txedBufferSize = rlcAm->GetTxedBufferSize();
-    std::vector < LteRlcAm::RetxPdu > txedBuffer = rlcAm->GetTxedBuffer();
+    const std::vector < LteRlcAm::RetxPdu > &txedBuffer = rlcAm->GetTxedBuffer();
     uint32_t retxBufferSize = rlcAm->GetRetxBufferSize();
-    std::vector < LteRlcAm::RetxPdu > retxBuffer = rlcAm->GetRetxBuffer();
+    const std::vector < LteRlcAm::RetxPdu > &retxBuffer = rlcAm->GetRetxBuffer();
 
     //Translate Pdus in Rlc txed/retx buffer into RLC Sdus
     //and put these Sdus into rlcAm->m_transmittingRlcSdus.
@@ -925,17 +935,15 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTei
     NS_LOG_INFO("txedBuffer size = " << txedBufferSize);
     //Merge txed and retx buffers into a single buffer before doing RlcPdusToRlc.
     if ( retxBufferSize + txedBufferSize > 0 ){
-      std::vector< LteRlcAm::RetxPdu > sortedTxedRetxBuffer;
       if (retxBufferSize == 0){
-        sortedTxedRetxBuffer = txedBuffer;
+        rlcAm->RlcPdusToRlcSdus(txedBuffer);
       }
       else if (txedBufferSize == 0){
-        sortedTxedRetxBuffer = retxBuffer;
+        rlcAm->RlcPdusToRlcSdus(retxBuffer);
       }
       else {
-        sortedTxedRetxBuffer = MergeBuffers(txedBuffer, retxBuffer);
+        rlcAm->RlcPdusToRlcSdus(MergeBuffers(txedBuffer, retxBuffer));
       }
-      rlcAm->RlcPdusToRlcSdus(sortedTxedRetxBuffer);
     }
 
     //Construct the forwarding buffer
@@ -944,7 +952,7 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTei
     //{
       LtePdcpHeader pdcpHeader;
       uint32_t pos = 0;
-      for (std::vector< Ptr<Packet> >::iterator it = txonBuffer.begin(); it != txonBuffer.end(); ++it)
+      for (LteRlc::TxBuffer::iterator it = txonBuffer.begin(); it != txonBuffer.end(); ++it)
       {
         pos++;
         if((*it)->GetSize() > 3)
@@ -963,10 +971,10 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTei
       if ( rlcAm->GetTransmittingRlcSduBufferSize() > 0 )
       { //something inside the RLC AM's transmitting buffer
         NS_LOG_DEBUG ("ADDING TRANSMITTING SDUS OF RLC AM TO X2FORWARDINGBUFFER... Size = " << rlcAm->GetTransmittingRlcSduBufferSize() );
-        //copy the RlcSdu buffer (map) to forwardingBuffer.
-        std::map < uint32_t, Ptr<Packet> > rlcAmTransmittingBuffer = rlcAm->GetTransmittingRlcSduBuffer();
+        //add the SDUs of the RlcSdu buffer (map) to forwardingBuffer, by reference.
+        const std::map < uint32_t, Ptr<Packet> > &rlcAmTransmittingBuffer = rlcAm->GetTransmittingRlcSduBuffer();
         NS_LOG_DEBUG (" *** SIZE = " << rlcAmTransmittingBuffer.size());
-        for (std::map< uint32_t, Ptr<Packet> >::iterator it = rlcAmTransmittingBuffer.begin(); it != rlcAmTransmittingBuffer.end(); ++it)
+        for (std::map< uint32_t, Ptr<Packet> >::const_iterator it = rlcAmTransmittingBuffer.begin(); it != rlcAmTransmittingBuffer.end(); ++it)
         {
           if (it->second != 0)
           {
@@ -982,17 +990,17 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTei
           segmentedRlcsdu->PeekHeader(pdcpHeader);
           NS_LOG_DEBUG(this << "SegmentedRlcSdu = " << segmentedRlcsdu->GetSize() << " SEQ = " << pdcpHeader.GetSequenceNumber());
           //insert the complete version of the fragmented SDU to the front of txonBuffer.
-          txonBuffer.insert(txonBuffer.begin(),segmentedRlcsdu);
+          txonBuffer.push_front(segmentedRlcsdu);
         }
         m_x2forwardingBuffer.insert(m_x2forwardingBuffer.end(), txonBuffer.begin(), txonBuffer.end());
         m_x2forwardingBufferSize += rlcAm->GetTransmittingRlcSduBufferSize() + txonBufferSize;
 
         //Get the rlcAm
-        std::vector < Ptr <Packet> > rlcAmTxedSduBuffer = rlcAm->GetTxedRlcSduBuffer();
+        const std::vector < Ptr <Packet> > &rlcAmTxedSduBuffer = rlcAm->GetTxedRlcSduBuffer();
         LtePdcpHeader pdcpHeader_1;
-        m_x2forwardingBuffer.at(0)->PeekHeader(pdcpHeader_1);
+        m_x2forwardingBuffer.front()->PeekHeader(pdcpHeader_1);
         uint16_t i = 0;
-        for (std::vector< Ptr<Packet> >::iterator it = rlcAmTxedSduBuffer.begin(); it != rlcAmTxedSduBuffer.end(); ++it)
+        for (std::vector< Ptr<Packet> >::const_iterator it = rlcAmTxedSduBuffer.begin(); it != rlcAmTxedSduBuffer.end(); ++it)
         {
           if ((*it) != NULL)
           {
@@ -1011,9 +1019,10 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTei
 
       }
       else
-      { //TransmittingBuffer is empty. Only copy TxonBuffer.
+      { //TransmittingBuffer is empty. Only move TxonBuffer.
         NS_LOG_DEBUG(this << " ADDING TXONBUFFER OF RLC AM " << m_rnti << " Size = " << txonBufferSize) ;
-        m_x2forwardingBuffer = txonBuffer;
+        m_x2forwardingBuffer.clear ();
+        m_x2forwardingBuffer.swap (txonBuffer);
         m_x2forwardingBufferSize += txonBufferSize;
       }
     //}
@@ -1026,14 +1035,16 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTei
   {
     //Copy lte-rlc-um.m_txOnBuffer to X2 forwarding buffer.
     NS_LOG_DEBUG(this << " Copying txonBuffer from RLC UM " << m_rnti);
-    m_x2forwardingBuffer = rlc->GetObject<LteRlcUm>()->GetTxBuffer();
+    const LteRlc::TxBuffer &txBuffer = rlc->GetObject<LteRlcUm>()->GetTxBuffer();
+    m_x2forwardingBuffer.assign(txBuffer.begin(), txBuffer.end());
     m_x2forwardingBufferSize =  rlc->GetObject<LteRlcUm>()->GetTxBufferSize();
   }
   else if (0 != rlc->GetObject<LteRlcUmLowLat> ())
   {
     //Copy lte-rlc-um-low-lat.m_txOnBuffer to X2 forwarding buffer.
     NS_LOG_DEBUG(this << " Copying txonBuffer from RLC UM " << m_rnti);
-    m_x2forwardingBuffer = rlc->GetObject<LteRlcUmLowLat>()->GetTxBuffer();
+    const LteRlc::TxBuffer &txBuffer = rlc->GetObject<LteRlcUmLowLat>()->GetTxBuffer();
+    m_x2forwardingBuffer.assign(txBuffer.begin(), txBuffer.end());
     m_x2forwardingBufferSize =  rlc->GetObject<LteRlcUmLowLat>()->GetTxBufferSize();
   }
   //LteRlcAm m_txBuffer stores PDCP "PDU".
@@ -1058,8 +1069,10 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTei
     params.targetCellId = m_targetCellId;
     params.gtpTeid = gtpTeid;
     //Remove tags to get PDCP SDU from PDCP PDU.
-    //Ptr<Packet> rlcSdu =  (*(m_x2forwardingBuffer.begin()))->Copy();
-    Ptr<Packet> rlcSdu =  m_x2forwardingBuffer.at(0);
+    //the SDU is removed from the forwarding buffer before it is modified
+    Ptr<Packet> rlcSdu =  m_x2forwardingBuffer.front();
+    m_x2forwardingBufferSize -= rlcSdu->GetSize();
+    m_x2forwardingBuffer.pop_front ();
     //Tags to be removed from rlcSdu (from outer to inner)
     //LteRlcSduStatusTag rlcSduStatusTag;
     //RlcTag  rlcTag; //rlc layer timestamp
@@ -1082,6 +1095,8 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTei
         rlcSdu->RemoveAllPacketTags(); // this does not remove byte tags
         NS_LOG_LOGIC ("removed tags, size = " << rlcSdu->GetSize() );
         params.ueData = rlcSdu;
+        ++forwardedSdus;
+        forwardedBytes += rlcSdu->GetSize();
         /*
         rlcSdu->RemovePacketTag(rlcSduStatusTag); //remove Rlc status tag.
         NS_LOG_DEBUG ("removed rlc status tag, size = " << rlcSdu->GetSize() );
@@ -1136,10 +1151,12 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTei
     {
       NS_LOG_UNCOND("Too small, not forwarded");
     }
-    m_x2forwardingBufferSize -= (*(m_x2forwardingBuffer.begin()))->GetSize();
-    m_x2forwardingBuffer.erase (m_x2forwardingBuffer.begin());
     NS_LOG_LOGIC(this << " After forwarding: buffer size = " << m_x2forwardingBufferSize );
   }
+
+  int64_t wallClockNs = std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - wallClockStart).count ();
+  m_rrc->m_rlcBufferForwardingTrace (m_imsi, m_rrc->m_cellId, mcLteToMmWaveForwarding ? m_mmWaveCellId : m_targetCellId,
+                                     forwardedSdus, forwardedBytes, Simulator::Now () - m_forwardingStartTime, wallClockNs);
 }
 
 
@@ -1968,6 +1985,7 @@ UeManager::SendRrcConnectionSwitch(bool useMmWaveConnection)
 {
   LteRrcSap::RrcConnectionSwitch msg;
   msg.rrcTransactionIdentifier = GetNewRrcTransactionIdentifier();
+  m_forwardingStartTime = Simulator::Now ();
   std::vector<uint8_t> drbidVector;
   for (std::map <uint8_t, Ptr<LteDataRadioBearerInfo> >::iterator it =  m_drbMap.begin ();
      it != m_drbMap.end ();
@@ -2085,6 +2103,7 @@ UeManager::RecvConnectionSwitchToMmWave (bool useMmWaveConnection, uint8_t drbid
   NS_LOG_INFO("RecvConnectionSwitchToMmWave on cell " << m_rrc->m_cellId << " switch " << useMmWaveConnection << " for drbid " << (uint32_t)drbid);
   if(!useMmWaveConnection)
   {
+    m_forwardingStartTime = Simulator::Now ();
     //Ptr<RlcBearerInfo> rlcInfo = m_rlcMap.find(drbid)->second;
     m_targetCellId = m_rrc->m_lteCellId;
     ForwardRlcBuffers(m_rlcMap.find(drbid)->second->m_rlc, 0, m_rlcMap.find(drbid)->second->gtpTeid, 0, 0, 0);
@@ -2448,7 +2467,7 @@ UeManager::SwitchToState (State newState)
             {
               uint16_t maxSinrCellId = m_rrc->m_bestMmWaveCellForImsiMap.at(m_imsi);
               // get the SINR
-              double maxSinrDb = 10*std::log10(m_rrc->m_imsiCellSinrMap.find(m_imsi)->second.find(maxSinrCellId)->second);
+              double maxSinrDb = 10*std::log10(m_rrc->GetMmWaveSinr(m_imsi, maxSinrCellId));
               if(maxSinrDb > m_rrc->m_outageThreshold)
               {
                 // there is a MmWave cell to which the UE can connect
@@ -2693,7 +2712,6 @@ LteEnbRrc::LteEnbRrc ()
   m_s1SapUser = new MemberEpcEnbS1SapUser<LteEnbRrc> (this);
   m_cphySapUser.push_back (new MemberLteEnbCphySapUser<LteEnbRrc> (this));
 
-  m_imsiCellSinrMap.clear();
   m_x2_received_cnt = 0;
   m_switchEnabled = true;
   m_lteCellId = 0;
@@ -2989,6 +3007,18 @@ LteEnbRrc::GetTypeId (void)
             BooleanValue (true),
             MakeBooleanAccessor (&LteEnbRrc::m_reportAllUeMeas),
             MakeBooleanChecker ())
+   .AddAttribute ("DeltaSinrReports",
+            "If true, the MmWave eNB sends to the LTE coordinator only the SINR values whose quantized value "
+            "changed since the last report, as dB values quantized with SinrReportQuantizationStep. "
+            "If false, it sends all the values in double precision",
+            BooleanValue (false),
+            MakeBooleanAccessor (&LteEnbRrc::m_deltaSinrReports),
+            MakeBooleanChecker ())
+   .AddAttribute ("SinrReportQuantizationStep",
+            "The quantization step of the SINR values sent to the LTE coordinator if DeltaSinrReports is true [dB]",
+            DoubleValue (0.1),
+            MakeDoubleAccessor (&LteEnbRrc::m_sinrReportQuantizationStep),
+            MakeDoubleChecker<double> (0.001, 1000))
     // Trace sources
     .AddTraceSource ("NewUeContext",
                      "Fired upon creation of a new UE context.",
@@ -3018,6 +3048,11 @@ LteEnbRrc::GetTypeId (void)
                   "trace fired when measurement report is received from mmWave cells, for each cell, for each UE",
                   MakeTraceSourceAccessor (&LteEnbRrc::m_notifyMmWaveSinrTrace),
                 "ns3::LteEnbRrc::NotifyMmWaveSinrTracedCallback")
+    .AddTraceSource ("RlcBufferForwarding",
+                     "trace fired when the RLC buffer of a bearer has been forwarded "
+                     "during a handover or a switch between LTE and mmWave",
+                     MakeTraceSourceAccessor (&LteEnbRrc::m_rlcBufferForwardingTrace),
+                     "ns3::LteEnbRrc::RlcBufferForwardingTracedCallback")
   ;
   return tid;
 }
@@ -3466,7 +3501,6 @@ LteEnbRrc::ConfigureCell (std::map<uint8_t, Ptr<ComponentCarrierEnb>> ccPhyConf)
    * SystemInformationPeriodicity attribute to configure this).
    */
   Simulator::Schedule (MilliSeconds (16), &LteEnbRrc::SendSystemInformation, this);
-  m_imsiCellSinrMap.clear();
   m_firstReport = true;
   m_configured = true;
 
@@ -3557,7 +3591,6 @@ LteEnbRrc::ConfigureCell (std::map<uint8_t, MmWaveComponentCarrierConf> ccPhyCon
    */
    // mmWave module: Changed scheduling of initial system information to +2ms
   Simulator::Schedule (MilliSeconds (m_firstSibTime), &LteEnbRrc::SendSystemInformation, this);
-  m_imsiCellSinrMap.clear();
   m_firstReport = true;
   m_configured = true;
 
@@ -3653,6 +3686,28 @@ LteEnbRrc::DoUpdateUeSinrEstimate(LteEnbCphySapUser::UeAssociatedSinrInfo info)
       }
     }
 
+    params.quantizationStep = 0;
+    if(m_deltaSinrReports)
+    {
+      // send only the values whose quantized value changed since the last report
+      params.quantizationStep = m_sinrReportQuantizationStep;
+      std::map<uint64_t, double>::iterator ue = params.ueImsiSinrMap.begin();
+      while(ue != params.ueImsiSinrMap.end())
+      {
+        int16_t value = EpcX2UeImsiSinrDeltaUpdateHeader::QuantizeSinr(ue->second, m_sinrReportQuantizationStep);
+        std::pair<std::map<uint64_t, int16_t>::iterator, bool> last = m_lastReportedSinr.insert(std::make_pair(ue->first, value));
+        if(!last.second && last.first->second == value)
+        {
+          ue = params.ueImsiSinrMap.erase(ue);
+        }
+        else
+        {
+          last.first->second = value;
+          ++ue;
+        }
+      }
+    }
+
     NS_LOG_INFO("number of SINR reported " << params.ueImsiSinrMap.size());
     m_x2SapProvider->SendUeSinrUpdate (params);
   }
@@ -3665,18 +3720,10 @@ LteEnbRrc::DoRecvUeSinrUpdate(EpcX2SapUser::UeImsiSinrParams params)
   NS_LOG_FUNCTION(this);
   NS_LOG_LOGIC("Recv Ue SINR Update from cell " << params.sourceCellId);
   uint16_t mmWaveCellId = params.sourceCellId;
-  if(m_cellSinrMap.find(mmWaveCellId) != m_cellSinrMap.end())
-  {     // update the entry
-    m_cellSinrMap[mmWaveCellId] = params.ueImsiSinrMap;
-    m_numNewSinrReports++;
-  }
-  else  // add the entry
-  {
-    m_cellSinrMap.insert(std::pair<uint16_t, ImsiSinrMap> (mmWaveCellId, params.ueImsiSinrMap));
-    m_numNewSinrReports++;
-  }
-  // cycle on all the Imsi whose SINR is known in cell mmWaveCellId
-  for(std::map<uint64_t, double>::iterator imsiIter = params.ueImsiSinrMap.begin(); imsiIter != params.ueImsiSinrMap.end(); ++imsiIter)
+  m_numNewSinrReports++;
+  // cycle on all the Imsi whose SINR is known in cell mmWaveCellId. A delta report
+  // contains only the changed values, the others keep the last reported value
+  for(std::map<uint64_t, double>::const_iterator imsiIter = params.ueImsiSinrMap.begin(); imsiIter != params.ueImsiSinrMap.end(); ++imsiIter)
   {
     uint64_t imsi = imsiIter->first;
     double sinr = imsiIter->second;
@@ -3685,34 +3732,7 @@ LteEnbRrc::DoRecvUeSinrUpdate(EpcX2SapUser::UeImsiSinrParams params)
 
     NS_LOG_LOGIC("Imsi " << imsi << " sinr " << sinr);
 
-    if(m_imsiCellSinrMap.find(imsi) != m_imsiCellSinrMap.end())
-    {
-      if(m_imsiCellSinrMap[imsi].find(mmWaveCellId) != m_imsiCellSinrMap[imsi].end())
-      {
-        // update the SINR measure
-        m_imsiCellSinrMap[imsi].find(mmWaveCellId)->second = sinr;
-      }
-      else // new cell for this Imsi
-      {
-        // insert a new SINR measure
-        m_imsiCellSinrMap[imsi].insert(std::pair<uint16_t, double>(mmWaveCellId, sinr));
-      }
-    }
-    else // new imsi
-    {
-      CellSinrMap map;
-      map.insert(std::pair<uint16_t, double>(mmWaveCellId, sinr));
-      m_imsiCellSinrMap.insert(std::pair<uint64_t, CellSinrMap> (imsi, map));
-    }
-  }
-
-  for(std::map<uint64_t, CellSinrMap>::iterator imsiIter = m_imsiCellSinrMap.begin(); imsiIter != m_imsiCellSinrMap.end(); ++imsiIter)
-  {
-    NS_LOG_LOGIC("Imsi " << imsiIter->first);
-    for(CellSinrMap::iterator cellIter = imsiIter->second.begin(); cellIter != imsiIter->second.end(); ++cellIter)
-    {
-      NS_LOG_LOGIC("mmWaveCell " << cellIter->first << " sinr " <<  cellIter->second);
-    }
+    SetMmWaveSinr(imsi, mmWaveCellId, sinr);
   }
 
   if(!m_ismmWave && !m_interRatHoMode && m_firstReport)
@@ -3735,9 +3755,149 @@ LteEnbRrc::DoRecvUeSinrUpdate(EpcX2SapUser::UeImsiSinrParams params)
 }
 
 void
-LteEnbRrc::TttBasedHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
+LteEnbRrc::SetMmWaveSinr(uint64_t imsi, uint16_t cellId, double sinr)
+{
+  uint32_t column;
+  std::unordered_map<uint16_t, uint32_t>::const_iterator cellIt = m_sinrColumnOfCell.find(cellId);
+  if(cellIt != m_sinrColumnOfCell.end())
+  {
+    column = cellIt->second;
+  }
+  else // new cell, widen the matrix
+  {
+    uint32_t oldColumns = m_sinrColumnCell.size();
+    column = oldColumns;
+    m_sinrColumnOfCell[cellId] = column;
+    m_sinrColumnCell.push_back(cellId);
+    std::vector<double> matrix(m_sinrRowImsi.size() * (oldColumns + 1), 0.0);
+    for(uint32_t row = 0; row < m_sinrRowImsi.size(); ++row)
+    {
+      std::copy(m_sinrMatrix.begin() + row * oldColumns, m_sinrMatrix.begin() + (row + 1) * oldColumns,
+        matrix.begin() + row * (oldColumns + 1));
+    }
+    m_sinrMatrix.swap(matrix);
+  }
+
+  uint32_t row;
+  std::unordered_map<uint64_t, uint32_t>::const_iterator imsiIt = m_sinrRowOfImsi.find(imsi);
+  if(imsiIt != m_sinrRowOfImsi.end())
+  {
+    row = imsiIt->second;
+  }
+  else // new imsi, add a row
+  {
+    row = m_sinrRowImsi.size();
+    m_sinrRowOfImsi[imsi] = row;
+    m_sinrRowImsi.push_back(imsi);
+    std::vector<uint32_t>::iterator pos = m_sinrRowsByImsi.begin();
+    while(pos != m_sinrRowsByImsi.end() && m_sinrRowImsi[*pos] < imsi)
+    {
+      ++pos;
+    }
+    m_sinrRowsByImsi.insert(pos, row);
+    m_sinrRowUpdated.push_back(true);
+    m_sinrRowState.push_back(UeAssociationState());
+    m_sinrMatrix.resize(m_sinrMatrix.size() + m_sinrColumnCell.size(), 0.0);
+  }
+
+  m_sinrMatrix[row * m_sinrColumnCell.size() + column] = sinr;
+  m_sinrRowUpdated[row] = true;
+}
+
+double
+LteEnbRrc::GetMmWaveSinr(uint64_t imsi, uint16_t cellId) const
+{
+  std::unordered_map<uint64_t, uint32_t>::const_iterator imsiIt = m_sinrRowOfImsi.find(imsi);
+  std::unordered_map<uint16_t, uint32_t>::const_iterator cellIt = m_sinrColumnOfCell.find(cellId);
+  if(imsiIt == m_sinrRowOfImsi.end() || cellIt == m_sinrColumnOfCell.end())
+  {
+    return 0;
+  }
+  return m_sinrMatrix[imsiIt->second * m_sinrColumnCell.size() + cellIt->second];
+}
+
+void
+LteEnbRrc::FindMaxSinrCell(uint32_t row, uint16_t currentCellId, long double &maxSinr,
+                           uint16_t &maxSinrCellId, long double &currentSinr) const
+{
+  uint32_t columns = m_sinrColumnCell.size();
+  const double *sinrRow = m_sinrMatrix.data() + row * columns;
+  maxSinr = 0;
+  maxSinrCellId = 0;
+  currentSinr = 0;
+  for(uint32_t column = 0; column < columns; ++column)
+  {
+    double sinr = sinrRow[column];
+    uint16_t cellId = m_sinrColumnCell[column];
+    // the columns are not sorted by CellId: on ties, prefer the lowest CellId,
+    // as when the cells are visited in increasing order
+    if(sinr > maxSinr || (sinr == maxSinr && sinr > 0 && cellId < maxSinrCellId))
+    {
+      maxSinr = sinr;
+      maxSinrCellId = cellId;
+    }
+    if(cellId == currentCellId)
+    {
+      currentSinr = sinr;
+    }
+  }
+}
+
+bool
+LteEnbRrc::UeAssociationState::operator== (const UeAssociationState &other) const
+{
+  return associated == other.associated && setupCompleted == other.setupCompleted
+         && usingLte == other.usingLte && lastMmWaveCell == other.lastMmWaveCell
+         && rnti == other.rnti && allMmWaveInOutage == other.allMmWaveInOutage
+         && handoverScheduled == other.handoverScheduled;
+}
+
+LteEnbRrc::UeAssociationState
+LteEnbRrc::GetUeAssociationState(uint64_t imsi)
+{
+  UeAssociationState state;
+  std::map<uint64_t, bool>::const_iterator setupIt = m_mmWaveCellSetupCompleted.find(imsi);
+  state.associated = (setupIt != m_mmWaveCellSetupCompleted.end());
+  state.setupCompleted = state.associated && setupIt->second;
+  std::map<uint64_t, bool>::const_iterator lteIt = m_imsiUsingLte.find(imsi);
+  state.usingLte = (lteIt != m_imsiUsingLte.end()) && lteIt->second;
+  std::map<uint64_t, uint16_t>::const_iterator cellIt = m_lastMmWaveCell.find(imsi);
+  state.lastMmWaveCell = (cellIt != m_lastMmWaveCell.end()) ? cellIt->second : 0;
+  state.rnti = GetRntiFromImsi(imsi);
+  std::map<uint16_t, Ptr<UeManager> >::const_iterator ueIt = m_ueMap.find(state.rnti);
+  state.allMmWaveInOutage = (ueIt != m_ueMap.end()) && ueIt->second->GetAllMmWaveInOutageAtInitialAccess();
+  state.handoverScheduled = (m_imsiHandoverEventsMap.find(imsi) != m_imsiHandoverEventsMap.end());
+  return state;
+}
+
+bool
+LteEnbRrc::IsUeAssociationUpdateNeeded(uint32_t row)
+{
+  if(m_sinrRowUpdated[row])
+  {
+    return true;
+  }
+  UeAssociationState state = GetUeAssociationState(m_sinrRowImsi[row]);
+  // the evaluation also depends on the current time when a TTT handover is
+  // scheduled, and repeats the connection command while the UE waits for
+  // its first mmWave cell
+  if(state.handoverScheduled || (state.usingLte && state.allMmWaveInOutage))
+  {
+    return true;
+  }
+  return !(state == m_sinrRowState[row]);
+}
+
+void
+LteEnbRrc::SetUeAssociationEvaluated(uint32_t row)
+{
+  m_sinrRowUpdated[row] = false;
+  m_sinrRowState[row] = GetUeAssociationState(m_sinrRowImsi[row]);
+}
+
+void
+LteEnbRrc::TttBasedHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
 {
-  uint64_t imsi = imsiIter->first;
   bool alreadyAssociatedImsi = false;
   bool onHandoverImsi = true;
   // On RecvRrcConnectionRequest for a new RNTI, the Lte Enb RRC stores the imsi
@@ -3762,7 +3922,7 @@ LteEnbRrc::TttBasedHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter,
   double currentSinrDb = 0;
   if(alreadyAssociatedImsi && m_lastMmWaveCell.find(imsi) != m_lastMmWaveCell.end())
   {
-    currentSinrDb = 10*std::log10(m_imsiCellSinrMap.find(imsi)->second[m_lastMmWaveCell[imsi]]);
+    currentSinrDb = 10*std::log10(GetMmWaveSinr(imsi, m_lastMmWaveCell[imsi]));
     NS_LOG_DEBUG("Current SINR " << currentSinrDb);
   }
 
@@ -3853,7 +4013,7 @@ LteEnbRrc::TttBasedHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter,
         uint16_t targetCellId = handoverEvent->second.targetCellId;
         NS_LOG_INFO("------ Handover was scheduled for " << handoverEvent->second.targetCellId << " but now maxSinrCellId is " << maxSinrCellId);
         //  get the SINR for the scheduled targetCellId: if the diff is smaller than 3 dB handover anyway
-        double originalTargetSinrDb = 10*std::log10(m_imsiCellSinrMap.find(imsi)->second[targetCellId]);
+        double originalTargetSinrDb = 10*std::log10(GetMmWaveSinr(imsi, targetCellId));
         if(maxSinrDb - originalTargetSinrDb > m_sinrThresholdDifference) // this parameter is the same as the one for ThresholdBasedSecondaryCellHandover
         {
           // delete this event
@@ -4018,9 +4178,8 @@ LteEnbRrc::PerformHandover(uint64_t imsi)
 }
 
 void
-LteEnbRrc::ThresholdBasedSecondaryCellHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
+LteEnbRrc::ThresholdBasedSecondaryCellHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
 {
-  uint64_t imsi = imsiIter->first;
   bool alreadyAssociatedImsi = false;
   bool onHandoverImsi = true;
   // On RecvRrcConnectionRequest for a new RNTI, the Lte Enb RRC stores the imsi
@@ -4132,11 +4291,18 @@ LteEnbRrc::ThresholdBasedSecondaryCellHandover(std::map<uint64_t, CellSinrMap>::
 void
 LteEnbRrc::TriggerUeAssociationUpdate()
 {
-  if(m_imsiCellSinrMap.size() > 0) // there are some entries
+  if(m_sinrRowImsi.size() > 0) // there are some entries
   {
-    for(std::map<uint64_t, CellSinrMap>::iterator imsiIter = m_imsiCellSinrMap.begin(); imsiIter != m_imsiCellSinrMap.end(); ++imsiIter)
+    // visit the UEs in increasing imsi order
+    for(std::vector<uint32_t>::const_iterator rowIter = m_sinrRowsByImsi.begin(); rowIter != m_sinrRowsByImsi.end(); ++rowIter)
     {
-      uint64_t imsi = imsiIter->first;
+      uint32_t row = *rowIter;
+      uint64_t imsi = m_sinrRowImsi[row];
+      if(!IsUeAssociationUpdateNeeded(row))
+      {
+        // neither the SINR nor the association of the UE changed since the last evaluation
+        continue;
+      }
       long double maxSinr = 0;
       long double currentSinr = 0;
       uint16_t maxSinrCellId = 0;
@@ -4161,19 +4327,7 @@ LteEnbRrc::TriggerUeAssociationUpdate()
       }
       NS_LOG_INFO("alreadyAssociatedImsi " << alreadyAssociatedImsi << " onHandoverImsi " << onHandoverImsi);
 
-      for(CellSinrMap::iterator cellIter = imsiIter->second.begin(); cellIter != imsiIter->second.end(); ++cellIter)
-      {
-        NS_LOG_INFO("Cell " << cellIter->first << " reports " << 10*std::log10(cellIter->second));
-        if(cellIter->second > maxSinr)
-        {
-          maxSinr = cellIter->second;
-          maxSinrCellId = cellIter->first;
-        }
-        if(m_lastMmWaveCell[imsi] == cellIter->first)
-        {
-          currentSinr = cellIter->second;
-        }
-      }
+      FindMaxSinrCell(row, m_lastMmWaveCell[imsi], maxSinr, maxSinrCellId, currentSinr);
       long double sinrDifference = std::abs(10*(std::log10((long double)maxSinr) - std::log10((long double)currentSinr)));
       long double maxSinrDb = 10*std::log10((long double)maxSinr);
       long double currentSinrDb = 10*std::log10((long double)currentSinr);
@@ -4216,17 +4370,18 @@ LteEnbRrc::TriggerUeAssociationUpdate()
         m_bestMmWaveCellForImsiMap[imsi] = maxSinrCellId;
         if(m_handoverMode == THRESHOLD)
         {
-          ThresholdBasedSecondaryCellHandover(imsiIter, sinrDifference, maxSinrCellId, maxSinrDb);
+          ThresholdBasedSecondaryCellHandover(imsi, sinrDifference, maxSinrCellId, maxSinrDb);
         }
         else if(m_handoverMode == FIXED_TTT || m_handoverMode == DYNAMIC_TTT)
         {
-          TttBasedHandover(imsiIter, sinrDifference, maxSinrCellId, maxSinrDb);
+          TttBasedHandover(imsi, sinrDifference, maxSinrCellId, maxSinrDb);
         }
         else
         {
           NS_FATAL_ERROR("Unsupported HO mode");
         }
       }
+      SetUeAssociationEvaluated(row);
     }
   }
 
@@ -4234,9 +4389,8 @@ LteEnbRrc::TriggerUeAssociationUpdate()
 }
 
 void
-LteEnbRrc::ThresholdBasedInterRatHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
+LteEnbRrc::ThresholdBasedInterRatHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
 {
-  uint64_t imsi = imsiIter->first;
   bool alreadyAssociatedImsi = false;
   bool onHandoverImsi = true;
   // On RecvRrcConnectionRequest for a new RNTI, the Lte Enb RRC stores the imsi
@@ -4320,11 +4474,18 @@ void
 LteEnbRrc::UpdateUeHandoverAssociation()
 {
   // TODO rules for possible ho of each UE
-  if(m_imsiCellSinrMap.size() > 0) // there are some entries
+  if(m_sinrRowImsi.size() > 0) // there are some entries
   {
-    for(std::map<uint64_t, CellSinrMap>::iterator imsiIter = m_imsiCellSinrMap.begin(); imsiIter != m_imsiCellSinrMap.end(); ++imsiIter)
+    // visit the UEs in increasing imsi order
+    for(std::vector<uint32_t>::const_iterator rowIter = m_sinrRowsByImsi.begin(); rowIter != m_sinrRowsByImsi.end(); ++rowIter)
     {
-      uint64_t imsi = imsiIter->first;
+      uint32_t row = *rowIter;
+      uint64_t imsi = m_sinrRowImsi[row];
+      if(!IsUeAssociationUpdateNeeded(row))
+      {
+        // neither the SINR nor the association of the UE changed since the last evaluation
+        continue;
+      }
       long double maxSinr = 0;
       long double currentSinr = 0;
       uint16_t maxSinrCellId = 0;
@@ -4347,19 +4508,7 @@ LteEnbRrc::UpdateUeHandoverAssociation()
       }
       NS_LOG_INFO("alreadyAssociatedImsi " << alreadyAssociatedImsi << " onHandoverImsi " << onHandoverImsi);
 
-      for(CellSinrMap::iterator cellIter = imsiIter->second.begin(); cellIter != imsiIter->second.end(); ++cellIter)
-      {
-        NS_LOG_INFO("Cell " << cellIter->first << " reports " << 10*std::log10(cellIter->second));
-        if(cellIter->second > maxSinr)
-        {
-          maxSinr = cellIter->second;
-          maxSinrCellId = cellIter->first;
-        }
-        if(m_lastMmWaveCell[imsi] == cellIter->first)
-        {
-          currentSinr = cellIter->second;
-        }
-      }
+      FindMaxSinrCell(row, m_lastMmWaveCell[imsi], maxSinr, maxSinrCellId, currentSinr);
 
       long double sinrDifference = std::abs(10*(std::log10((long double)maxSinr) - std::log10((long double)currentSinr)));
       long double maxSinrDb = 10*std::log10((long double)maxSinr);
@@ -4409,18 +4558,19 @@ LteEnbRrc::UpdateUeHandoverAssociation()
       {
         if(m_handoverMode == THRESHOLD)
         {
-          ThresholdBasedInterRatHandover(imsiIter, sinrDifference, maxSinrCellId, maxSinrDb);
+          ThresholdBasedInterRatHandover(imsi, sinrDifference, maxSinrCellId, maxSinrDb);
         }
         else if(m_handoverMode == FIXED_TTT || m_handoverMode == DYNAMIC_TTT)
         {
           m_bestMmWaveCellForImsiMap[imsi] = maxSinrCellId;
-          TttBasedHandover(imsiIter, sinrDifference, maxSinrCellId, maxSinrDb);
+          TttBasedHandover(imsi, sinrDifference, maxSinrCellId, maxSinrDb);
         }
         else
         {
           NS_FATAL_ERROR("Unsupported HO mode");
         }
       }
+      SetUeAssociationEvaluated(row);
     }
   }
   Simulator::Schedule(MicroSeconds(m_crtPeriod), &LteEnbRrc::UpdateUeHandoverAssociation, this);
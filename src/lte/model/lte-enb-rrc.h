@@ -57,6 +57,7 @@
 
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <ns3/component-carrier-enb.h>
 #include <vector>
 
@@ -446,10 +447,13 @@ public:
 
 private:
   //Lossless HO: merge 2 buffers into 1 with increment order.
-  std::vector < LteRlcAm::RetxPdu > MergeBuffers(std::vector < LteRlcAm::RetxPdu > first, std::vector < LteRlcAm::RetxPdu > second);
+  std::vector < LteRlcAm::RetxPdu > MergeBuffers(const std::vector < LteRlcAm::RetxPdu > &first, const std::vector < LteRlcAm::RetxPdu > &second);
   /**
    * Forward the content of RLC buffers. For RLC UM and UM LowLat, forward txBuffer.
-   * For RLC AM, forward the merge of retx and txed buffers, and txBuffer
+   * For RLC AM, forward the merge of retx and txed buffers, and txBuffer.
+   * The SDUs are moved to the forwarding buffer by reference, i.e., only the
+   * pointers are copied, and the RlcBufferForwarding trace of LteEnbRrc is
+   * fired once the buffer has been forwarded
    * @param the RLC entity
    * @param the PDCP entity, if the mcLteToMmWaveForwarding is false it can be 0
    * @param the gtpTeid that identifies the X2 connection to be used
@@ -682,8 +686,9 @@ private:
    */
   EventId m_handoverLeavingTimeout;
 
-  std::vector < Ptr<Packet> > m_x2forwardingBuffer;
+  LteRlc::TxBuffer m_x2forwardingBuffer; ///< SDUs to be forwarded to the target cell, in order
   uint32_t m_x2forwardingBufferSize;
+  Time m_forwardingStartTime; ///< time at which the handover or switch that forwards the RLC buffers started
   uint32_t m_maxx2forwardingBufferSize;
 
   // this variable is set to true if on initial access, for mc devices, all the mmWave eNBs are in outage
@@ -1240,6 +1245,23 @@ public:
    typedef void (* NotifyMmWaveSinrTracedCallback)
      (uint64_t imsi, uint16_t cellId, long double sinr);
 
+  /**
+   * TracedCallback signature for the forwarding of an RLC buffer.
+   *
+   * \param [in] imsi
+   * \param [in] cellId the cell that forwards the buffer
+   * \param [in] targetCid the cell that receives the buffer
+   * \param [in] sdus the number of forwarded SDUs
+   * \param [in] bytes the size of the forwarded PDCP PDUs
+   * \param [in] delay the simulated time elapsed since the start of the
+   *              handover or switch
+   * \param [in] wallClockNs the wall-clock time spent forwarding, in nanoseconds
+   */
+  typedef void (*RlcBufferForwardingTracedCallback)
+    (const uint64_t imsi, const uint16_t cellId, const uint16_t targetCid,
+     const uint32_t sdus, const uint32_t bytes, const Time delay,
+     const int64_t wallClockNs);
+
    /**
     * Different secondary cell handover modes
     */
@@ -1629,21 +1651,21 @@ private:
 
   /**
    * Trigger an handover according to certain conditions on the SINR
-   * @params the iterator on m_imsiCellSinrMap
+   * @params the imsi of the UE
    * @params the sinrDifference between the current and the maxSinr cell
    * @params the CellId of the maximum SINR cell
    * @params the value of the SINR for this cell
    */
-  void ThresholdBasedSecondaryCellHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
+  void ThresholdBasedSecondaryCellHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
 
     /**
    * Trigger an handover according to certain conditions on the SINR and the TTT
-   * @params the iterator on m_imsiCellSinrMap
+   * @params the imsi of the UE
    * @params the sinrDifference between the current and the maxSinr cell
    * @params the CellId of the maximum SINR cell
    * @params the value of the SINR for this cell
    */
-  void TttBasedHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
+  void TttBasedHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
 
   /**
    * Compute the TTT according to the sinrDifference and the dynamic handover algorithm
@@ -1664,12 +1686,87 @@ private:
 
   /**
    * Trigger an handover according to certain conditions on the SINR (for single-connectivity devices)
-   * @params the iterator on m_imsiCellSinrMap
+   * @params the imsi of the UE
    * @params the sinrDifference between the current and the maxSinr cell
    * @params the CellId of the maximum SINR cell
    * @params the value of the SINR for this cell
    */
-  void ThresholdBasedInterRatHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
+  void ThresholdBasedInterRatHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
+
+  /**
+   * Store the SINR reported by a mmWave cell for a UE in the SINR matrix,
+   * adding a row and a column if the UE or the cell are new
+   * @params the imsi of the UE
+   * @params the CellId of the mmWave cell
+   * @params the SINR (linear)
+   */
+  void SetMmWaveSinr (uint64_t imsi, uint16_t cellId, double sinr);
+
+  /**
+   * Get the last SINR reported by a mmWave cell for a UE
+   * @params the imsi of the UE
+   * @params the CellId of the mmWave cell
+   * @return the SINR (linear), or 0 if the cell did not report it
+   */
+  double GetMmWaveSinr (uint64_t imsi, uint16_t cellId) const;
+
+  /**
+   * Find the mmWave cell with the maximum SINR in a row of the SINR matrix,
+   * and the SINR of the cell the UE is attached to
+   * @params the row of the UE
+   * @params the CellId of the current mmWave cell of the UE
+   * @params the maximum SINR (output)
+   * @params the CellId of the maximum SINR cell, 0 if no cell reports a positive SINR (output)
+   * @params the SINR of the current cell, 0 if it is not known (output)
+   */
+  void FindMaxSinrCell (uint32_t row, uint16_t currentCellId, long double &maxSinr,
+                        uint16_t &maxSinrCellId, long double &currentSinr) const;
+
+  /**
+   * The state of the association of a UE which, together with its row of
+   * the SINR matrix, determines the outcome of the association update
+   */
+  struct UeAssociationState
+  {
+    bool associated; ///< the UE has an entry in m_mmWaveCellSetupCompleted
+    bool setupCompleted; ///< the value of the entry in m_mmWaveCellSetupCompleted
+    bool usingLte; ///< the UE is using the LTE connection
+    uint16_t lastMmWaveCell; ///< the last mmWave cell of the UE
+    uint16_t rnti; ///< the RNTI of the UE in this cell
+    bool allMmWaveInOutage; ///< all the mmWave cells were in outage at the initial access
+    bool handoverScheduled; ///< a TTT handover event is scheduled for the UE
+
+    /**
+     * \param other the other state
+     * \return true if the two states are equal
+     */
+    bool operator== (const UeAssociationState &other) const;
+  };
+
+  /**
+   * \param imsi the imsi of the UE
+   * \return the current association state of the UE
+   */
+  UeAssociationState GetUeAssociationState (uint64_t imsi);
+
+  /**
+   * Check if the association of the UE in a row of the SINR matrix must be
+   * evaluated, i.e., if its SINR row was updated or its association state
+   * changed since the last evaluation. With the same inputs, the handover
+   * algorithms would take the same decision as in the last evaluation,
+   * which already took effect. UEs with a scheduled TTT handover, or still
+   * waiting for their first mmWave cell, are always evaluated.
+   * @params the row of the UE
+   * @return true if the association must be evaluated
+   */
+  bool IsUeAssociationUpdateNeeded (uint32_t row);
+
+  /**
+   * Mark the row as evaluated, storing the association state of the UE
+   * after the evaluation
+   * @params the row of the UE
+   */
+  void SetUeAssociationEvaluated (uint32_t row);
 
   Callback <void, Ptr<Packet> > m_forwardUpCallback;  ///< forward up callback function
 
@@ -1894,6 +1991,13 @@ private:
   TracedCallback<uint64_t, uint16_t, uint16_t, LteRrcSap::MeasurementReport> m_recvMeasurementReportTrace;
 
   TracedCallback<uint64_t, uint16_t, long double> m_notifyMmWaveSinrTrace;
+  /**
+   * The `RlcBufferForwarding` trace source. Fired when the RLC buffer of a
+   * bearer has been forwarded. Exporting IMSI, cell ID, target cell ID, number
+   * of SDUs, bytes, simulated time since the start of the handover or switch
+   * and wall-clock time spent forwarding.
+   */
+  TracedCallback<uint64_t, uint16_t, uint16_t, uint32_t, uint32_t, Time, int64_t> m_rlcBufferForwardingTrace;
 
   //mc
   bool m_ismmWave;
@@ -1905,15 +2009,30 @@ private:
   // for MmWave eNBs
   std::map<uint8_t, ImsiSinrMap> m_ueImsiSinrMap; // this map contains the ueImsiSinrMap reports sent by the CCs
   bool m_reportAllUeMeas; // if true, the MmWave eNB reports to the coordinator all the received UE measures, i.e. one per CC
+  bool m_deltaSinrReports; // if true, the MmWave eNB reports to the coordinator only the changed SINR values, quantized
+  double m_sinrReportQuantizationStep; // quantization step of the delta SINR reports [dB]
+  std::map<uint64_t, int16_t> m_lastReportedSinr; // last quantized SINR reported to the coordinator for each imsi
 
   // for LTE eNBs
-  std::map<uint16_t, ImsiSinrMap> m_cellSinrMap;
   uint16_t m_numNewSinrReports;
   std::map<uint64_t, uint16_t> m_bestMmWaveCellForImsiMap;
   std::map<uint64_t, uint16_t> m_lastMmWaveCell;
   std::map<uint64_t, bool> m_mmWaveCellSetupCompleted;
   std::map<uint64_t, bool> m_imsiUsingLte;
-  std::map<uint64_t, CellSinrMap> m_imsiCellSinrMap;
+  /*
+   * SINR reported by the mmWave cells for each UE, stored as a dense
+   * IMSI x cell matrix, row by row. Rows and columns are added in the order
+   * in which UEs and cells are first reported, and are never removed.
+   * A cell that did not report the SINR of a UE has a 0 entry.
+   */
+  std::vector<double> m_sinrMatrix;
+  std::unordered_map<uint64_t, uint32_t> m_sinrRowOfImsi; // row of each imsi
+  std::vector<uint64_t> m_sinrRowImsi; // imsi of each row
+  std::vector<uint32_t> m_sinrRowsByImsi; // rows, in increasing imsi order
+  std::unordered_map<uint16_t, uint32_t> m_sinrColumnOfCell; // column of each mmWave cell
+  std::vector<uint16_t> m_sinrColumnCell; // mmWave cell of each column
+  std::vector<bool> m_sinrRowUpdated; // the row was updated since the last evaluation
+  std::vector<UeAssociationState> m_sinrRowState; // association state after the last evaluation
   std::map<uint64_t, uint16_t> m_imsiRntiMap;
   std::map<uint16_t, uint64_t> m_rntiImsiMap;
 
@@ -28,6 +28,7 @@
 
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/profiler.h"
 #include "ns3/string.h"
 
 #include "ns3/lte-rlc-am-header.h"
@@ -762,7 +763,7 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
 
   m_txonBufferSize -= (*(m_txonBuffer.begin()))->GetSize ();
   NS_LOG_LOGIC ("txBufferSize      = " << m_txonBufferSize );
-  m_txonBuffer.erase (m_txonBuffer.begin ());
+  m_txonBuffer.pop_front ();
 
   while ( firstSegment && (firstSegment->GetSize () > 0) && (nextSegmentSize > 0) )
     {
@@ -818,14 +819,7 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
 
               // m_txonBuffer.insert (m_txonBuffer.begin (), firstSegment);
 
-              if(m_txonBuffer.empty())
-              {
-                m_txonBuffer.push_back(firstSegment);
-              }
-              else
-              {
-                m_txonBuffer.insert (m_txonBuffer.begin (), firstSegment);
-              }
+              m_txonBuffer.push_front (firstSegment);
 
               m_txonBufferSize += (*(m_txonBuffer.begin()))->GetSize ();
 
@@ -957,7 +951,7 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
           entireSdu = (*(m_txonBuffer.begin ()))->Copy ();
 
           m_txonBufferSize -= (*(m_txonBuffer.begin()))->GetSize ();
-          m_txonBuffer.erase (m_txonBuffer.begin ());
+          m_txonBuffer.pop_front ();
           NS_LOG_LOGIC ("        txBufferSize = " << m_txonBufferSize );
         }
     }
@@ -1105,14 +1099,13 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
   m_macSapProvider->TransmitPdu (params);
 }
 
-std::vector < Ptr<Packet> >
+LteRlc::TxBuffer
 LteRlcAm::GetTxBuffer()
 {
-  std::vector < Ptr<Packet> > toBeReturned;
+  TxBuffer toBeReturned;
   if(!m_enableAqm)
   {
-    toBeReturned.insert(toBeReturned.begin(), m_txonBuffer.begin(), m_txonBuffer.end());
-    m_txonBuffer.clear();
+    toBeReturned.swap(m_txonBuffer);
     m_txonBufferSize = 0;
   }
   else
@@ -1129,11 +1122,9 @@ uint32_t LteRlcAm::GetTxBufferSize()
   return m_txonBufferSize + m_txonQueue->GetNBytes();
 }
 
-std::vector < LteRlcAm::RetxPdu >
-LteRlcAm::GetTxedBuffer()
+const std::vector < LteRlcAm::RetxPdu > &
+LteRlcAm::GetTxedBuffer() const
 {
-  //std::vector < LteRlcAm::RetxPdu > toBeReturned;
-  //toBeReturned.insert(toBeReturned.begin(), m_txedBuffer.begin(), m_txedBuffer.end());
   return m_txedBuffer;
 }
 uint32_t
@@ -1142,12 +1133,10 @@ LteRlcAm::GetTxedBufferSize()
   return m_txedBufferSize;
 }
 
-std::vector < LteRlcAm::RetxPdu >
-LteRlcAm::GetRetxBuffer()
+const std::vector < LteRlcAm::RetxPdu > &
+LteRlcAm::GetRetxBuffer() const
 {
-  std::vector < LteRlcAm::RetxPdu > toBeReturned;
-  toBeReturned.insert(toBeReturned.begin(), m_retxBuffer.begin(), m_retxBuffer.end());
-  return toBeReturned;
+  return m_retxBuffer;
 }
 
 uint32_t
@@ -1156,8 +1145,8 @@ LteRlcAm::GetRetxBufferSize()
   return m_retxBufferSize;
 }
 
-std::map < uint32_t, Ptr<Packet> >
-LteRlcAm::GetTransmittingRlcSduBuffer()
+const std::map < uint32_t, Ptr<Packet> > &
+LteRlcAm::GetTransmittingRlcSduBuffer() const
 {
   return m_transmittingRlcSduBuffer;
   // TODO check if it must be emptied
@@ -1723,11 +1712,11 @@ LteRlcAm::CreateRlcSduBuffer(){
 
 // LL HO
 void
-LteRlcAm::RlcPdusToRlcSdus (std::vector < LteRlcAm::RetxPdu > RlcPdus){
+LteRlcAm::RlcPdusToRlcSdus (const std::vector < LteRlcAm::RetxPdu > & RlcPdus){
 
   NS_LOG_DEBUG (this << "in RlcPdusTo..." );
   uint16_t isGotExpectedSeqNumber = 0;
-  for ( std::vector <LteRlcAm::RetxPdu>::iterator it = RlcPdus.begin(); it != RlcPdus.end (); it++)
+  for ( std::vector <LteRlcAm::RetxPdu>::const_iterator it = RlcPdus.begin(); it != RlcPdus.end (); it++)
         {
           if (it->m_pdu == 0){
             continue;
@@ -2242,6 +2231,8 @@ LteRlcAm::IsInsideReceivingWindow (SequenceNumber10 seqNumber)
 void
 LteRlcAm::ReassembleAndDeliver (Ptr<Packet> packet)
 {
+  NS_PROFILE_SCOPE ("LteRlcAm::ReassembleAndDeliver");
+  NS_PROFILE_COUNT ("LteRlcAm::ReassembleAndDeliver", packet->GetSize ());
   LteRlcAmHeader rlcAmHeader;
   packet->RemoveHeader (rlcAmHeader);
   uint8_t framingInfo = rlcAmHeader.GetFramingInfo ();
@@ -75,24 +75,41 @@ public:
   virtual void DoSendMcPdcpSdu(EpcX2Sap::UeDataParams params);
 
   // LL HO
-  std::vector < Ptr<Packet> > GetTxBuffer();
+  /**
+   * Remove the SDUs from the transmission buffer, e.g., to forward them to
+   * the target eNB during a handover. The buffer is moved, not copied
+   * \return the SDUs of the transmission buffer
+   */
+  TxBuffer GetTxBuffer();
   uint32_t GetTxBufferSize();
 
-  std::vector < RetxPdu > GetTxedBuffer();
+  /**
+   * \return a reference to the buffer of the PDUs transmitted and not yet
+   *         acknowledged, which is valid until the next operation on the entity
+   */
+  const std::vector < RetxPdu > & GetTxedBuffer() const;
   uint32_t GetTxedBufferSize();
 
-  std::vector < RetxPdu > GetRetxBuffer();
+  /**
+   * \return a reference to the retransmission buffer, which is valid until
+   *         the next operation on the entity
+   */
+  const std::vector < RetxPdu > & GetRetxBuffer() const;
   uint32_t GetRetxBufferSize();
 
-  std::map < uint32_t, Ptr<Packet> > GetTransmittingRlcSduBuffer();
+  /**
+   * \return a reference to the SDUs rebuilt by RlcPdusToRlcSdus, by PDCP
+   *         sequence number
+   */
+  const std::map < uint32_t, Ptr<Packet> > & GetTransmittingRlcSduBuffer() const;
   uint32_t GetTransmittingRlcSduBufferSize();
 
   Ptr<Packet> GetSegmentedRlcsdu();
   ///< translate a vector of Rlc PDUs to Rlc SDUs
   ///< and put the Rlc SDUs into m_transmittingRlcSdus.
-  void  RlcPdusToRlcSdus (std::vector < RetxPdu >  Pdus);
+  void  RlcPdusToRlcSdus (const std::vector < RetxPdu > & Pdus);
 
-  std::vector < Ptr<Packet> > GetTxedRlcSduBuffer (){
+  const std::vector < Ptr<Packet> > & GetTxedRlcSduBuffer () const {
     return m_txedRlcSduBuffer;
   }
 
@@ -176,7 +193,7 @@ private:
   void BufferSizeTrace();
 
 private:
-    std::vector < Ptr<Packet> > m_txonBuffer; ///< Transmission buffer
+    TxBuffer m_txonBuffer; ///< Transmission buffer
 
     struct RetxSegPdu
     {
@@ -32,6 +32,7 @@
 
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/profiler.h"
 
 #include "ns3/lte-rlc-header.h"
 #include "ns3/lte-rlc-sdu-status-tag.h"
@@ -225,7 +226,7 @@ LteRlcUmLowLat::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters tx
   Ptr<Packet> firstSegment = (*(m_txBuffer.begin ()))->Copy ();
   m_txBufferSize -= (*(m_txBuffer.begin()))->GetSize ();
   NS_LOG_LOGIC ("txBufferSize      = " << m_txBufferSize );
-  m_txBuffer.erase (m_txBuffer.begin ());
+  m_txBuffer.pop_front ();
 
   while ( firstSegment && (firstSegment->GetSize () > 0) && (nextSegmentSize > 0) )
     {
@@ -273,7 +274,7 @@ LteRlcUmLowLat::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters tx
             {
               firstSegment->AddPacketTag (oldTag);
 
-              m_txBuffer.insert (m_txBuffer.begin (), firstSegment);
+              m_txBuffer.push_front (firstSegment);
               m_txBufferSize += (*(m_txBuffer.begin()))->GetSize ();
 
               NS_LOG_LOGIC ("    TX buffer: Give back the remaining segment");
@@ -378,7 +379,7 @@ LteRlcUmLowLat::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters tx
           // (more segments)
           firstSegment = (*(m_txBuffer.begin ()))->Copy ();
           m_txBufferSize -= (*(m_txBuffer.begin()))->GetSize ();
-          m_txBuffer.erase (m_txBuffer.begin ());
+          m_txBuffer.pop_front ();
           NS_LOG_LOGIC ("        txBufferSize = " << m_txBufferSize );
         }
 
@@ -469,8 +470,8 @@ LteRlcUmLowLat::DoNotifyHarqDeliveryFailure ()
   NS_LOG_FUNCTION (this);
 }
 
-std::vector < Ptr<Packet> >
-LteRlcUmLowLat::GetTxBuffer()
+const LteRlc::TxBuffer &
+LteRlcUmLowLat::GetTxBuffer () const
 {
   return m_txBuffer;
 }
@@ -664,6 +665,8 @@ LteRlcUmLowLat::IsInsideReorderingWindow (SequenceNumber10 seqNumber)
 void
 LteRlcUmLowLat::ReassembleAndDeliver (Ptr<Packet> packet)
 {
+  NS_PROFILE_SCOPE ("LteRlcUmLowLat::ReassembleAndDeliver");
+  NS_PROFILE_COUNT ("LteRlcUmLowLat::ReassembleAndDeliver", packet->GetSize ());
   LteRlcHeader rlcHeader;
   packet->RemoveHeader (rlcHeader);
   uint8_t framingInfo = rlcHeader.GetFramingInfo ();
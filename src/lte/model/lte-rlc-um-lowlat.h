@@ -66,7 +66,12 @@ public:
   virtual void DoNotifyHarqDeliveryFailure ();
   virtual void DoReceivePdu (LteMacSapUser::ReceivePduParameters params);
 
-  std::vector < Ptr<Packet> > GetTxBuffer();
+  /**
+  * Get the SDUs in the transmission buffer, e.g., to forward them to the
+  * target eNB during a handover. The buffer is not copied
+  * \return a reference to the transmission buffer
+  */
+  const TxBuffer & GetTxBuffer () const;
   uint32_t GetTxBufferSize()
   {
     return m_txBufferSize;
@@ -89,7 +94,7 @@ private:
 private:
   uint32_t m_maxTxBufferSize;
   uint32_t m_txBufferSize;
-  std::vector < Ptr<Packet> > m_txBuffer;       // Transmission buffer
+  TxBuffer m_txBuffer;                          // Transmission buffer
   std::map <uint16_t, Ptr<Packet> > m_rxBuffer; // Reception buffer
   std::vector < Ptr<Packet> > m_reasBuffer;     // Reassembling buffer
 
@@ -24,6 +24,7 @@
 
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/profiler.h"
 
 #include "ns3/lte-rlc-header.h"
 #include "ns3/lte-rlc-um.h"
@@ -190,7 +191,7 @@ LteRlcUm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
   Ptr<Packet> firstSegment = (*(m_txBuffer.begin ()))->Copy ();
   m_txBufferSize -= (*(m_txBuffer.begin()))->GetSize ();
   NS_LOG_LOGIC ("txBufferSize      = " << m_txBufferSize );
-  m_txBuffer.erase (m_txBuffer.begin ());
+  m_txBuffer.pop_front ();
 
   while ( firstSegment && (firstSegment->GetSize () > 0) && (nextSegmentSize > 0) )
     {
@@ -238,7 +239,7 @@ LteRlcUm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
             {
               firstSegment->AddPacketTag (oldTag);
 
-              m_txBuffer.insert (m_txBuffer.begin (), firstSegment);
+              m_txBuffer.push_front (firstSegment);
               m_txBufferSize += (*(m_txBuffer.begin()))->GetSize ();
 
               NS_LOG_LOGIC ("    TX buffer: Give back the remaining segment");
@@ -343,7 +344,7 @@ LteRlcUm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
           // (more segments)
           firstSegment = (*(m_txBuffer.begin ()))->Copy ();
           m_txBufferSize -= (*(m_txBuffer.begin()))->GetSize ();
-          m_txBuffer.erase (m_txBuffer.begin ());
+          m_txBuffer.pop_front ();
           NS_LOG_LOGIC ("        txBufferSize = " << m_txBufferSize );
         }
 
@@ -435,8 +436,8 @@ LteRlcUm::DoNotifyHarqDeliveryFailure ()
   NS_LOG_FUNCTION (this);
 }
 
-std::vector < Ptr<Packet> >
-LteRlcUm::GetTxBuffer()
+const LteRlc::TxBuffer &
+LteRlcUm::GetTxBuffer () const
 {
   return m_txBuffer;
 }
@@ -632,6 +633,8 @@ LteRlcUm::IsInsideReorderingWindow (SequenceNumber10 seqNumber)
 void
 LteRlcUm::ReassembleAndDeliver (Ptr<Packet> packet)
 {
+  NS_PROFILE_SCOPE ("LteRlcUm::ReassembleAndDeliver");
+  NS_PROFILE_COUNT ("LteRlcUm::ReassembleAndDeliver", packet->GetSize ());
   LteRlcHeader rlcHeader;
   packet->RemoveHeader (rlcHeader);
   uint8_t framingInfo = rlcHeader.GetFramingInfo ();
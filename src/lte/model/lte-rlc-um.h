@@ -72,7 +72,12 @@ public:
   virtual void DoNotifyHarqDeliveryFailure ();
   virtual void DoReceivePdu (LteMacSapUser::ReceivePduParameters rxPduParams);
 
-  std::vector < Ptr<Packet> > GetTxBuffer();
+  /**
+   * Get the SDUs in the transmission buffer, e.g., to forward them to the
+   * target eNB during a handover. The buffer is not copied
+   * \return a reference to the transmission buffer
+   */
+  const TxBuffer & GetTxBuffer () const;
   uint32_t GetTxBufferSize()
   {
     return m_txBufferSize;
@@ -116,7 +121,7 @@ private:
 private:
   uint32_t m_maxTxBufferSize; ///< maximum transmit buffer status
   uint32_t m_txBufferSize; ///< transmit buffer size
-  std::vector < Ptr<Packet> > m_txBuffer;       ///< Transmission buffer
+  TxBuffer m_txBuffer;                          ///< Transmission buffer
   std::map <uint16_t, Ptr<Packet> > m_rxBuffer; ///< Reception buffer
   std::vector < Ptr<Packet> > m_reasBuffer;     ///< Reassembling buffer
 
@@ -38,6 +38,8 @@
 #include "ns3/lte-rlc-sap.h"
 #include "ns3/lte-mac-sap.h"
 
+#include <deque>
+
 namespace ns3 {
 
 
@@ -88,6 +90,14 @@ public:
   static TypeId GetTypeId (void);
   virtual void DoDispose ();
 
+  /**
+   * Transmission buffer of the SDUs. The SDUs are removed from the head, and
+   * the remaining segment of a SDU is put back at the head, thus a deque is
+   * used to do both in constant time, independently of the number of SDUs
+   * in the buffer
+   */
+  typedef std::deque < Ptr<Packet> > TxBuffer;
+
   /**
    *
    *
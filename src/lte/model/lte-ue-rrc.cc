@@ -1562,12 +1562,13 @@ LteUeRrc::DoRecvRrcConnectionSwitch (LteRrcSap::RrcConnectionSwitch msg)
  * Merge 2 buffers of RlcAmPdus into 1 vector with increment order of Pdus
  */
 std::vector < LteRlcAm::RetxPdu >
-LteUeRrc::MergeBuffers(std::vector < LteRlcAm::RetxPdu > first, std::vector < LteRlcAm::RetxPdu > second)
+LteUeRrc::MergeBuffers(const std::vector < LteRlcAm::RetxPdu > &first, const std::vector < LteRlcAm::RetxPdu > &second)
 {
   LteRlcAmHeader rlcamHeader_1, rlcamHeader_2;
   std::vector < LteRlcAm::RetxPdu> result;
-  std::vector < LteRlcAm::RetxPdu>::iterator it_1 = first.begin();
-  std::vector < LteRlcAm::RetxPdu>::iterator it_2 = second.begin();
+  result.reserve (first.size () + second.size ());
+  std::vector < LteRlcAm::RetxPdu>::const_iterator it_1 = first.begin();
+  std::vector < LteRlcAm::RetxPdu>::const_iterator it_2 = second.begin();
   bool end_1_reached = false;
   bool end_2_reached = false;
   while (it_1 != first.end() && it_2 != second.end()){
@@ -1633,13 +1634,13 @@ LteUeRrc::CopyRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint16_t lcid)
     //Copy lte-rlc-am.m_txOnBuffer to X2 forwarding buffer.
     Ptr<LteRlcAm> rlcAm = rlc->GetObject<LteRlcAm>();
     uint32_t txonBufferSize = rlcAm->GetTxBufferSize();
-    std::vector < Ptr<Packet> > txonBuffer = rlcAm->GetTxBuffer();
+    LteRlc::TxBuffer txonBuffer = rlcAm->GetTxBuffer();
     //m_rlcBufferToBeForwardedSize =  drbIt->second->m_rlc->GetObject<LteRlcAm>()->GetTxBufferSize();
     //m_rlcBufferToBeForwarded = drbIt->second->m_rlc->GetObject<LteRlcAm>()->GetTxBuffer();
     uint32_t txedBufferSize = rlcAm->GetTxedBufferSize();
-    std::vector < LteRlcAm::RetxPdu > txedBuffer = rlcAm->GetTxedBuffer();
+    const std::vector < LteRlcAm::RetxPdu > &txedBuffer = rlcAm->GetTxedBuffer();
     uint32_t retxBufferSize = rlcAm->GetRetxBufferSize();
-    std::vector < LteRlcAm::RetxPdu > retxBuffer = rlcAm->GetRetxBuffer();
+    const std::vector < LteRlcAm::RetxPdu > &retxBuffer = rlcAm->GetRetxBuffer();
 
     //Translate Pdus in Rlc txed/retx buffer into RLC Sdus
     //and put these Sdus into rlcAm->m_transmittingRlcSdus.
@@ -1647,17 +1648,15 @@ LteUeRrc::CopyRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint16_t lcid)
     NS_LOG_INFO("UE RRC: txedBuffer size = " << txedBufferSize);
     //Merge txed and retx buffers into a single buffer before doing RlcPdusToRlc.
     if ( retxBufferSize + txedBufferSize > 0 ){
-      std::vector< LteRlcAm::RetxPdu > sortedTxedRetxBuffer;
       if (retxBufferSize == 0){
-        sortedTxedRetxBuffer = txedBuffer;
+        rlcAm->RlcPdusToRlcSdus(txedBuffer);
       }
       else if (txedBufferSize == 0){
-        sortedTxedRetxBuffer = retxBuffer;
+        rlcAm->RlcPdusToRlcSdus(retxBuffer);
       }
       else {
-        sortedTxedRetxBuffer = MergeBuffers(txedBuffer, retxBuffer);
+        rlcAm->RlcPdusToRlcSdus(MergeBuffers(txedBuffer, retxBuffer));
       }
-      rlcAm->RlcPdusToRlcSdus(sortedTxedRetxBuffer);
     }
 
     //Construct the forwarding buffer
@@ -1666,7 +1665,7 @@ LteUeRrc::CopyRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint16_t lcid)
     //{
       LtePdcpHeader pdcpHeader;
       uint32_t pos = 0;
-      for (std::vector< Ptr<Packet> >::iterator it = txonBuffer.begin(); it != txonBuffer.end(); ++it)
+      for (LteRlc::TxBuffer::iterator it = txonBuffer.begin(); it != txonBuffer.end(); ++it)
       {
         pos++;
         if((*it)->GetSize() > 3)
@@ -1685,10 +1684,10 @@ LteUeRrc::CopyRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint16_t lcid)
       if ( rlcAm->GetTransmittingRlcSduBufferSize() > 0 )
       { //something inside the RLC AM's transmitting buffer
         NS_LOG_DEBUG ("UE RRC: ADDING TRANSMITTING SDUS OF RLC AM TO X2FORWARDINGBUFFER... Size = " << rlcAm->GetTransmittingRlcSduBufferSize() );
-        //copy the RlcSdu buffer (map) to forwardingBuffer.
-        std::map < uint32_t, Ptr<Packet> > rlcAmTransmittingBuffer = rlcAm->GetTransmittingRlcSduBuffer();
+        //add the SDUs of the RlcSdu buffer (map) to forwardingBuffer, by reference.
+        const std::map < uint32_t, Ptr<Packet> > &rlcAmTransmittingBuffer = rlcAm->GetTransmittingRlcSduBuffer();
         NS_LOG_DEBUG ("UE RRC:  *** SIZE = " << rlcAmTransmittingBuffer.size());
-        for (std::map< uint32_t, Ptr<Packet> >::iterator it = rlcAmTransmittingBuffer.begin(); it != rlcAmTransmittingBuffer.end(); ++it)
+        for (std::map< uint32_t, Ptr<Packet> >::const_iterator it = rlcAmTransmittingBuffer.begin(); it != rlcAmTransmittingBuffer.end(); ++it)
         {
           if (it->second != 0)
           {
@@ -1704,17 +1703,17 @@ LteUeRrc::CopyRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint16_t lcid)
           segmentedRlcsdu->PeekHeader(pdcpHeader);
           NS_LOG_DEBUG(this << "UE RRC: SegmentedRlcSdu = " << segmentedRlcsdu->GetSize() << " SEQ = " << pdcpHeader.GetSequenceNumber());
           //insert the complete version of the fragmented SDU to the front of txonBuffer.
-          txonBuffer.insert(txonBuffer.begin(),segmentedRlcsdu);
+          txonBuffer.push_front(segmentedRlcsdu);
         }
         m_rlcBufferToBeForwarded.insert(m_rlcBufferToBeForwarded.end(), txonBuffer.begin(), txonBuffer.end());
         m_rlcBufferToBeForwardedSize += rlcAm->GetTransmittingRlcSduBufferSize() + txonBufferSize;
 
         //Get the rlcAm
-        std::vector < Ptr <Packet> > rlcAmTxedSduBuffer = rlcAm->GetTxedRlcSduBuffer();
+        const std::vector < Ptr <Packet> > &rlcAmTxedSduBuffer = rlcAm->GetTxedRlcSduBuffer();
         LtePdcpHeader pdcpHeader_1;
-        m_rlcBufferToBeForwarded.at(0)->PeekHeader(pdcpHeader_1);
+        m_rlcBufferToBeForwarded.front()->PeekHeader(pdcpHeader_1);
         uint16_t i = 0;
-        for (std::vector< Ptr<Packet> >::iterator it = rlcAmTxedSduBuffer.begin(); it != rlcAmTxedSduBuffer.end(); ++it)
+        for (std::vector< Ptr<Packet> >::const_iterator it = rlcAmTxedSduBuffer.begin(); it != rlcAmTxedSduBuffer.end(); ++it)
         {
           if ((*it) != NULL)
           {
@@ -1733,9 +1732,10 @@ LteUeRrc::CopyRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint16_t lcid)
 
       }
       else
-      { //TransmittingBuffer is empty. Only copy TxonBuffer.
+      { //TransmittingBuffer is empty. Only move TxonBuffer.
         NS_LOG_DEBUG(this << " UE RRC: ADDING TXONBUFFER OF RLC AM " << m_rnti << " Size = " << txonBufferSize) ;
-        m_rlcBufferToBeForwarded = txonBuffer;
+        m_rlcBufferToBeForwarded.clear ();
+        m_rlcBufferToBeForwarded.swap (txonBuffer);
         m_rlcBufferToBeForwardedSize += txonBufferSize;
       }
     //}
@@ -1748,14 +1748,16 @@ LteUeRrc::CopyRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint16_t lcid)
   {
     //Copy lte-rlc-um.m_txOnBuffer to X2 forwarding buffer.
     NS_LOG_DEBUG(this << " UE RRC: Copying txonBuffer from RLC UM " << m_rnti);
-    m_rlcBufferToBeForwarded = rlc->GetObject<LteRlcUm>()->GetTxBuffer();
+    const LteRlc::TxBuffer &txBuffer = rlc->GetObject<LteRlcUm>()->GetTxBuffer();
+    m_rlcBufferToBeForwarded.assign(txBuffer.begin(), txBuffer.end());
     m_rlcBufferToBeForwardedSize =  rlc->GetObject<LteRlcUm>()->GetTxBufferSize();
   }
   else if (0 != rlc->GetObject<LteRlcUmLowLat> ())
   {
     //Copy lte-rlc-um-low-lat.m_txOnBuffer to X2 forwarding buffer.
     NS_LOG_DEBUG(this << " UE RRC: Copying txonBuffer from RLC UM " << m_rnti);
-    m_rlcBufferToBeForwarded = rlc->GetObject<LteRlcUmLowLat>()->GetTxBuffer();
+    const LteRlc::TxBuffer &txBuffer = rlc->GetObject<LteRlcUmLowLat>()->GetTxBuffer();
+    m_rlcBufferToBeForwarded.assign(txBuffer.begin(), txBuffer.end());
     m_rlcBufferToBeForwardedSize =  rlc->GetObject<LteRlcUmLowLat>()->GetTxBufferSize();
   }
   //LteRlcAm m_txBuffer stores PDCP "PDU".
@@ -1766,8 +1768,10 @@ LteUeRrc::CopyRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint16_t lcid)
   {
     NS_LOG_DEBUG(this << " UE RRC: Forwarding m_rlcBufferToBeForwarded to target eNB, lcid = " << lcid );
     //Remove tags to get PDCP SDU from PDCP PDU.
-    //Ptr<Packet> rlcSdu =  (*(m_rlcBufferToBeForwarded.begin()))->Copy();
-    Ptr<Packet> rlcSdu =  m_rlcBufferToBeForwarded.at(0);
+    //the SDU is removed from the forwarding buffer before it is modified
+    Ptr<Packet> rlcSdu =  m_rlcBufferToBeForwarded.front();
+    m_rlcBufferToBeForwardedSize -= rlcSdu->GetSize();
+    m_rlcBufferToBeForwarded.pop_front ();
     //Tags to be removed from rlcSdu (from outer to inner)
     //LteRlcSduStatusTag rlcSduStatusTag;
     //RlcTag  rlcTag; //rlc layer timestamp
@@ -1812,8 +1816,6 @@ LteUeRrc::CopyRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint16_t lcid)
     {
       NS_LOG_UNCOND("UE RRC: Too small, not forwarded");
     }
-    m_rlcBufferToBeForwardedSize -= (*(m_rlcBufferToBeForwarded.begin()))->GetSize();
-    m_rlcBufferToBeForwarded.erase (m_rlcBufferToBeForwarded.begin());
     NS_LOG_LOGIC(this << " UE RRC: After forwarding: buffer size = " << m_rlcBufferToBeForwardedSize );
   }
 }
@@ -756,7 +756,7 @@ private:
    */
   void CopyRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint16_t lcid);
   //Lossless HO: merge 2 buffers into 1 with increment order.
-  std::vector < LteRlcAm::RetxPdu > MergeBuffers(std::vector < LteRlcAm::RetxPdu > first, std::vector < LteRlcAm::RetxPdu > second);
+  std::vector < LteRlcAm::RetxPdu > MergeBuffers(const std::vector < LteRlcAm::RetxPdu > &first, const std::vector < LteRlcAm::RetxPdu > &second);
 
 
   std::map<uint8_t, uint8_t> m_bid2DrbidMap; ///< bid to DR bid map
@@ -1253,7 +1253,7 @@ private:
   bool m_ncRaStarted;
 
   // lossless HO
-  std::vector < Ptr<Packet> > m_rlcBufferToBeForwarded;
+  LteRlc::TxBuffer m_rlcBufferToBeForwarded; ///< SDUs to be re-injected in the PDCP, in order
   uint32_t m_rlcBufferToBeForwardedSize;
 
 public:
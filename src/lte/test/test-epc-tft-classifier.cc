@@ -429,5 +429,46 @@ EpcTftClassifierTestSuite::EpcTftClassifierTestSuite ()
       AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::UPLINK,   "9.1.1.1", "8.1.1.1",  7895,       10,     0,    1, useIpv6), TestCase::QUICK);
       AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::UPLINK,   "9.1.1.1", "8.1.1.1",     9,     5897,     0,    2, useIpv6), TestCase::QUICK);
       AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::DOWNLINK, "9.1.1.1", "8.1.1.1",  5897,       10,     0,    2, useIpv6), TestCase::QUICK);
+
+
+      ///////////////////////////////////////////////////////////////
+      // check the priority of TFTs with single ports and port ranges
+      ///////////////////////////////////////////////////////////////
+
+      Ptr<EpcTftClassifier> c5 = Create<EpcTftClassifier> ();
+      c5->Add (EpcTft::Default (), 1);
+      Ptr<EpcTft> tft5_2 = Create<EpcTft> ();
+      EpcTft::PacketFilter pf5_2;
+      pf5_2.localPortStart = 5000;
+      pf5_2.localPortEnd   = 5000;
+      tft5_2->Add (pf5_2);
+      c5->Add (tft5_2, 2);
+      Ptr<EpcTft> tft5_3 = Create<EpcTft> ();
+      EpcTft::PacketFilter pf5_3;
+      pf5_3.remotePortStart = 4000;
+      pf5_3.remotePortEnd   = 6000;
+      tft5_3->Add (pf5_3);
+      c5->Add (tft5_3, 3);
+      Ptr<EpcTft> tft5_4 = Create<EpcTft> ();
+      EpcTft::PacketFilter pf5_4;
+      pf5_4.remotePortStart = 80;
+      pf5_4.remotePortEnd   = 80;
+      tft5_4->Add (pf5_4);
+      c5->Add (tft5_4, 4);
+      Ptr<EpcTft> tft5_5 = Create<EpcTft> ();
+      EpcTft::PacketFilter pf5_5;
+      pf5_5.direction = EpcTft::DOWNLINK;
+      pf5_5.localPortStart = 6000;
+      pf5_5.localPortEnd   = 6000;
+      tft5_5->Add (pf5_5);
+      c5->Add (tft5_5, 5);
+      AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::UPLINK,   "9.1.1.1", "8.1.1.1",  5000,     4500,     0,    3, useIpv6), TestCase::QUICK);
+      AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::UPLINK,   "9.1.1.1", "8.1.1.1",  5000,     7000,     0,    2, useIpv6), TestCase::QUICK);
+      AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::DOWNLINK, "9.1.1.1", "8.1.1.1",    80,     5000,     0,    4, useIpv6), TestCase::QUICK);
+      AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::UPLINK,   "9.1.1.1", "8.1.1.1",     1,       80,     0,    4, useIpv6), TestCase::QUICK);
+      AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::UPLINK,   "9.1.1.1", "8.1.1.1",     2,        3,     0,    1, useIpv6), TestCase::QUICK);
+      AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::UPLINK,   "9.1.1.1", "8.1.1.1",  6000,        9,     0,    1, useIpv6), TestCase::QUICK);
+      AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::DOWNLINK, "9.1.1.1", "8.1.1.1",     9,     6000,     0,    5, useIpv6), TestCase::QUICK);
+      AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::DOWNLINK, "9.1.1.1", "8.1.1.1",  4500,     6000,     0,    5, useIpv6), TestCase::QUICK);
     }
 }
@@ -0,0 +1,201 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/ptr.h"
+#include "ns3/packet.h"
+
+#include "ns3/epc-x2-header.h"
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+
+NS_LOG_COMPONENT_DEFINE ("TestEpcX2SinrUpdateHeader");
+
+namespace ns3 {
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check the serialization of EpcX2UeImsiSinrDeltaUpdateHeader against
+ * a known byte sequence, and that the deserialized header carries the
+ * quantized SINR values
+ */
+class EpcX2SinrDeltaUpdateHeaderTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param map the SINR of each IMSI
+   * \param step the quantization step [dB]
+   * \param hex the expected serialization, in hexadecimal
+   */
+  EpcX2SinrDeltaUpdateHeaderTestCase (std::map<uint64_t, double> map, double step, std::string hex);
+
+private:
+  virtual void DoRun (void);
+
+  std::map<uint64_t, double> m_map; ///< the SINR of each IMSI
+  double m_step; ///< the quantization step [dB]
+  std::string m_hex; ///< the expected serialization
+};
+
+EpcX2SinrDeltaUpdateHeaderTestCase::EpcX2SinrDeltaUpdateHeaderTestCase (std::map<uint64_t, double> map,
+                                                                        double step, std::string hex)
+  : TestCase ("Serialization of the delta SINR report with " + std::to_string (map.size ()) + " entries"),
+    m_map (map),
+    m_step (step),
+    m_hex (hex)
+{
+}
+
+void
+EpcX2SinrDeltaUpdateHeaderTestCase::DoRun ()
+{
+  EpcX2UeImsiSinrDeltaUpdateHeader header;
+  header.SetQuantizationStep (m_step);
+  header.SetSourceCellId (2);
+  header.SetUeImsiSinrMap (m_map);
+
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (header);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), header.GetLengthOfIes (), "wrong length of the IEs");
+
+  uint32_t size = packet->GetSize ();
+  std::vector<uint8_t> buffer (size);
+  packet->CopyData (buffer.data (), size);
+  std::ostringstream oss;
+  for (uint32_t i = 0; i < size; i++)
+    {
+      oss << std::setfill ('0') << std::setw (2) << std::hex << (uint32_t) buffer[i];
+    }
+  NS_TEST_ASSERT_MSG_EQ (oss.str (), m_hex, "wrong serialization");
+
+  EpcX2UeImsiSinrDeltaUpdateHeader received;
+  packet->RemoveHeader (received);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "the header was not entirely deserialized");
+  NS_TEST_ASSERT_MSG_EQ (received.GetSourceCellId (), 2, "wrong source cell");
+  NS_TEST_ASSERT_MSG_EQ_TOL (received.GetQuantizationStep (), m_step, 1e-9, "wrong quantization step");
+  NS_TEST_ASSERT_MSG_EQ (received.GetNumberOfIes (), header.GetNumberOfIes (), "wrong number of IEs");
+
+  std::map<uint64_t, double> map = received.GetUeImsiSinrMap ();
+  NS_TEST_ASSERT_MSG_EQ (map.size (), m_map.size (), "wrong number of entries");
+  for (std::map<uint64_t, double>::const_iterator it = m_map.begin (); it != m_map.end (); ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((map.find (it->first) != map.end ()), true, "missing IMSI " << it->first);
+      double sinr = map.at (it->first);
+      if (it->second == 0)
+        {
+          NS_TEST_ASSERT_MSG_EQ (sinr, 0, "a 0 SINR must be preserved");
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ_TOL (10 * std::log10 (sinr), 10 * std::log10 (it->second), m_step / 2 + 1e-9,
+                                     "the error is larger than half a quantization step for IMSI " << it->first);
+        }
+    }
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check the quantization of the SINR values
+ */
+class EpcX2SinrQuantizationTestCase : public TestCase
+{
+public:
+  EpcX2SinrQuantizationTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+EpcX2SinrQuantizationTestCase::EpcX2SinrQuantizationTestCase ()
+  : TestCase ("Quantization of the SINR values")
+{
+}
+
+void
+EpcX2SinrQuantizationTestCase::DoRun ()
+{
+  NS_TEST_ASSERT_MSG_EQ (EpcX2UeImsiSinrDeltaUpdateHeader::QuantizeSinr (100, 0.1), 200, "20 dB");
+  NS_TEST_ASSERT_MSG_EQ (EpcX2UeImsiSinrDeltaUpdateHeader::QuantizeSinr (1, 0.1), 0, "0 dB");
+  NS_TEST_ASSERT_MSG_EQ (EpcX2UeImsiSinrDeltaUpdateHeader::QuantizeSinr (0.5, 0.1), -30, "-3 dB");
+  NS_TEST_ASSERT_MSG_EQ (EpcX2UeImsiSinrDeltaUpdateHeader::QuantizeSinr (0, 0.1),
+                         std::numeric_limits<int16_t>::min (), "0 SINR");
+  NS_TEST_ASSERT_MSG_EQ (EpcX2UeImsiSinrDeltaUpdateHeader::QuantizeSinr (1e300, 0.001),
+                         std::numeric_limits<int16_t>::max (), "saturation of large values");
+  NS_TEST_ASSERT_MSG_EQ (EpcX2UeImsiSinrDeltaUpdateHeader::QuantizeSinr (1e-300, 0.001),
+                         std::numeric_limits<int16_t>::min () + 1, "saturation of small values");
+  NS_TEST_ASSERT_MSG_EQ (EpcX2UeImsiSinrDeltaUpdateHeader::DequantizeSinr (std::numeric_limits<int16_t>::min (), 0.1),
+                         0, "0 SINR");
+  NS_TEST_ASSERT_MSG_EQ_TOL (EpcX2UeImsiSinrDeltaUpdateHeader::DequantizeSinr (200, 0.1), 100, 1e-9, "20 dB");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test suite of the X2 SINR report headers
+ */
+class EpcX2SinrUpdateHeaderTestSuite : public TestSuite
+{
+public:
+  EpcX2SinrUpdateHeaderTestSuite ();
+};
+
+EpcX2SinrUpdateHeaderTestSuite::EpcX2SinrUpdateHeaderTestSuite ()
+  : TestSuite ("epc-x2-sinr-update-header", UNIT)
+{
+  AddTestCase (new EpcX2SinrQuantizationTestCase, TestCase::QUICK);
+
+  {
+    std::map<uint64_t, double> map;
+    // cell 2, step 100000 micro dB, 0 entries
+    std::string hex ("0002000186a00000");
+    AddTestCase (new EpcX2SinrDeltaUpdateHeaderTestCase (map, 0.1, hex), TestCase::QUICK);
+  }
+
+  {
+    std::map<uint64_t, double> map;
+    map[1] = 100; // delta 1, 200 steps
+    map[2] = 0; // delta 1, 0 SINR
+    map[300] = 0.5; // delta 298 in two bytes, -30 steps
+    std::string hex ("0002000186a0000301" "00c8" "01" "8000" "aa02" "ffe2");
+    AddTestCase (new EpcX2SinrDeltaUpdateHeaderTestCase (map, 0.1, hex), TestCase::QUICK);
+  }
+
+  {
+    std::map<uint64_t, double> map;
+    map[1ULL << 40] = 2; // delta in six bytes, 3.0103 dB / 0.01 = 301 steps
+    std::string hex ("000200002710" "0001" "808080808020" "012d");
+    AddTestCase (new EpcX2SinrDeltaUpdateHeaderTestCase (map, 0.01, hex), TestCase::QUICK);
+  }
+}
+
+/**
+ * \ingroup lte-test
+ * Static variable for test initialization
+ */
+static EpcX2SinrUpdateHeaderTestSuite g_epcX2SinrUpdateHeaderTestSuite;
+
+} // namespace ns3
@@ -0,0 +1,67 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Converts a trace written by MmWavePhyTrace or MmWaveMacTrace with the
+ * BinaryFormat attribute enabled to the tab separated text format, so that
+ * the existing post-processing scripts can be used on it.
+ *
+ * Example: ./waf --run "mmwave-binary-trace-converter --input=RxPacketTrace.txt --output=RxPacketTrace.tsv"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mmwave-binary-trace.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace ns3;
+using namespace mmwave;
+
+int
+main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("input", "Name of the binary trace file", input);
+  cmd.AddValue ("output", "Name of the text file, if empty the text is written to the standard output", output);
+  cmd.Parse (argc, argv);
+
+  if (input.empty ())
+    {
+      NS_FATAL_ERROR ("The name of the binary trace file must be provided with --input");
+    }
+
+  uint64_t numRecords;
+  if (output.empty ())
+    {
+      numRecords = MmWaveBinaryTraceReader::ConvertToText (input, std::cout);
+    }
+  else
+    {
+      std::ofstream file (output.c_str ());
+      if (!file.is_open ())
+        {
+          NS_FATAL_ERROR ("Could not open " << output);
+        }
+      numRecords = MmWaveBinaryTraceReader::ConvertToText (input, file);
+      std::cerr << "Converted " << numRecords << " records to " << output << std::endl;
+    }
+
+  return 0;
+}
@@ -0,0 +1,144 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Measures the throughput of MmWaveErrorModel::GetTbDecodificationStats for
+ * the error models available in the mmwave module, with random SINR vectors,
+ * MCSs and TB sizes, and with an increasing number of HARQ retransmissions.
+ *
+ * Example: ./waf --run "mmwave-error-model-profiler --calls=100000 --useSimd=false"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/spectrum-model.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/mmwave-error-model.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * Profile the error model of type tid
+ *
+ * \param tid the TypeId of the error model
+ * \param sm the spectrum model of the SINR vectors
+ * \param calls the number of TBs to decode
+ * \param maxRetx the maximum number of HARQ retransmissions of a TB
+ * \return the sum of the TBLERs, to avoid that the calls are optimized away
+ */
+static double
+Profile (TypeId tid, Ptr<const SpectrumModel> sm, uint32_t calls, uint32_t maxRetx)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (tid);
+  Ptr<MmWaveErrorModel> em = factory.Create<MmWaveErrorModel> ();
+
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  uniform->SetStream (1);
+  uint32_t nRbs = sm->GetNumBands ();
+
+  // pre-generate the inputs, so that only the error model is timed
+  std::vector<SpectrumValue> sinrs;
+  std::vector<std::vector<int> > maps;
+  for (uint32_t i = 0; i < 64; ++i)
+    {
+      SpectrumValue sinr (sm);
+      double meanDb = uniform->GetValue (-5.0, 30.0);
+      for (uint32_t rb = 0; rb < nRbs; ++rb)
+        {
+          sinr [rb] = std::pow (10.0, (meanDb + uniform->GetValue (-3.0, 3.0)) / 10.0);
+        }
+      sinrs.push_back (sinr);
+
+      std::vector<int> map;
+      uint32_t first = uniform->GetInteger (0, nRbs / 2);
+      uint32_t last = uniform->GetInteger (first, nRbs - 1);
+      for (uint32_t rb = first; rb <= last; ++rb)
+        {
+          map.push_back (rb);
+        }
+      maps.push_back (map);
+    }
+
+  double sum = 0.0;
+  auto start = std::chrono::steady_clock::now ();
+  for (uint32_t i = 0; i < calls; ++i)
+    {
+      uint8_t mcs = static_cast<uint8_t> (i % (em->GetMaxMcs () + 1));
+      uint32_t size = 100 + (i * 7919) % 20000;
+      MmWaveErrorModel::MmWaveErrorModelHistory history;
+      for (uint32_t retx = 0; retx <= i % (maxRetx + 1); ++retx)
+        {
+          const SpectrumValue &sinr = sinrs [(i + retx) % sinrs.size ()];
+          const std::vector<int> &map = maps [(i + retx) % maps.size ()];
+          Ptr<MmWaveErrorModelOutput> output = em->GetTbDecodificationStats (sinr, map, size, mcs, history);
+          sum += output->m_tbler;
+          history.push_back (output);
+        }
+    }
+  auto stop = std::chrono::steady_clock::now ();
+  double seconds = std::chrono::duration<double> (stop - start).count ();
+
+  std::cout << std::setw (24) << std::left << tid.GetName ()
+            << std::setw (12) << std::right << std::fixed << std::setprecision (3) << seconds << " s"
+            << std::setw (14) << static_cast<uint64_t> (calls / seconds) << " TB/s" << std::endl;
+  return sum;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t calls = 50000;
+  uint32_t numRbs = 72;
+  uint32_t maxRetx = 2;
+  bool useSimd = true;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("calls", "Number of TBs decoded by each error model", calls);
+  cmd.AddValue ("numRbs", "Number of RBs of the SINR vectors", numRbs);
+  cmd.AddValue ("maxRetx", "Maximum number of HARQ retransmissions of each TB", maxRetx);
+  cmd.AddValue ("useSimd", "Compute the EESM effective SINR with the AVX2 kernel, if available", useSimd);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::MmWaveEesmErrorModel::UseSimd", BooleanValue (useSimd));
+
+  Bands bands;
+  for (uint32_t rb = 0; rb < numRbs; ++rb)
+    {
+      BandInfo band;
+      band.fl = 28e9 + rb * 1.44e6;
+      band.fc = band.fl + 0.72e6;
+      band.fh = band.fl + 1.44e6;
+      bands.push_back (band);
+    }
+  Ptr<const SpectrumModel> sm = Create<SpectrumModel> (bands);
+
+  double sum = 0.0;
+  for (const std::string &name : {"ns3::MmWaveEesmCcT1", "ns3::MmWaveEesmCcT2",
+                                  "ns3::MmWaveEesmIrT1", "ns3::MmWaveEesmIrT2",
+                                  "ns3::MmWaveLteMiErrorModel"})
+    {
+      sum += Profile (TypeId::LookupByName (name), sm, calls, maxRetx);
+    }
+  std::cout << "checksum " << std::setprecision (6) << sum << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,170 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Counts the events scheduled by a lightly loaded mmWave network: a row of
+ * eNBs, each serving a few UEs with sparse UDP downlink traffic through the
+ * EPC, so that most slots carry only the control TTIs. Run it with and
+ * without --skipIdleSlots to compare the events per simulated second of
+ * the MmWavePhy::SkipIdleSlots mode with the default slot machinery.
+ *
+ * Example: ./waf --run "mmwave-idle-slot-profiler --numEnb=3 --skipIdleSlots=1"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mmwave-helper.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/mmwave-point-to-point-epc-helper.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace ns3;
+using namespace mmwave;
+
+/// Number of events executed when the applications started
+static uint64_t g_startEvents;
+/// Wall-clock time at which the applications started
+static std::chrono::steady_clock::time_point g_start;
+
+/**
+ * Store the event counter and the wall-clock time
+ */
+static void
+StartProfiling (void)
+{
+  g_startEvents = Simulator::GetEventCount ();
+  g_start = std::chrono::steady_clock::now ();
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint16_t numEnb = 3;
+  uint16_t numUePerEnb = 2;
+  double simTime = 1.0;
+  double interPacketInterval = 20000;
+  bool skipIdleSlots = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("numEnb", "Number of eNBs", numEnb);
+  cmd.AddValue ("numUePerEnb", "Number of UEs per eNB", numUePerEnb);
+  cmd.AddValue ("simTime", "Total duration of the simulation [s]", simTime);
+  cmd.AddValue ("interPacketInterval", "Inter-packet interval [us]", interPacketInterval);
+  cmd.AddValue ("skipIdleSlots", "Skip the events of the idle slots", skipIdleSlots);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::MmWavePhy::SkipIdleSlots", BooleanValue (skipIdleSlots));
+  Config::SetDefault ("ns3::MmWaveHelper::RlcAmEnabled", BooleanValue (false));
+
+  Ptr<MmWaveHelper> mmwaveHelper = CreateObject<MmWaveHelper> ();
+  mmwaveHelper->SetSchedulerType ("ns3::MmWaveFlexTtiMacScheduler");
+  Ptr<MmWavePointToPointEpcHelper> epcHelper = CreateObject<MmWavePointToPointEpcHelper> ();
+  mmwaveHelper->SetEpcHelper (epcHelper);
+
+  Ptr<Node> pgw = epcHelper->GetPgwNode ();
+  NodeContainer remoteHostContainer;
+  remoteHostContainer.Create (1);
+  Ptr<Node> remoteHost = remoteHostContainer.Get (0);
+  InternetStackHelper internet;
+  internet.Install (remoteHostContainer);
+
+  PointToPointHelper p2ph;
+  p2ph.SetDeviceAttribute ("DataRate", DataRateValue (DataRate ("100Gb/s")));
+  p2ph.SetDeviceAttribute ("Mtu", UintegerValue (1500));
+  p2ph.SetChannelAttribute ("Delay", TimeValue (Seconds (0.010)));
+  NetDeviceContainer internetDevices = p2ph.Install (pgw, remoteHost);
+  Ipv4AddressHelper ipv4h;
+  ipv4h.SetBase ("1.0.0.0", "255.0.0.0");
+  ipv4h.Assign (internetDevices);
+
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  Ptr<Ipv4StaticRouting> remoteHostStaticRouting = ipv4RoutingHelper.GetStaticRouting (remoteHost->GetObject<Ipv4> ());
+  remoteHostStaticRouting->AddNetworkRouteTo (Ipv4Address ("7.0.0.0"), Ipv4Mask ("255.0.0.0"), 1);
+
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (numEnb);
+  ueNodes.Create (numEnb * numUePerEnb);
+
+  Ptr<ListPositionAllocator> enbPositionAlloc = CreateObject<ListPositionAllocator> ();
+  Ptr<ListPositionAllocator> uePositionAlloc = CreateObject<ListPositionAllocator> ();
+  for (uint16_t i = 0; i < numEnb; i++)
+    {
+      enbPositionAlloc->Add (Vector (200.0 * i, 0.0, 10.0));
+      for (uint16_t u = 0; u < numUePerEnb; u++)
+        {
+          uePositionAlloc->Add (Vector (200.0 * i + 20.0 + 10.0 * u, 10.0, 1.5));
+        }
+    }
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (enbPositionAlloc);
+  mobility.Install (enbNodes);
+  mobility.SetPositionAllocator (uePositionAlloc);
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = mmwaveHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = mmwaveHelper->InstallUeDevice (ueNodes);
+
+  internet.Install (ueNodes);
+  Ipv4InterfaceContainer ueIpIface = epcHelper->AssignUeIpv4Address (NetDeviceContainer (ueDevs));
+  for (uint32_t u = 0; u < ueNodes.GetN (); ++u)
+    {
+      Ptr<Ipv4StaticRouting> ueStaticRouting = ipv4RoutingHelper.GetStaticRouting (ueNodes.Get (u)->GetObject<Ipv4> ());
+      ueStaticRouting->SetDefaultRoute (epcHelper->GetUeDefaultGatewayAddress (), 1);
+    }
+  mmwaveHelper->AttachToClosestEnb (ueDevs, enbDevs);
+
+  uint16_t dlPort = 1234;
+  ApplicationContainer clientApps;
+  ApplicationContainer serverApps;
+  for (uint32_t u = 0; u < ueNodes.GetN (); ++u)
+    {
+      PacketSinkHelper dlPacketSinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), dlPort));
+      serverApps.Add (dlPacketSinkHelper.Install (ueNodes.Get (u)));
+      UdpClientHelper dlClient (ueIpIface.GetAddress (u), dlPort);
+      dlClient.SetAttribute ("Interval", TimeValue (MicroSeconds (interPacketInterval)));
+      dlClient.SetAttribute ("MaxPackets", UintegerValue (1000000));
+      clientApps.Add (dlClient.Install (remoteHost));
+    }
+  serverApps.Start (Seconds (0.1));
+  clientApps.Start (Seconds (0.1));
+  Simulator::Schedule (Seconds (0.1), &StartProfiling);
+
+  Simulator::Stop (Seconds (simTime));
+  Simulator::Run ();
+  double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - g_start).count ();
+  uint64_t events = Simulator::GetEventCount () - g_startEvents;
+
+  uint64_t rxBytes = 0;
+  for (uint32_t i = 0; i < serverApps.GetN (); ++i)
+    {
+      rxBytes += DynamicCast<PacketSink> (serverApps.Get (i))->GetTotalRx ();
+    }
+
+  std::cout << "skip idle slots       " << (skipIdleSlots ? "yes" : "no") << std::endl
+            << "received bytes        " << rxBytes << std::endl
+            << "events                " << events << std::endl
+            << "events per sim second " << events / (simTime - 0.1) << std::endl
+            << "wall-clock time [s]   " << seconds << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
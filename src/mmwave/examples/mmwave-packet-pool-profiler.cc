@@ -0,0 +1,181 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Counts the heap allocations of packet buffers and tag lists in the
+ * scenario of mmwave-simple-epc (one eNB, UDP traffic in downlink and
+ * uplink through the EPC), without the traces. The counters are reset when
+ * the applications start, so that the configuration of the scenario is not
+ * counted. Build ns-3 with and without --disable-packet-pool to compare the
+ * size-class pool of PacketMemoryPool with the heap allocation.
+ *
+ * Example: ./waf --run "mmwave-packet-pool-profiler --numUe=4 --simTime=1"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mmwave-helper.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/mmwave-point-to-point-epc-helper.h"
+#include "ns3/packet-memory-pool.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace ns3;
+using namespace mmwave;
+
+/// Wall-clock time at which the counters were reset
+static std::chrono::steady_clock::time_point g_start;
+
+/**
+ * Reset the allocation counters and the wall-clock timer
+ */
+static void
+StartProfiling (void)
+{
+  PacketMemoryPool::ResetStats ();
+  g_start = std::chrono::steady_clock::now ();
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint16_t numUe = 1;
+  double simTime = 0.5;
+  double interPacketInterval = 100;
+  bool rlcAmEnabled = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("numUe", "Number of UEs", numUe);
+  cmd.AddValue ("simTime", "Total duration of the simulation [s]", simTime);
+  cmd.AddValue ("interPacketInterval", "Inter-packet interval [us]", interPacketInterval);
+  cmd.AddValue ("rlcAm", "Enable RLC-AM", rlcAmEnabled);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::MmWaveHelper::RlcAmEnabled", BooleanValue (rlcAmEnabled));
+  Config::SetDefault ("ns3::MmWaveHelper::HarqEnabled", BooleanValue (true));
+  Config::SetDefault ("ns3::MmWaveFlexTtiMacScheduler::HarqEnabled", BooleanValue (true));
+  Config::SetDefault ("ns3::LteRlcAm::ReportBufferStatusTimer", TimeValue (MicroSeconds (100.0)));
+  Config::SetDefault ("ns3::LteRlcUmLowLat::ReportBufferStatusTimer", TimeValue (MicroSeconds (100.0)));
+
+  Ptr<MmWaveHelper> mmwaveHelper = CreateObject<MmWaveHelper> ();
+  mmwaveHelper->SetSchedulerType ("ns3::MmWaveFlexTtiMacScheduler");
+  Ptr<MmWavePointToPointEpcHelper> epcHelper = CreateObject<MmWavePointToPointEpcHelper> ();
+  mmwaveHelper->SetEpcHelper (epcHelper);
+  mmwaveHelper->SetHarqEnabled (true);
+
+  Ptr<Node> pgw = epcHelper->GetPgwNode ();
+  NodeContainer remoteHostContainer;
+  remoteHostContainer.Create (1);
+  Ptr<Node> remoteHost = remoteHostContainer.Get (0);
+  InternetStackHelper internet;
+  internet.Install (remoteHostContainer);
+
+  PointToPointHelper p2ph;
+  p2ph.SetDeviceAttribute ("DataRate", DataRateValue (DataRate ("100Gb/s")));
+  p2ph.SetDeviceAttribute ("Mtu", UintegerValue (1500));
+  p2ph.SetChannelAttribute ("Delay", TimeValue (Seconds (0.010)));
+  NetDeviceContainer internetDevices = p2ph.Install (pgw, remoteHost);
+  Ipv4AddressHelper ipv4h;
+  ipv4h.SetBase ("1.0.0.0", "255.0.0.0");
+  Ipv4InterfaceContainer internetIpIfaces = ipv4h.Assign (internetDevices);
+  Ipv4Address remoteHostAddr = internetIpIfaces.GetAddress (1);
+
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  Ptr<Ipv4StaticRouting> remoteHostStaticRouting = ipv4RoutingHelper.GetStaticRouting (remoteHost->GetObject<Ipv4> ());
+  remoteHostStaticRouting->AddNetworkRouteTo (Ipv4Address ("7.0.0.0"), Ipv4Mask ("255.0.0.0"), 1);
+
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (1);
+  ueNodes.Create (numUe);
+
+  MobilityHelper enbMobility;
+  enbMobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  enbMobility.Install (enbNodes);
+  Ptr<ListPositionAllocator> uePositionAlloc = CreateObject<ListPositionAllocator> ();
+  for (uint16_t i = 0; i < numUe; i++)
+    {
+      uePositionAlloc->Add (Vector (10.0 + 10.0 * i, 0.0, 0.0));
+    }
+  MobilityHelper ueMobility;
+  ueMobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  ueMobility.SetPositionAllocator (uePositionAlloc);
+  ueMobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = mmwaveHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = mmwaveHelper->InstallUeDevice (ueNodes);
+
+  internet.Install (ueNodes);
+  Ipv4InterfaceContainer ueIpIface = epcHelper->AssignUeIpv4Address (NetDeviceContainer (ueDevs));
+  for (uint32_t u = 0; u < ueNodes.GetN (); ++u)
+    {
+      Ptr<Ipv4StaticRouting> ueStaticRouting = ipv4RoutingHelper.GetStaticRouting (ueNodes.Get (u)->GetObject<Ipv4> ());
+      ueStaticRouting->SetDefaultRoute (epcHelper->GetUeDefaultGatewayAddress (), 1);
+    }
+  mmwaveHelper->AttachToClosestEnb (ueDevs, enbDevs);
+
+  uint16_t dlPort = 1234;
+  uint16_t ulPort = 2000;
+  ApplicationContainer clientApps;
+  ApplicationContainer serverApps;
+  for (uint32_t u = 0; u < ueNodes.GetN (); ++u)
+    {
+      ++ulPort;
+      PacketSinkHelper dlPacketSinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), dlPort));
+      PacketSinkHelper ulPacketSinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), ulPort));
+      serverApps.Add (dlPacketSinkHelper.Install (ueNodes.Get (u)));
+      serverApps.Add (ulPacketSinkHelper.Install (remoteHost));
+
+      UdpClientHelper dlClient (ueIpIface.GetAddress (u), dlPort);
+      dlClient.SetAttribute ("Interval", TimeValue (MicroSeconds (interPacketInterval)));
+      dlClient.SetAttribute ("MaxPackets", UintegerValue (1000000));
+      UdpClientHelper ulClient (remoteHostAddr, ulPort);
+      ulClient.SetAttribute ("Interval", TimeValue (MicroSeconds (interPacketInterval)));
+      ulClient.SetAttribute ("MaxPackets", UintegerValue (1000000));
+      clientApps.Add (dlClient.Install (remoteHost));
+      clientApps.Add (ulClient.Install (ueNodes.Get (u)));
+    }
+  serverApps.Start (Seconds (0.1));
+  clientApps.Start (Seconds (0.1));
+  Simulator::Schedule (Seconds (0.1), &StartProfiling);
+
+  Simulator::Stop (Seconds (simTime));
+  Simulator::Run ();
+  double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - g_start).count ();
+  PacketMemoryPool::Stats stats = PacketMemoryPool::GetStats ();
+
+  uint64_t rxBytes = 0;
+  for (uint32_t i = 0; i < serverApps.GetN (); ++i)
+    {
+      rxBytes += DynamicCast<PacketSink> (serverApps.Get (i))->GetTotalRx ();
+    }
+
+  std::cout << "packet pool          " << (PacketMemoryPool::IsEnabled () ? "enabled" : "disabled") << std::endl
+            << "received bytes       " << rxBytes << std::endl
+            << "requests             " << stats.requests << std::endl
+            << "heap allocations     " << stats.heapAllocations << std::endl
+            << "heap deallocations   " << stats.heapDeallocations << std::endl
+            << "pooled blocks        " << stats.pooledBlocks << std::endl
+            << "pooled bytes         " << stats.pooledBytes << std::endl
+            << "wall-clock time [s]  " << seconds << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
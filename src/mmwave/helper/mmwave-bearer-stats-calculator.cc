@@ -35,11 +35,28 @@
 #include "ns3/nstime.h"
 #include <ns3/boolean.h>
 #include <ns3/log.h>
+#include <ns3/abort.h>
+#include <ns3/rng-seed-manager.h>
 #include <vector>
 #include <algorithm>
+#include <cctype>
+
+#ifdef MMWAVE_HAS_SQLITE_STATS
+#include <ns3/sqlite-output.h>
+#endif
 
 namespace ns3 {
 
+#ifndef MMWAVE_HAS_SQLITE_STATS
+/**
+ * Without SQLite support the database is never created, but m_db still
+ * needs a complete type to be destroyed
+ */
+class SQLiteOutput : public SimpleRefCount<SQLiteOutput>
+{
+};
+#endif
+
 NS_LOG_COMPONENT_DEFINE ("MmWaveBearerStatsCalculator");
 
 namespace mmwave {
@@ -111,6 +128,20 @@ MmWaveBearerStatsCalculator::GetTypeId (void)
                    StringValue ("UlPdcpStats.txt"),
                    MakeStringAccessor (&MmWaveBearerStatsCalculator::SetUlPdcpOutputFilename),
                    MakeStringChecker ())
+    .AddAttribute ("SqliteOutputFilename",
+                   "Name of the SQLite database where the statistics of each epoch are saved "
+                   "instead of the text files, by (IMSI, LCID, cell ID). If empty, the text files are used. "
+                   "Requires ns-3 to be built with SQLite support.",
+                   StringValue (""),
+                   MakeStringAccessor (&MmWaveBearerStatsCalculator::SetSqliteOutputFilename,
+                                       &MmWaveBearerStatsCalculator::GetSqliteOutputFilename),
+                   MakeStringChecker ())
+    .AddAttribute ("DelayHistogramBinWidth",
+                   "Width of the bins of the histograms of the PDU delay saved in the SQLite database. "
+                   "If zero, the histograms are not saved.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&MmWaveBearerStatsCalculator::m_delayHistogramBinWidth),
+                   MakeTimeChecker (Seconds (0)))
   ;
   return tid;
 }
@@ -123,6 +154,15 @@ MmWaveBearerStatsCalculator::DoDispose ()
     {
       ShowResults ();
     }
+  if (m_ulOutFile.is_open ())
+    {
+      m_ulOutFile.close ();
+    }
+  if (m_dlOutFile.is_open ())
+    {
+      m_dlOutFile.close ();
+    }
+  m_db = nullptr;
 }
 
 void
@@ -170,6 +210,13 @@ MmWaveBearerStatsCalculator::UlTxPdu (uint16_t cellId, uint64_t imsi, uint16_t r
         m_flowId[p] = LteFlowId_t (rnti, lcid);
         m_ulTxPackets[p]++;
         m_ulTxData[p] += packetSize;
+        if (!m_sqliteFilename.empty ())
+          {
+            CellBearerStats &stats = GetCellBearerStats (m_ulCellStats, cellId, imsi, lcid);
+            stats.rnti = rnti;
+            stats.txPackets++;
+            stats.txData += packetSize;
+          }
       }
     m_pendingOutput = true;
   }
@@ -182,7 +229,7 @@ MmWaveBearerStatsCalculator::UlTxPdu (uint16_t cellId, uint64_t imsi, uint16_t r
       }
     m_ulOutFile << "Tx\t" << Simulator::Now ().GetNanoSeconds () / 1.0e9 << "\t" 
     << cellId << "\t" << imsi << "\t" << rnti << "\t" << (uint32_t) lcid << "\t" 
-    << packetSize << "\t" << 0 << "\t" << std::endl;
+    << packetSize << "\t" << 0 << "\t" << "\n";
   }
 }
 
@@ -199,6 +246,13 @@ MmWaveBearerStatsCalculator::DlTxPdu (uint16_t cellId, uint64_t imsi, uint16_t r
         m_flowId[p] = LteFlowId_t (rnti, lcid);
         m_dlTxPackets[p]++;
         m_dlTxData[p] += packetSize;
+        if (!m_sqliteFilename.empty ())
+          {
+            CellBearerStats &stats = GetCellBearerStats (m_dlCellStats, cellId, imsi, lcid);
+            stats.rnti = rnti;
+            stats.txPackets++;
+            stats.txData += packetSize;
+          }
       }
     m_pendingOutput = true;
   }            
@@ -211,7 +265,7 @@ MmWaveBearerStatsCalculator::DlTxPdu (uint16_t cellId, uint64_t imsi, uint16_t r
       }
     m_dlOutFile << "Tx\t" << Simulator::Now ().GetNanoSeconds () / 1.0e9 << "\t" 
     << cellId << "\t" << imsi << "\t" << rnti << "\t" << (uint32_t) lcid << "\t" 
-    << packetSize << "\t" << 0 << "\t" << std::endl;
+    << packetSize << "\t" << 0 << "\t" << "\n";
   }
 }
 
@@ -238,6 +292,12 @@ MmWaveBearerStatsCalculator::UlRxPdu (uint16_t cellId, uint64_t imsi, uint16_t r
           }
         m_ulDelay[p]->Update (delay);
         m_ulPduSize[p]->Update (packetSize);
+        if (!m_sqliteFilename.empty ())
+          {
+            CellBearerStats &stats = GetCellBearerStats (m_ulCellStats, cellId, imsi, lcid);
+            stats.rnti = rnti;
+            UpdateRxStats (stats, packetSize, delay);
+          }
       }
     m_pendingOutput = true;
   }
@@ -250,7 +310,7 @@ MmWaveBearerStatsCalculator::UlRxPdu (uint16_t cellId, uint64_t imsi, uint16_t r
       }
     m_ulOutFile << "Rx\t" << Simulator::Now ().GetNanoSeconds () / 1.0e9 << "\t" 
     << cellId << "\t" << imsi << "\t" << rnti << "\t" << (uint32_t) lcid << "\t" 
-    << packetSize << "\t" << delay << "\t" << std::endl;
+    << packetSize << "\t" << delay << "\t" << "\n";
   }
 }
 
@@ -276,6 +336,12 @@ MmWaveBearerStatsCalculator::DlRxPdu (uint16_t cellId, uint64_t imsi, uint16_t r
       }
       m_dlDelay[p]->Update (delay);
       m_dlPduSize[p]->Update (packetSize);
+      if (!m_sqliteFilename.empty ())
+        {
+          CellBearerStats &stats = GetCellBearerStats (m_dlCellStats, cellId, imsi, lcid);
+          stats.rnti = rnti;
+          UpdateRxStats (stats, packetSize, delay);
+        }
     }
     m_pendingOutput = true;
   }
@@ -288,7 +354,7 @@ MmWaveBearerStatsCalculator::DlRxPdu (uint16_t cellId, uint64_t imsi, uint16_t r
     }
     m_dlOutFile << "Rx\t" << Simulator::Now ().GetNanoSeconds () / 1.0e9 << "\t" 
     << cellId << "\t" << imsi << "\t" << rnti << "\t" << (uint32_t) lcid << "\t" 
-    << packetSize << "\t" << delay << "\t" << std::endl;
+    << packetSize << "\t" << delay << "\t" << "\n";
   }
 }
 
@@ -296,6 +362,13 @@ void
 MmWaveBearerStatsCalculator::ShowResults (void)
 {
 
+  if (!m_sqliteFilename.empty ())
+    {
+      WriteDbResults ();
+      m_pendingOutput = false;
+      return;
+    }
+
   NS_LOG_FUNCTION (this << GetUlOutputFilename ().c_str () << GetDlOutputFilename ().c_str ());
   NS_LOG_INFO ("Write stats in " << GetUlOutputFilename ().c_str () << " and in " << GetDlOutputFilename ().c_str ());
 
@@ -441,6 +514,163 @@ MmWaveBearerStatsCalculator::WriteDlResults (std::ofstream& outFile)
   outFile.close ();
 }
 
+MmWaveBearerStatsCalculator::CellBearerStats &
+MmWaveBearerStatsCalculator::GetCellBearerStats (CellBearerStatsMap &stats, uint16_t cellId, uint64_t imsi, uint8_t lcid)
+{
+  ImsiLcidCellId_t key (ImsiLcidPair_t (imsi, lcid), cellId);
+  CellBearerStatsMap::iterator it = stats.find (key);
+  if (it == stats.end ())
+    {
+      it = stats.insert (std::make_pair (key, CellBearerStats ())).first;
+      if (m_delayHistogramBinWidth.IsStrictlyPositive ())
+        {
+          it->second.delayHistogram.SetDefaultBinWidth (m_delayHistogramBinWidth.GetSeconds ());
+        }
+    }
+  return it->second;
+}
+
+void
+MmWaveBearerStatsCalculator::UpdateRxStats (CellBearerStats &stats, uint32_t packetSize, uint64_t delay)
+{
+  stats.rxPackets++;
+  stats.rxData += packetSize;
+  if (stats.delay == 0)
+    {
+      stats.delay = CreateObject<MinMaxAvgTotalCalculator<uint64_t> > ();
+      stats.pduSize = CreateObject<MinMaxAvgTotalCalculator<uint32_t> > ();
+    }
+  stats.delay->Update (delay);
+  stats.pduSize->Update (packetSize);
+  if (m_delayHistogramBinWidth.IsStrictlyPositive ())
+    {
+      stats.delayHistogram.AddValue (delay * 1e-9);
+    }
+}
+
+void
+MmWaveBearerStatsCalculator::WriteDbResults (void)
+{
+  NS_LOG_FUNCTION (this << m_sqliteFilename);
+#ifdef MMWAVE_HAS_SQLITE_STATS
+  std::string protocol = m_protocolType;
+  std::transform (protocol.begin (), protocol.end (), protocol.begin (), ::tolower);
+  if (m_db == nullptr)
+    {
+      m_db = Create<SQLiteOutput> (m_sqliteFilename, "ns3-mmwave-bearer-stats");
+      bool ret = m_db->WaitExec ("CREATE TABLE IF NOT EXISTS " + protocol + "_bearer_stats ("
+                                 "seed INTEGER NOT NULL, run INTEGER NOT NULL, direction TEXT NOT NULL, "
+                                 "start DOUBLE NOT NULL, end DOUBLE NOT NULL, cellId INTEGER NOT NULL, "
+                                 "imsi INTEGER NOT NULL, rnti INTEGER NOT NULL, lcid INTEGER NOT NULL, "
+                                 "nTxPDUs INTEGER NOT NULL, txBytes INTEGER NOT NULL, "
+                                 "nRxPDUs INTEGER NOT NULL, rxBytes INTEGER NOT NULL, "
+                                 "delay DOUBLE, delayStdDev DOUBLE, delayMin DOUBLE, delayMax DOUBLE, "
+                                 "pduSize DOUBLE, pduSizeStdDev DOUBLE, pduSizeMin DOUBLE, pduSizeMax DOUBLE);");
+      NS_ABORT_MSG_UNLESS (ret, "Can't create the table of the bearer statistics in " << m_sqliteFilename);
+      ret = m_db->WaitExec ("CREATE TABLE IF NOT EXISTS " + protocol + "_delay_histogram ("
+                            "seed INTEGER NOT NULL, run INTEGER NOT NULL, direction TEXT NOT NULL, "
+                            "start DOUBLE NOT NULL, cellId INTEGER NOT NULL, imsi INTEGER NOT NULL, "
+                            "lcid INTEGER NOT NULL, binStart DOUBLE NOT NULL, binEnd DOUBLE NOT NULL, "
+                            "count INTEGER NOT NULL);");
+      NS_ABORT_MSG_UNLESS (ret, "Can't create the table of the delay histograms in " << m_sqliteFilename);
+    }
+
+  // a transaction for each epoch, instead of one for each row
+  bool ret = m_db->WaitExec ("BEGIN TRANSACTION;");
+  NS_ABORT_MSG_UNLESS (ret, "Can't begin a transaction in " << m_sqliteFilename);
+  WriteDbResults ("UL", m_ulCellStats);
+  WriteDbResults ("DL", m_dlCellStats);
+  ret = m_db->WaitExec ("END TRANSACTION;");
+  NS_ABORT_MSG_UNLESS (ret, "Can't end a transaction in " << m_sqliteFilename);
+#endif
+}
+
+void
+MmWaveBearerStatsCalculator::WriteDbResults (const std::string &direction, CellBearerStatsMap &stats)
+{
+  NS_LOG_FUNCTION (this << direction);
+#ifdef MMWAVE_HAS_SQLITE_STATS
+  std::string protocol = m_protocolType;
+  std::transform (protocol.begin (), protocol.end (), protocol.begin (), ::tolower);
+  long long seed = RngSeedManager::GetSeed ();
+  long long run = RngSeedManager::GetRun ();
+  double start = m_startTime.GetSeconds ();
+  double end = (m_startTime + m_epochDuration).GetSeconds ();
+
+  sqlite3_stmt *statsStmt;
+  sqlite3_stmt *histogramStmt;
+  bool ret = m_db->SpinPrepare (&statsStmt, "INSERT INTO " + protocol + "_bearer_stats VALUES "
+                                "(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);");
+  NS_ABORT_MSG_UNLESS (ret, "Can't prepare the insertion of the bearer statistics");
+  ret = m_db->SpinPrepare (&histogramStmt, "INSERT INTO " + protocol + "_delay_histogram VALUES "
+                           "(?,?,?,?,?,?,?,?,?,?);");
+  NS_ABORT_MSG_UNLESS (ret, "Can't prepare the insertion of the delay histograms");
+
+  for (CellBearerStatsMap::iterator it = stats.begin (); it != stats.end (); ++it)
+    {
+      const ImsiLcidPair_t &p = it->first.first;
+      uint16_t cellId = it->first.second;
+      CellBearerStats &s = it->second;
+      long long imsi = p.m_imsi;
+
+      sqlite3_clear_bindings (statsStmt);
+      m_db->Bind (statsStmt, 1, seed);
+      m_db->Bind (statsStmt, 2, run);
+      m_db->Bind (statsStmt, 3, direction);
+      m_db->Bind (statsStmt, 4, start);
+      m_db->Bind (statsStmt, 5, end);
+      m_db->Bind (statsStmt, 6, cellId);
+      m_db->Bind (statsStmt, 7, imsi);
+      m_db->Bind (statsStmt, 8, s.rnti);
+      m_db->Bind (statsStmt, 9, p.m_lcId);
+      m_db->Bind (statsStmt, 10, static_cast<long long> (s.txPackets));
+      m_db->Bind (statsStmt, 11, static_cast<long long> (s.txData));
+      m_db->Bind (statsStmt, 12, static_cast<long long> (s.rxPackets));
+      m_db->Bind (statsStmt, 13, static_cast<long long> (s.rxData));
+      if (s.delay != 0)
+        {
+          // without received PDUs, the delay and size columns are NULL
+          m_db->Bind (statsStmt, 14, s.delay->getMean () * 1e-9);
+          m_db->Bind (statsStmt, 15, s.delay->getStddev () * 1e-9);
+          m_db->Bind (statsStmt, 16, s.delay->getMin () * 1e-9);
+          m_db->Bind (statsStmt, 17, s.delay->getMax () * 1e-9);
+          m_db->Bind (statsStmt, 18, s.pduSize->getMean ());
+          m_db->Bind (statsStmt, 19, s.pduSize->getStddev ());
+          m_db->Bind (statsStmt, 20, static_cast<double> (s.pduSize->getMin ()));
+          m_db->Bind (statsStmt, 21, static_cast<double> (s.pduSize->getMax ()));
+        }
+      int rc = SQLiteOutput::SpinStep (statsStmt);
+      NS_ABORT_MSG_UNLESS (rc == SQLITE_DONE, "Can't insert the bearer statistics, error " << rc);
+      SQLiteOutput::SpinReset (statsStmt);
+
+      for (uint32_t i = 0; i < s.delayHistogram.GetNBins (); ++i)
+        {
+          long long count = s.delayHistogram.GetBinCount (i);
+          if (count == 0)
+            {
+              continue;
+            }
+          m_db->Bind (histogramStmt, 1, seed);
+          m_db->Bind (histogramStmt, 2, run);
+          m_db->Bind (histogramStmt, 3, direction);
+          m_db->Bind (histogramStmt, 4, start);
+          m_db->Bind (histogramStmt, 5, cellId);
+          m_db->Bind (histogramStmt, 6, imsi);
+          m_db->Bind (histogramStmt, 7, p.m_lcId);
+          m_db->Bind (histogramStmt, 8, s.delayHistogram.GetBinStart (i));
+          m_db->Bind (histogramStmt, 9, s.delayHistogram.GetBinEnd (i));
+          m_db->Bind (histogramStmt, 10, count);
+          rc = SQLiteOutput::SpinStep (histogramStmt);
+          NS_ABORT_MSG_UNLESS (rc == SQLITE_DONE, "Can't insert the delay histogram, error " << rc);
+          SQLiteOutput::SpinReset (histogramStmt);
+        }
+    }
+
+  SQLiteOutput::SpinFinalize (statsStmt);
+  SQLiteOutput::SpinFinalize (histogramStmt);
+#endif
+}
+
 void
 MmWaveBearerStatsCalculator::ResetResults (void)
 {
@@ -459,6 +689,9 @@ MmWaveBearerStatsCalculator::ResetResults (void)
   m_dlTxData.erase (m_dlTxData.begin (), m_dlTxData.end ());
   m_dlDelay.erase (m_dlDelay.begin (), m_dlDelay.end ());
   m_dlPduSize.erase (m_dlPduSize.begin (), m_dlPduSize.end ());
+
+  m_ulCellStats.clear ();
+  m_dlCellStats.clear ();
 }
 
 void
@@ -466,8 +699,14 @@ MmWaveBearerStatsCalculator::RescheduleEndEpoch (void)
 {
   NS_LOG_FUNCTION (this);
   m_endEpochEvent.Cancel ();
-  NS_ASSERT (Simulator::Now ().GetMilliSeconds () == 0); // below event time assumes this
-  m_endEpochEvent = Simulator::Schedule (m_startTime + m_epochDuration, &MmWaveBearerStatsCalculator::EndEpoch, this);
+  // a calculator created during the simulation, e.g., by the worker of a
+  // ReplicationRunner after the warm-up, starts its first epoch when created
+  if (m_startTime < Simulator::Now ())
+    {
+      m_startTime = Simulator::Now ();
+    }
+  m_endEpochEvent = Simulator::Schedule (m_startTime + m_epochDuration - Simulator::Now (),
+                                         &MmWaveBearerStatsCalculator::EndEpoch, this);
 }
 
 void
@@ -730,6 +969,23 @@ MmWaveBearerStatsCalculator::GetDlPdcpOutputFilename (void)
   return m_dlPdcpOutputFilename;
 }
 
+void
+MmWaveBearerStatsCalculator::SetSqliteOutputFilename (std::string outputFilename)
+{
+#ifndef MMWAVE_HAS_SQLITE_STATS
+  // fail before the simulation runs, rather than at the end of the first epoch
+  NS_ABORT_MSG_UNLESS (outputFilename.empty (),
+                       "SqliteOutputFilename requires ns-3 to be built with SQLite support");
+#endif
+  m_sqliteFilename = outputFilename;
+}
+
+std::string
+MmWaveBearerStatsCalculator::GetSqliteOutputFilename (void) const
+{
+  return m_sqliteFilename;
+}
+
 } // namespace mmwave
 
 } // namespace ns3
@@ -34,6 +34,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/object.h"
 #include "ns3/basic-data-calculators.h"
+#include "ns3/histogram.h"
 #include "ns3/lte-common.h"
 #include <string>
 #include <map>
@@ -41,6 +42,8 @@
 
 namespace ns3 {
 
+class SQLiteOutput;
+
 namespace mmwave {
 
 /// Container: (IMSI, LCID) pair, uint32_t
@@ -55,6 +58,8 @@ typedef std::map<ImsiLcidPair_t, Ptr<MinMaxAvgTotalCalculator<uint64_t> > > Uint
 typedef std::map<ImsiLcidPair_t, double> DoubleMap;
 /// Container: (IMSI, LCID) pair, LteFlowId_t
 typedef std::map<ImsiLcidPair_t, LteFlowId_t> FlowIdMap;
+/// (IMSI, LCID) pair and cell ID
+typedef std::pair<ImsiLcidPair_t, uint16_t> ImsiLcidCellId_t;
 
 /**
  * \ingroup lte
@@ -75,6 +80,18 @@ typedef std::map<ImsiLcidPair_t, LteFlowId_t> FlowIdMap;
  *   - Average, min, max and standard deviation of PDU delay (delay is
  *     calculated from the generation of the PDU to its reception)
  *   - Average, min, max and standard deviation of PDU size
+ *
+ * If the SqliteOutputFilename attribute is set, the statistics of each
+ * epoch are written in an SQLite database instead of the text files, with
+ * a row for each (IMSI, LCID, cell ID), so that the PDUs of a bearer are
+ * split between the cells that served it during the epoch. If the
+ * DelayHistogramBinWidth attribute is not zero, the database also holds
+ * the histograms of the delay of the received PDUs. The rows carry the
+ * seed and run number of the simulation, so that several runs can write
+ * in the same database.
+ *
+ * If the AggregatedStats attribute is false, a line is written in the text
+ * files for each PDU instead.
  */
 class MmWaveBearerStatsCalculator : public LteStatsCalculator
 {
@@ -141,6 +158,20 @@ public:
    */
   std::string GetDlPdcpOutputFilename (void);
 
+  /**
+   * Set the name of the SQLite database where the statistics will be stored
+   * instead of the text files. Aborts if the name is not empty and ns-3 is
+   * built without SQLite support.
+   *
+   * @param outputFilename string with the name of the database, empty to use the text files
+   */
+  void SetSqliteOutputFilename (std::string outputFilename);
+
+  /**
+   * Get the name of the SQLite database where the statistics will be stored.
+   * @return the name of the database, empty if the text files are used
+   */
+  std::string GetSqliteOutputFilename (void) const;
 
   /**
    *
@@ -357,6 +388,25 @@ public:
   GetDlPduSizeStats (uint64_t imsi, uint8_t lcid);
 
 private:
+  /**
+   * Statistics of a radio bearer served by a cell during an epoch, in one
+   * direction, written in the SQLite database
+   */
+  struct CellBearerStats
+  {
+    uint16_t rnti {0}; //!< C-RNTI of the UE in the cell
+    uint32_t txPackets {0}; //!< Number of TX PDUs
+    uint64_t txData {0}; //!< Amount of TX data
+    uint32_t rxPackets {0}; //!< Number of RX PDUs
+    uint64_t rxData {0}; //!< Amount of RX data
+    Ptr<MinMaxAvgTotalCalculator<uint64_t> > delay; //!< Delay of the RX PDUs
+    Ptr<MinMaxAvgTotalCalculator<uint32_t> > pduSize; //!< Size of the RX PDUs
+    Histogram delayHistogram; //!< Histogram of the delay of the RX PDUs, in seconds
+  };
+
+  /// Container: (IMSI, LCID, cell ID), CellBearerStats
+  typedef std::map<ImsiLcidCellId_t, CellBearerStats> CellBearerStatsMap;
+
   /**
    * Called after each epoch to write collected
    * statistics to output files. During first call
@@ -366,6 +416,21 @@ private:
   void
   ShowResults (void);
 
+  /**
+   * Writes the statistics of the epoch in the SQLite database. During the
+   * first call it opens the database and creates the tables.
+   */
+  void
+  WriteDbResults (void);
+
+  /**
+   * Writes the statistics of a direction in the SQLite database.
+   * @param direction "DL" or "UL"
+   * @param stats the statistics of the epoch by (IMSI, LCID, cell ID)
+   */
+  void
+  WriteDbResults (const std::string &direction, CellBearerStatsMap &stats);
+
   /**
    * Writes collected statistics to UL output file and
    * closes UL output file.
@@ -403,6 +468,29 @@ private:
 
   EventId m_endEpochEvent; //!< Event id for next end epoch event
 
+  /**
+   * Gets the statistics of a bearer in a cell, and creates them if needed
+   * @param stats the statistics of a direction
+   * @param cellId the cell ID
+   * @param imsi the IMSI of the UE
+   * @param lcid the LCID
+   * @return the statistics of the bearer in the cell
+   */
+  CellBearerStats &
+  GetCellBearerStats (CellBearerStatsMap &stats, uint16_t cellId, uint64_t imsi, uint8_t lcid);
+
+  /**
+   * Updates the statistics of a received PDU
+   * @param stats the statistics of the bearer in the cell
+   * @param packetSize size of the PDU in bytes
+   * @param delay delay of the PDU in nanoseconds
+   */
+  void
+  UpdateRxStats (CellBearerStats &stats, uint32_t packetSize, uint64_t delay);
+
+  CellBearerStatsMap m_dlCellStats; //!< DL statistics by (IMSI, LCID, cell ID), for the database
+  CellBearerStatsMap m_ulCellStats; //!< UL statistics by (IMSI, LCID, cell ID), for the database
+
   FlowIdMap m_flowId; //!< List of FlowIds, ie. (RNTI, LCID) by (IMSI, LCID) pair
 
   Uint32Map m_dlCellId; //!< List of DL CellIds by (IMSI, LCID) pair
@@ -463,6 +551,22 @@ private:
 
   std::ofstream m_dlOutFile;
   std::ofstream m_ulOutFile;
+
+  /**
+   * Name of the SQLite database where the statistics are written instead
+   * of the text files, empty to use the text files
+   */
+  std::string m_sqliteFilename;
+
+  /**
+   * Width of the bins of the delay histograms, zero to disable them
+   */
+  Time m_delayHistogramBinWidth;
+
+  /**
+   * The SQLite database, opened at the end of the first epoch
+   */
+  Ptr<SQLiteOutput> m_db;
 };
 
 } // namespace mmwave
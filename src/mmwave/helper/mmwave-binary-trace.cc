@@ -0,0 +1,341 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "mmwave-binary-trace.h"
+#include "mmwave-phy-trace.h"
+#include "mmwave-mac-trace.h"
+#include <ns3/log.h>
+#include <ns3/fatal-error.h>
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveBinaryTrace");
+
+namespace mmwave {
+
+/// Magic string at the beginning of a binary trace file
+static const char BINARY_TRACE_MAGIC[8] = {'M', 'M', 'W', 'T', 'R', 'A', 'C', 'E'};
+/// Version of the binary trace format
+static const uint16_t BINARY_TRACE_VERSION = 1;
+/// Value written in the header to detect the byte order of the writer
+static const uint32_t BINARY_TRACE_BYTE_ORDER = 0x01020304;
+/// Size of the header of a binary trace file
+static const std::size_t BINARY_TRACE_HEADER_SIZE = sizeof (BINARY_TRACE_MAGIC) + 2 + 1 + 4;
+
+/// Size of a RX_PACKET record
+static const std::size_t RX_PACKET_RECORD_SIZE = 1 + 8 + 8 + 1 + 2 + 2 + 4 * 1 + 4 + 2 * 1 + 3 * 8 + 1;
+/// Size of a PHY_TRANSMISSION record
+static const std::size_t PHY_TRANSMISSION_RECORD_SIZE = 4 * 1 + 2 + 5 * 1;
+/// Size of a SCHED_ALLOC record
+static const std::size_t SCHED_ALLOC_RECORD_SIZE = 2 + 2 * 1 + 2 + 6 * 1;
+
+/**
+ * \param type the type of the records
+ * \return the size of a record of that type, 0 if the type is unknown
+ */
+static std::size_t
+GetRecordSize (uint8_t type)
+{
+  switch (type)
+    {
+    case MmWaveBinaryTraceWriter::RX_PACKET:
+      return RX_PACKET_RECORD_SIZE;
+    case MmWaveBinaryTraceWriter::PHY_TRANSMISSION:
+      return PHY_TRANSMISSION_RECORD_SIZE;
+    case MmWaveBinaryTraceWriter::SCHED_ALLOC:
+      return SCHED_ALLOC_RECORD_SIZE;
+    default:
+      return 0;
+    }
+}
+
+/**
+ * Read a field of a record and advance the cursor
+ * \param cursor the position of the field
+ * \return the value of the field
+ */
+template <class T>
+static T
+ReadField (const uint8_t *&cursor)
+{
+  T value;
+  std::memcpy (&value, cursor, sizeof (T));
+  cursor += sizeof (T);
+  return value;
+}
+
+MmWaveBinaryTraceWriter::MmWaveBinaryTraceWriter (std::size_t bufferSize)
+  : m_file (0),
+    m_buffer (bufferSize),
+    m_used (0),
+    m_type (RX_PACKET)
+{
+}
+
+MmWaveBinaryTraceWriter::~MmWaveBinaryTraceWriter ()
+{
+  Close ();
+}
+
+void
+MmWaveBinaryTraceWriter::Open (const std::string &fileName, RecordType type)
+{
+  NS_LOG_FUNCTION (this << fileName << type);
+  Close ();
+  m_file = std::fopen (fileName.c_str (), "wb");
+  if (m_file == 0)
+    {
+      NS_FATAL_ERROR ("Could not open tracefile " << fileName);
+    }
+  m_type = type;
+  m_used = 0;
+
+  Reserve (BINARY_TRACE_HEADER_SIZE);
+  for (char c : BINARY_TRACE_MAGIC)
+    {
+      Append<char> (c);
+    }
+  Append<uint16_t> (BINARY_TRACE_VERSION);
+  Append<uint8_t> (type);
+  Append<uint32_t> (BINARY_TRACE_BYTE_ORDER);
+}
+
+bool
+MmWaveBinaryTraceWriter::IsOpen (void) const
+{
+  return m_file != 0;
+}
+
+void
+MmWaveBinaryTraceWriter::Flush (void)
+{
+  if (m_file != 0 && m_used > 0)
+    {
+      if (std::fwrite (m_buffer.data (), 1, m_used, m_file) != m_used)
+        {
+          NS_FATAL_ERROR ("Could not write to the binary tracefile");
+        }
+    }
+  m_used = 0;
+}
+
+void
+MmWaveBinaryTraceWriter::Close (void)
+{
+  if (m_file != 0)
+    {
+      Flush ();
+      std::fclose (m_file);
+      m_file = 0;
+    }
+}
+
+void
+MmWaveBinaryTraceWriter::Reserve (std::size_t size)
+{
+  if (m_used + size > m_buffer.size ())
+    {
+      Flush ();
+      if (size > m_buffer.size ())
+        {
+          m_buffer.resize (size);
+        }
+    }
+}
+
+template <class T>
+void
+MmWaveBinaryTraceWriter::Append (T value)
+{
+  std::memcpy (m_buffer.data () + m_used, &value, sizeof (T));
+  m_used += sizeof (T);
+}
+
+void
+MmWaveBinaryTraceWriter::WriteRxPacket (bool isDownlink, double time, const RxPacketTraceParams &params)
+{
+  NS_ASSERT_MSG (m_type == RX_PACKET, "The file does not contain RX_PACKET records");
+  Reserve (RX_PACKET_RECORD_SIZE);
+  Append<uint8_t> (isDownlink);
+  Append<double> (time);
+  Append<uint64_t> (params.m_cellId);
+  Append<uint8_t> (params.m_ccId);
+  Append<uint16_t> (params.m_rnti);
+  Append<uint16_t> (params.m_frameNum);
+  Append<uint8_t> (params.m_sfNum);
+  Append<uint8_t> (params.m_slotNum);
+  Append<uint8_t> (params.m_symStart);
+  Append<uint8_t> (params.m_numSym);
+  Append<uint32_t> (params.m_tbSize);
+  Append<uint8_t> (params.m_mcs);
+  Append<uint8_t> (params.m_rv);
+  Append<double> (params.m_sinr);
+  Append<double> (params.m_sinrMin);
+  Append<double> (params.m_tbler);
+  Append<uint8_t> (params.m_corrupt);
+}
+
+void
+MmWaveBinaryTraceWriter::WritePhyTransmission (const PhyTransmissionTraceParams &params)
+{
+  NS_ASSERT_MSG (m_type == PHY_TRANSMISSION, "The file does not contain PHY_TRANSMISSION records");
+  Reserve (PHY_TRANSMISSION_RECORD_SIZE);
+  Append<uint8_t> (params.m_tddMode);
+  Append<uint8_t> (params.m_slotNum);
+  Append<uint8_t> (params.m_sfNum);
+  Append<uint8_t> (params.m_frameNum);
+  Append<uint16_t> (params.m_rnti);
+  Append<uint8_t> (params.m_symStart);
+  Append<uint8_t> (params.m_numSym);
+  Append<uint8_t> (params.m_ttiType);
+  Append<uint8_t> (params.m_rv);
+  Append<uint8_t> (params.m_ccId);
+}
+
+void
+MmWaveBinaryTraceWriter::WriteSchedAlloc (const SfnSf &sfn, const TtiAllocInfo &tti, uint8_t ccId)
+{
+  NS_ASSERT_MSG (m_type == SCHED_ALLOC, "The file does not contain SCHED_ALLOC records");
+  Reserve (SCHED_ALLOC_RECORD_SIZE);
+  Append<uint16_t> (sfn.m_frameNum);
+  Append<uint8_t> (sfn.m_sfNum);
+  Append<uint8_t> (sfn.m_slotNum);
+  Append<uint16_t> (tti.m_dci.m_rnti);
+  Append<uint8_t> (tti.m_dci.m_symStart);
+  Append<uint8_t> (tti.m_dci.m_numSym);
+  Append<uint8_t> (tti.m_ttiType);
+  Append<uint8_t> (tti.m_tddMode);
+  Append<uint8_t> (tti.m_dci.m_rv);
+  Append<uint8_t> (ccId);
+}
+
+uint64_t
+MmWaveBinaryTraceReader::ConvertToText (const std::string &fileName, std::ostream &os)
+{
+  NS_LOG_FUNCTION (fileName);
+  FILE *file = std::fopen (fileName.c_str (), "rb");
+  if (file == 0)
+    {
+      NS_FATAL_ERROR ("Could not open tracefile " << fileName);
+    }
+
+  uint8_t header[BINARY_TRACE_HEADER_SIZE];
+  if (std::fread (header, 1, BINARY_TRACE_HEADER_SIZE, file) != BINARY_TRACE_HEADER_SIZE
+      || std::memcmp (header, BINARY_TRACE_MAGIC, sizeof (BINARY_TRACE_MAGIC)) != 0)
+    {
+      std::fclose (file);
+      NS_FATAL_ERROR (fileName << " is not a binary mmWave trace file");
+    }
+  const uint8_t *cursor = header + sizeof (BINARY_TRACE_MAGIC);
+  uint16_t version = ReadField<uint16_t> (cursor);
+  uint8_t type = ReadField<uint8_t> (cursor);
+  uint32_t byteOrder = ReadField<uint32_t> (cursor);
+  std::size_t recordSize = GetRecordSize (type);
+  if (byteOrder != BINARY_TRACE_BYTE_ORDER || version != BINARY_TRACE_VERSION || recordSize == 0)
+    {
+      std::fclose (file);
+      NS_FATAL_ERROR (fileName << ": unsupported version " << version << ", record type " << +type
+                               << " or byte order");
+    }
+
+  switch (type)
+    {
+    case MmWaveBinaryTraceWriter::RX_PACKET:
+      MmWavePhyTrace::WriteRxPacketTraceHeader (os);
+      break;
+    case MmWaveBinaryTraceWriter::PHY_TRANSMISSION:
+      MmWavePhyTrace::WritePhyTransmissionTraceHeader (os);
+      break;
+    case MmWaveBinaryTraceWriter::SCHED_ALLOC:
+      MmWaveMacTrace::WriteSchedAllocTraceHeader (os);
+      break;
+    }
+
+  // read many records at a time
+  std::vector<uint8_t> buffer (recordSize * 16384);
+  uint64_t numRecords = 0;
+  std::size_t read;
+  while ((read = std::fread (buffer.data (), recordSize, buffer.size () / recordSize, file)) > 0)
+    {
+      for (std::size_t r = 0; r < read; ++r)
+        {
+          cursor = buffer.data () + r * recordSize;
+          if (type == MmWaveBinaryTraceWriter::RX_PACKET)
+            {
+              RxPacketTraceParams params;
+              bool isDownlink = ReadField<uint8_t> (cursor);
+              double time = ReadField<double> (cursor);
+              params.m_cellId = ReadField<uint64_t> (cursor);
+              params.m_ccId = ReadField<uint8_t> (cursor);
+              params.m_rnti = ReadField<uint16_t> (cursor);
+              params.m_frameNum = ReadField<uint16_t> (cursor);
+              params.m_sfNum = ReadField<uint8_t> (cursor);
+              params.m_slotNum = ReadField<uint8_t> (cursor);
+              params.m_symStart = ReadField<uint8_t> (cursor);
+              params.m_numSym = ReadField<uint8_t> (cursor);
+              params.m_tbSize = ReadField<uint32_t> (cursor);
+              params.m_mcs = ReadField<uint8_t> (cursor);
+              params.m_rv = ReadField<uint8_t> (cursor);
+              params.m_sinr = ReadField<double> (cursor);
+              params.m_sinrMin = ReadField<double> (cursor);
+              params.m_tbler = ReadField<double> (cursor);
+              params.m_corrupt = ReadField<uint8_t> (cursor);
+              MmWavePhyTrace::WriteRxPacketTraceLine (os, isDownlink, time, params);
+            }
+          else if (type == MmWaveBinaryTraceWriter::PHY_TRANSMISSION)
+            {
+              PhyTransmissionTraceParams params;
+              params.m_tddMode = ReadField<uint8_t> (cursor);
+              params.m_slotNum = ReadField<uint8_t> (cursor);
+              params.m_sfNum = ReadField<uint8_t> (cursor);
+              params.m_frameNum = ReadField<uint8_t> (cursor);
+              params.m_rnti = ReadField<uint16_t> (cursor);
+              params.m_symStart = ReadField<uint8_t> (cursor);
+              params.m_numSym = ReadField<uint8_t> (cursor);
+              params.m_ttiType = ReadField<uint8_t> (cursor);
+              params.m_rv = ReadField<uint8_t> (cursor);
+              params.m_ccId = ReadField<uint8_t> (cursor);
+              MmWavePhyTrace::WritePhyTransmissionTraceLine (os, params);
+            }
+          else
+            {
+              SfnSf sfn;
+              TtiAllocInfo tti;
+              sfn.m_frameNum = ReadField<uint16_t> (cursor);
+              sfn.m_sfNum = ReadField<uint8_t> (cursor);
+              sfn.m_slotNum = ReadField<uint8_t> (cursor);
+              tti.m_dci.m_rnti = ReadField<uint16_t> (cursor);
+              tti.m_dci.m_symStart = ReadField<uint8_t> (cursor);
+              tti.m_dci.m_numSym = ReadField<uint8_t> (cursor);
+              tti.m_ttiType = static_cast<TtiAllocInfo::TddTtiType> (ReadField<uint8_t> (cursor));
+              tti.m_tddMode = static_cast<TtiAllocInfo::TddMode> (ReadField<uint8_t> (cursor));
+              tti.m_dci.m_rv = ReadField<uint8_t> (cursor);
+              uint8_t ccId = ReadField<uint8_t> (cursor);
+              MmWaveMacTrace::WriteSchedAllocTraceLine (os, sfn, tti, ccId);
+            }
+        }
+      numRecords += read;
+    }
+
+  std::fclose (file);
+  return numRecords;
+}
+
+} // namespace mmwave
+
+} // namespace ns3
@@ -0,0 +1,161 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef SRC_MMWAVE_HELPER_MMWAVE_BINARY_TRACE_H_
+#define SRC_MMWAVE_HELPER_MMWAVE_BINARY_TRACE_H_
+
+#include <ns3/mmwave-phy-mac-common.h>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+namespace mmwave {
+
+/**
+ * \brief Buffered writer of the binary format of the mmWave PHY and MAC traces
+ *
+ * A binary trace file starts with a header made of the magic string
+ * "MMWTRACE", a format version (uint16_t), the RecordType of all the records
+ * in the file (uint8_t) and the value 0x01020304 (uint32_t), which tells the
+ * reader the byte order of the host that wrote the file. The header is
+ * followed by fixed-size records, whose fields are written one after the
+ * other, without padding, in the byte order of the host.
+ *
+ * The records are accumulated in memory and written to the file with a
+ * single fwrite when the buffer is full, when Flush or Close are called,
+ * and when the writer is destroyed.
+ *
+ * \see MmWaveBinaryTraceReader
+ */
+class MmWaveBinaryTraceWriter
+{
+public:
+  /**
+   * The type of the records of a binary trace file
+   */
+  enum RecordType
+  {
+    RX_PACKET = 1, //!< RxPacketTraceParams, written by MmWavePhyTrace
+    PHY_TRANSMISSION = 2, //!< PhyTransmissionTraceParams, written by MmWavePhyTrace
+    SCHED_ALLOC = 3, //!< scheduled TTIs, written by MmWaveMacTrace
+  };
+
+  /**
+   * Constructor
+   * \param bufferSize the size of the write buffer in bytes
+   */
+  MmWaveBinaryTraceWriter (std::size_t bufferSize = 1 << 20);
+
+  /**
+   * Destructor, flushes the buffer and closes the file
+   */
+  ~MmWaveBinaryTraceWriter ();
+
+  /**
+   * Create the file and write the header. Aborts the simulation if the file
+   * cannot be created.
+   * \param fileName the name of the file
+   * \param type the type of the records that will be written
+   */
+  void Open (const std::string &fileName, RecordType type);
+
+  /**
+   * \return true if the file is open
+   */
+  bool IsOpen (void) const;
+
+  /**
+   * Write the content of the buffer to the file
+   */
+  void Flush (void);
+
+  /**
+   * Flush the buffer and close the file
+   */
+  void Close (void);
+
+  /**
+   * Write a RX_PACKET record
+   * \param isDownlink true for a TB received by a UE, false for a TB received by an eNB
+   * \param time the reception time in seconds
+   * \param params the reception info
+   */
+  void WriteRxPacket (bool isDownlink, double time, const RxPacketTraceParams &params);
+
+  /**
+   * Write a PHY_TRANSMISSION record
+   * \param params the transmission info
+   */
+  void WritePhyTransmission (const PhyTransmissionTraceParams &params);
+
+  /**
+   * Write a SCHED_ALLOC record
+   * \param sfn the frame, subframe and slot of the allocation
+   * \param tti the allocated TTI
+   * \param ccId the component carrier ID
+   */
+  void WriteSchedAlloc (const SfnSf &sfn, const TtiAllocInfo &tti, uint8_t ccId);
+
+private:
+  /**
+   * Make room in the buffer for a record
+   * \param size the size of the record in bytes
+   */
+  void Reserve (std::size_t size);
+
+  /**
+   * Append a field to the buffer
+   * \param value the value of the field
+   */
+  template <class T>
+  void Append (T value);
+
+  FILE *m_file; //!< the output file
+  std::vector<uint8_t> m_buffer; //!< the write buffer
+  std::size_t m_used; //!< number of bytes of m_buffer in use
+  RecordType m_type; //!< the type of the records of the file
+};
+
+/**
+ * \brief Reader of the binary format of the mmWave PHY and MAC traces
+ *
+ * Converts a file written by MmWaveBinaryTraceWriter to the tab separated
+ * format written by MmWavePhyTrace and MmWaveMacTrace when the binary
+ * format is disabled, including the line with the names of the columns.
+ */
+class MmWaveBinaryTraceReader
+{
+public:
+  /**
+   * Convert a binary trace file to text. Aborts the simulation if the file
+   * cannot be read, is not a binary trace file, or was written by a host
+   * with a different byte order.
+   * \param fileName the name of the binary trace file
+   * \param os the stream where the text is written
+   * \return the number of records converted
+   */
+  static uint64_t ConvertToText (const std::string &fileName, std::ostream &os);
+};
+
+} // namespace mmwave
+
+} // namespace ns3
+
+#endif /* SRC_MMWAVE_HELPER_MMWAVE_BINARY_TRACE_H_ */
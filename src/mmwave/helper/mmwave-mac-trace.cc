@@ -20,6 +20,8 @@
 
 #include <ns3/log.h>
 #include "mmwave-mac-trace.h"
+#include <ns3/boolean.h>
+#include <ns3/profiler.h>
 
 namespace ns3 {
 
@@ -31,6 +33,8 @@ NS_OBJECT_ENSURE_REGISTERED (MmWaveMacTrace);
 
 std::ofstream MmWaveMacTrace::m_schedAllocTraceFile {};
 std::string MmWaveMacTrace::m_schedAllocTraceFilename {};
+bool MmWaveMacTrace::m_binaryFormat {false};
+MmWaveBinaryTraceWriter MmWaveMacTrace::m_schedAllocTraceWriter;
 
 MmWaveMacTrace::MmWaveMacTrace ()
 {
@@ -42,6 +46,7 @@ MmWaveMacTrace::~MmWaveMacTrace ()
     {
       m_schedAllocTraceFile.close ();
     }
+  m_schedAllocTraceWriter.Close ();
 }
 
 TypeId
@@ -55,13 +60,52 @@ MmWaveMacTrace::GetTypeId (void)
                    StringValue ("EnbSchedAllocTraces.txt"),
                    MakeStringAccessor (&MmWaveMacTrace::SetOutputFilename),
                    MakeStringChecker ())
+    .AddAttribute ("BinaryFormat",
+                   "If true, write the traces in the binary format of MmWaveBinaryTraceWriter, "
+                   "which can be converted to text with the mmwave-binary-trace-converter program",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MmWaveMacTrace::SetBinaryFormat),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
+void
+MmWaveMacTrace::WriteSchedAllocTraceHeader (std::ostream &os)
+{
+  os << "frame\tsubF\tslot\trnti\tfirstSym\tnumSym\ttype\ttddMode\tretxNum\tccId" << std::endl;
+}
+
+void
+MmWaveMacTrace::WriteSchedAllocTraceLine (std::ostream &os, const SfnSf &sfn, const TtiAllocInfo &tti, uint8_t ccId)
+{
+  os << +sfn.m_frameNum << "\t" << +sfn.m_sfNum << "\t"
+     << +sfn.m_slotNum << "\t" << +tti.m_dci.m_rnti << "\t"
+     << +tti.m_dci.m_symStart << "\t" << +tti.m_dci.m_numSym << "\t"
+     << tti.m_ttiType << "\t" << tti.m_tddMode << "\t"
+     << +tti.m_dci.m_rv << "\t" << +ccId << '\n';
+}
+
 void
 MmWaveMacTrace::ReportEnbSchedulingInfo (Ptr<MmWaveMacTrace> enbStats, MmWaveEnbMac::MmWaveSchedTraceInfo schedParams)
 {
+    NS_PROFILE_SCOPE ("MmWaveMacTrace::ReportEnbSchedulingInfo");
+    const SlotAllocInfo &allocInfo = schedParams.m_indParam.m_slotAllocInfo;
+    const SfnSf &dlSfn = schedParams.m_indParam.m_sfnSf;   // Holds the intended slot, subframe and frame info
+
+    if (m_binaryFormat)
+    {
+      if (!m_schedAllocTraceWriter.IsOpen ())
+        {
+          m_schedAllocTraceWriter.Open (m_schedAllocTraceFilename, MmWaveBinaryTraceWriter::SCHED_ALLOC);
+        }
+      for (const auto &iTti : allocInfo.m_ttiAllocInfo)
+        {
+          m_schedAllocTraceWriter.WriteSchedAlloc (dlSfn, iTti, schedParams.m_ccId);
+        }
+      return;
+    }
+
     // Open the output file if it is not open yet
     if (!m_schedAllocTraceFile.is_open ())
     {
@@ -70,24 +114,23 @@ MmWaveMacTrace::ReportEnbSchedulingInfo (Ptr<MmWaveMacTrace> enbStats, MmWaveEnb
         {
           NS_FATAL_ERROR ("Could not open tracefile");
         }
-      m_schedAllocTraceFile << "frame\tsubF\tslot\trnti\tfirstSym\tnumSym\ttype\ttddMode\tretxNum\tccId" << std::endl;
+      WriteSchedAllocTraceHeader (m_schedAllocTraceFile);
     }
-    
 
-    SlotAllocInfo allocInfo = schedParams.m_indParam.m_slotAllocInfo;
-    SfnSf dlSfn = schedParams.m_indParam.m_sfnSf;   // Holds the intended slot, subframe and frame info
-
-    for (auto iTti : allocInfo.m_ttiAllocInfo)
+    for (const auto &iTti : allocInfo.m_ttiAllocInfo)
     {
       // Trace the incoming alloc info
-      m_schedAllocTraceFile << +dlSfn.m_frameNum << "\t" << +dlSfn.m_sfNum << "\t"
-                            << +dlSfn.m_slotNum << "\t" << +iTti.m_dci.m_rnti << "\t" 
-                            << +iTti.m_dci.m_symStart << "\t" << +iTti.m_dci.m_numSym << "\t" 
-                            << iTti.m_ttiType << "\t" << iTti.m_tddMode << "\t" 
-                            << +iTti.m_dci.m_rv << "\t" << +schedParams.m_ccId << std::endl;
+      WriteSchedAllocTraceLine (m_schedAllocTraceFile, dlSfn, iTti, schedParams.m_ccId);
     }   
 }
 
+void
+MmWaveMacTrace::SetBinaryFormat (bool binary)
+{
+  NS_LOG_INFO ("Binary format: " << binary);
+  m_binaryFormat = binary;
+}
+
 void
 MmWaveMacTrace::SetOutputFilename (std::string fileName)
 {
@@ -24,6 +24,7 @@
 #include <ns3/object.h>
 #include <ns3/mmwave-phy-mac-common.h>
 #include <ns3/mmwave-enb-mac.h>
+#include <ns3/mmwave-binary-trace.h>
 #include <fstream>
 
 namespace ns3 {
@@ -59,9 +60,33 @@ public:
   */
   static void ReportEnbSchedulingInfo (Ptr<MmWaveMacTrace> enbStats, MmWaveEnbMac::MmWaveSchedTraceInfo schedParams);
 
+ /**
+  * Selects the binary format of MmWaveBinaryTraceWriter instead of the
+  * text format for the traces opened afterwards
+  * \param binary true to write binary traces
+  */
+  void SetBinaryFormat (bool binary);
+
+ /**
+  * Writes the names of the columns of the scheduling allocations trace
+  * \param os the output stream
+  */
+  static void WriteSchedAllocTraceHeader (std::ostream &os);
+
+ /**
+  * Writes a line of the scheduling allocations trace
+  * \param os the output stream
+  * \param sfn the frame, subframe and slot of the allocation
+  * \param tti the allocated TTI
+  * \param ccId the component carrier ID
+  */
+  static void WriteSchedAllocTraceLine (std::ostream &os, const SfnSf &sfn, const TtiAllocInfo &tti, uint8_t ccId);
+
 private:
   static std::ofstream m_schedAllocTraceFile;  //!< Output stream for the scheduling allocations trace
   static std::string m_schedAllocTraceFilename;   //!< Output filename for the scheduling allocations trace
+  static bool m_binaryFormat;   //!< If true, write the traces in binary format
+  static MmWaveBinaryTraceWriter m_schedAllocTraceWriter;   //!< Binary writer for the scheduling allocations trace
 };
 
 } // namespace mmwave
@@ -36,6 +36,8 @@
 #include <ns3/log.h>
 #include "mmwave-phy-trace.h"
 #include <ns3/simulator.h>
+#include <ns3/profiler.h>
+#include <ns3/boolean.h>
 #include <stdio.h>
 
 namespace ns3 {
@@ -55,6 +57,11 @@ std::string MmWavePhyTrace::m_ulPhyTraceFilename {};
 std::ofstream MmWavePhyTrace::m_dlPhyTraceFile {};
 std::string MmWavePhyTrace::m_dlPhyTraceFilename {};
 
+bool MmWavePhyTrace::m_binaryFormat {false};
+MmWaveBinaryTraceWriter MmWavePhyTrace::m_rxPacketTraceWriter;
+MmWaveBinaryTraceWriter MmWavePhyTrace::m_ulPhyTraceWriter;
+MmWaveBinaryTraceWriter MmWavePhyTrace::m_dlPhyTraceWriter;
+
 MmWavePhyTrace::MmWavePhyTrace ()
 {
 }
@@ -65,6 +72,9 @@ MmWavePhyTrace::~MmWavePhyTrace ()
     {
       m_rxPacketTraceFile.close ();
     }
+  m_rxPacketTraceWriter.Close ();
+  m_ulPhyTraceWriter.Close ();
+  m_dlPhyTraceWriter.Close ();
 }
 
 TypeId
@@ -88,7 +98,12 @@ MmWavePhyTrace::GetTypeId (void)
                    StringValue ("DlPhyTransmissionTrace.txt"),
                    MakeStringAccessor (&MmWavePhyTrace::SetDlPhyTxOutputFilename),
                    MakeStringChecker ())
-          
+    .AddAttribute ("BinaryFormat",
+                   "If true, write the traces in the binary format of MmWaveBinaryTraceWriter, "
+                   "which can be converted to text with the mmwave-binary-trace-converter program",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MmWavePhyTrace::SetBinaryFormat),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -114,6 +129,48 @@ MmWavePhyTrace::SetDlPhyTxOutputFilename (std::string fileName)
   m_dlPhyTraceFilename = fileName;
 }
 
+void
+MmWavePhyTrace::SetBinaryFormat (bool binary)
+{
+  NS_LOG_INFO ("Binary format: " << binary);
+  m_binaryFormat = binary;
+}
+
+void
+MmWavePhyTrace::WriteRxPacketTraceHeader (std::ostream &os)
+{
+  os << "DL/UL\ttime\tframe\tsubF\tslot\t1stSym\tsymbol#\tcellId\trnti\tccId\ttbSize\tmcs\trv\tSINR(dB)\tcorrupt\tTBler" << std::endl;
+}
+
+void
+MmWavePhyTrace::WriteRxPacketTraceLine (std::ostream &os, bool isDownlink, double time, const RxPacketTraceParams &params)
+{
+  os << (isDownlink ? "DL\t" : "UL\t") << time << "\t"
+     << params.m_frameNum << "\t" << +params.m_sfNum << "\t"
+     << +params.m_slotNum << "\t" << +params.m_symStart << "\t"
+     << +params.m_numSym << "\t" << params.m_cellId << "\t"
+     << params.m_rnti << "\t" << +params.m_ccId << "\t"
+     << params.m_tbSize << "\t" << +params.m_mcs << "\t"
+     << +params.m_rv << "\t" << 10 * std::log10 (params.m_sinr) << (isDownlink ? "\t" : " \t")
+     << params.m_corrupt << "\t" << params.m_tbler << '\n';
+}
+
+void
+MmWavePhyTrace::WritePhyTransmissionTraceHeader (std::ostream &os)
+{
+  os << "frame\tsubF\tslot\trnti\tfirstSym\tnumSym\ttype\ttddMode\tretxNum\tccId" << std::endl;
+}
+
+void
+MmWavePhyTrace::WritePhyTransmissionTraceLine (std::ostream &os, const PhyTransmissionTraceParams &params)
+{
+  os << +params.m_frameNum << "\t" << +params.m_sfNum << "\t"
+     << +params.m_slotNum << "\t" << +params.m_rnti << "\t"
+     << +params.m_symStart << "\t" << +params.m_numSym << "\t"
+     << +params.m_ttiType << "\t" << +params.m_tddMode << "\t"
+     << +params.m_rv << "\t" << +params.m_ccId << '\n';
+}
+
 void
 MmWavePhyTrace::ReportCurrentCellRsrpSinrCallback (Ptr<MmWavePhyTrace> phyStats, std::string path,
                                                      uint64_t imsi, SpectrumValue& sinr, SpectrumValue& power)
@@ -188,68 +245,77 @@ MmWavePhyTrace::ReportDLTbSize (uint64_t imsi, uint64_t tbSize)
         fclose(log_file);
 }
 */
-void 
-MmWavePhyTrace::ReportUlPhyTransmissionCallback (Ptr<MmWavePhyTrace> phyStats, PhyTransmissionTraceParams param)
+void
+MmWavePhyTrace::WritePhyTransmissionTrace (std::ofstream &file, MmWaveBinaryTraceWriter &writer,
+                                           const std::string &fileName, const PhyTransmissionTraceParams &params)
 {
-  if (!m_ulPhyTraceFile.is_open ())
+  NS_PROFILE_SCOPE ("MmWavePhyTrace::WritePhyTransmissionTrace");
+  if (m_binaryFormat)
+    {
+      if (!writer.IsOpen ())
+        {
+          writer.Open (fileName, MmWaveBinaryTraceWriter::PHY_TRANSMISSION);
+        }
+      writer.WritePhyTransmission (params);
+      return;
+    }
+
+  if (!file.is_open ())
     {
-      m_ulPhyTraceFile.open (m_ulPhyTraceFilename.c_str ());
-      if (!m_ulPhyTraceFile.is_open ())
+      file.open (fileName.c_str ());
+      if (!file.is_open ())
         {
           NS_FATAL_ERROR ("Could not open tracefile");
         }
-      m_ulPhyTraceFile << "frame\tsubF\tslot\trnti\tfirstSym\tnumSym\ttype\ttddMode\tretxNum\tccId" << std::endl;
+      WritePhyTransmissionTraceHeader (file);
     }
+  WritePhyTransmissionTraceLine (file, params);
+}
 
+void 
+MmWavePhyTrace::ReportUlPhyTransmissionCallback (Ptr<MmWavePhyTrace> phyStats, PhyTransmissionTraceParams param)
+{
   // Trace the UL PHY transmission info
-  m_ulPhyTraceFile << +param.m_frameNum << "\t" << +param.m_sfNum << "\t"
-                   << +param.m_slotNum << "\t" << +param.m_rnti << "\t" 
-                   << +param.m_symStart << "\t" << +param.m_numSym << "\t" 
-                   << +param.m_ttiType << "\t" << +param.m_tddMode << "\t" 
-                   << +param.m_rv << "\t" << +param.m_ccId << std::endl;
+  WritePhyTransmissionTrace (m_ulPhyTraceFile, m_ulPhyTraceWriter, m_ulPhyTraceFilename, param);
 }
 
 void 
 MmWavePhyTrace::ReportDlPhyTransmissionCallback (Ptr<MmWavePhyTrace> phyStats, PhyTransmissionTraceParams param)
 {
-  if (!m_dlPhyTraceFile.is_open ())
-    {
-      m_dlPhyTraceFile.open (m_dlPhyTraceFilename.c_str ());
-      if (!m_dlPhyTraceFile.is_open ())
-        {
-          NS_FATAL_ERROR ("Could not open tracefile");
-        }
-      m_dlPhyTraceFile << "frame\tsubF\tslot\trnti\tfirstSym\tnumSym\ttype\ttddMode\tretxNum\tccId" << std::endl;
-    }
-
   // Trace the DL PHY transmission info
-  m_dlPhyTraceFile << +param.m_frameNum << "\t" << +param.m_sfNum << "\t"
-                   << +param.m_slotNum << "\t" << +param.m_rnti << "\t" 
-                   << +param.m_symStart << "\t" << +param.m_numSym << "\t" 
-                   << +param.m_ttiType << "\t" << +param.m_tddMode << "\t" 
-                   << +param.m_rv << "\t" << +param.m_ccId << std::endl;
+  WritePhyTransmissionTrace (m_dlPhyTraceFile, m_dlPhyTraceWriter, m_dlPhyTraceFilename, param);
 }
 
 void
-MmWavePhyTrace::RxPacketTraceUeCallback (Ptr<MmWavePhyTrace> phyStats, std::string path, RxPacketTraceParams params)
+MmWavePhyTrace::WriteRxPacketTrace (bool isDownlink, const RxPacketTraceParams &params)
 {
+  NS_PROFILE_SCOPE ("MmWavePhyTrace::WriteRxPacketTrace");
+  if (m_binaryFormat)
+    {
+      if (!m_rxPacketTraceWriter.IsOpen ())
+        {
+          m_rxPacketTraceWriter.Open (m_rxPacketTraceFilename, MmWaveBinaryTraceWriter::RX_PACKET);
+        }
+      m_rxPacketTraceWriter.WriteRxPacket (isDownlink, Simulator::Now ().GetSeconds (), params);
+      return;
+    }
+
   if (!m_rxPacketTraceFile.is_open ())
     {
       m_rxPacketTraceFile.open (m_rxPacketTraceFilename.c_str ());
-      m_rxPacketTraceFile << "DL/UL\ttime\tframe\tsubF\tslot\t1stSym\tsymbol#\tcellId\trnti\tccId\ttbSize\tmcs\trv\tSINR(dB)\tcorrupt\tTBler" << std::endl;
       if (!m_rxPacketTraceFile.is_open ())
         {
           NS_FATAL_ERROR ("Could not open tracefile");
         }
+      WriteRxPacketTraceHeader (m_rxPacketTraceFile);
     }
-  m_rxPacketTraceFile << "DL\t" << Simulator::Now ().GetSeconds () << "\t" 
-                      << params.m_frameNum << "\t" << +params.m_sfNum << "\t" 
-                      << +params.m_slotNum << "\t" << +params.m_symStart << "\t" 
-                      << +params.m_numSym << "\t" << params.m_cellId << "\t" 
-                      << params.m_rnti << "\t" << +params.m_ccId << "\t" 
-                      << params.m_tbSize << "\t" << +params.m_mcs << "\t" 
-                      << +params.m_rv << "\t" << 10 * std::log10 (params.m_sinr) << "\t" 
-                      << params.m_corrupt << "\t" <<  params.m_tbler << std::endl;
+  WriteRxPacketTraceLine (m_rxPacketTraceFile, isDownlink, Simulator::Now ().GetSeconds (), params);
+}
+
+void
+MmWavePhyTrace::RxPacketTraceUeCallback (Ptr<MmWavePhyTrace> phyStats, std::string path, RxPacketTraceParams params)
+{
+  WriteRxPacketTrace (true, params);
 
   if (params.m_corrupt)
     {
@@ -265,23 +331,7 @@ MmWavePhyTrace::RxPacketTraceUeCallback (Ptr<MmWavePhyTrace> phyStats, std::stri
 void
 MmWavePhyTrace::RxPacketTraceEnbCallback (Ptr<MmWavePhyTrace> phyStats, std::string path, RxPacketTraceParams params)
 {
-  if (!m_rxPacketTraceFile.is_open ())
-    {
-      m_rxPacketTraceFile.open (m_rxPacketTraceFilename.c_str ());
-      m_rxPacketTraceFile << "DL/UL\ttime\tframe\tsubF\tslot\t1stSym\tsymbol#\tcellId\trnti\tccId\ttbSize\tmcs\trv\tSINR(dB)\tcorrupt\tTBler" << std::endl;
-      if (!m_rxPacketTraceFile.is_open ())
-        {
-          NS_FATAL_ERROR ("Could not open tracefile");
-        }
-    }
-  m_rxPacketTraceFile << "UL\t" << Simulator::Now ().GetSeconds () << "\t" 
-                      << params.m_frameNum << "\t" << +params.m_sfNum << "\t" 
-                      << +params.m_slotNum << "\t" << +params.m_symStart << "\t" 
-                      << +params.m_numSym << "\t" << params.m_cellId << "\t" 
-                      << params.m_rnti << "\t" << +params.m_ccId << "\t" 
-                      << params.m_tbSize << "\t" << +params.m_mcs << "\t" 
-                      << +params.m_rv << "\t" << 10 * std::log10 (params.m_sinr) << " \t" 
-                      << params.m_corrupt << "\t" << params.m_tbler << std::endl;
+  WriteRxPacketTrace (false, params);
 
   if (params.m_corrupt)
     {
@@ -36,6 +36,7 @@
 #include <ns3/object.h>
 #include <ns3/spectrum-value.h>
 #include <ns3/mmwave-phy-mac-common.h>
+#include <ns3/mmwave-binary-trace.h>
 #include <fstream>
 #include <iostream>
 
@@ -84,7 +85,59 @@ public:
   */
   void SetDlPhyTxOutputFilename (std::string fileName);
 
+ /**
+  * Selects the binary format of MmWaveBinaryTraceWriter instead of the
+  * text format for the traces opened afterwards
+  * \param binary true to write binary traces
+  */
+  void SetBinaryFormat (bool binary);
+
+ /**
+  * Writes the names of the columns of the PHY reception trace
+  * \param os the output stream
+  */
+  static void WriteRxPacketTraceHeader (std::ostream &os);
+
+ /**
+  * Writes a line of the PHY reception trace
+  * \param os the output stream
+  * \param isDownlink true for a TB received by a UE, false for a TB received by an eNB
+  * \param time the reception time in seconds
+  * \param params the reception info
+  */
+  static void WriteRxPacketTraceLine (std::ostream &os, bool isDownlink, double time, const RxPacketTraceParams &params);
+
+ /**
+  * Writes the names of the columns of the UL and DL PHY transmission traces
+  * \param os the output stream
+  */
+  static void WritePhyTransmissionTraceHeader (std::ostream &os);
+
+ /**
+  * Writes a line of the UL or DL PHY transmission trace
+  * \param os the output stream
+  * \param params the transmission info
+  */
+  static void WritePhyTransmissionTraceLine (std::ostream &os, const PhyTransmissionTraceParams &params);
+
 private:
+ /**
+  * Writes a PHY reception trace entry, in the selected format
+  * \param isDownlink true for a TB received by a UE, false for a TB received by an eNB
+  * \param params the reception info
+  */
+  static void WriteRxPacketTrace (bool isDownlink, const RxPacketTraceParams &params);
+
+ /**
+  * Writes a PHY transmission trace entry, in the selected format
+  * \param file the text output stream
+  * \param writer the binary writer
+  * \param fileName the name of the file
+  * \param params the transmission info
+  */
+  static void WritePhyTransmissionTrace (std::ofstream &file, MmWaveBinaryTraceWriter &writer,
+                                         const std::string &fileName, const PhyTransmissionTraceParams &params);
+
   //void ReportInterferenceTrace (uint64_t imsi, SpectrumValue& sinr);
   //void ReportDLTbSize (uint64_t imsi, uint64_t tbSize);
   static std::ofstream m_rxPacketTraceFile;   //!< Output stream for the PHY reception trace
@@ -95,6 +148,11 @@ private:
   
   static std::ofstream m_dlPhyTraceFile;    //!< Output stream for the DL PHY transmission trace
   static std::string m_dlPhyTraceFilename;    //!< Output filename for the DL PHY transmission trace
+
+  static bool m_binaryFormat;    //!< If true, write the traces in binary format
+  static MmWaveBinaryTraceWriter m_rxPacketTraceWriter;    //!< Binary writer for the PHY reception trace
+  static MmWaveBinaryTraceWriter m_ulPhyTraceWriter;    //!< Binary writer for the UL PHY transmission trace
+  static MmWaveBinaryTraceWriter m_dlPhyTraceWriter;    //!< Binary writer for the DL PHY transmission trace
   
 };
 
@@ -67,6 +67,12 @@ MmWaveEesmCcT1::GetSimulatedBlerFromSINR() const
   return m_t1.m_simulatedBlerFromSINR;
 }
 
+const MmWaveEesmBlerTable *
+MmWaveEesmCcT1::GetBlerTable () const
+{
+  return m_t1.m_blerTable;
+}
+
 const std::vector<uint8_t> *
 MmWaveEesmCcT1::GetMcsMTable() const
 {
@@ -57,6 +57,7 @@ protected:
   virtual const std::vector<double> * GetBetaTable () const override;
   virtual const std::vector<double> * GetMcsEcrTable () const override;
   virtual const SimulatedBlerFromSINR * GetSimulatedBlerFromSINR () const override;
+  virtual const MmWaveEesmBlerTable * GetBlerTable () const override;
   virtual const std::vector<uint8_t> * GetMcsMTable () const override;
   virtual const std::vector<double> * GetSpectralEfficiencyForMcs () const override;
   virtual const std::vector<double> * GetSpectralEfficiencyForCqi () const override;
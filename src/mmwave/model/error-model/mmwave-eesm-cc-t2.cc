@@ -67,6 +67,12 @@ MmWaveEesmCcT2::GetSimulatedBlerFromSINR() const
   return m_t2.m_simulatedBlerFromSINR;
 }
 
+const MmWaveEesmBlerTable *
+MmWaveEesmCcT2::GetBlerTable () const
+{
+  return m_t2.m_blerTable;
+}
+
 const std::vector<uint8_t> *
 MmWaveEesmCcT2::GetMcsMTable() const
 {
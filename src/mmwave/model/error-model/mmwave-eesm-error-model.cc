@@ -27,7 +27,9 @@
 #include <cmath>
 #include <algorithm>
 #include "ns3/enum.h"
+#include "ns3/boolean.h"
 #include <ns3/mmwave-phy-mac-common.h>
+#include "mmwave-error-model-kernels.h"
 
 namespace ns3 {
 
@@ -63,6 +65,13 @@ MmWaveEesmErrorModel::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::MmWaveEesmErrorModel")
     .SetParent<MmWaveErrorModel> ()
+    .AddAttribute ("UseSimd",
+                   "If true, compute the effective SINR with the AVX2 kernel, "
+                   "when the CPU supports it. The result can differ from the "
+                   "scalar one in the last digits.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&MmWaveEesmErrorModel::m_useSimd),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -80,18 +89,16 @@ MmWaveEesmErrorModel::SinrEff (const SpectrumValue& sinr, const std::vector<int>
   NS_ABORT_MSG_IF (map.size () == 0,
                    " Error: number of allocated RBs cannot be 0 - EESM method - SinrEff function");
 
-  double SINR = 0.0;
-  double SINRsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
+  NS_ASSERT_MSG (std::all_of (map.begin (), map.end (),
+                              [&sinr] (int rb) { return rb >= 0 && static_cast<uint32_t> (rb) < sinr.GetValuesN (); }),
+                 "RB map out of the SINR vector");
 
   double beta = GetBetaTable ()->at (mcs);
 
-  for (uint32_t i = 0; i < map.size (); i++)
-    {
-      double sinrLin = sinrCopy[map.at (i)];
-      SINR = exp ( -sinrLin / beta );
-      SINRsum += SINR;
-    }
+  // read the SINRs of the allocated RBs directly from the SpectrumValue storage
+  double SINRsum = MmWaveErrorModelKernels::EesmExpSum (&(*sinr.ConstValuesBegin ()), map.data (),
+                                                        map.size (), beta, m_useSimd);
+  double SINR;
 
   SINR = -beta * log ( SINRsum / map.size () );
 
@@ -101,20 +108,6 @@ MmWaveEesmErrorModel::SinrEff (const SpectrumValue& sinr, const std::vector<int>
 }
 
 
-const std::vector<double> &
-MmWaveEesmErrorModel::GetSinrDbVectorFromSimulatedValues (MmWaveEesmErrorModel::GraphType graphType,
-                                                      uint8_t mcs, uint32_t cbSizeIndex) const
-{
-  return std::get<0> (GetSimulatedBlerFromSINR ()->at (graphType).at (mcs).at (cbSizeIndex));
-}
-
-const std::vector<double> &
-MmWaveEesmErrorModel::GetBLERVectorFromSimulatedValues (MmWaveEesmErrorModel::GraphType graphType,
-                                                    uint8_t mcs, uint32_t cbSizeIndex) const
-{
-  return std::get<1> (GetSimulatedBlerFromSINR ()->at (graphType).at (mcs).at (cbSizeIndex));
-}
-
 double
 MmWaveEesmErrorModel::MappingSinrBler (double sinr, uint8_t mcs, uint32_t cbSizeBit)
 {
@@ -124,45 +117,12 @@ MmWaveEesmErrorModel::MappingSinrBler (double sinr, uint8_t mcs, uint32_t cbSize
   // use cbSize to obtain the index of CBSIZE in the map, jointly with mcs and sinr. take the
   // lowest CBSIZE simulated including this CB for removing CB size quatization
   // errors. sinr is also lower-bounded.
-  double bler = 0.0;
   double sinr_db = 10 * log10 (sinr);
   GraphType bg_type = GetBaseGraphType (cbSizeBit, mcs);
 
-  // Get the index of CBSIZE in the map
   NS_LOG_INFO ("For sinr " << sinr << " and mcs " << +mcs <<
                 " CbSizebit " << cbSizeBit << " we got bg type " << m_bgTypeName[bg_type]);
-  auto cbMap = GetSimulatedBlerFromSINR ()->at (bg_type).at (mcs);
-  auto cbIt = cbMap.upper_bound (cbSizeBit);
-
-  if (cbIt != cbMap.begin ())
-    {
-      cbIt--;
-    }
-
-  if (sinr_db < GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).front ())
-    {
-      bler = 1.0;
-    }
-  else if (sinr_db > GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).back ())
-    {
-      bler = 0.0;
-    }
-  else
-    {
-      // Get the index of SINR in the vector
-      auto sinrIt = std::upper_bound (GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).begin (),
-                                      GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).end (),
-                                      sinr_db);
-
-      if (sinrIt != GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).begin ())
-        {
-          sinrIt--;
-        }
-
-      auto sinr_index = std::distance (GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).begin (),
-                                       sinrIt);
-      bler = GetBLERVectorFromSimulatedValues (bg_type, mcs, cbIt->first).at (sinr_index);
-    }
+  double bler = GetBlerTable ()->GetBler (bg_type, mcs, cbSizeBit, sinr_db);
 
   NS_LOG_LOGIC ("SINR effective: " << sinr << " BLER:" << bler);
   return bler;
@@ -404,5 +364,76 @@ MmWaveEesmErrorModel::GetMaxMcs () const
   return static_cast<uint8_t> (GetMcsEcrTable ()->size () - 1);
 }
 
+MmWaveEesmBlerTable::MmWaveEesmBlerTable (const MmWaveEesmErrorModel::SimulatedBlerFromSINR &table)
+{
+  for (const auto &graph : table)
+    {
+      m_nMcs = std::max (m_nMcs, static_cast<uint32_t> (graph.size ()));
+    }
+
+  // the curves of each (base graph, MCS) pair are already sorted by CB size,
+  // since they are stored in a std::map
+  m_curveOffset.push_back (0);
+  m_sampleOffset.push_back (0);
+  for (const auto &graph : table)
+    {
+      for (uint32_t mcs = 0; mcs < m_nMcs; ++mcs)
+        {
+          if (mcs < graph.size ())
+            {
+              for (const auto &curve : graph.at (mcs))
+                {
+                  const std::vector<double> &sinrDb = std::get<0> (curve.second);
+                  const std::vector<double> &bler = std::get<1> (curve.second);
+                  NS_ABORT_MSG_IF (sinrDb.empty () || sinrDb.size () != bler.size (),
+                                   "Malformed BLER curve for CB size " << curve.first);
+                  m_cbSize.push_back (curve.first);
+                  m_sinrDb.insert (m_sinrDb.end (), sinrDb.begin (), sinrDb.end ());
+                  m_bler.insert (m_bler.end (), bler.begin (), bler.end ());
+                  m_sampleOffset.push_back (static_cast<uint32_t> (m_sinrDb.size ()));
+                }
+            }
+          m_curveOffset.push_back (static_cast<uint32_t> (m_cbSize.size ()));
+        }
+    }
+}
+
+double
+MmWaveEesmBlerTable::GetBler (uint8_t graphType, uint8_t mcs, uint32_t cbSizeBit, double sinrDb) const
+{
+  uint32_t index = graphType * m_nMcs + mcs;
+  NS_ASSERT (mcs < m_nMcs && index + 1 < m_curveOffset.size ());
+
+  // the curve of the largest CB size not greater than cbSizeBit
+  auto cbBegin = m_cbSize.begin () + m_curveOffset [index];
+  auto cbEnd = m_cbSize.begin () + m_curveOffset [index + 1];
+  NS_ABORT_MSG_IF (cbBegin == cbEnd, "No BLER curve for MCS " << +mcs);
+  auto cbIt = std::upper_bound (cbBegin, cbEnd, cbSizeBit);
+  if (cbIt != cbBegin)
+    {
+      cbIt--;
+    }
+  uint32_t curve = static_cast<uint32_t> (cbIt - m_cbSize.begin ());
+
+  auto sinrBegin = m_sinrDb.begin () + m_sampleOffset [curve];
+  auto sinrEnd = m_sinrDb.begin () + m_sampleOffset [curve + 1];
+  if (sinrDb < *sinrBegin)
+    {
+      return 1.0;
+    }
+  if (sinrDb > *(sinrEnd - 1))
+    {
+      return 0.0;
+    }
+
+  // Get the index of SINR in the vector
+  auto sinrIt = std::upper_bound (sinrBegin, sinrEnd, sinrDb);
+  if (sinrIt != sinrBegin)
+    {
+      sinrIt--;
+    }
+  return m_bler [sinrIt - m_sinrDb.begin ()];
+}
+
 } // namespace ns3
 } // namespace mmwave
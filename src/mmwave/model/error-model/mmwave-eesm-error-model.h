@@ -28,6 +28,8 @@ namespace ns3 {
 
 namespace mmwave {
 
+class MmWaveEesmBlerTable;
+
 /**
  * \ingroup error-models
  * \brief The MmWaveEesmErrorModelOutput struct
@@ -226,6 +228,11 @@ protected:
    * \return pointer to a table of BLER vs SINR
    */
   virtual const SimulatedBlerFromSINR * GetSimulatedBlerFromSINR () const = 0;
+  /**
+   * \return pointer to the flattened version of the table of BLER vs SINR,
+   * used for the lookups
+   */
+  virtual const MmWaveEesmBlerTable * GetBlerTable () const = 0;
   /**
    * \return pointer to a static vector that represents the MCS-M table
    */
@@ -241,6 +248,7 @@ protected:
 
 private:
   static std::vector<std::string> m_bgTypeName; //!< Base graph name
+  bool m_useSimd {true}; //!< Compute the effective SINR with the AVX2 kernel, if available
 
   /**
    * \brief map the effective SINR into CBLER for the specified MCS and CB size,
@@ -301,23 +309,55 @@ private:
    */
   std::pair<uint32_t, uint32_t>
   CodeBlockSegmentation (uint32_t B, GraphType bg_type) const;
+};
 
+/**
+ * \ingroup error-models
+ * \brief Read-only, flattened version of a SimulatedBlerFromSINR table
+ *
+ * The nested SimulatedBlerFromSINR tables (base graph, MCS, map of CB sizes,
+ * tuple of vectors) are convenient to write down, but a lookup in them walks
+ * several levels of indirection. This class copies them once into contiguous
+ * arrays: the CB sizes simulated for each (base graph, MCS) pair are stored
+ * sorted and next to each other, and the SINR and BLER samples of all the
+ * curves are stored in two arrays. A lookup is then a binary search on the
+ * CB sizes and one on the SINR samples, without any allocation.
+ *
+ * \see MmWaveEesmT1
+ * \see MmWaveEesmT2
+ */
+class MmWaveEesmBlerTable
+{
+public:
   /**
-   * \brief Get SinrDb Vector From Simulated Values
-   * \param graphType
-   * \param mcs
-   * \param cbSizeIndex
-   * \return
+   * \brief Build the flattened table
+   * \param table the BLER vs SINR table to flatten
    */
-  const std::vector<double> & GetSinrDbVectorFromSimulatedValues (GraphType graphType, uint8_t mcs, uint32_t cbSizeIndex) const;
+  explicit MmWaveEesmBlerTable (const MmWaveEesmErrorModel::SimulatedBlerFromSINR &table);
+
   /**
-   * \brief Get BLER Vector From Simulated Values
-   * \param graphType
-   * \param mcs
-   * \param cbSizeIndex
-   * \return
+   * \brief Get the BLER of a code block
+   *
+   * The curve used is the one of the largest simulated CB size not greater
+   * than cbSizeBit (or the smallest one, if cbSizeBit is smaller than all of
+   * them). The BLER is 1 below the first SINR sample, 0 above the last one,
+   * and the one of the closest lower SINR sample otherwise.
+   *
+   * \param graphType the LDPC base graph (0 for BG1, 1 for BG2)
+   * \param mcs the MCS
+   * \param cbSizeBit the size of the code block in bits
+   * \param sinrDb the effective SINR in dB
+   * \return the code block error rate
    */
-  const std::vector<double> & GetBLERVectorFromSimulatedValues (GraphType graphType, uint8_t mcs, uint32_t cbSizeIndex) const;
+  double GetBler (uint8_t graphType, uint8_t mcs, uint32_t cbSizeBit, double sinrDb) const;
+
+private:
+  uint32_t m_nMcs {0};                 //!< number of MCSs of each base graph
+  std::vector<uint32_t> m_curveOffset;  //!< first curve of each (base graph, MCS) pair, plus the end
+  std::vector<uint32_t> m_cbSize;       //!< CB size of each curve
+  std::vector<uint32_t> m_sampleOffset; //!< first sample of each curve, plus the end
+  std::vector<double> m_sinrDb;         //!< SINR samples of all the curves
+  std::vector<double> m_bler;           //!< BLER samples of all the curves
 };
 
 
@@ -67,6 +67,12 @@ MmWaveEesmIrT1::GetSimulatedBlerFromSINR() const
   return m_t1.m_simulatedBlerFromSINR;
 }
 
+const MmWaveEesmBlerTable *
+MmWaveEesmIrT1::GetBlerTable () const
+{
+  return m_t1.m_blerTable;
+}
+
 const std::vector<uint8_t> *
 MmWaveEesmIrT1::GetMcsMTable() const
 {
@@ -66,6 +66,12 @@ MmWaveEesmIrT2::GetSimulatedBlerFromSINR() const
   return m_t2.m_simulatedBlerFromSINR;
 }
 
+const MmWaveEesmBlerTable *
+MmWaveEesmIrT2::GetBlerTable () const
+{
+  return m_t2.m_blerTable;
+}
+
 const std::vector<uint8_t> *
 MmWaveEesmIrT2::GetMcsMTable() const
 {
@@ -8185,11 +8185,17 @@ static const std::vector<uint8_t> McsMTable1 = {
   6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6
 };
 
+/**
+ * \brief Flattened copy of BlerForSinr1, used for the lookups
+ */
+static const MmWaveEesmBlerTable FlatBlerForSinr1 (BlerForSinr1);
+
 MmWaveEesmT1::MmWaveEesmT1 ()
 {
   m_betaTable = &BetaTable1;
   m_mcsEcrTable = &McsEcrTable1;
   m_simulatedBlerFromSINR = &BlerForSinr1;
+  m_blerTable = &FlatBlerForSinr1;
   m_mcsMTable = &McsMTable1;
   m_spectralEfficiencyForMcs = &SpectralEfficiencyForMcs1;
   m_spectralEfficiencyForCqi = &SpectralEfficiencyForCqi1;
@@ -7484,11 +7484,17 @@ static const MmWaveEesmErrorModel::SimulatedBlerFromSINR BlerForSinr2 = {
 };
 
 
+/**
+ * \brief Flattened copy of BlerForSinr2, used for the lookups
+ */
+static const MmWaveEesmBlerTable FlatBlerForSinr2 (BlerForSinr2);
+
 MmWaveEesmT2::MmWaveEesmT2 ()
 {
   m_betaTable = &BetaTable2;
   m_mcsEcrTable = &McsEcrTable2;
   m_simulatedBlerFromSINR = &BlerForSinr2;
+  m_blerTable = &FlatBlerForSinr2;
   m_mcsMTable = &McsMTable2;
   m_spectralEfficiencyForMcs = &SpectralEfficiencyForMcs2;
   m_spectralEfficiencyForCqi = &SpectralEfficiencyForCqi2;
@@ -56,6 +56,7 @@ struct MmWaveEesmT2
   const std::vector<double> *m_betaTable {nullptr};  //!< Beta table
   const std::vector<double> *m_mcsEcrTable {nullptr}; //!< MCS-ECR table
   const MmWaveEesmErrorModel::SimulatedBlerFromSINR *m_simulatedBlerFromSINR {nullptr}; //!< BLER from SINR table
+  const MmWaveEesmBlerTable *m_blerTable {nullptr}; //!< Flattened BLER from SINR table
   const std::vector<uint8_t> *m_mcsMTable {nullptr}; //!< MCS-M table
   const std::vector<double> *m_spectralEfficiencyForMcs {nullptr}; //!< Spectral-efficiency for MCS
   const std::vector<double> *m_spectralEfficiencyForCqi {nullptr}; //!< Spectral-efficiency for CQI
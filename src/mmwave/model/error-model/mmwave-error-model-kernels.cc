@@ -0,0 +1,165 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "mmwave-error-model-kernels.h"
+#include <cmath>
+#include <stdint.h>
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define MMWAVE_KERNELS_AVX2
+#include <immintrin.h>
+#endif
+
+namespace ns3 {
+
+namespace mmwave {
+
+#ifdef MMWAVE_KERNELS_AVX2
+
+/**
+ * \brief AVX2 version of MmWaveErrorModelKernels::EesmExpSum
+ *
+ * exp (x) is computed as 2^k * exp (r), with k = round (x / ln 2) and
+ * |r| <= ln 2 / 2, using the Taylor expansion of exp (r) up to the 12th
+ * order (truncation error below 2e-16). The lanes whose argument is out
+ * of the range in which 2^k is a normal number, or is not a number, are
+ * evaluated with std::exp.
+ *
+ * \param sinr pointer to the linear SINR values of all the RBs
+ * \param map indexes of the allocated RBs in sinr
+ * \param n number of allocated RBs
+ * \param beta the EESM beta parameter
+ * \return the sum of exp (-sinr [map [i]] / beta), for i in [0, n)
+ */
+__attribute__ ((target ("avx2,fma")))
+static double
+EesmExpSumAvx2 (const double *sinr, const int *map, std::size_t n, double beta)
+{
+  const __m256d minusBeta = _mm256_set1_pd (-beta);
+  const __m256d log2e = _mm256_set1_pd (1.4426950408889634074);
+  const __m256d ln2Hi = _mm256_set1_pd (6.93145751953125e-1);
+  const __m256d ln2Lo = _mm256_set1_pd (1.42860682030941723212e-6);
+  const __m256d minArg = _mm256_set1_pd (-708.0);
+  const __m256d maxArg = _mm256_set1_pd (708.0);
+  const __m128i bias = _mm_set1_epi32 (1023);
+
+  // 1 / k!, from k = 12 down to k = 0
+  static const double coeff[13] = {
+    2.08767569878680989792e-9, 2.50521083854417187751e-8, 2.75573192239858906526e-7,
+    2.75573192239858906526e-6, 2.48015873015873015873e-5, 1.98412698412698412698e-4,
+    1.38888888888888888889e-3, 8.33333333333333333333e-3, 4.16666666666666666667e-2,
+    1.66666666666666666667e-1, 0.5, 1.0, 1.0
+  };
+
+  __m256d acc = _mm256_setzero_pd ();
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    {
+      // scalar loads, since the hardware gather is microcoded (and slow) on
+      // many CPUs
+      __m256d values = _mm256_set_pd (sinr[map[i + 3]], sinr[map[i + 2]], sinr[map[i + 1]], sinr[map[i]]);
+      __m256d x = _mm256_div_pd (values, minusBeta);
+
+      __m256d k = _mm256_round_pd (_mm256_mul_pd (x, log2e),
+                                   _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+      __m256d r = _mm256_fnmadd_pd (k, ln2Hi, x);
+      r = _mm256_fnmadd_pd (k, ln2Lo, r);
+
+      __m256d p = _mm256_set1_pd (coeff[0]);
+      for (uint32_t c = 1; c < 13; ++c)
+        {
+          p = _mm256_fmadd_pd (p, r, _mm256_set1_pd (coeff[c]));
+        }
+
+      // 2^k, built directly in the exponent field
+      __m128i e = _mm_add_epi32 (_mm256_cvtpd_epi32 (k), bias);
+      __m256d scale = _mm256_castsi256_pd (_mm256_slli_epi64 (_mm256_cvtepi32_epi64 (e), 52));
+      __m256d y = _mm256_mul_pd (p, scale);
+
+      __m256d inRange = _mm256_and_pd (_mm256_cmp_pd (x, minArg, _CMP_GE_OQ),
+                                       _mm256_cmp_pd (x, maxArg, _CMP_LE_OQ));
+      int mask = _mm256_movemask_pd (inRange);
+      if (mask != 0xf)
+        {
+          alignas (32) double lanes[4];
+          _mm256_store_pd (lanes, _mm256_and_pd (y, inRange));
+          _mm256_zeroupper ();
+          for (uint32_t l = 0; l < 4; ++l)
+            {
+              if (!(mask & (1 << l)))
+                {
+                  lanes[l] = std::exp (-sinr[map[i + l]] / beta);
+                }
+            }
+          y = _mm256_load_pd (lanes);
+        }
+      acc = _mm256_add_pd (acc, y);
+    }
+
+  __m128d half = _mm_add_pd (_mm256_castpd256_pd128 (acc), _mm256_extractf128_pd (acc, 1));
+  double sum = _mm_cvtsd_f64 (_mm_add_sd (half, _mm_unpackhi_pd (half, half)));
+  // clear the upper halves of the YMM registers before going back to SSE
+  // code (the rest of the simulator), otherwise every SSE instruction pays
+  // the AVX-SSE transition penalty
+  _mm256_zeroupper ();
+
+  for (; i < n; ++i)
+    {
+      sum += std::exp (-sinr[map[i]] / beta);
+    }
+  return sum;
+}
+
+#endif /* MMWAVE_KERNELS_AVX2 */
+
+bool
+MmWaveErrorModelKernels::IsSimdAvailable (void)
+{
+#ifdef MMWAVE_KERNELS_AVX2
+  static const bool available = __builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma");
+  return available;
+#else
+  return false;
+#endif
+}
+
+double
+MmWaveErrorModelKernels::EesmExpSumScalar (const double *sinr, const int *map, std::size_t n, double beta)
+{
+  double sum = 0.0;
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      sum += std::exp (-sinr[map[i]] / beta);
+    }
+  return sum;
+}
+
+double
+MmWaveErrorModelKernels::EesmExpSum (const double *sinr, const int *map, std::size_t n,
+                                     double beta, bool useSimd)
+{
+#ifdef MMWAVE_KERNELS_AVX2
+  if (useSimd && n >= 4 && IsSimdAvailable ())
+    {
+      return EesmExpSumAvx2 (sinr, map, n, beta);
+    }
+#endif
+  return EesmExpSumScalar (sinr, map, n, beta);
+}
+
+} // namespace ns3
+} // namespace mmwave
@@ -0,0 +1,73 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef SRC_MMWAVE_ERROR_MODEL_KERNELS_H
+#define SRC_MMWAVE_ERROR_MODEL_KERNELS_H
+
+#include <cstddef>
+
+namespace ns3 {
+
+namespace mmwave {
+
+/**
+ * \ingroup error-models
+ * \brief Batched numerical kernels of the error models
+ *
+ * The kernels read the SINR of the allocated RBs straight from the storage
+ * of a SpectrumValue, through the RB map. On x86 CPUs supporting AVX2 and
+ * FMA, EesmExpSum processes four RBs at a time, with a polynomial
+ * approximation of exp whose relative error is within a few ulp of
+ * std::exp; otherwise (or for the arguments out of its range) it falls
+ * back to the scalar version.
+ */
+class MmWaveErrorModelKernels
+{
+public:
+  /**
+   * \brief Compute the EESM sum of the exponentials of the SINRs
+   *
+   * \param sinr pointer to the linear SINR values of all the RBs
+   * \param map indexes of the allocated RBs in sinr
+   * \param n number of allocated RBs
+   * \param beta the EESM beta parameter
+   * \param useSimd use the AVX2 kernel, if the CPU supports it
+   * \return the sum of exp (-sinr [map [i]] / beta), for i in [0, n)
+   */
+  static double EesmExpSum (const double *sinr, const int *map, std::size_t n,
+                            double beta, bool useSimd = true);
+
+  /**
+   * \brief Scalar version of EesmExpSum
+   *
+   * \param sinr pointer to the linear SINR values of all the RBs
+   * \param map indexes of the allocated RBs in sinr
+   * \param n number of allocated RBs
+   * \param beta the EESM beta parameter
+   * \return the sum of exp (-sinr [map [i]] / beta), for i in [0, n)
+   */
+  static double EesmExpSumScalar (const double *sinr, const int *map, std::size_t n, double beta);
+
+  /**
+   * \return true if the CPU supports the AVX2 kernels
+   */
+  static bool IsSimdAvailable (void);
+};
+
+} // namespace ns3
+} // namespace mmwave
+
+#endif // SRC_MMWAVE_ERROR_MODEL_KERNELS_H
@@ -344,76 +344,53 @@ MmWaveLteMiErrorModel::Mib (const SpectrumValue& sinr, const std::vector<int>& m
 
   double MI;
   double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
 
+  // select the MI map of the modulation once, instead of for every RB
+  const double *miMap;
+  const double *miAxis;
+  uint16_t miSize;
+  if (mcs <= MI_QPSK_MAX_ID) // QPSK
+    {
+      miMap = MI_map_qpsk;
+      miAxis = MI_map_qpsk_axis;
+      miSize = MI_MAP_QPSK_SIZE;
+    }
+  else if (mcs <= MI_16QAM_MAX_ID) // 16-QAM
+    {
+      miMap = MI_map_16qam;
+      miAxis = MI_map_16qam_axis;
+      miSize = MI_MAP_16QAM_SIZE;
+    }
+  else // 64-QAM
+    {
+      miMap = MI_map_64qam;
+      miAxis = MI_map_64qam_axis;
+      miSize = MI_MAP_64QAM_SIZE;
+    }
+  // since the values in the MI axis are uniformly spaced, we have
+  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
+  const double scalingCoeff = (miSize - 1) / (miAxis[miSize - 1] - miAxis[0]);
+  const double maxSinr = miAxis[miSize - 1];
+
+  // read the SINRs of the allocated RBs directly from the SpectrumValue storage
+  const double *values = (sinr.GetValuesN () > 0) ? &(*sinr.ConstValuesBegin ()) : nullptr;
   for (uint32_t i = 0; i < map.size (); i++)
     {
-      double sinrLin = sinrCopy[map.at (i)];
-      if (mcs <= MI_QPSK_MAX_ID) // QPSK
+      NS_ASSERT_MSG (map[i] >= 0 && static_cast<uint32_t> (map[i]) < sinr.GetValuesN (),
+                     "RB map out of the SINR vector");
+      double sinrLin = values[map[i]];
+      if (sinrLin > maxSinr)
         {
-
-          if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE - 1])
-            {
-              MI = 1;
-            }
-          else
-            {
-              // since the values in MI_map_qpsk_axis are uniformly spaced, we have
-              // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-              // the scaling coefficient is always the same, so we use a static const
-              // to speed up the calculation
-              static const double scalingCoeffQpsk =
-                (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE - 1] - MI_map_qpsk_axis[0]);
-              double sinrIndexDouble = (sinrLin -  MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
-              uint32_t sinrIndex = std::max (0.0, std::floor (sinrIndexDouble));
-              NS_ASSERT_MSG (sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
-              MI = MI_map_qpsk[sinrIndex];
-            }
+          MI = 1;
         }
       else
         {
-          if (mcs > MI_QPSK_MAX_ID && mcs <= MI_16QAM_MAX_ID )  // 16-QAM
-            {
-              if (sinrLin > MI_map_16qam_axis[MI_MAP_16QAM_SIZE - 1])
-                {
-                  MI = 1;
-                }
-              else
-                {
-                  // since the values in MI_map_16QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff16qam =
-                    (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE - 1] - MI_map_16qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_16qam_axis[0]) * scalingCoeff16qam + 1;
-                  uint32_t sinrIndex = std::max (0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_16QAM_SIZE, "MI map out of data");
-                  MI = MI_map_16qam[sinrIndex];
-                }
-            }
-          else // 64-QAM
-            {
-              if (sinrLin > MI_map_64qam_axis[MI_MAP_64QAM_SIZE - 1])
-                {
-                  MI = 1;
-                }
-              else
-                {
-                  // since the values in MI_map_64QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff64qam =
-                    (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE - 1] - MI_map_64qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_64qam_axis[0]) * scalingCoeff64qam + 1;
-                  uint32_t sinrIndex = std::max (0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_64QAM_SIZE, "MI map out of data");
-                  MI = MI_map_64qam[sinrIndex];
-                }
-            }
+          double sinrIndexDouble = (sinrLin - miAxis[0]) * scalingCoeff + 1;
+          uint32_t sinrIndex = std::max (0.0, std::floor (sinrIndexDouble));
+          NS_ASSERT_MSG (sinrIndex < miSize, "MI map out of data");
+          MI = miMap[sinrIndex];
         }
-      NS_LOG_LOGIC (" RB " << map.at (i) << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
+      NS_LOG_LOGIC (" RB " << map[i] << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
       MIsum += MI;
     }
   if (map.size () == 0)
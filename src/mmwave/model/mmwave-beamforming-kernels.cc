@@ -0,0 +1,152 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "mmwave-beamforming-kernels.h"
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define MMWAVE_BEAMFORMING_KERNELS_AVX2
+#include <immintrin.h>
+#endif
+
+namespace ns3 {
+
+namespace mmwave {
+
+#ifdef MMWAVE_BEAMFORMING_KERNELS_AVX2
+
+/**
+ * \brief AVX2 version of MmWaveBeamformingKernels::Dot
+ *
+ * Each register holds two complex numbers. The products of a with the real
+ * and the imaginary parts of b are accumulated separately, and combined
+ * once at the end, so that the loop needs two FMAs per pair of elements.
+ *
+ * \param a the first vector
+ * \param b the second vector
+ * \param n the size of the vectors
+ * \param conjugate if true, a is conjugated
+ * \return the dot product
+ */
+__attribute__ ((target ("avx2,fma")))
+static std::complex<double>
+DotAvx2 (const std::complex<double> *a, const std::complex<double> *b, std::size_t n, bool conjugate)
+{
+  const double *pa = reinterpret_cast<const double *> (a);
+  const double *pb = reinterpret_cast<const double *> (b);
+
+  // accRe = sum (a * re (b)) = [ar br, ai br]
+  // accIm = sum (swap (a) * im (b)) = [ai bi, ar bi]
+  __m256d accRe = _mm256_setzero_pd ();
+  __m256d accIm = _mm256_setzero_pd ();
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2)
+    {
+      __m256d va = _mm256_loadu_pd (pa + 2 * i);
+      __m256d vb = _mm256_loadu_pd (pb + 2 * i);
+      __m256d bRe = _mm256_movedup_pd (vb);
+      __m256d bIm = _mm256_permute_pd (vb, 0xf);
+      __m256d aSwap = _mm256_permute_pd (va, 0x5);
+      accRe = _mm256_fmadd_pd (va, bRe, accRe);
+      accIm = _mm256_fmadd_pd (aSwap, bIm, accIm);
+    }
+
+  __m256d res;
+  if (conjugate)
+    {
+      // conj (a) * b = [ar br + ai bi, ar bi - ai br]
+      res = _mm256_blend_pd (_mm256_add_pd (accRe, accIm), _mm256_sub_pd (accIm, accRe), 0xa);
+    }
+  else
+    {
+      // a * b = [ar br - ai bi, ai br + ar bi]
+      res = _mm256_addsub_pd (accRe, accIm);
+    }
+  __m128d sum = _mm_add_pd (_mm256_castpd256_pd128 (res), _mm256_extractf128_pd (res, 1));
+  double out[2];
+  _mm_storeu_pd (out, sum);
+  // clear the upper halves of the YMM registers before going back to SSE
+  // code, as in the error model kernels
+  _mm256_zeroupper ();
+
+  std::complex<double> result (out[0], out[1]);
+  for (; i < n; ++i)
+    {
+      result += (conjugate ? std::conj (a[i]) : a[i]) * b[i];
+    }
+  return result;
+}
+
+#endif /* MMWAVE_BEAMFORMING_KERNELS_AVX2 */
+
+bool
+MmWaveBeamformingKernels::IsSimdAvailable (void)
+{
+#ifdef MMWAVE_BEAMFORMING_KERNELS_AVX2
+  static const bool available = __builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma");
+  return available;
+#else
+  return false;
+#endif
+}
+
+std::complex<double>
+MmWaveBeamformingKernels::DotScalar (const std::complex<double> *a, const std::complex<double> *b,
+                                     std::size_t n, bool conjugate)
+{
+  std::complex<double> sum (0, 0);
+  if (conjugate)
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        {
+          sum += std::conj (a[i]) * b[i];
+        }
+    }
+  else
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        {
+          sum += a[i] * b[i];
+        }
+    }
+  return sum;
+}
+
+std::complex<double>
+MmWaveBeamformingKernels::Dot (const std::complex<double> *a, const std::complex<double> *b,
+                               std::size_t n, bool conjugate, bool useSimd)
+{
+#ifdef MMWAVE_BEAMFORMING_KERNELS_AVX2
+  if (useSimd && n >= 4 && IsSimdAvailable ())
+    {
+      return DotAvx2 (a, b, n, conjugate);
+    }
+#endif
+  return DotScalar (a, b, n, conjugate);
+}
+
+void
+MmWaveBeamformingKernels::Gemv (const std::complex<double> *a, std::size_t rows, std::size_t cols,
+                                const std::complex<double> *x, std::complex<double> *y, bool useSimd)
+{
+  for (std::size_t r = 0; r < rows; ++r)
+    {
+      y[r] = Dot (a + r * cols, x, cols, false, useSimd);
+    }
+}
+
+} // namespace mmwave
+} // namespace ns3
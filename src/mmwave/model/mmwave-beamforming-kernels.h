@@ -0,0 +1,88 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef SRC_MMWAVE_BEAMFORMING_KERNELS_H
+#define SRC_MMWAVE_BEAMFORMING_KERNELS_H
+
+#include <complex>
+#include <cstddef>
+
+namespace ns3 {
+
+namespace mmwave {
+
+/**
+ * \brief Complex linear algebra kernels of the beamforming models
+ *
+ * The kernels work on contiguous arrays of std::complex<double>, e.g., the
+ * columns of the matrices of a ChannelTensor. On x86 CPUs supporting AVX2
+ * and FMA, they process two complex numbers at a time; otherwise they fall
+ * back to the scalar versions. The two versions sum the products in a
+ * different order, thus their results can differ by a few ulp.
+ */
+class MmWaveBeamformingKernels
+{
+public:
+  /**
+   * \brief Compute the dot product of two complex vectors
+   *
+   * \param a the first vector
+   * \param b the second vector
+   * \param n the size of the vectors
+   * \param conjugate if true, a is conjugated
+   * \param useSimd use the AVX2 kernel, if the CPU supports it
+   * \return the sum of a[i] * b[i] (conj (a[i]) * b[i] if conjugate is true),
+   *         for i in [0, n)
+   */
+  static std::complex<double> Dot (const std::complex<double> *a, const std::complex<double> *b,
+                                   std::size_t n, bool conjugate, bool useSimd = true);
+
+  /**
+   * \brief Scalar version of Dot
+   *
+   * \param a the first vector
+   * \param b the second vector
+   * \param n the size of the vectors
+   * \param conjugate if true, a is conjugated
+   * \return the sum of a[i] * b[i] (conj (a[i]) * b[i] if conjugate is true),
+   *         for i in [0, n)
+   */
+  static std::complex<double> DotScalar (const std::complex<double> *a, const std::complex<double> *b,
+                                         std::size_t n, bool conjugate);
+
+  /**
+   * \brief Compute the product of a matrix and a vector, y = A x
+   *
+   * \param a the matrix, stored row by row
+   * \param rows the number of rows of the matrix
+   * \param cols the number of columns of the matrix, and the size of x
+   * \param x the vector
+   * \param y the result, of size rows
+   * \param useSimd use the AVX2 kernel, if the CPU supports it
+   */
+  static void Gemv (const std::complex<double> *a, std::size_t rows, std::size_t cols,
+                    const std::complex<double> *x, std::complex<double> *y, bool useSimd = true);
+
+  /**
+   * \return true if the CPU supports the AVX2 kernels
+   */
+  static bool IsSimdAvailable (void);
+};
+
+} // namespace mmwave
+} // namespace ns3
+
+#endif // SRC_MMWAVE_BEAMFORMING_KERNELS_H
@@ -28,6 +28,8 @@
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/log.h"
+#include "ns3/profiler.h"
+#include "ns3/mmwave-beamforming-kernels.h"
 
 namespace ns3 {
 
@@ -107,6 +109,31 @@ MmWaveBeamformingModel::SetAntenna (Ptr<ThreeGppAntennaArrayModel> antenna)
   m_antenna = antenna;
 }
 
+void
+MmWaveBeamformingModel::SetBeamformingVectorForDevice (Ptr<NetDevice> otherDevice, Ptr<ThreeGppAntennaArrayModel> otherAntenna)
+{
+  NS_LOG_FUNCTION (this << otherDevice << otherAntenna);
+
+  BeamformingVectorPair bfVectors = GetBeamformingVectorsForDevice (otherDevice, otherAntenna);
+
+  // configure the antenna to use the new beamforming vector
+  m_antenna->SetBeamformingVector (bfVectors.first);
+  NS_LOG_LOGIC ("antenna " << m_antenna
+                           << " set BF vector"
+                           << " numAntennaElem " << m_antenna->GetNumberOfElements ()
+                           << " this device ID=" << m_device->GetNode ()->GetId ()
+                           << " otherDevice ID=" << otherDevice->GetNode ()->GetId ());
+  if (!bfVectors.second.empty ())
+    {
+      otherAntenna->SetBeamformingVector (bfVectors.second);
+      NS_LOG_LOGIC ("antenna " << otherAntenna
+                               << " set BF vector"
+                               << " numAntennaElem " << otherAntenna->GetNumberOfElements ()
+                               << " this device ID=" << otherDevice->GetNode ()->GetId ()
+                               << " otherDevice ID=" << m_device->GetNode ()->GetId ());
+    }
+}
+
 /*----------------------------------------------------------------------------*/
 
 NS_OBJECT_ENSURE_REGISTERED (MmWaveDftBeamforming);
@@ -132,9 +159,8 @@ MmWaveDftBeamforming::~MmWaveDftBeamforming ()
 {
 }
 
-
-void
-MmWaveDftBeamforming::SetBeamformingVectorForDevice (Ptr<NetDevice> otherDevice, Ptr<ThreeGppAntennaArrayModel> otherAntenna)
+MmWaveBeamformingModel::BeamformingVectorPair
+MmWaveDftBeamforming::GetBeamformingVectorsForDevice (Ptr<NetDevice> otherDevice, Ptr<ThreeGppAntennaArrayModel> otherAntenna)
 {
   NS_LOG_FUNCTION (this << otherDevice << otherAntenna);
 
@@ -174,8 +200,8 @@ MmWaveDftBeamforming::SetBeamformingVectorForDevice (Ptr<NetDevice> otherDevice,
       antennaWeights.push_back (exp (std::complex<double> (0, phase)) * power);
     }
 
-  // configure the antenna to use the new beamforming vector
-  m_antenna->SetBeamformingVector (antennaWeights);
+  // the antenna of the other device is not configured
+  return std::make_pair (antennaWeights, ThreeGppAntennaArrayModel::ComplexVector ());
 }
 
 /*----------------------------------------------------------------------------*/
@@ -232,8 +258,8 @@ MmWaveSvdBeamforming::DoDispose (void)
   MmWaveBeamformingModel::DoDispose ();
 }
 
-void
-MmWaveSvdBeamforming::SetBeamformingVectorForDevice (Ptr<NetDevice> otherDevice, Ptr<ThreeGppAntennaArrayModel> otherAntenna)
+MmWaveBeamformingModel::BeamformingVectorPair
+MmWaveSvdBeamforming::GetBeamformingVectorsForDevice (Ptr<NetDevice> otherDevice, Ptr<ThreeGppAntennaArrayModel> otherAntenna)
 {
   NS_LOG_FUNCTION (this << otherDevice << otherAntenna);
 
@@ -245,7 +271,7 @@ MmWaveSvdBeamforming::SetBeamformingVectorForDevice (Ptr<NetDevice> otherDevice,
   // this will trigger a new computation (if needed)
   auto channelMatrix = m_channel->GetChannel (thisMob, otherMob, m_antenna, otherAntenna);
 
-  std::pair<ThreeGppAntennaArrayModel::ComplexVector, ThreeGppAntennaArrayModel::ComplexVector> bfVectors;
+  BeamformingVectorPair bfVectors;
 
   bool toCache {false};
 
@@ -266,7 +292,7 @@ MmWaveSvdBeamforming::SetBeamformingVectorForDevice (Ptr<NetDevice> otherDevice,
 
   if (!m_useCache || toCache)
     {
-      if (channelMatrix->m_channel[0][0].size () == 0)
+      if (channelMatrix->m_channel.GetNumClusters () == 0)
         {
           NS_LOG_LOGIC ("Channel has no MPCs");
 
@@ -293,20 +319,6 @@ MmWaveSvdBeamforming::SetBeamformingVectorForDevice (Ptr<NetDevice> otherDevice,
         }
     }
 
-  // configure the antenna to use the new beamforming vector
-  m_antenna->SetBeamformingVector (std::get<0> (bfVectors));
-  NS_LOG_LOGIC ("antenna " << m_antenna
-                           << " set BF vector"
-                           << " numAntennaElem " << m_antenna->GetNumberOfElements ()
-                           << " this device ID=" << m_device->GetNode ()->GetId ()
-                           << " otherDevice ID=" << otherDevice->GetNode ()->GetId ());
-  otherAntenna->SetBeamformingVector (std::get<1> (bfVectors));
-  NS_LOG_LOGIC ("antenna " << otherAntenna
-                           << " set BF vector"
-                           << " numAntennaElem " << otherAntenna->GetNumberOfElements ()
-                           << " this device ID=" << otherDevice->GetNode ()->GetId ()
-                           << " otherDevice ID=" << m_device->GetNode ()->GetId ());
-
   if (toCache)
     {
       auto entry {m_cacheChannelMap.find (otherDevice)};
@@ -322,35 +334,29 @@ MmWaveSvdBeamforming::SetBeamformingVectorForDevice (Ptr<NetDevice> otherDevice,
           m_cacheBfVectors.insert (std::make_pair (otherDevice, bfVectors));
         }
     }
+
+  return bfVectors;
 }
 
-std::pair<ThreeGppAntennaArrayModel::ComplexVector, ThreeGppAntennaArrayModel::ComplexVector>
-MmWaveSvdBeamforming::ComputeBeamformingVectors (Ptr<const MatrixBasedChannelModel::ChannelMatrix> params) const
+MmWaveBeamformingModel::BeamformingVectorPair
+MmWaveSvdBeamforming::ComputeBeamformingVectors (Ptr<const MatrixBasedChannelModel::ChannelMatrix> params)
 {
+  NS_PROFILE_SCOPE ("MmWaveSvdBeamforming::ComputeBeamformingVectors");
   //generate transmitter side spatial correlation matrix
-  uint16_t aSize = params->m_channel.size ();
-  uint16_t bSize = params->m_channel[0].size ();
-  uint16_t clusterSize = params->m_channel[0][0].size ();
-
-  // compute narrowband channel by summing over the cluster index
-  MatrixBasedChannelModel::Complex2DVector narrowbandChannel;
-  narrowbandChannel.resize (aSize);
-
-  for (uint16_t aIndex = 0; aIndex < aSize; aIndex++)
+  uint16_t aSize = params->m_channel.GetNumRows ();
+  uint16_t bSize = params->m_channel.GetNumCols ();
+  uint16_t clusterSize = params->m_channel.GetNumClusters ();
+
+  // compute narrowband channel by summing over the cluster index, one
+  // contiguous cluster matrix at a time. The element [a][b] has index
+  // bIndex * aSize + aIndex, as in the cluster matrices
+  ThreeGppAntennaArrayModel::ComplexVector narrowbandChannel (aSize * bSize);
+  for (uint16_t cIndex = 0; cIndex < clusterSize; cIndex++)
     {
-      narrowbandChannel[aIndex].resize (bSize);
-    }
-
-  for (uint16_t aIndex = 0; aIndex < aSize; aIndex++)
-    {
-      for (uint16_t bIndex = 0; bIndex < bSize; bIndex++)
+      const std::complex<double> *h = params->m_channel.GetCluster (cIndex);
+      for (uint32_t i = 0; i < narrowbandChannel.size (); i++)
         {
-          std::complex<double> cSum (0, 0);
-          for (uint16_t cIndex = 0; cIndex < clusterSize; cIndex++)
-            {
-              cSum += params->m_channel[aIndex][bIndex][cIndex];
-            }
-          narrowbandChannel[aIndex][bIndex] = cSum;
+          narrowbandChannel[i] += h[i];
         }
     }
 
@@ -368,9 +374,11 @@ MmWaveSvdBeamforming::ComputeBeamformingVectors (Ptr<const MatrixBasedChannelMod
       for (uint16_t b2Index = 0; b2Index < bSize; b2Index++)
         {
           std::complex<double> aSum (0,0);
+          const std::complex<double> *h1 = &narrowbandChannel[b1Index * aSize];
+          const std::complex<double> *h2 = &narrowbandChannel[b2Index * aSize];
           for (uint16_t aIndex = 0; aIndex < aSize; aIndex++)
             {
-              aSum += std::conj (narrowbandChannel[aIndex][b1Index]) * narrowbandChannel[aIndex][b2Index];
+              aSum += std::conj (h1[aIndex]) * h2[aIndex];
             }
           bQ[b1Index][b2Index] += aSum;
         }
@@ -395,7 +403,7 @@ MmWaveSvdBeamforming::ComputeBeamformingVectors (Ptr<const MatrixBasedChannelMod
           std::complex<double> bSum (0,0);
           for (uint16_t bIndex = 0; bIndex < bSize; bIndex++)
             {
-              bSum += narrowbandChannel[a1Index][bIndex] * std::conj (narrowbandChannel[a2Index][bIndex]);
+              bSum += narrowbandChannel[bIndex * aSize + a1Index] * std::conj (narrowbandChannel[bIndex * aSize + a2Index]);
             }
           aQ[a1Index][a2Index] += bSum;
         }
@@ -462,5 +470,502 @@ MmWaveSvdBeamforming::GetFirstEigenvector (MatrixBasedChannelModel::Complex2DVec
   return antennaWeights;
 }
 
+/*----------------------------------------------------------------------------*/
+
+NS_OBJECT_ENSURE_REGISTERED (MmWaveFastSvdBeamforming);
+
+TypeId
+MmWaveFastSvdBeamforming::GetTypeId ()
+{
+  static TypeId
+    tid =
+    TypeId ("ns3::MmWaveFastSvdBeamforming")
+    .SetParent<MmWaveSvdBeamforming> ()
+    .AddConstructor<MmWaveFastSvdBeamforming> ()
+    .AddAttribute ("UseSimd",
+                   "If true, compute the Gram matrix and the power iteration with the "
+                   "AVX2 kernels, if the CPU supports them",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&MmWaveFastSvdBeamforming::m_useSimd),
+                   MakeBooleanChecker ())
+    .AddAttribute ("WarmStart",
+                   "If true, start the power iteration from the singular vector computed "
+                   "for the previous channel matrix of the same pair of nodes",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&MmWaveFastSvdBeamforming::m_warmStart),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+MmWaveFastSvdBeamforming::MmWaveFastSvdBeamforming ()
+  : m_useSimd {true},
+    m_warmStart {true}
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MmWaveFastSvdBeamforming::~MmWaveFastSvdBeamforming ()
+{
+}
+
+void
+MmWaveFastSvdBeamforming::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_lastVectors.clear ();
+  MmWaveSvdBeamforming::DoDispose ();
+}
+
+MmWaveBeamformingModel::BeamformingVectorPair
+MmWaveFastSvdBeamforming::ComputeBeamformingVectors (Ptr<const MatrixBasedChannelModel::ChannelMatrix> params)
+{
+  NS_PROFILE_SCOPE ("MmWaveFastSvdBeamforming::ComputeBeamformingVectors");
+  size_t aSize = params->m_channel.GetNumRows ();
+  size_t bSize = params->m_channel.GetNumCols ();
+  size_t clusterSize = params->m_channel.GetNumClusters ();
+
+  // compute the narrowband channel H by summing the cluster matrices, the
+  // column b of H (the element [a][b] has index bIndex * aSize + aIndex) is
+  // contiguous
+  ThreeGppAntennaArrayModel::ComplexVector h (aSize * bSize);
+  for (size_t cIndex = 0; cIndex < clusterSize; cIndex++)
+    {
+      const std::complex<double> *cluster = params->m_channel.GetCluster (cIndex);
+      for (size_t i = 0; i < h.size (); i++)
+        {
+          h[i] += cluster[i];
+        }
+    }
+
+  // the power iteration runs on the Gram matrix of the side with fewer
+  // antenna elements, bQ = H^H H (bSize x bSize) or conj (aQ) = H^T conj (H)
+  // (aSize x aSize). For the latter, H is transposed first, so that its rows
+  // are contiguous
+  bool bSide = (bSize <= aSize);
+  size_t size = bSide ? bSize : aSize;
+  size_t length = bSide ? aSize : bSize;
+  ThreeGppAntennaArrayModel::ComplexVector vectors;
+  if (bSide)
+    {
+      vectors = h;
+    }
+  else
+    {
+      vectors.resize (h.size ());
+      for (size_t bIndex = 0; bIndex < bSize; bIndex++)
+        {
+          for (size_t aIndex = 0; aIndex < aSize; aIndex++)
+            {
+              vectors[aIndex * bSize + bIndex] = h[bIndex * aSize + aIndex];
+            }
+        }
+    }
+
+  // gram[i][j] = sum_k conj (vectors[i][k]) * vectors[j][k], computed only for
+  // j >= i since the matrix is hermitian
+  ThreeGppAntennaArrayModel::ComplexVector gram (size * size);
+  for (size_t i = 0; i < size; i++)
+    {
+      for (size_t j = i; j < size; j++)
+        {
+          gram[i * size + j] = MmWaveBeamformingKernels::Dot (&vectors[i * length], &vectors[j * length],
+                                                              length, true, m_useSimd);
+          gram[j * size + i] = std::conj (gram[i * size + j]);
+        }
+    }
+
+  ThreeGppAntennaArrayModel::ComplexVector x;
+  auto last = m_lastVectors.find (params->m_nodeIds);
+  if (m_warmStart && last != m_lastVectors.end () && last->second.size () == size)
+    {
+      x = last->second;
+    }
+  else
+    {
+      // the same initial vector of MmWaveSvdBeamforming
+      x.assign (gram.begin (), gram.begin () + size);
+    }
+  uint32_t iter = PowerIteration (gram, size, x);
+  NS_LOG_DEBUG ("power iteration stopped after " << iter << " iterations");
+  if (m_warmStart)
+    {
+      m_lastVectors[params->m_nodeIds] = x;
+    }
+
+  // derive the singular vector of the other side, e.g., aW = conj (H bW / |H bW|)
+  ThreeGppAntennaArrayModel::ComplexVector other (length);
+  for (size_t k = 0; k < length; k++)
+    {
+      std::complex<double> sum (0, 0);
+      for (size_t i = 0; i < size; i++)
+        {
+          sum += vectors[i * length + k] * x[i];
+        }
+      other[k] = sum;
+    }
+  double norm = 0;
+  for (const auto &v : other)
+    {
+      norm += std::norm (v);
+    }
+  norm = std::sqrt (norm);
+  for (auto &v : other)
+    {
+      v = norm > 0 ? v / norm : v;
+    }
+
+  ThreeGppAntennaArrayModel::ComplexVector bW;
+  ThreeGppAntennaArrayModel::ComplexVector aW;
+  if (bSide)
+    {
+      // x is the eigenvector of bQ, other = H bW / |H bW|
+      bW = x;
+      aW = other;
+      for (auto &v : aW)
+        {
+          v = std::conj (v);
+        }
+    }
+  else
+    {
+      // x is the eigenvector of conj (aQ), i.e., the conjugate of the one of
+      // aQ, thus aW = x, and other = H^T aW / |H^T aW|, the conjugate of bW
+      aW = x;
+      bW = other;
+      for (auto &v : bW)
+        {
+          v = std::conj (v);
+        }
+    }
+  return std::make_pair (bW, aW);
+}
+
+uint32_t
+MmWaveFastSvdBeamforming::PowerIteration (const ThreeGppAntennaArrayModel::ComplexVector &gram, size_t size,
+                                          ThreeGppAntennaArrayModel::ComplexVector &x) const
+{
+  ThreeGppAntennaArrayModel::ComplexVector y (size);
+  uint32_t iter = 0;
+  double diff = 1;
+  while (iter < m_maxIterations && diff > m_tolerance)
+    {
+      MmWaveBeamformingKernels::Gemv (gram.data (), size, size, x.data (), y.data (), m_useSimd);
+
+      double weightSum = 0;
+      for (size_t i = 0; i < size; i++)
+        {
+          weightSum += std::norm (y[i]);
+        }
+      if (weightSum == 0)
+        {
+          // x is in the null space of the Gram matrix
+          break;
+        }
+      double scale = 1 / std::sqrt (weightSum);
+      diff = 0;
+      for (size_t i = 0; i < size; i++)
+        {
+          y[i] *= scale;
+          diff += std::norm (y[i] - x[i]);
+        }
+      iter++;
+      x.swap (y);
+    }
+  return iter;
+}
+
+/*----------------------------------------------------------------------------*/
+
+NS_OBJECT_ENSURE_REGISTERED (MmWaveCodebookBeamforming);
+
+TypeId
+MmWaveCodebookBeamforming::GetTypeId ()
+{
+  static TypeId
+    tid =
+    TypeId ("ns3::MmWaveCodebookBeamforming")
+    .SetParent<MmWaveBeamformingModel> ()
+    .AddConstructor<MmWaveCodebookBeamforming> ()
+    .AddAttribute ("ChannelModel",
+                   "Pointer to the MatrixBasedChannelModel object used in the simulation scenario",
+                   PointerValue (),
+                   MakePointerAccessor (&MmWaveCodebookBeamforming::m_channel),
+                   MakePointerChecker<MatrixBasedChannelModel> ())
+    .AddAttribute ("OversamplingFactor",
+                   "The oversampling factor of the DFT codebooks, in each dimension of the arrays",
+                   UintegerValue (2),
+                   MakeUintegerAccessor (&MmWaveCodebookBeamforming::m_oversampling),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("UseSimd",
+                   "Use the AVX2 kernels to evaluate the gains, if the CPU supports them",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&MmWaveCodebookBeamforming::m_useSimd),
+                   MakeBooleanChecker ())
+    .AddAttribute ("UseCache",
+                   "Use the cache for the BF vectors",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&MmWaveCodebookBeamforming::m_useCache),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+MmWaveCodebookBeamforming::MmWaveCodebookBeamforming ()
+  : m_oversampling {2},
+    m_useSimd {true},
+    m_useCache {true}
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MmWaveCodebookBeamforming::~MmWaveCodebookBeamforming ()
+{
+}
+
+void
+MmWaveCodebookBeamforming::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_channel = 0;
+  m_cacheChannelMap.clear ();
+  m_cacheBfVectors.clear ();
+  MmWaveBeamformingModel::DoDispose ();
+}
+
+Ptr<const MmWaveCodebookBeamforming::Codebook>
+MmWaveCodebookBeamforming::GetCodebook (Ptr<const ThreeGppAntennaArrayModel> antenna, uint32_t oversampling)
+{
+  NS_LOG_FUNCTION (antenna << oversampling);
+  NS_ASSERT_MSG (oversampling > 0, "The oversampling factor must be positive");
+
+  UintegerValue numRowsValue;
+  UintegerValue numColumnsValue;
+  DoubleValue disHValue;
+  DoubleValue disVValue;
+  antenna->GetAttribute ("NumRows", numRowsValue);
+  antenna->GetAttribute ("NumColumns", numColumnsValue);
+  antenna->GetAttribute ("AntennaHorizontalSpacing", disHValue);
+  antenna->GetAttribute ("AntennaVerticalSpacing", disVValue);
+  uint32_t numRows = numRowsValue.Get ();
+  uint32_t numColumns = numColumnsValue.Get ();
+  double disH = disHValue.Get ();
+  double disV = disVValue.Get ();
+
+  // the codebooks are shared by all the instances, and live until the end
+  // of the program
+  static std::map<CodebookKey, Ptr<const Codebook> > codebooks;
+  CodebookKey key = std::make_tuple (numRows, numColumns, disH, disV, oversampling);
+  auto it = codebooks.find (key);
+  if (it != codebooks.end ())
+    {
+      return it->second;
+    }
+
+  // the spatial frequencies of the beams in one dimension of the array, i.e.,
+  // the DFT grid oversampled by the oversampling factor, which spans one
+  // period of the array response. A dimension with a single element has a
+  // single (broadside) beam
+  auto getGrid = [oversampling] (uint32_t numElements, double spacing)
+    {
+      std::vector<double> grid;
+      if (numElements == 1)
+        {
+          grid.push_back (0);
+          return grid;
+        }
+      uint32_t numPoints = numElements * oversampling;
+      for (uint32_t k = 0; k < numPoints; k++)
+        {
+          grid.push_back ((2.0 * k / numPoints - 1) / (2 * spacing));
+        }
+      return grid;
+    };
+  std::vector<double> hGrid = getGrid (numColumns, disH);
+  std::vector<double> vGrid = getGrid (numRows, disV);
+
+  Ptr<Codebook> codebook = Create<Codebook> ();
+  codebook->m_numElements = numRows * numColumns;
+  codebook->m_numBeams = 0;
+  double power = 1 / std::sqrt (codebook->m_numElements);
+  for (double uV : vGrid)
+    {
+      for (double uH : hGrid)
+        {
+          // skip the beams outside of the visible region
+          if (uH * uH + uV * uV > 1 + 1e-9)
+            {
+              continue;
+            }
+          // as in GetElementLocation, the element i is in the column
+          // i % numColumns and in the row i / numColumns. The phase is the
+          // one of MmWaveDftBeamforming, in the local coordinate system of
+          // the array
+          for (uint32_t i = 0; i < codebook->m_numElements; i++)
+            {
+              double phase = -2 * M_PI * (uH * disH * (i % numColumns) + uV * disV * (i / numColumns));
+              codebook->m_beams.push_back (exp (std::complex<double> (0, phase)) * power);
+            }
+          codebook->m_directions.push_back (std::make_pair (uH, uV));
+          codebook->m_numBeams++;
+        }
+    }
+  NS_LOG_DEBUG ("New codebook for a " << numRows << "x" << numColumns << " array with "
+                                      << codebook->m_numBeams << " beams");
+
+  codebooks.insert (std::make_pair (key, codebook));
+  return codebook;
+}
+
+MmWaveBeamformingModel::BeamformingVectorPair
+MmWaveCodebookBeamforming::GetBeamformingVectorsForDevice (Ptr<NetDevice> otherDevice, Ptr<ThreeGppAntennaArrayModel> otherAntenna)
+{
+  NS_LOG_FUNCTION (this << otherDevice << otherAntenna);
+
+  Ptr<MobilityModel> thisMob = m_device->GetNode ()->GetObject<MobilityModel> ();
+  NS_ASSERT_MSG (thisMob, "This device " << m_device << " does not have a mobility model");
+  Ptr<MobilityModel> otherMob = otherDevice->GetNode ()->GetObject<MobilityModel> ();
+  NS_ASSERT_MSG (otherMob, "The otherDevice " << otherDevice << " does not have a mobility model");
+
+  // this will trigger a new computation (if needed)
+  auto channelMatrix = m_channel->GetChannel (thisMob, otherMob, m_antenna, otherAntenna);
+
+  if (m_useCache)
+    {
+      auto entry = m_cacheChannelMap.find (otherDevice);
+      if (entry != m_cacheChannelMap.end () && entry->second == channelMatrix)
+        {
+          NS_LOG_DEBUG ("channel cached " << channelMatrix);
+          return m_cacheBfVectors.find (otherDevice)->second;
+        }
+    }
+
+  BeamformingVectorPair bfVectors;
+  if (channelMatrix->m_channel.GetNumClusters () == 0)
+    {
+      NS_LOG_LOGIC ("Channel has no MPCs");
+      bfVectors = std::make_pair (ThreeGppAntennaArrayModel::ComplexVector (m_antenna->GetNumberOfElements ()),
+                                  ThreeGppAntennaArrayModel::ComplexVector (otherAntenna->GetNumberOfElements ()));
+    }
+  else
+    {
+      // this antenna is on the columns of the channel matrices, unless the
+      // channel was generated with the other device as the transmitter
+      uint32_t thisDeviceId = m_device->GetNode ()->GetId ();
+      uint32_t otherDeviceId = otherDevice->GetNode ()->GetId ();
+      bool reverse = channelMatrix->IsReverse (thisDeviceId, otherDeviceId);
+      Ptr<const Codebook> thisCodebook = GetCodebook (m_antenna, m_oversampling);
+      Ptr<const Codebook> otherCodebook = GetCodebook (otherAntenna, m_oversampling);
+      if (reverse)
+        {
+          bfVectors = SearchBeamPair (channelMatrix, otherCodebook, thisCodebook);
+          bfVectors = std::make_pair (std::get<1> (bfVectors), std::get<0> (bfVectors));
+        }
+      else
+        {
+          bfVectors = SearchBeamPair (channelMatrix, thisCodebook, otherCodebook);
+        }
+    }
+
+  if (m_useCache)
+    {
+      m_cacheChannelMap[otherDevice] = channelMatrix;
+      m_cacheBfVectors[otherDevice] = bfVectors;
+    }
+
+  return bfVectors;
+}
+
+MmWaveBeamformingModel::BeamformingVectorPair
+MmWaveCodebookBeamforming::SearchBeamPair (Ptr<const MatrixBasedChannelModel::ChannelMatrix> params,
+                                           Ptr<const Codebook> bCodebook, Ptr<const Codebook> aCodebook) const
+{
+  NS_PROFILE_SCOPE ("MmWaveCodebookBeamforming::SearchBeamPair");
+  uint32_t aSize = params->m_channel.GetNumRows ();
+  uint32_t bSize = params->m_channel.GetNumCols ();
+  uint32_t clusterSize = params->m_channel.GetNumClusters ();
+  NS_ASSERT_MSG (aCodebook->m_numElements == aSize && bCodebook->m_numElements == bSize,
+                 "The codebooks do not match the size of the channel matrix");
+
+  // narrowband channel, as in MmWaveSvdBeamforming. The element [a][b] has
+  // index b * aSize + a, thus this is the b x a matrix H^T, stored row by row
+  ThreeGppAntennaArrayModel::ComplexVector narrowbandChannel (aSize * bSize);
+  for (uint32_t cIndex = 0; cIndex < clusterSize; cIndex++)
+    {
+      const std::complex<double> *h = params->m_channel.GetCluster (cIndex);
+      for (uint32_t i = 0; i < narrowbandChannel.size (); i++)
+        {
+          narrowbandChannel[i] += h[i];
+        }
+    }
+
+  // The gain of the beams (a, b) is g = w_a^T H w_b. The beams of one side,
+  // say x, are projected on the channel first, i.e., y_x = H w_x for each
+  // beam, which costs numBeams (x) * aSize * bSize. Then, the gains of all the
+  // pairs are the products of the beams of the other side, z, with the
+  // projections, which costs numBeams (x) * numBeams (z) * size (z). The side
+  // to project is the one with the lower total cost.
+  uint64_t costB = static_cast<uint64_t> (bCodebook->m_numBeams) * (bSize + aCodebook->m_numBeams) * aSize;
+  uint64_t costA = static_cast<uint64_t> (aCodebook->m_numBeams) * (aSize + bCodebook->m_numBeams) * bSize;
+  bool projectB = (costB <= costA);
+  Ptr<const Codebook> xCodebook = projectB ? bCodebook : aCodebook;
+  Ptr<const Codebook> zCodebook = projectB ? aCodebook : bCodebook;
+  uint32_t xSize = xCodebook->m_numElements;
+  uint32_t zSize = zCodebook->m_numElements;
+
+  // the matrix which maps a beam of x to the side z, stored row by row
+  ThreeGppAntennaArrayModel::ComplexVector transposed;
+  const std::complex<double> *channel = narrowbandChannel.data ();
+  if (projectB)
+    {
+      transposed.resize (aSize * bSize);
+      for (uint32_t b = 0; b < bSize; b++)
+        {
+          for (uint32_t a = 0; a < aSize; a++)
+            {
+              transposed[a * bSize + b] = narrowbandChannel[b * aSize + a];
+            }
+        }
+      channel = transposed.data ();
+    }
+
+  ThreeGppAntennaArrayModel::ComplexVector projections (static_cast<size_t> (xCodebook->m_numBeams) * zSize);
+  for (uint32_t x = 0; x < xCodebook->m_numBeams; x++)
+    {
+      MmWaveBeamformingKernels::Gemv (channel, zSize, xSize, xCodebook->GetBeam (x),
+                                      projections.data () + x * zSize, m_useSimd);
+    }
+
+  double maxGain = -1;
+  uint32_t bestX = 0;
+  uint32_t bestZ = 0;
+  for (uint32_t z = 0; z < zCodebook->m_numBeams; z++)
+    {
+      const std::complex<double> *wz = zCodebook->GetBeam (z);
+      for (uint32_t x = 0; x < xCodebook->m_numBeams; x++)
+        {
+          double gain = std::norm (MmWaveBeamformingKernels::Dot (wz, projections.data () + x * zSize,
+                                                                  zSize, false, m_useSimd));
+          if (gain > maxGain)
+            {
+              maxGain = gain;
+              bestX = x;
+              bestZ = z;
+            }
+        }
+    }
+
+  uint32_t bestB = projectB ? bestX : bestZ;
+  uint32_t bestA = projectB ? bestZ : bestX;
+  NS_LOG_DEBUG ("best beams b " << bestB << " a " << bestA << " out of "
+                                << bCodebook->m_numBeams << "x" << aCodebook->m_numBeams
+                                << ", gain " << maxGain);
+
+  const std::complex<double> *bBeam = bCodebook->GetBeam (bestB);
+  const std::complex<double> *aBeam = aCodebook->GetBeam (bestA);
+  return std::make_pair (ThreeGppAntennaArrayModel::ComplexVector (bBeam, bBeam + bSize),
+                         ThreeGppAntennaArrayModel::ComplexVector (aBeam, aBeam + aSize));
+}
+
 } // namespace mmwave
 } // namespace ns3
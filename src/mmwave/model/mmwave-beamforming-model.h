@@ -21,7 +21,9 @@
 
 #include "ns3/object.h"
 #include "ns3/matrix-based-channel-model.h"
+#include "ns3/simple-ref-count.h"
 #include <map>
+#include <tuple>
 
 namespace ns3 {
 
@@ -80,13 +82,32 @@ public:
    */
   void SetAntenna (Ptr<ThreeGppAntennaArrayModel> antenna);
 
+  /**
+   * The beamforming vectors of a pair of devices. The first element is the
+   * vector of the antenna of this device, the second one is the vector of the
+   * antenna of the other device, or an empty vector if the algorithm
+   * configures only the antenna of this device
+   */
+  typedef std::pair<ThreeGppAntennaArrayModel::ComplexVector, ThreeGppAntennaArrayModel::ComplexVector> BeamformingVectorPair;
+
   /**
    * Computes the beamforming vector to communicate with the target device and antenna
-   * and configures the antenna
+   * and configures the antenna.
+   * The default implementation configures the antennas with the vectors
+   * returned by GetBeamformingVectorsForDevice.
    * \param otherDevice the target device
    * \param otherAntenna the target antenna of otherDevice
    */
-  virtual void SetBeamformingVectorForDevice (Ptr<NetDevice> otherDevice, Ptr<ThreeGppAntennaArrayModel> otherAntenna) = 0;
+  virtual void SetBeamformingVectorForDevice (Ptr<NetDevice> otherDevice, Ptr<ThreeGppAntennaArrayModel> otherAntenna);
+
+  /**
+   * Computes the beamforming vectors to communicate with the target device
+   * and antenna, without configuring any antenna
+   * \param otherDevice the target device
+   * \param otherAntenna the target antenna of otherDevice
+   * \return the beamforming vectors of this antenna and of otherAntenna
+   */
+  virtual BeamformingVectorPair GetBeamformingVectorsForDevice (Ptr<NetDevice> otherDevice, Ptr<ThreeGppAntennaArrayModel> otherAntenna) = 0;
 
 protected:
   virtual void DoDispose (void) override;
@@ -120,12 +141,13 @@ public:
   static TypeId GetTypeId (void);
 
   /**
-   * Computes the beamforming vector to communicate with the target device and antenna
-   * and configures the antenna
+   * Computes the DFT beamforming vector of this antenna towards the position
+   * of the target device. The vector of otherAntenna is left empty.
    * \param otherDevice the target device
    * \param otherAntenna the target antenna of otherDevice
+   * \return the beamforming vectors
    */
-  void SetBeamformingVectorForDevice (Ptr<NetDevice> otherDevice, Ptr<ThreeGppAntennaArrayModel> otherAntenna) override;
+  BeamformingVectorPair GetBeamformingVectorsForDevice (Ptr<NetDevice> otherDevice, Ptr<ThreeGppAntennaArrayModel> otherAntenna) override;
 };
 
 
@@ -154,23 +176,24 @@ public:
   static TypeId GetTypeId (void);
 
   /**
-   * Computes the beamforming vector to communicate with the target device
-   * and sets the antenna.
-   * The beamforming vector is computed using a SVD-based beamforming
+   * Computes the beamforming vectors of both antennas to communicate with the
+   * target device.
+   * The beamforming vectors are computed using a SVD-based beamforming
    * algorithm.
    * \param otherDevice the target device
    * \param otherAntenna the target antenna of otherDevice
+   * \return the beamforming vectors
    */
-  void SetBeamformingVectorForDevice (Ptr<NetDevice> otherDevice, Ptr<ThreeGppAntennaArrayModel> otherAntenna) override;
+  BeamformingVectorPair GetBeamformingVectorsForDevice (Ptr<NetDevice> otherDevice, Ptr<ThreeGppAntennaArrayModel> otherAntenna) override;
 
-private:
+protected:
   void DoDispose (void) override;
   /**
    * Compute the beamforming vectors using SVD
    * \param params the channel matrix
    * \return a pair with the beamforming vectors
    */
-  std::pair<ThreeGppAntennaArrayModel::ComplexVector, ThreeGppAntennaArrayModel::ComplexVector> ComputeBeamformingVectors (Ptr<const MatrixBasedChannelModel::ChannelMatrix> params) const;
+  virtual BeamformingVectorPair ComputeBeamformingVectors (Ptr<const MatrixBasedChannelModel::ChannelMatrix> params);
 
   /**
    * Compute eigenvector related to highest eigenvalue
@@ -183,13 +206,186 @@ private:
   Ptr<MatrixBasedChannelModel> m_channel; //!< pointer to the MatrixChannel, to retrieve the matrix on which the SVD should be computed
 
   std::map<Ptr<NetDevice>, Ptr<const MatrixBasedChannelModel::ChannelMatrix> > m_cacheChannelMap; //!< map that stores the channel previously computed
-  std::map<Ptr<NetDevice>, std::pair<ThreeGppAntennaArrayModel::ComplexVector, ThreeGppAntennaArrayModel::ComplexVector> > m_cacheBfVectors; //!< map that stores the previous bf vectors
+  std::map<Ptr<NetDevice>, BeamformingVectorPair> m_cacheBfVectors; //!< map that stores the previous bf vectors
   uint32_t m_maxIterations; //!< Maximum number of iterations to numerically approximate the SVD decomposition
   double m_tolerance; //!< Tolerance to numerically approximate the SVD decomposition
   bool m_useCache; //!< Cache the channel matrix whenever possible. NOTE: the SVD decomposition can be extremely computationally expensive, caching is suggested.
 };
 
 
+/**
+ * This class extends the MmWaveSvdBeamforming class.
+ * It computes the same beamforming vectors, i.e., the dominant singular
+ * vectors of the narrowband channel H, but:
+ * - it works on contiguous matrices, with the complex kernels of
+ *   MmWaveBeamformingKernels, which use AVX2 if UseSimd is true and the CPU
+ *   supports it;
+ * - it computes only the smaller of the Gram matrices H^H H and H H^H, and
+ *   derives the singular vector of the other side from the one of the Gram
+ *   matrix, e.g., u = H v / |H v|;
+ * - if WarmStart is true, the power iteration starts from the singular
+ *   vector computed for the previous channel matrix of the same pair of
+ *   nodes, so that it converges in a few iterations when the channel
+ *   changes slowly.
+ * The vectors can differ from the ones of MmWaveSvdBeamforming by a constant
+ * phase, and within the convergence tolerance of the power iteration.
+ */
+class MmWaveFastSvdBeamforming : public MmWaveSvdBeamforming
+{
+public:
+  /**
+   * Constructor
+   */
+  MmWaveFastSvdBeamforming ();
+
+  /**
+   * Destructor
+   */
+  virtual ~MmWaveFastSvdBeamforming () override;
+
+  /**
+   * Returns the object type id
+   * \return the type id
+   */
+  static TypeId GetTypeId (void);
+
+protected:
+  void DoDispose (void) override;
+  /**
+   * Compute the beamforming vectors from the smaller Gram matrix of the
+   * narrowband channel
+   * \param params the channel matrix
+   * \return a pair with the beamforming vectors
+   */
+  BeamformingVectorPair ComputeBeamformingVectors (Ptr<const MatrixBasedChannelModel::ChannelMatrix> params) override;
+
+private:
+  /**
+   * Compute the eigenvector related to the highest eigenvalue with the power
+   * iteration
+   * \param gram the Gram matrix (complex, hermitian), stored row by row
+   * \param size the number of rows and columns of the Gram matrix
+   * \param x the initial vector, replaced by the eigenvector
+   * \return the number of iterations
+   */
+  uint32_t PowerIteration (const ThreeGppAntennaArrayModel::ComplexVector &gram, size_t size,
+                           ThreeGppAntennaArrayModel::ComplexVector &x) const;
+
+  bool m_useSimd; //!< Use the AVX2 kernels, if available
+  bool m_warmStart; //!< Start the power iteration from the previous singular vector of the same pair of nodes
+  std::map<std::pair<uint32_t, uint32_t>, ThreeGppAntennaArrayModel::ComplexVector> m_lastVectors; //!< the last singular vector of the Gram matrix, for each pair of node IDs of the channel matrices
+};
+
+
+/**
+ * This class extends the MmWaveBeamformingModel interface.
+ * It implements a beam search over a codebook of steering vectors.
+ *
+ * The codebook of a ThreeGppAntennaArrayModel is a 2D DFT codebook,
+ * oversampled by OversamplingFactor in both the horizontal and the vertical
+ * dimension, and restricted to the visible region of the array. It depends
+ * only on the number of rows and columns and on the spacing of the elements,
+ * thus it is computed once and shared by all the models using an array with
+ * the same geometry. The steering vectors are defined in the local coordinate
+ * system of the array, thus the orientation of the array does not matter.
+ *
+ * For each pair of devices, the beam pair which maximizes the gain
+ * |w_a^T H w_b|^2 on the narrowband channel H, i.e., the sum of the cluster
+ * matrices of the channel, is selected. The gains of all the beam pairs are
+ * evaluated in two batched matrix products, with the complex kernels of
+ * MmWaveBeamformingKernels. As in MmWaveSvdBeamforming, the beam pair is
+ * computed again only when the channel matrix changes.
+ */
+class MmWaveCodebookBeamforming : public MmWaveBeamformingModel
+{
+public:
+  /**
+   * The codebook of an antenna array. The steering vectors are stored one
+   * after the other in a single contiguous vector
+   */
+  struct Codebook : public SimpleRefCount<Codebook>
+  {
+    uint32_t m_numElements; //!< the number of antenna elements, i.e., the size of each steering vector
+    uint32_t m_numBeams; //!< the number of steering vectors
+    ThreeGppAntennaArrayModel::ComplexVector m_beams; //!< the steering vectors, the element i of the beam b has index b * m_numElements + i
+    std::vector<std::pair<double, double> > m_directions; //!< the horizontal and vertical spatial frequencies of each beam
+
+    /**
+     * \param beam the index of the beam
+     * \return a pointer to the first element of the steering vector
+     */
+    const std::complex<double> * GetBeam (uint32_t beam) const
+    {
+      return m_beams.data () + beam * m_numElements;
+    }
+  };
+
+  /**
+   * Constructor
+   */
+  MmWaveCodebookBeamforming ();
+
+  /**
+   * Destructor
+   */
+  virtual ~MmWaveCodebookBeamforming () override;
+
+  /**
+   * Returns the object type id
+   * \return the type id
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * Computes the beamforming vectors of both antennas to communicate with the
+   * target device, as the best beam pair of the codebooks of the antennas.
+   * \param otherDevice the target device
+   * \param otherAntenna the target antenna of otherDevice
+   * \return the beamforming vectors
+   */
+  BeamformingVectorPair GetBeamformingVectorsForDevice (Ptr<NetDevice> otherDevice, Ptr<ThreeGppAntennaArrayModel> otherAntenna) override;
+
+  /**
+   * Get the codebook of an antenna array. The codebook is computed at the
+   * first call for each geometry of the array, and shared afterwards.
+   * \param antenna the antenna array
+   * \param oversampling the oversampling factor of the codebook
+   * \return the codebook
+   */
+  static Ptr<const Codebook> GetCodebook (Ptr<const ThreeGppAntennaArrayModel> antenna, uint32_t oversampling);
+
+protected:
+  void DoDispose (void) override;
+
+private:
+  /**
+   * Search the best beam pair of the codebooks on a channel matrix
+   * \param params the channel matrix
+   * \param bCodebook the codebook of the antenna of the columns of the
+   *        channel matrices
+   * \param aCodebook the codebook of the antenna of the rows of the
+   *        channel matrices
+   * \return a pair with the beamforming vectors of the columns and of the
+   *         rows antenna
+   */
+  BeamformingVectorPair SearchBeamPair (Ptr<const MatrixBasedChannelModel::ChannelMatrix> params,
+                                        Ptr<const Codebook> bCodebook, Ptr<const Codebook> aCodebook) const;
+
+  /**
+   * The geometry of an antenna array and the oversampling factor: number of
+   * rows, number of columns, horizontal and vertical spacing, oversampling
+   */
+  typedef std::tuple<uint32_t, uint32_t, double, double, uint32_t> CodebookKey;
+
+  Ptr<MatrixBasedChannelModel> m_channel; //!< pointer to the MatrixChannel, to retrieve the matrix on which the beam search is done
+  uint32_t m_oversampling; //!< The oversampling factor of the codebooks
+  bool m_useSimd; //!< Use the AVX2 kernels, if available
+  bool m_useCache; //!< Cache the beam pairs whenever possible
+  std::map<Ptr<NetDevice>, Ptr<const MatrixBasedChannelModel::ChannelMatrix> > m_cacheChannelMap; //!< map that stores the channel previously used
+  std::map<Ptr<NetDevice>, BeamformingVectorPair> m_cacheBfVectors; //!< map that stores the previous bf vectors
+};
+
+
 } // namespace mmwave
 } // namespace ns3
 
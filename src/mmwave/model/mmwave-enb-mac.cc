@@ -945,6 +945,9 @@ MmWaveEnbMac::DoSchedConfigIndication (MmWaveMacSchedSapUser::SchedConfigIndPara
 
                   std::map<uint32_t, struct MacPduInfo>::iterator pduMapIt = mapRet.first;
                   pduMapIt->second.m_numRlcPdu = 0;
+                  // the RLC PDUs are written in place in the TB, and the MAC header
+                  // is serialized once in front of them
+                  pduMapIt->second.ReserveTb (rlcPduInfo.size ());
                   for (unsigned int ipdu = 0; ipdu < rlcPduInfo.size (); ipdu++)
                     {
                       NS_ASSERT_MSG (rntiIt != m_rlcAttached.end (), "could not find RNTI" << rnti);
@@ -970,16 +973,14 @@ MmWaveEnbMac::DoSchedConfigIndication (MmWaveMacSchedSapUser::SchedConfigIndPara
                     }
                   pduMapIt->second.m_pdu->AddHeader (pduMapIt->second.m_macHeader);
 
-                  MmWaveMacPduHeader hdrTst;
-                  pduMapIt->second.m_pdu->PeekHeader (hdrTst);
-
                   NS_ASSERT (pduMapIt->second.m_pdu->GetSize () > 0);
                   LteRadioBearerTag bearerTag (rnti, pduMapIt->second.m_size, 0);
                   pduMapIt->second.m_pdu->AddPacketTag (bearerTag);
                   NS_LOG_DEBUG ("eNB sending MAC pdu size " << pduMapIt->second.m_pdu->GetSize ());
-                  for (unsigned i = 0; i < pduMapIt->second.m_macHeader.GetSubheaders ().size (); i++)
+                  const std::vector<MacSubheader> &subheaders = pduMapIt->second.m_macHeader.GetSubheaders ();
+                  for (unsigned i = 0; i < subheaders.size (); i++)
                     {
-                      NS_LOG_DEBUG ("Subheader " << i << " size " << pduMapIt->second.m_macHeader.GetSubheaders ().at (i).m_size);
+                      NS_LOG_DEBUG ("Subheader " << i << " size " << subheaders.at (i).m_size);
                     }
                   NS_LOG_DEBUG ("Total MAC PDU size " << pduMapIt->second.m_pdu->GetSize ());
                   harqIt->second.at (tbUid).m_pktBurst->AddPacket (pduMapIt->second.m_pdu);
@@ -62,6 +62,8 @@
 #include <algorithm>
 #include <array>
 #include <ns3/antenna-model.h>
+#include <ns3/three-gpp-spectrum-propagation-loss-model.h>
+#include <chrono>
 
 namespace ns3 {
 
@@ -81,7 +83,8 @@ MmWaveEnbPhy::MmWaveEnbPhy (Ptr<MmWaveSpectrumPhy> dlPhy, Ptr<MmWaveSpectrumPhy>
   : MmWavePhy (dlPhy, ulPhy),
   m_prevSlot (0),
   m_prevTtiDir (TtiAllocInfo::NA),
-  m_currSymStart (0)
+  m_currSymStart (0),
+  m_batchedSinrEstimate (true)
 {
   m_enbCphySapProvider = new MemberLteEnbCphySapProvider<MmWaveEnbPhy> (this);
   m_roundFromLastUeSinrUpdate = 0;
@@ -125,6 +128,13 @@ MmWaveEnbPhy::GetTypeId (void)
                    IntegerValue (320000),
                    MakeIntegerAccessor (&MmWaveEnbPhy::m_transient),
                    MakeIntegerChecker<int> ())
+    .AddAttribute ("BatchedSinrEstimate",
+                   "If true, estimate the SINR of all the UEs from the beamforming vectors of each pair, "
+                   "without pointing the antennas of the eNB and of the UEs towards each other. "
+                   "Used only with the ThreeGppSpectrumPropagationLossModel",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&MmWaveEnbPhy::m_batchedSinrEstimate),
+                   MakeBooleanChecker ())
     .AddAttribute ("NoiseFigure",
                    "Loss (dB) in the Signal-to-Noise-Ratio due to non-idealities in the receiver."
                    " According to Wikipedia (http://en.wikipedia.org/wiki/Noise_figure), this is "
@@ -157,7 +167,11 @@ MmWaveEnbPhy::GetTypeId (void)
                      "Report the allocation info for the current DL transmission",
                      MakeTraceSourceAccessor (&MmWaveEnbPhy::m_dlPhyTrace),
                      "ns3::DlPhyTransmission::TracedCallback")
-
+    .AddTraceSource ("SinrEstimateCost",
+                     "Report the number of UEs, the number of channel long term components recomputed "
+                     "and the wall-clock time of each update of the SINR estimates",
+                     MakeTraceSourceAccessor (&MmWaveEnbPhy::m_sinrEstimateCostTrace),
+                     "ns3::mmwave::SinrEstimateCostTraceParams::TracedCallback")
   ;
   return tid;
 
@@ -167,8 +181,8 @@ void
 MmWaveEnbPhy::DoInitialize (void)
 {
   NS_LOG_FUNCTION (this);
-  Ptr<SpectrumValue> noisePsd = MmWaveSpectrumValueHelper::CreateNoisePowerSpectralDensity (m_phyMacConfig, m_noiseFigure);
-  m_downlinkSpectrumPhy->SetNoisePowerSpectralDensity (noisePsd);
+  m_noisePsd = MmWaveSpectrumValueHelper::CreateNoisePowerSpectralDensity (m_phyMacConfig, m_noiseFigure);
+  m_downlinkSpectrumPhy->SetNoisePowerSpectralDensity (m_noisePsd);
 
   for (unsigned i = 0; i < m_phyMacConfig->GetL1L2Latency (); i++)
     {   // push elements onto queue for initial scheduling delay
@@ -570,13 +584,28 @@ MmWaveEnbPhy::UpdateUeSinrEstimate ()
 {
   NS_LOG_FUNCTION (this);
 
+  auto wallClockStart = std::chrono::steady_clock::now ();
+
   m_sinrMap.clear ();
   m_rxPsdMap.clear ();
 
-
-  Ptr<SpectrumValue> noisePsd = MmWaveSpectrumValueHelper::CreateNoisePowerSpectralDensity (m_phyMacConfig, m_noiseFigure);
+  Ptr<SpectrumValue> noisePsd = m_noisePsd;
   Ptr<SpectrumValue> totalReceivedPsd = Create <SpectrumValue> (SpectrumValue (noisePsd->GetSpectrumModel ()));
 
+  // with the 3GPP channel model, the beamforming gain can be computed from
+  // the beamforming vectors, without configuring the antennas
+  Ptr<ThreeGppSpectrumPropagationLossModel> threeGppSplm = DynamicCast<ThreeGppSpectrumPropagationLossModel> (m_spectrumPropagationLossModel);
+  bool batched = m_batchedSinrEstimate && threeGppSplm;
+  uint64_t numLongTermUpdates = threeGppSplm ? threeGppSplm->GetNumLongTermUpdates () : 0;
+
+  // the tx PSD depends only on the tx power of the UE, which is usually the
+  // same for all the UEs
+  std::map<double, Ptr<const SpectrumValue> > txPsdMap;
+
+  // get this node mobility
+  Ptr<MobilityModel> enbMob = m_netDevice->GetNode ()->GetObject<MobilityModel> ();
+  NS_LOG_LOGIC ("eNB mobility " << enbMob->GetPosition ());
+
   for (std::map<uint64_t, Ptr<NetDevice> >::iterator ue = m_ueAttachedImsiMap.begin (); ue != m_ueAttachedImsiMap.end (); ++ue)
     {
       // distinguish between MC and MmWaveNetDevice
@@ -601,28 +630,52 @@ MmWaveEnbPhy::UpdateUeSinrEstimate ()
           NS_FATAL_ERROR ("Unrecognized device");
         }
       NS_LOG_LOGIC ("UE Tx power = " << ueTxPower);
-      double powerTxW = std::pow (10., (ueTxPower - 30) / 10);
-      double txPowerDensity = 0;
-      txPowerDensity = (powerTxW / (m_phyMacConfig->GetBandwidth ()));
-      NS_LOG_LOGIC ("Linear UE Tx power = " << powerTxW);
-      NS_LOG_LOGIC ("System bandwidth = " << m_phyMacConfig->GetBandwidth ());
-      NS_LOG_LOGIC ("txPowerDensity = " << txPowerDensity);
-      // create tx psd
-      Ptr<SpectrumValue> txPsd =                                                        // it is the eNB that dictates the conf, m_listOfSubchannels contains all the subch
-        MmWaveSpectrumValueHelper::CreateTxPowerSpectralDensity (m_phyMacConfig, ueTxPower, m_listOfSubchannels);
+
+      // create tx psd, or reuse the one of a UE with the same tx power
+      Ptr<const SpectrumValue> txPsd;
+      auto txPsdIt = txPsdMap.find (ueTxPower);
+      if (txPsdIt != txPsdMap.end ())
+        {
+          txPsd = txPsdIt->second;
+        }
+      else
+        {
+          // it is the eNB that dictates the conf, m_listOfSubchannels contains all the subch
+          txPsd = MmWaveSpectrumValueHelper::CreateTxPowerSpectralDensity (m_phyMacConfig, ueTxPower, m_listOfSubchannels);
+          txPsdMap[ueTxPower] = txPsd;
+        }
       NS_LOG_LOGIC ("TxPsd " << *txPsd);
 
-      // get this node and remote node mobility
-      Ptr<MobilityModel> enbMob = m_netDevice->GetNode ()->GetObject<MobilityModel> ();
-      NS_LOG_LOGIC ("eNB mobility " << enbMob->GetPosition ());
+      // get remote node mobility
       Ptr<MobilityModel> ueMob = ue->second->GetNode ()->GetObject<MobilityModel> ();
       NS_LOG_DEBUG ("UE mobility " << ueMob->GetPosition ());
 
       // compute rx psd
 
-      // adjuts beamforming of antenna model wrt user
-      m_downlinkSpectrumPhy->ConfigureBeamforming (ue->second);
-      uePhy->GetDlSpectrumPhy ()->ConfigureBeamforming (m_netDevice);
+      ThreeGppAntennaArrayModel::ComplexVector enbBfVector;
+      ThreeGppAntennaArrayModel::ComplexVector ueBfVector;
+      if (batched)
+        {
+          // compute the vectors that the two following calls to
+          // ConfigureBeamforming would set: the UE configures its antenna,
+          // and possibly the one of the eNB, after the eNB
+          MmWaveBeamformingModel::BeamformingVectorPair ueBf = uePhy->GetDlSpectrumPhy ()->GetBeamformingVectors (m_netDevice);
+          ueBfVector = ueBf.first;
+          if (!ueBf.second.empty ())
+            {
+              enbBfVector = ueBf.second;
+            }
+          else
+            {
+              enbBfVector = m_downlinkSpectrumPhy->GetBeamformingVectors (ue->second).first;
+            }
+        }
+      else
+        {
+          // adjuts beamforming of antenna model wrt user
+          m_downlinkSpectrumPhy->ConfigureBeamforming (ue->second);
+          uePhy->GetDlSpectrumPhy ()->ConfigureBeamforming (m_netDevice);
+        }
 
       // TODO remove, the antenna gains are taken into account by the channel
       // model. Should we support other kinds of antennas?
@@ -655,12 +708,25 @@ MmWaveEnbPhy::UpdateUeSinrEstimate ()
       Ptr<SpectrumValue> rxPsd = txPsd->Copy ();
       *(rxPsd) *= pathGainLinear;
 
-      rxPsd = m_spectrumPropagationLossModel->CalcRxPowerSpectralDensity (rxPsd, ueMob, enbMob);
+      if (batched)
+        {
+          rxPsd = threeGppSplm->CalcRxPowerSpectralDensityWithBeams (rxPsd, ueMob, enbMob, ueBfVector, enbBfVector);
+        }
+      else
+        {
+          rxPsd = m_spectrumPropagationLossModel->CalcRxPowerSpectralDensity (rxPsd, ueMob, enbMob);
+        }
       NS_LOG_LOGIC ("RxPsd " << *rxPsd);
 
       m_rxPsdMap[ue->first] = rxPsd;
       *totalReceivedPsd += *rxPsd;
 
+      if (batched)
+        {
+          // the antennas have not been modified
+          continue;
+        }
+
       // set back the bf vector to the main eNB
       if (ueNetDevice != 0)
         {                                                                                                                       // target not set yet
@@ -683,6 +749,15 @@ MmWaveEnbPhy::UpdateUeSinrEstimate ()
 
     }
 
+  SinrEstimateCostTraceParams costParams;
+  costParams.m_cellId = m_cellId;
+  costParams.m_ccId = m_componentCarrierId;
+  costParams.m_batched = batched;
+  costParams.m_numUes = m_ueAttachedImsiMap.size ();
+  costParams.m_numLongTermUpdates = threeGppSplm ? threeGppSplm->GetNumLongTermUpdates () - numLongTermUpdates : 0;
+  costParams.m_wallClockNs = std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - wallClockStart).count ();
+  m_sinrEstimateCostTrace (costParams);
+
   for (std::map<uint64_t, Ptr<SpectrumValue> >::iterator ue = m_rxPsdMap.begin (); ue != m_rxPsdMap.end (); ++ue)
     {
       SpectrumValue interference = *totalReceivedPsd - *(ue->second);
@@ -1002,7 +1077,14 @@ MmWaveEnbPhy::StartTti (void)
       // Trace current DL transmission info
       TraceDlPhyTransmission (currTti.m_dci, PhyTransmissionTraceParams::CTRL);
 
-      SendCtrlChannels (ctrlMsgs, ttiPeriod - NanoSeconds (1.0));       // -1 ns ensures control ends before data period
+      if (m_skipIdleSlots && ctrlMsgs.empty ())
+        {
+          NS_LOG_LOGIC ("No DL control messages, the control frame is not transmitted");
+        }
+      else
+        {
+          SendCtrlChannels (ctrlMsgs, ttiPeriod - NanoSeconds (1.0));       // -1 ns ensures control ends before data period
+        }
     }
   else if (m_ttiIndex == m_currSlotNumTti - 1)      // Last TTI of this slot: reserved UL control
     {
@@ -1087,6 +1169,23 @@ MmWaveEnbPhy::StartTti (void)
   NS_ASSERT (m_ttiIndex != 0 || currTti.m_dci.m_symStart == m_ttiIndex);
   m_phySapUser->SlotIndication (SfnSf (m_frameNum, m_sfNum, m_slotNum, currTti.m_dci.m_symStart));  // trigger MAC
 
+  if (m_skipIdleSlots && m_currSlotNumTti == 2)
+    {
+      // only the control TTIs: EndTti has nothing to do, chain the next TTI, or the next slot
+      if (m_ttiIndex == 0)
+        {
+          m_ttiIndex++;
+          Time nextTtiStart = m_phyMacConfig->GetSymbolPeriod () *
+                                           m_currSlotAllocInfo.m_ttiAllocInfo[m_ttiIndex].m_dci.m_symStart;
+          Simulator::Schedule (nextTtiStart + m_lastSlotStart - Simulator::Now (), &MmWaveEnbPhy::StartTti, this);
+        }
+      else
+        {
+          Simulator::Schedule (MmWavePhy::GetNextSlotDelay (), &MmWaveEnbPhy::EndSlot, this);
+        }
+      return;
+    }
+
   Simulator::Schedule (ttiPeriod, &MmWaveEnbPhy::EndTti, this);
 }
 
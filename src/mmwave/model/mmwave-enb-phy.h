@@ -158,6 +158,18 @@ public:
 
   void ReceiveUlHarqFeedback (UlHarqInfo mes);
 
+  /**
+   * Estimates the SNR of the uplink reference signals of all the attached
+   * UEs, reports them to the RRC and, periodically, to the UEs, and
+   * reschedules itself after UpdateSinrEstimatePeriod.
+   *
+   * If BatchedSinrEstimate is true and a ThreeGppSpectrumPropagationLossModel
+   * is used, the beamforming vectors of each eNB-UE pair are only computed
+   * and passed to the channel model, so that the antennas are neither
+   * reconfigured towards each UE nor restored afterwards. Otherwise, the
+   * antennas of the eNB and of each UE are pointed towards each other before
+   * computing the received PSD.
+   */
   void UpdateUeSinrEstimate ();
 
   double AddGaussianNoise (double sample);
@@ -240,6 +252,10 @@ private:
   TracedCallback< uint64_t, SpectrumValue&, SpectrumValue& > m_ulSinrTrace;
 
   TracedCallback<PhyTransmissionTraceParams> m_dlPhyTrace;   //!< Traces the current TTI allocation info, from the eNB side
+
+  bool m_batchedSinrEstimate;   //!< If true, estimate the SINR of all the UEs without reconfiguring the antennas
+  Ptr<SpectrumValue> m_noisePsd;   //!< The noise PSD used to estimate the SINR of the UEs
+  TracedCallback<SinrEstimateCostTraceParams> m_sinrEstimateCostTrace;   //!< Traces the cost of each update of the SINR estimates
 };
 
 } // namespace mmwave
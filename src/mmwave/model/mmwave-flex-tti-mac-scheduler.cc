@@ -29,6 +29,7 @@
 
 #include <ns3/log.h>
 #include <ns3/abort.h>
+#include <ns3/profiler.h>
 #include "mmwave-flex-tti-mac-scheduler.h"
 #include <ns3/lte-common.h>
 #include <ns3/boolean.h>
@@ -657,6 +658,7 @@ void
 MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params)
 {
   NS_LOG_FUNCTION (this);
+  NS_PROFILE_SCOPE ("MmWaveFlexTtiMacScheduler::DoSchedTriggerReq");
 
   uint16_t frameNum = params.m_snfSf.m_frameNum;
   uint8_t sfNum = params.m_snfSf.m_sfNum;
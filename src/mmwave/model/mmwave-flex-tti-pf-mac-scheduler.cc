@@ -7,6 +7,7 @@
 
 #include <ns3/log.h>
 #include <ns3/abort.h>
+#include <ns3/profiler.h>
 #include "mmwave-flex-tti-pf-mac-scheduler.h"
 #include <ns3/lte-common.h>
 #include <ns3/boolean.h>
@@ -755,6 +756,7 @@ unsigned MmWaveFlexTtiPfMacScheduler::CalcMinTbSizeNumSym (unsigned mcs, unsigne
 void
 MmWaveFlexTtiPfMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params)
 {
+  NS_PROFILE_SCOPE ("MmWaveFlexTtiPfMacScheduler::DoSchedTriggerReq");
   uint16_t frameNum = params.m_snfSf.m_frameNum;
   uint8_t sfNum = params.m_snfSf.m_sfNum;
   uint8_t slotNum = params.m_snfSf.m_slotNum;
@@ -93,11 +93,20 @@ public:
     m_subheaderList = macSubheaderList;
   }
 
-  std::vector<MacSubheader> GetSubheaders (void)
+  const std::vector<MacSubheader>& GetSubheaders (void) const
   {
     return m_subheaderList;
   }
 
+  /**
+   * \brief Reserve the memory of the subheader list
+   * \param numSubheaders the number of subheaders that will be added
+   */
+  void ReserveSubheaders (uint32_t numSubheaders)
+  {
+    m_subheaderList.reserve (numSubheaders);
+  }
+
 protected:
   std::vector<MacSubheader> m_subheaderList;
   uint32_t m_headerSize;
@@ -76,6 +76,26 @@ struct MacPduInfo
     m_pdu->AddPacketTag (tag);
   }
 
+  /**
+   * \brief Reserve the memory of the whole TB in m_pdu
+   *
+   * The RLC PDUs appended to m_pdu, and the MAC header then added in front
+   * of them, are written in place in the reserved memory, instead of
+   * reallocating and copying the TB at each RLC PDU.
+   *
+   * \param numSubheaders the number of subheaders of the MAC header
+   */
+  void ReserveTb (uint32_t numSubheaders)
+  {
+    NS_ASSERT (m_pdu->GetSize () == 0);
+    // a subheader takes at most 4 bytes
+    uint32_t headerSize = 4 * numSubheaders;
+    m_pdu->AddPaddingAtEnd (headerSize + m_size);
+    m_pdu->RemoveAtStart (headerSize);
+    m_pdu->RemoveAtEnd (m_size);
+    m_macHeader.ReserveSubheaders (numSubheaders);
+  }
+
   SfnSf m_sfnSf;
   uint32_t m_size;
   uint8_t m_numRlcPdu;
@@ -133,6 +133,38 @@ struct PhyTransmissionTraceParams
   uint8_t m_ccId;    //!< The Component Carrier (CC) ID
 };
 
+/**
+ * Struct used to trace the cost of an update of the SINR estimates of the
+ * UEs attached to an eNB.
+ * \see MmWaveEnbPhy::UpdateUeSinrEstimate
+ */
+struct SinrEstimateCostTraceParams
+{
+  SinrEstimateCostTraceParams ()
+    : m_cellId (0),
+    m_ccId (0),
+    m_batched (false),
+    m_numUes (0),
+    m_numLongTermUpdates (0),
+    m_wallClockNs (0)
+  {
+
+  }
+
+  /**
+   * TracedCallback signature.
+   * \param [in] params the cost of the SINR estimation
+   */
+  typedef void (* TracedCallback)(SinrEstimateCostTraceParams params);
+
+  uint16_t m_cellId;  //!< The cell ID of the eNB
+  uint8_t m_ccId;    //!< The Component Carrier (CC) ID
+  bool m_batched;    //!< True if the batched estimator was used
+  uint32_t m_numUes;    //!< Number of UEs whose SINR was estimated
+  uint64_t m_numLongTermUpdates;    //!< Number of long term components of the channel recomputed during the update
+  int64_t m_wallClockNs;    //!< Wall-clock time spent computing the received PSDs, in nanoseconds
+};
+
 /**
  * Struct holding the information of a DCI message
  */
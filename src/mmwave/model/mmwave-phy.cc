@@ -38,6 +38,7 @@
 #include <ns3/node.h>
 #include <ns3/packet.h>
 #include <ns3/log.h>
+#include <ns3/boolean.h>
 #include "mmwave-phy.h"
 #include "mmwave-phy-sap.h"
 #include "mmwave-mac-pdu-tag.h"
@@ -108,6 +109,14 @@ MmWavePhy::GetTypeId ()
     tid =
     TypeId ("ns3::MmWavePhy")
     .SetParent<Object> ()
+    .AddAttribute ("SkipIdleSlots",
+                   "If true, the control frames without control messages are "
+                   "not transmitted, since they are neither decoded nor counted "
+                   "as interference, and the slots without data TTIs skip the "
+                   "TTI end events, so that idle cells schedule fewer events",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MmWavePhy::m_skipIdleSlots),
+                   MakeBooleanChecker ())
   ;
 
   return tid;
@@ -128,7 +137,8 @@ MmWavePhy::MmWavePhy (Ptr<MmWaveSpectrumPhy> dlChannelPhy, Ptr<MmWaveSpectrumPhy
   m_slotNum (0),
   m_ttiIndex (0),
   m_sfAllocInfoUpdated (false),
-  m_componentCarrierId (0)
+  m_componentCarrierId (0),
+  m_skipIdleSlots (false)
 {
   NS_LOG_FUNCTION (this);
   m_phySapProvider = new MmWaveMemberPhySapProvider (this);
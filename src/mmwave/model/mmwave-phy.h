@@ -199,6 +199,12 @@ protected:
   /// component carrier Id used to address sap
   uint8_t m_componentCarrierId;
 
+  /**
+   * If true, the empty control frames are not transmitted, and the TTIs of
+   * the slots without data are chained without their end events
+   */
+  bool m_skipIdleSlots;
+
 
 private:
 };
@@ -293,10 +293,9 @@ MmWaveSpectrumPhy::SetPhyUlHarqFeedbackCallback (MmWavePhyUlHarqFeedbackCallback
   m_phyUlHarqFeedbackCallback = c;
 }
 
-void
-MmWaveSpectrumPhy::ConfigureBeamforming (Ptr<NetDevice> device)
+Ptr<ThreeGppAntennaArrayModel>
+MmWaveSpectrumPhy::GetDeviceAntenna (Ptr<NetDevice> device) const
 {
-  NS_LOG_FUNCTION (this << device);
   Ptr<ThreeGppAntennaArrayModel> antenna;
 
   // test if device is a MmWaveNetDevice
@@ -312,8 +311,21 @@ MmWaveSpectrumPhy::ConfigureBeamforming (Ptr<NetDevice> device)
     {
       antenna = mcUeNetDevice->GetAntenna (m_componentCarrierId);
     }
-  
-  m_beamforming->SetBeamformingVectorForDevice (device, antenna);
+  return antenna;
+}
+
+void
+MmWaveSpectrumPhy::ConfigureBeamforming (Ptr<NetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  m_beamforming->SetBeamformingVectorForDevice (device, GetDeviceAntenna (device));
+}
+
+MmWaveBeamformingModel::BeamformingVectorPair
+MmWaveSpectrumPhy::GetBeamformingVectors (Ptr<NetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  return m_beamforming->GetBeamformingVectorsForDevice (device, GetDeviceAntenna (device));
 }
 
 void
@@ -200,6 +200,17 @@ public:
   */
   void ConfigureBeamforming (Ptr<NetDevice> device);
 
+  /**
+  * Compute the beamforming vectors which ConfigureBeamforming would apply to
+  * point the beam towards the target device, without updating the
+  * configuration of any antenna.
+  * \param device target device
+  * \return the beamforming vectors of the antenna of this device and of the
+  *         antenna of the target device (empty if it would not be configured)
+  * \see MmWaveBeamformingModel::GetBeamformingVectorsForDevice
+  */
+  MmWaveBeamformingModel::BeamformingVectorPair GetBeamformingVectors (Ptr<NetDevice> device);
+
   void SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd);
   void SetTxPowerSpectralDensity (Ptr<SpectrumValue> TxPsd);
   void StartRx (Ptr<SpectrumSignalParameters> params) override;
@@ -251,6 +262,14 @@ public:
 
 
 private:
+  /**
+  * Returns the antenna of the target device used for the component carrier
+  * of this spectrum phy
+  * \param device target device
+  * \return the antenna of the target device
+  */
+  Ptr<ThreeGppAntennaArrayModel> GetDeviceAntenna (Ptr<NetDevice> device) const;
+
 
   /**
    * \brief change the state
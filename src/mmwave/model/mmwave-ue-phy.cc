@@ -575,7 +575,14 @@ MmWaveUePhy::StartTti ()
       // Trace current UL transmission info
       TraceUlPhyTransmission (currTti.m_dci, PhyTransmissionTraceParams::CTRL);
 
-      SendCtrlChannels (ctrlMsg, currTtiDuration - NanoSeconds (1.0));
+      if (m_skipIdleSlots && ctrlMsg.empty ())
+        {
+          NS_LOG_LOGIC ("No UL control messages, the control frame is not transmitted");
+        }
+      else
+        {
+          SendCtrlChannels (ctrlMsg, currTtiDuration - NanoSeconds (1.0));
+        }
 
     }
   else if (currTti.m_dci.m_format == DciInfoElementTdma::DL_dci)  // Scheduled DL data Tti
@@ -635,6 +642,13 @@ MmWaveUePhy::StartTti ()
   NS_ASSERT (m_ttiIndex != 0 || currTti.m_dci.m_symStart == m_ttiIndex);
   m_phySapUser->SlotIndication (SfnSf (m_frameNum, m_sfNum, m_slotNum, currTti.m_dci.m_symStart));            // trigger mac
 
+  if (m_skipIdleSlots && m_currSlotAllocInfo.m_ttiAllocInfo.size () == 2 && m_ttiIndex == 1)
+    {
+      // UL control TTI of a slot without data: EndTti has nothing to do, chain the next slot
+      ScheduleNextSlot ();
+      return;
+    }
+
   NS_LOG_DEBUG ("MmWaveUePhy: Scheduling TTI end after " << currTtiDuration);
   Simulator::Schedule (currTtiDuration, &MmWaveUePhy::EndTti, this);
 }
@@ -649,29 +663,7 @@ MmWaveUePhy::EndTti ()
 
   if (m_ttiIndex == m_currSlotAllocInfo.m_ttiAllocInfo.size () - 1) // End of this slot, as last TTI always happens at the last OFDM symbol
     {
-      uint16_t frameNum = m_frameNum;
-      uint8_t sfNum = m_sfNum;
-      uint8_t slotNum {0};
-      if (m_slotNum == m_phyMacConfig->GetSlotsPerSubframe () - 1) // End of this subframe
-        {
-          if (m_sfNum == m_phyMacConfig->GetSubframesPerFrame () - 1) // End of the frame as well
-            {
-              sfNum = 0;
-              frameNum = m_frameNum + 1;
-            }
-          else // End of the current subframe only
-            {
-              sfNum = m_sfNum + 1;
-            }
-        }
-      else // End of just the slot
-        {
-          slotNum = m_slotNum + 1;
-        }
-
-      m_ttiIndex = 0; // Start of a new NR slot
-      Time nextSlotDelay = MmWavePhy::GetNextSlotDelay ();
-      Simulator::Schedule (nextSlotDelay, &MmWaveUePhy::SlotIndication, this, frameNum, sfNum, slotNum);
+      ScheduleNextSlot ();
     }
   else
     {
@@ -692,6 +684,35 @@ MmWaveUePhy::EndTti ()
     }
 }
 
+void
+MmWaveUePhy::ScheduleNextSlot ()
+{
+  NS_LOG_FUNCTION (this);
+  uint16_t frameNum = m_frameNum;
+  uint8_t sfNum = m_sfNum;
+  uint8_t slotNum {0};
+  if (m_slotNum == m_phyMacConfig->GetSlotsPerSubframe () - 1) // End of this subframe
+    {
+      if (m_sfNum == m_phyMacConfig->GetSubframesPerFrame () - 1) // End of the frame as well
+        {
+          sfNum = 0;
+          frameNum = m_frameNum + 1;
+        }
+      else // End of the current subframe only
+        {
+          sfNum = m_sfNum + 1;
+        }
+    }
+  else // End of just the slot
+    {
+      slotNum = m_slotNum + 1;
+    }
+
+  m_ttiIndex = 0; // Start of a new NR slot
+  Time nextSlotDelay = MmWavePhy::GetNextSlotDelay ();
+  Simulator::Schedule (nextSlotDelay, &MmWaveUePhy::SlotIndication, this, frameNum, sfNum, slotNum);
+}
+
 void
 MmWaveUePhy::PhyDataPacketReceived (Ptr<Packet> p)
 {
@@ -137,6 +137,12 @@ public:
    */
   void EndTti ();
 
+  /**
+   * Computes the frame, subframe and slot numbers of the next slot, and schedules
+   * \ref SlotIndication at the end of the current slot.
+   */
+  void ScheduleNextSlot ();
+
   /**
    * Initializes the slots allocation info for the given frame, subframe and slot.
    * 
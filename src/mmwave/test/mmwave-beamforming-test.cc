@@ -16,6 +16,7 @@
 */
 
 #include "ns3/mmwave-beamforming-model.h"
+#include "ns3/mmwave-beamforming-kernels.h"
 #include "ns3/test.h"
 #include "ns3/simple-net-device.h"
 #include "ns3/constant-position-mobility-model.h"
@@ -318,6 +319,333 @@ MmWaveSvdBeamformingTestCase::DoRun (void)
     }
 }
 
+/**
+* This test case checks if the MmWaveFastSvdBeamforming computes beamforming
+* vectors with the same gain of the ones of MmWaveSvdBeamforming, both when
+* the tx and when the rx antenna has fewer elements, with and without the
+* AVX2 kernels
+*/
+class MmWaveFastSvdBeamformingTestCase : public TestCase
+{
+public:
+  /**
+  * Constructor
+  * \param txSize the number of rows and columns of the tx antenna
+  * \param rxSize the number of rows and columns of the rx antenna
+  * \param useSimd use the AVX2 kernels, if available
+  */
+  MmWaveFastSvdBeamformingTestCase (uint32_t txSize, uint32_t rxSize, bool useSimd);
+
+  /**
+  * Destructor
+  */
+  virtual ~MmWaveFastSvdBeamformingTestCase ();
+
+private:
+  /**
+  * Run the test
+  */
+  virtual void DoRun (void);
+
+  /**
+  * Compute the gain of the beamforming vectors configured in the antennas
+  * \param channel the channel matrix, with the tx as the s node
+  * \param txAntenna the tx antenna
+  * \param rxAntenna the rx antenna
+  * \return the absolute value of the gain
+  */
+  static double GetGain (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channel,
+                         Ptr<ThreeGppAntennaArrayModel> txAntenna,
+                         Ptr<ThreeGppAntennaArrayModel> rxAntenna);
+
+  uint32_t m_txSize; //!< the number of rows and columns of the tx antenna
+  uint32_t m_rxSize; //!< the number of rows and columns of the rx antenna
+  bool m_useSimd; //!< use the AVX2 kernels
+};
+
+MmWaveFastSvdBeamformingTestCase::MmWaveFastSvdBeamformingTestCase (uint32_t txSize, uint32_t rxSize, bool useSimd)
+  : TestCase ("Checks if the MmWaveFastSvdBeamforming class gives the gain of MmWaveSvdBeamforming, tx "
+              + std::to_string (txSize) + "x" + std::to_string (txSize) + ", rx "
+              + std::to_string (rxSize) + "x" + std::to_string (rxSize)
+              + (useSimd ? ", SIMD" : ", scalar")),
+    m_txSize (txSize),
+    m_rxSize (rxSize),
+    m_useSimd (useSimd)
+{
+}
+
+MmWaveFastSvdBeamformingTestCase::~MmWaveFastSvdBeamformingTestCase ()
+{
+}
+
+double
+MmWaveFastSvdBeamformingTestCase::GetGain (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channel,
+                                           Ptr<ThreeGppAntennaArrayModel> txAntenna,
+                                           Ptr<ThreeGppAntennaArrayModel> rxAntenna)
+{
+  ThreeGppAntennaArrayModel::ComplexVector txW = txAntenna->GetBeamformingVector ();
+  ThreeGppAntennaArrayModel::ComplexVector rxW = rxAntenna->GetBeamformingVector ();
+  std::complex<double> gain (0, 0);
+  for (uint32_t c = 0; c < channel->m_channel.GetNumClusters (); c++)
+    {
+      for (uint32_t u = 0; u < rxW.size (); u++)
+        {
+          for (uint32_t s = 0; s < txW.size (); s++)
+            {
+              gain += rxW[u] * channel->m_channel (u, s, c) * txW[s];
+            }
+        }
+    }
+  return std::abs (gain);
+}
+
+void
+MmWaveFastSvdBeamformingTestCase::DoRun (void)
+{
+  // check the kernels
+  std::vector<std::complex<double> > a;
+  std::vector<std::complex<double> > b;
+  for (uint32_t i = 0; i < 7; i++)
+    {
+      a.push_back (std::complex<double> (0.5 * i - 1, 2.0 - i));
+      b.push_back (std::complex<double> (i * i, 0.25 * i));
+    }
+  for (bool conjugate : {false, true})
+    {
+      std::complex<double> ref = MmWaveBeamformingKernels::DotScalar (a.data (), b.data (), a.size (), conjugate);
+      std::complex<double> dot = MmWaveBeamformingKernels::Dot (a.data (), b.data (), a.size (), conjugate, m_useSimd);
+      NS_TEST_ASSERT_MSG_EQ_TOL (std::abs (dot - ref), 0, 1e-12, "The dot product differs from the scalar one");
+    }
+
+  Ptr<MobilityModel> txMob = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> rxMob = CreateObject<ConstantPositionMobilityModel> ();
+  rxMob->SetPosition (Vector (1, 0, 0));
+  Ptr<Node> txNode = CreateObject<Node> ();
+  txNode->AggregateObject (txMob);
+  Ptr<NetDevice> txDevice = CreateObject<SimpleNetDevice> ();
+  txDevice->SetNode (txNode);
+  txNode->AddDevice (txDevice);
+  Ptr<Node> rxNode = CreateObject<Node> ();
+  rxNode->AggregateObject (rxMob);
+  Ptr<NetDevice> rxDevice = CreateObject<SimpleNetDevice> ();
+  rxDevice->SetNode (rxNode);
+  rxNode->AddDevice (rxDevice);
+
+  Ptr<ThreeGppAntennaArrayModel> txAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumRows", UintegerValue (m_txSize),
+                                                                                                    "NumColumns", UintegerValue (m_txSize),
+                                                                                                    "IsotropicElements", BooleanValue (true));
+  Ptr<ThreeGppAntennaArrayModel> rxAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumRows", UintegerValue (m_rxSize),
+                                                                                                    "NumColumns", UintegerValue (m_rxSize),
+                                                                                                    "IsotropicElements", BooleanValue (true));
+
+  // a channel with three clusters
+  Ptr<SimpleMatrixBasedChannelModel> channelModel = CreateObject<SimpleMatrixBasedChannelModel> ();
+  channelModel->SetAodAzimuth ({10, -30, 60});
+  channelModel->SetAodElevation ({20, 80, 100});
+  channelModel->SetAoaAzimuth ({30, 120, -45});
+  channelModel->SetAoaElevation ({40, 90, 70});
+  channelModel->SetPhaseShift ({0, 1, 2});
+  channelModel->SetPathLoss ({0, -3, -6});
+  channelModel->SetDelay ({0, 1e-8, 3e-8});
+  Ptr<const MatrixBasedChannelModel::ChannelMatrix> channel = channelModel->GetChannel (txMob, rxMob, txAntenna, rxAntenna);
+
+  Ptr<MmWaveSvdBeamforming> svd = CreateObjectWithAttributes<MmWaveSvdBeamforming> ("Device", PointerValue (txDevice),
+                                                                                    "Antenna", PointerValue (txAntenna),
+                                                                                    "ChannelModel", PointerValue (channelModel),
+                                                                                    "MaxIterations", UintegerValue (1000),
+                                                                                    "Tolerance", DoubleValue (1e-20));
+  svd->SetBeamformingVectorForDevice (rxDevice, rxAntenna);
+  double svdGain = GetGain (channel, txAntenna, rxAntenna);
+
+  Ptr<MmWaveFastSvdBeamforming> fast = CreateObjectWithAttributes<MmWaveFastSvdBeamforming> ("Device", PointerValue (txDevice),
+                                                                                             "Antenna", PointerValue (txAntenna),
+                                                                                             "ChannelModel", PointerValue (channelModel),
+                                                                                             "MaxIterations", UintegerValue (1000),
+                                                                                             "Tolerance", DoubleValue (1e-20),
+                                                                                             "UseSimd", BooleanValue (m_useSimd),
+                                                                                             "UseCache", BooleanValue (false));
+  fast->SetBeamformingVectorForDevice (rxDevice, rxAntenna);
+  double fastGain = GetGain (channel, txAntenna, rxAntenna);
+  NS_TEST_ASSERT_MSG_EQ_TOL (fastGain, svdGain, svdGain * 1e-9, "The gain differs from the one of MmWaveSvdBeamforming");
+
+  // the beamforming vectors must be normalized
+  double txNorm = 0;
+  for (const auto &w : txAntenna->GetBeamformingVector ())
+    {
+      txNorm += std::norm (w);
+    }
+  double rxNorm = 0;
+  for (const auto &w : rxAntenna->GetBeamformingVector ())
+    {
+      rxNorm += std::norm (w);
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (txNorm, 1, 1e-12, "The tx beamforming vector is not normalized");
+  NS_TEST_ASSERT_MSG_EQ_TOL (rxNorm, 1, 1e-12, "The rx beamforming vector is not normalized");
+
+  // with the warm start, the same channel gives the same gain
+  fast->SetBeamformingVectorForDevice (rxDevice, rxAntenna);
+  NS_TEST_ASSERT_MSG_EQ_TOL (GetGain (channel, txAntenna, rxAntenna), svdGain, svdGain * 1e-9,
+                             "The gain with the warm start differs from the one of MmWaveSvdBeamforming");
+}
+
+/**
+* This test case checks if the MmWaveCodebookBeamforming selects the best
+* beam pair of the codebooks, and if the codebooks are shared by the
+* antennas with the same geometry
+*/
+class MmWaveCodebookBeamformingTestCase : public TestCase
+{
+public:
+  /**
+  * Constructor
+  * \param txSize the number of rows and columns of the tx antenna
+  * \param rxSize the number of rows and columns of the rx antenna
+  */
+  MmWaveCodebookBeamformingTestCase (uint32_t txSize, uint32_t rxSize);
+
+  /**
+  * Destructor
+  */
+  virtual ~MmWaveCodebookBeamformingTestCase ();
+
+private:
+  /**
+  * Run the test
+  */
+  virtual void DoRun (void);
+
+  /**
+  * Compute the gain of a pair of beamforming vectors
+  * \param channel the channel matrix, with the tx as the s node
+  * \param txW the tx beamforming vector
+  * \param rxW the rx beamforming vector
+  * \return the absolute value of the gain
+  */
+  static double GetGain (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channel,
+                         const std::complex<double> *txW, const std::complex<double> *rxW);
+
+  uint32_t m_txSize; //!< the number of rows and columns of the tx antenna
+  uint32_t m_rxSize; //!< the number of rows and columns of the rx antenna
+};
+
+MmWaveCodebookBeamformingTestCase::MmWaveCodebookBeamformingTestCase (uint32_t txSize, uint32_t rxSize)
+  : TestCase ("Checks if the MmWaveCodebookBeamforming class selects the best beam pair, tx "
+              + std::to_string (txSize) + "x" + std::to_string (txSize) + ", rx "
+              + std::to_string (rxSize) + "x" + std::to_string (rxSize)),
+    m_txSize (txSize),
+    m_rxSize (rxSize)
+{
+}
+
+MmWaveCodebookBeamformingTestCase::~MmWaveCodebookBeamformingTestCase ()
+{
+}
+
+double
+MmWaveCodebookBeamformingTestCase::GetGain (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channel,
+                                            const std::complex<double> *txW, const std::complex<double> *rxW)
+{
+  std::complex<double> gain (0, 0);
+  for (uint32_t c = 0; c < channel->m_channel.GetNumClusters (); c++)
+    {
+      for (uint32_t u = 0; u < channel->m_channel.GetNumRows (); u++)
+        {
+          for (uint32_t s = 0; s < channel->m_channel.GetNumCols (); s++)
+            {
+              gain += rxW[u] * channel->m_channel (u, s, c) * txW[s];
+            }
+        }
+    }
+  return std::abs (gain);
+}
+
+void
+MmWaveCodebookBeamformingTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> txMob = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> rxMob = CreateObject<ConstantPositionMobilityModel> ();
+  rxMob->SetPosition (Vector (1, 0, 0));
+  Ptr<Node> txNode = CreateObject<Node> ();
+  txNode->AggregateObject (txMob);
+  Ptr<NetDevice> txDevice = CreateObject<SimpleNetDevice> ();
+  txDevice->SetNode (txNode);
+  txNode->AddDevice (txDevice);
+  Ptr<Node> rxNode = CreateObject<Node> ();
+  rxNode->AggregateObject (rxMob);
+  Ptr<NetDevice> rxDevice = CreateObject<SimpleNetDevice> ();
+  rxDevice->SetNode (rxNode);
+  rxNode->AddDevice (rxDevice);
+
+  Ptr<ThreeGppAntennaArrayModel> txAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumRows", UintegerValue (m_txSize),
+                                                                                                    "NumColumns", UintegerValue (m_txSize),
+                                                                                                    "IsotropicElements", BooleanValue (true));
+  Ptr<ThreeGppAntennaArrayModel> rxAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumRows", UintegerValue (m_rxSize),
+                                                                                                    "NumColumns", UintegerValue (m_rxSize),
+                                                                                                    "IsotropicElements", BooleanValue (true));
+
+  // the codebooks depend only on the geometry of the arrays
+  uint32_t oversampling = 2;
+  Ptr<const MmWaveCodebookBeamforming::Codebook> txCodebook = MmWaveCodebookBeamforming::GetCodebook (txAntenna, oversampling);
+  Ptr<const MmWaveCodebookBeamforming::Codebook> rxCodebook = MmWaveCodebookBeamforming::GetCodebook (rxAntenna, oversampling);
+  Ptr<ThreeGppAntennaArrayModel> rotatedAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumRows", UintegerValue (m_txSize),
+                                                                                                         "NumColumns", UintegerValue (m_txSize),
+                                                                                                         "BearingAngle", DoubleValue (M_PI / 3));
+  NS_TEST_ASSERT_MSG_EQ (MmWaveCodebookBeamforming::GetCodebook (rotatedAntenna, oversampling), txCodebook,
+                         "The antennas with the same geometry should share the codebook");
+  NS_TEST_ASSERT_MSG_NE (MmWaveCodebookBeamforming::GetCodebook (txAntenna, oversampling + 1), txCodebook,
+                         "The codebooks with different oversampling should differ");
+  NS_TEST_ASSERT_MSG_EQ (txCodebook->m_numElements, txAntenna->GetNumberOfElements (), "Wrong size of the steering vectors");
+  NS_TEST_ASSERT_MSG_EQ (txCodebook->m_beams.size (), txCodebook->m_numBeams * txCodebook->m_numElements, "Wrong size of the codebook");
+  NS_TEST_ASSERT_MSG_GT (txCodebook->m_numBeams, txAntenna->GetNumberOfElements (), "The codebook should be oversampled");
+
+  // a channel with three clusters
+  Ptr<SimpleMatrixBasedChannelModel> channelModel = CreateObject<SimpleMatrixBasedChannelModel> ();
+  channelModel->SetAodAzimuth ({10, -30, 60});
+  channelModel->SetAodElevation ({20, 80, 100});
+  channelModel->SetAoaAzimuth ({30, 120, -45});
+  channelModel->SetAoaElevation ({40, 90, 70});
+  channelModel->SetPhaseShift ({0, 1, 2});
+  channelModel->SetPathLoss ({0, -3, -6});
+  channelModel->SetDelay ({0, 1e-8, 3e-8});
+  Ptr<const MatrixBasedChannelModel::ChannelMatrix> channel = channelModel->GetChannel (txMob, rxMob, txAntenna, rxAntenna);
+
+  // exhaustive search of the best beam pair
+  double bestGain = 0;
+  for (uint32_t t = 0; t < txCodebook->m_numBeams; t++)
+    {
+      for (uint32_t r = 0; r < rxCodebook->m_numBeams; r++)
+        {
+          bestGain = std::max (bestGain, GetGain (channel, txCodebook->GetBeam (t), rxCodebook->GetBeam (r)));
+        }
+    }
+
+  Ptr<MmWaveCodebookBeamforming> bf = CreateObjectWithAttributes<MmWaveCodebookBeamforming> ("Device", PointerValue (txDevice),
+                                                                                             "Antenna", PointerValue (txAntenna),
+                                                                                             "ChannelModel", PointerValue (channelModel),
+                                                                                             "OversamplingFactor", UintegerValue (oversampling));
+  bf->SetBeamformingVectorForDevice (rxDevice, rxAntenna);
+  double gain = GetGain (channel, txAntenna->GetBeamformingVector ().data (), rxAntenna->GetBeamformingVector ().data ());
+  NS_TEST_ASSERT_MSG_EQ_TOL (gain, bestGain, bestGain * 1e-9, "The model did not select the best beam pair");
+
+  // the scalar kernels select the same beam pair
+  bf->SetAttribute ("UseSimd", BooleanValue (false));
+  bf->SetAttribute ("UseCache", BooleanValue (false));
+  bf->SetBeamformingVectorForDevice (rxDevice, rxAntenna);
+  gain = GetGain (channel, txAntenna->GetBeamformingVector ().data (), rxAntenna->GetBeamformingVector ().data ());
+  NS_TEST_ASSERT_MSG_EQ_TOL (gain, bestGain, bestGain * 1e-9, "The scalar kernels did not select the best beam pair");
+
+  // the SVD beamforming vectors are an upper bound of the gain
+  Ptr<MmWaveSvdBeamforming> svd = CreateObjectWithAttributes<MmWaveSvdBeamforming> ("Device", PointerValue (txDevice),
+                                                                                    "Antenna", PointerValue (txAntenna),
+                                                                                    "ChannelModel", PointerValue (channelModel),
+                                                                                    "MaxIterations", UintegerValue (1000),
+                                                                                    "Tolerance", DoubleValue (1e-20));
+  svd->SetBeamformingVectorForDevice (rxDevice, rxAntenna);
+  double svdGain = GetGain (channel, txAntenna->GetBeamformingVector ().data (), rxAntenna->GetBeamformingVector ().data ());
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (bestGain, svdGain * (1 + 1e-9), "The codebook gain cannot exceed the SVD gain");
+  NS_TEST_ASSERT_MSG_GT (bestGain, svdGain / 2, "The codebook gain is too far from the SVD gain");
+}
+
 /**
 * This suite tests if the beamforming module works properly
 */
@@ -333,6 +661,11 @@ MmWaveBeamformingTest::MmWaveBeamformingTest ()
   // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
   AddTestCase (new MmWaveDftBeamformingTestCase, TestCase::QUICK);
   AddTestCase (new MmWaveSvdBeamformingTestCase, TestCase::QUICK);
+  AddTestCase (new MmWaveFastSvdBeamformingTestCase (4, 2, true), TestCase::QUICK);
+  AddTestCase (new MmWaveFastSvdBeamformingTestCase (2, 4, true), TestCase::QUICK);
+  AddTestCase (new MmWaveFastSvdBeamformingTestCase (4, 2, false), TestCase::QUICK);
+  AddTestCase (new MmWaveCodebookBeamformingTestCase (4, 2), TestCase::QUICK);
+  AddTestCase (new MmWaveCodebookBeamformingTestCase (2, 4), TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -0,0 +1,157 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+#include "ns3/mmwave-bearer-stats-calculator.h"
+#include "ns3/sqlite-output.h"
+
+#include <cstdio>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * Feeds MmWaveBearerStatsCalculator with the PDUs of a bearer that is handed
+ * over from cell 1 to cell 2 during an epoch, and checks the epoch summaries
+ * and the delay histograms written in the SQLite database
+ */
+class MmWaveBearerStatsSqliteTestCase : public TestCase
+{
+public:
+  MmWaveBearerStatsSqliteTestCase ();
+
+private:
+  virtual void DoRun (void) override;
+
+  /**
+   * Runs a query that returns a single integer
+   * \param db the database
+   * \param query the query
+   * \returns the result of the query
+   */
+  int QueryInt (const SQLiteOutput &db, const std::string &query);
+
+  /**
+   * Runs a query that returns a single double
+   * \param db the database
+   * \param query the query
+   * \returns the result of the query
+   */
+  double QueryDouble (const SQLiteOutput &db, const std::string &query);
+};
+
+MmWaveBearerStatsSqliteTestCase::MmWaveBearerStatsSqliteTestCase ()
+  : TestCase ("Epoch summaries by (IMSI, LCID, cell ID) in the SQLite database")
+{
+}
+
+int
+MmWaveBearerStatsSqliteTestCase::QueryInt (const SQLiteOutput &db, const std::string &query)
+{
+  sqlite3_stmt *stmt;
+  db.SpinPrepare (&stmt, query);
+  NS_TEST_EXPECT_MSG_EQ (SQLiteOutput::SpinStep (stmt), SQLITE_ROW, "no result for " << query);
+  int value = db.RetrieveColumn<int> (stmt, 0);
+  SQLiteOutput::SpinFinalize (stmt);
+  return value;
+}
+
+double
+MmWaveBearerStatsSqliteTestCase::QueryDouble (const SQLiteOutput &db, const std::string &query)
+{
+  sqlite3_stmt *stmt;
+  db.SpinPrepare (&stmt, query);
+  NS_TEST_EXPECT_MSG_EQ (SQLiteOutput::SpinStep (stmt), SQLITE_ROW, "no result for " << query);
+  double value = db.RetrieveColumn<double> (stmt, 0);
+  SQLiteOutput::SpinFinalize (stmt);
+  return value;
+}
+
+void
+MmWaveBearerStatsSqliteTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("mmwave-bearer-stats.db");
+  std::remove (fileName.c_str ());
+
+  Ptr<MmWaveBearerStatsCalculator> stats = CreateObject<MmWaveBearerStatsCalculator> ("RLC");
+  stats->SetAttribute ("SqliteOutputFilename", StringValue (fileName));
+  stats->SetAttribute ("DelayHistogramBinWidth", TimeValue (MilliSeconds (1)));
+  stats->SetAttribute ("EpochDuration", TimeValue (MilliSeconds (100)));
+
+  // IMSI 1, LCID 3: two DL PDUs in cell 1 (RNTI 10), then a handover to
+  // cell 2 (RNTI 20) and one DL PDU; one UL PDU in cell 1
+  Simulator::Schedule (MilliSeconds (10), &MmWaveBearerStatsCalculator::DlTxPdu, stats, 1, 1, 10, 3, 100);
+  Simulator::Schedule (MilliSeconds (12), &MmWaveBearerStatsCalculator::DlRxPdu, stats, 1, 1, 10, 3, 100, 2000000);
+  Simulator::Schedule (MilliSeconds (20), &MmWaveBearerStatsCalculator::DlTxPdu, stats, 1, 1, 10, 3, 300);
+  Simulator::Schedule (MilliSeconds (22), &MmWaveBearerStatsCalculator::DlRxPdu, stats, 1, 1, 10, 3, 300, 2500000);
+  Simulator::Schedule (MilliSeconds (30), &MmWaveBearerStatsCalculator::UlTxPdu, stats, 1, 1, 10, 3, 50);
+  Simulator::Schedule (MilliSeconds (31), &MmWaveBearerStatsCalculator::UlRxPdu, stats, 1, 1, 10, 3, 50, 1000000);
+  Simulator::Schedule (MilliSeconds (60), &MmWaveBearerStatsCalculator::DlTxPdu, stats, 2, 1, 20, 3, 200);
+  Simulator::Schedule (MilliSeconds (65), &MmWaveBearerStatsCalculator::DlRxPdu, stats, 2, 1, 20, 3, 200, 5000000);
+  // a PDU in the second epoch, written when the calculator is disposed
+  Simulator::Schedule (MilliSeconds (120), &MmWaveBearerStatsCalculator::DlTxPdu, stats, 2, 1, 20, 3, 400);
+  Simulator::Stop (MilliSeconds (150));
+  Simulator::Run ();
+  stats->Dispose ();
+  Simulator::Destroy ();
+
+  SQLiteOutput db (fileName, "ns3-mmwave-bearer-stats-test");
+  NS_TEST_ASSERT_MSG_EQ (QueryInt (db, "SELECT COUNT(*) FROM rlc_bearer_stats WHERE start = 0;"), 3,
+                         "the first epoch must have a row for each direction and cell");
+  NS_TEST_ASSERT_MSG_EQ (QueryInt (db, "SELECT COUNT(*) FROM rlc_bearer_stats;"), 4, "wrong number of rows");
+
+  std::string cell1 = " FROM rlc_bearer_stats WHERE direction = 'DL' AND cellId = 1 AND start = 0;";
+  NS_TEST_ASSERT_MSG_EQ (QueryInt (db, "SELECT rnti" + cell1), 10, "wrong RNTI in cell 1");
+  NS_TEST_ASSERT_MSG_EQ (QueryInt (db, "SELECT nTxPDUs" + cell1), 2, "wrong number of TX PDUs in cell 1");
+  NS_TEST_ASSERT_MSG_EQ (QueryInt (db, "SELECT txBytes" + cell1), 400, "wrong TX bytes in cell 1");
+  NS_TEST_ASSERT_MSG_EQ (QueryInt (db, "SELECT rxBytes" + cell1), 400, "wrong RX bytes in cell 1");
+  NS_TEST_ASSERT_MSG_EQ_TOL (QueryDouble (db, "SELECT delay" + cell1), 2.25e-3, 1e-9, "wrong delay in cell 1");
+  NS_TEST_ASSERT_MSG_EQ_TOL (QueryDouble (db, "SELECT pduSizeMax" + cell1), 300, 1e-9, "wrong PDU size in cell 1");
+
+  std::string cell2 = " FROM rlc_bearer_stats WHERE direction = 'DL' AND cellId = 2 AND start = 0;";
+  NS_TEST_ASSERT_MSG_EQ (QueryInt (db, "SELECT rnti" + cell2), 20, "wrong RNTI in cell 2");
+  NS_TEST_ASSERT_MSG_EQ (QueryInt (db, "SELECT nRxPDUs" + cell2), 1, "wrong number of RX PDUs in cell 2");
+  NS_TEST_ASSERT_MSG_EQ_TOL (QueryDouble (db, "SELECT delayMax" + cell2), 5e-3, 1e-9, "wrong delay in cell 2");
+
+  NS_TEST_ASSERT_MSG_EQ (QueryInt (db, "SELECT rxBytes FROM rlc_bearer_stats WHERE direction = 'UL';"), 50,
+                         "wrong UL RX bytes");
+  NS_TEST_ASSERT_MSG_EQ (QueryInt (db, "SELECT COUNT(*) FROM rlc_bearer_stats WHERE start > 0 AND delay IS NULL;"), 1,
+                         "the second epoch has no received PDUs");
+
+  // 2 and 2.5 ms fall in the same 1 ms bin
+  NS_TEST_ASSERT_MSG_EQ (QueryInt (db, "SELECT COUNT(*) FROM rlc_delay_histogram WHERE direction = 'DL';"), 2,
+                         "wrong number of DL histogram bins");
+  NS_TEST_ASSERT_MSG_EQ (QueryInt (db, "SELECT count FROM rlc_delay_histogram WHERE cellId = 1 AND direction = 'DL';"), 2,
+                         "wrong count of the histogram bin of cell 1");
+  NS_TEST_ASSERT_MSG_EQ_TOL (QueryDouble (db, "SELECT binStart FROM rlc_delay_histogram WHERE cellId = 2;"), 5e-3, 1e-9,
+                             "wrong histogram bin of cell 2");
+
+  std::remove (fileName.c_str ());
+}
+
+class MmWaveBearerStatsTestSuite : public TestSuite
+{
+public:
+  MmWaveBearerStatsTestSuite () : TestSuite ("mmwave-bearer-stats-test", UNIT)
+    {
+      AddTestCase (new MmWaveBearerStatsSqliteTestCase (), QUICK);
+    }
+};
+
+static MmWaveBearerStatsTestSuite mmwaveBearerStatsTestSuite; //!< MmWave bearer statistics test suite
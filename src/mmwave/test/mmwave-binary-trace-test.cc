@@ -0,0 +1,174 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/mmwave-binary-trace.h"
+#include "ns3/mmwave-phy-trace.h"
+#include "ns3/mmwave-mac-trace.h"
+
+#include <sstream>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * Writes records of each type with MmWaveBinaryTraceWriter, converts them
+ * with MmWaveBinaryTraceReader and checks that the text matches the one
+ * written by MmWavePhyTrace and MmWaveMacTrace in text mode
+ */
+class MmWaveBinaryTraceTestCase : public TestCase
+{
+public:
+  MmWaveBinaryTraceTestCase ();
+
+private:
+  virtual void DoRun (void) override;
+
+  /**
+   * Converts a binary trace file and compares it with the expected text
+   * \param fileName the name of the binary trace file
+   * \param expected the expected text
+   * \param numRecords the expected number of records
+   */
+  void CheckConversion (const std::string &fileName, const std::string &expected, uint64_t numRecords);
+};
+
+MmWaveBinaryTraceTestCase::MmWaveBinaryTraceTestCase ()
+  : TestCase ("Binary traces are converted to the text format")
+{
+}
+
+void
+MmWaveBinaryTraceTestCase::CheckConversion (const std::string &fileName, const std::string &expected, uint64_t numRecords)
+{
+  std::ostringstream converted;
+  uint64_t count = MmWaveBinaryTraceReader::ConvertToText (fileName, converted);
+  NS_TEST_ASSERT_MSG_EQ (count, numRecords, "Unexpected number of records in " << fileName);
+  NS_TEST_ASSERT_MSG_EQ (converted.str (), expected, "Converted text of " << fileName << " differs");
+}
+
+void
+MmWaveBinaryTraceTestCase::DoRun (void)
+{
+  // a small buffer, so that the records are also written while tracing
+  const std::size_t bufferSize = 100;
+  const uint32_t numRecords = 50;
+
+  // PHY reception trace, alternating DL and UL records
+  std::string rxFileName = CreateTempDirFilename ("rx-packet-trace.bin");
+  std::ostringstream rxExpected;
+  MmWavePhyTrace::WriteRxPacketTraceHeader (rxExpected);
+  {
+    MmWaveBinaryTraceWriter writer (bufferSize);
+    writer.Open (rxFileName, MmWaveBinaryTraceWriter::RX_PACKET);
+    for (uint32_t i = 0; i < numRecords; ++i)
+      {
+        RxPacketTraceParams params;
+        params.m_cellId = 1 + i % 3;
+        params.m_ccId = i % 2;
+        params.m_rnti = 1 + i;
+        params.m_frameNum = 100 + i;
+        params.m_sfNum = i % 10;
+        params.m_slotNum = i % 8;
+        params.m_symStart = 1 + i % 13;
+        params.m_numSym = 1 + i % 12;
+        params.m_tbSize = 1000 * i + 7;
+        params.m_mcs = i % 29;
+        params.m_rv = i % 4;
+        params.m_sinr = 0.37 * i + 1e-3;
+        params.m_sinrMin = 0.11 * i;
+        params.m_tbler = 1.0 / (i + 1);
+        params.m_corrupt = (i % 5 == 0);
+        bool isDownlink = (i % 2 == 0);
+        double time = 0.000125 * i;
+        writer.WriteRxPacket (isDownlink, time, params);
+        MmWavePhyTrace::WriteRxPacketTraceLine (rxExpected, isDownlink, time, params);
+      }
+  }
+  CheckConversion (rxFileName, rxExpected.str (), numRecords);
+
+  // PHY transmission trace
+  std::string phyFileName = CreateTempDirFilename ("phy-transmission-trace.bin");
+  std::ostringstream phyExpected;
+  MmWavePhyTrace::WritePhyTransmissionTraceHeader (phyExpected);
+  {
+    MmWaveBinaryTraceWriter writer (bufferSize);
+    writer.Open (phyFileName, MmWaveBinaryTraceWriter::PHY_TRANSMISSION);
+    for (uint32_t i = 0; i < numRecords; ++i)
+      {
+        PhyTransmissionTraceParams params;
+        params.m_frameNum = 10 * i;
+        params.m_sfNum = i % 10;
+        params.m_slotNum = i % 8;
+        params.m_tddMode = (i % 2 == 0) ? PhyTransmissionTraceParams::DL : PhyTransmissionTraceParams::UL;
+        params.m_ttiType = (i % 3 == 0) ? PhyTransmissionTraceParams::CTRL : PhyTransmissionTraceParams::DATA;
+        params.m_rnti = 1 + i;
+        params.m_ccId = i % 2;
+        params.m_symStart = i % 14;
+        params.m_numSym = 1 + i % 13;
+        writer.WritePhyTransmission (params);
+        MmWavePhyTrace::WritePhyTransmissionTraceLine (phyExpected, params);
+      }
+    // the destructor also flushes the buffer, but the file may also be
+    // closed explicitly
+    writer.Close ();
+    NS_TEST_ASSERT_MSG_EQ (writer.IsOpen (), false, "The writer should be closed");
+  }
+  CheckConversion (phyFileName, phyExpected.str (), numRecords);
+
+  // scheduling allocations trace
+  std::string schedFileName = CreateTempDirFilename ("sched-alloc-trace.bin");
+  std::ostringstream schedExpected;
+  MmWaveMacTrace::WriteSchedAllocTraceHeader (schedExpected);
+  {
+    MmWaveBinaryTraceWriter writer (bufferSize);
+    writer.Open (schedFileName, MmWaveBinaryTraceWriter::SCHED_ALLOC);
+    for (uint32_t i = 0; i < numRecords; ++i)
+      {
+        SfnSf sfn (i, i % 10, i % 8);
+        TtiAllocInfo tti (i % 14, (i % 2 == 0) ? TtiAllocInfo::DL_slotAllocInfo : TtiAllocInfo::UL_slotAllocInfo,
+                          TtiAllocInfo::DATA, 1 + i);
+        tti.m_dci.m_rnti = 1 + i;
+        tti.m_dci.m_symStart = i % 14;
+        tti.m_dci.m_numSym = 1 + i % 13;
+        tti.m_dci.m_rv = i % 4;
+        writer.WriteSchedAlloc (sfn, tti, i % 2);
+        MmWaveMacTrace::WriteSchedAllocTraceLine (schedExpected, sfn, tti, i % 2);
+      }
+  }
+  CheckConversion (schedFileName, schedExpected.str (), numRecords);
+
+  // a file without records
+  std::string emptyFileName = CreateTempDirFilename ("empty-trace.bin");
+  std::ostringstream emptyExpected;
+  MmWaveMacTrace::WriteSchedAllocTraceHeader (emptyExpected);
+  {
+    MmWaveBinaryTraceWriter writer (bufferSize);
+    writer.Open (emptyFileName, MmWaveBinaryTraceWriter::SCHED_ALLOC);
+  }
+  CheckConversion (emptyFileName, emptyExpected.str (), 0);
+}
+
+class MmWaveBinaryTraceTestSuite : public TestSuite
+{
+public:
+  MmWaveBinaryTraceTestSuite () : TestSuite ("mmwave-binary-trace-test", UNIT)
+    {
+      AddTestCase (new MmWaveBinaryTraceTestCase (), QUICK);
+    }
+};
+
+static MmWaveBinaryTraceTestSuite mmwaveBinaryTraceTestSuite; //!< MmWave binary trace test suite
@@ -23,6 +23,12 @@
 #include "ns3/mmwave-eesm-cc-t2.h"
 #include "ns3/mmwave-eesm-ir-t1.h"
 #include "ns3/mmwave-eesm-ir-t2.h"
+#include "ns3/mmwave-error-model-kernels.h"
+#include "ns3/boolean.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/spectrum-model.h"
+#include <cmath>
 
 using namespace ns3;
 using namespace mmwave;
@@ -34,7 +40,8 @@ using namespace mmwave;
  * \brief This test validates specific functions of the NR PHY abstraction model.
  * The test checks two issues: 1) LDPC base graph (BG) selection works properly, and 2)
  * BLER values are properly obtained from the BLER-SINR look up tables for different
- * block sizes, MCS Tables, BG types, and SINR values.
+ * block sizes, MCS Tables, BG types, and SINR values. It also checks that the
+ * AVX2 EESM kernel gives the same result as the scalar one.
  *
  */
 
@@ -259,12 +266,135 @@ MmWaveL2smEesmTestCase::DoRun ()
   TestEesmIrTable2 ();
 }
 
+/**
+ * \brief Check the batched EESM kernel against the scalar computation
+ */
+class MmWaveEesmKernelTestCase : public TestCase
+{
+public:
+  MmWaveEesmKernelTestCase () : TestCase ("EESM kernel accuracy") { }
+
+private:
+  virtual void DoRun (void) override;
+
+  /**
+   * \brief Compare the effective SINR of an error model with and without the
+   * AVX2 kernel, over random SINR vectors and HARQ histories
+   * \param tid the TypeId of the error model
+   * \param uniform the random variable used to generate the inputs
+   */
+  void TestErrorModel (TypeId tid, Ptr<UniformRandomVariable> uniform);
+};
+
+void
+MmWaveEesmKernelTestCase::DoRun ()
+{
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  uniform->SetStream (1);
+
+  // SINRs from -20 dB to 60 dB, plus some values out of the range of the
+  // polynomial approximation
+  std::vector<double> sinr (512);
+  for (double &value : sinr)
+    {
+      value = std::pow (10.0, uniform->GetValue (-2.0, 6.0));
+    }
+  sinr[0] = 0.0;
+  sinr[1] = 1e9;
+
+  for (double beta : {1.0, 1.6, 8.0, 92.5, 10000.0})
+    {
+      // all the lengths up to a few SIMD blocks, to cover the remainders
+      for (uint32_t n = 1; n <= 67; ++n)
+        {
+          std::vector<int> map;
+          for (uint32_t i = 0; i < n; ++i)
+            {
+              map.push_back (uniform->GetInteger (0, sinr.size () - 1));
+            }
+          double naive = 0.0;
+          for (int rb : map)
+            {
+              naive += std::exp (-sinr[rb] / beta);
+            }
+          double scalar = MmWaveErrorModelKernels::EesmExpSumScalar (sinr.data (), map.data (), n, beta);
+          double simd = MmWaveErrorModelKernels::EesmExpSum (sinr.data (), map.data (), n, beta, true);
+          NS_TEST_ASSERT_MSG_EQ (scalar, naive, "Scalar kernel differs from std::exp");
+          NS_TEST_ASSERT_MSG_EQ_TOL (simd, scalar, 1e-13 * scalar,
+                                     "SIMD kernel differs from the scalar one, n " << n << " beta " << beta);
+        }
+    }
+
+  for (const std::string &name : {"ns3::MmWaveEesmCcT1", "ns3::MmWaveEesmCcT2",
+                                  "ns3::MmWaveEesmIrT1", "ns3::MmWaveEesmIrT2"})
+    {
+      TestErrorModel (TypeId::LookupByName (name), uniform);
+    }
+}
+
+void
+MmWaveEesmKernelTestCase::TestErrorModel (TypeId tid, Ptr<UniformRandomVariable> uniform)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (tid);
+  factory.Set ("UseSimd", BooleanValue (false));
+  Ptr<MmWaveErrorModel> scalar = factory.Create<MmWaveErrorModel> ();
+  factory.Set ("UseSimd", BooleanValue (true));
+  Ptr<MmWaveErrorModel> simd = factory.Create<MmWaveErrorModel> ();
+
+  Bands bands;
+  for (uint32_t rb = 0; rb < 100; ++rb)
+    {
+      BandInfo band;
+      band.fl = 28e9 + rb * 1.44e6;
+      band.fc = band.fl + 0.72e6;
+      band.fh = band.fl + 1.44e6;
+      bands.push_back (band);
+    }
+  Ptr<const SpectrumModel> sm = Create<SpectrumModel> (bands);
+
+  for (uint32_t t = 0; t < 50; ++t)
+    {
+      uint8_t mcs = static_cast<uint8_t> (uniform->GetInteger (0, scalar->GetMaxMcs ()));
+      uint32_t size = uniform->GetInteger (100, 20000);
+      MmWaveErrorModel::MmWaveErrorModelHistory scalarHistory;
+      MmWaveErrorModel::MmWaveErrorModelHistory simdHistory;
+      for (uint32_t retx = 0; retx < 3; ++retx)
+        {
+          SpectrumValue sinr (sm);
+          double meanDb = uniform->GetValue (-10.0, 30.0);
+          for (uint32_t rb = 0; rb < bands.size (); ++rb)
+            {
+              sinr[rb] = std::pow (10.0, (meanDb + uniform->GetValue (-5.0, 5.0)) / 10.0);
+            }
+          std::vector<int> map;
+          uint32_t first = uniform->GetInteger (0, 50);
+          uint32_t last = uniform->GetInteger (first, bands.size () - 1);
+          for (uint32_t rb = first; rb <= last; ++rb)
+            {
+              map.push_back (rb);
+            }
+
+          Ptr<MmWaveEesmErrorModelOutput> scalarOutput = DynamicCast<MmWaveEesmErrorModelOutput> (
+            scalar->GetTbDecodificationStats (sinr, map, size, mcs, scalarHistory));
+          Ptr<MmWaveEesmErrorModelOutput> simdOutput = DynamicCast<MmWaveEesmErrorModelOutput> (
+            simd->GetTbDecodificationStats (sinr, map, size, mcs, simdHistory));
+          NS_TEST_ASSERT_MSG_EQ_TOL (simdOutput->m_sinrEff, scalarOutput->m_sinrEff,
+                                     1e-12 * std::abs (scalarOutput->m_sinrEff),
+                                     tid.GetName () << ": effective SINR differs with the SIMD kernel");
+          scalarHistory.push_back (scalarOutput);
+          simdHistory.push_back (simdOutput);
+        }
+    }
+}
+
 class MmWaveTestL2smEesm : public TestSuite
 {
 public:
   MmWaveTestL2smEesm () : TestSuite ("mmwave-l2sm-test", UNIT)
     {
       AddTestCase(new MmWaveL2smEesmTestCase ("First test"), QUICK);
+      AddTestCase(new MmWaveEesmKernelTestCase (), QUICK);
     }
 };
 
@@ -0,0 +1,140 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/mmwave-mac.h"
+#include "ns3/packet-memory-pool.h"
+
+#include <vector>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * Assembles a TB from RLC PDUs of different sizes, as MmWaveEnbMac does,
+ * with and without reserving its memory with MacPduInfo::ReserveTb, and
+ * checks that the two TBs carry the same bytes
+ */
+class MmWaveMacPduReserveTestCase : public TestCase
+{
+public:
+  MmWaveMacPduReserveTestCase ();
+
+private:
+  virtual void DoRun (void) override;
+
+  /**
+   * Assembles a TB
+   * \param pdus the RLC PDUs
+   * \param reserve whether to reserve the memory of the TB first
+   * \param requests the number of blocks requested to PacketMemoryPool
+   * \returns the TB, with the MAC header
+   */
+  Ptr<Packet> Assemble (const std::vector<Ptr<Packet> > &pdus, bool reserve, uint64_t &requests);
+};
+
+MmWaveMacPduReserveTestCase::MmWaveMacPduReserveTestCase ()
+  : TestCase ("TBs are assembled in place in the reserved memory")
+{
+}
+
+Ptr<Packet>
+MmWaveMacPduReserveTestCase::Assemble (const std::vector<Ptr<Packet> > &pdus, bool reserve, uint64_t &requests)
+{
+  uint32_t tbSize = 0;
+  for (uint32_t i = 0; i < pdus.size (); ++i)
+    {
+      tbSize += pdus[i]->GetSize () + 4;
+    }
+  DciInfoElementTdma dci;
+  dci.m_numSym = 2;
+  MacPduInfo macPduInfo (SfnSf (1, 2, 3, 4), tbSize, pdus.size (), dci);
+
+  PacketMemoryPool::ResetStats ();
+  if (reserve)
+    {
+      macPduInfo.ReserveTb (pdus.size ());
+    }
+  for (uint32_t i = 0; i < pdus.size (); ++i)
+    {
+      macPduInfo.m_pdu->AddAtEnd (pdus[i]);
+      macPduInfo.m_macHeader.AddSubheader (MacSubheader (3 + i % 2, pdus[i]->GetSize ()));
+    }
+  macPduInfo.m_pdu->AddHeader (macPduInfo.m_macHeader);
+  requests = PacketMemoryPool::GetStats ().requests;
+  return macPduInfo.m_pdu;
+}
+
+void
+MmWaveMacPduReserveTestCase::DoRun (void)
+{
+  // small PDUs, PDUs with 3 bytes subheaders, and PDUs with a zero area
+  std::vector<Ptr<Packet> > pdus;
+  for (uint32_t i = 0; i < 40; ++i)
+    {
+      uint32_t size = (i % 3 == 0) ? 1400 : 20 + i;
+      if (i % 5 == 0)
+        {
+          pdus.push_back (Create<Packet> (size));
+        }
+      else
+        {
+          std::vector<uint8_t> data (size);
+          for (uint32_t j = 0; j < size; ++j)
+            {
+              data[j] = (i + j) % 251;
+            }
+          pdus.push_back (Create<Packet> (data.data (), size));
+        }
+    }
+
+  uint64_t appendRequests;
+  uint64_t reserveRequests;
+  Ptr<Packet> appended = Assemble (pdus, false, appendRequests);
+  Ptr<Packet> reserved = Assemble (pdus, true, reserveRequests);
+
+  NS_TEST_ASSERT_MSG_EQ (reserved->GetSize (), appended->GetSize (), "TBs of different size");
+  std::vector<uint8_t> appendedData (appended->GetSize ());
+  std::vector<uint8_t> reservedData (reserved->GetSize ());
+  appended->CopyData (appendedData.data (), appendedData.size ());
+  reserved->CopyData (reservedData.data (), reservedData.size ());
+  NS_TEST_ASSERT_MSG_EQ ((reservedData == appendedData), true, "TBs with different bytes");
+  NS_TEST_ASSERT_MSG_LT (reserveRequests, appendRequests, "the reserved TB was reallocated");
+
+  MmWaveMacPduTag tag;
+  NS_TEST_ASSERT_MSG_EQ (reserved->PeekPacketTag (tag), true, "missing MAC PDU tag");
+  NS_TEST_ASSERT_MSG_EQ (tag.GetSfn ().m_slotNum, 3, "wrong MAC PDU tag");
+
+  MmWaveMacPduHeader header;
+  reserved->RemoveHeader (header);
+  const std::vector<MacSubheader> &subheaders = header.GetSubheaders ();
+  NS_TEST_ASSERT_MSG_EQ (subheaders.size (), pdus.size (), "wrong number of subheaders");
+  for (uint32_t i = 0; i < subheaders.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (subheaders[i].m_size, pdus[i]->GetSize (), "wrong size in subheader " << i);
+    }
+}
+
+class MmWaveMacPduTestSuite : public TestSuite
+{
+public:
+  MmWaveMacPduTestSuite () : TestSuite ("mmwave-mac-pdu-test", UNIT)
+    {
+      AddTestCase (new MmWaveMacPduReserveTestCase (), QUICK);
+    }
+};
+
+static MmWaveMacPduTestSuite mmwaveMacPduTestSuite; //!< MmWave MAC PDU test suite
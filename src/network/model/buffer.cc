@@ -169,7 +169,13 @@ Buffer::Allocate (uint32_t reqSize)
     }
   NS_ASSERT (reqSize >= 1);
   uint32_t size = reqSize - 1 + sizeof (struct Buffer::Data);
-  uint8_t *b = new uint8_t [size];
+#ifdef PACKET_MEMORY_POOL
+  /* use the whole block of the size class */
+  uint32_t capacity = PacketMemoryPool::GetCapacity (size);
+  reqSize += capacity - size;
+  size = capacity;
+#endif
+  uint8_t *b = static_cast<uint8_t *> (PacketMemoryPool::Allocate (size));
   struct Buffer::Data *data = reinterpret_cast<struct Buffer::Data*>(b);
   data->m_size = reqSize;
   data->m_count = 1;
@@ -181,8 +187,7 @@ Buffer::Deallocate (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  uint8_t *buf = reinterpret_cast<uint8_t *> (data);
-  delete [] buf;
+  PacketMemoryPool::Deallocate (data, data->m_size - 1 + sizeof (struct Buffer::Data));
 }
 
 Buffer::Buffer ()
@@ -426,6 +431,20 @@ Buffer::AddAtEnd (const Buffer &o)
       return;
     }
 
+  if (o.m_data == m_data)
+    {
+      /**
+       * o shares the data of this buffer, e.g., both are fragments of the
+       * same packet, and the data may be extended in place below: copy o
+       * first.
+       */
+      Buffer copy;
+      copy.AddAtStart (o.GetSize ());
+      copy.Begin ().Write (o.Begin (), o.End ());
+      AddAtEnd (copy);
+      return;
+    }
+
   *this = CreateFullCopy ();
   AddAtEnd (o.GetSize ());
   Buffer::Iterator destStart = End ();
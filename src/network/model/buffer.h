@@ -24,8 +24,11 @@
 #include <vector>
 #include <ostream>
 #include "ns3/assert.h"
+#include "packet-memory-pool.h"
 
+#ifndef PACKET_MEMORY_POOL
 #define BUFFER_FREE_LIST 1
+#endif
 
 namespace ns3 {
 
@@ -18,12 +18,15 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "byte-tag-list.h"
+#include "packet-memory-pool.h"
 #include "ns3/log.h"
 #include <vector>
 #include <cstring>
 #include <limits>
 
+#ifndef PACKET_MEMORY_POOL
 #define USE_FREE_LIST 1
+#endif
 #define FREE_LIST_SIZE 1000
 #define OFFSET_MAX (std::numeric_limits<int32_t>::max ())
 
@@ -66,8 +69,7 @@ ByteTagListDataFreeList::~ByteTagListDataFreeList ()
   for (ByteTagListDataFreeList::iterator i = begin ();
        i != end (); i++)
     {
-      uint8_t *buffer = (uint8_t *)(*i);
-      delete [] buffer;
+      PacketMemoryPool::Deallocate (*i, (*i)->size + sizeof (struct ByteTagListData) - 4);
     }
 }
 #endif /* USE_FREE_LIST */
@@ -356,10 +358,9 @@ ByteTagList::Allocate (uint32_t size)
           data->dirty = 0;
           return data;
         }
-      uint8_t *buffer = (uint8_t *)data;
-      delete [] buffer;
+      PacketMemoryPool::Deallocate (data, data->size + sizeof (struct ByteTagListData) - 4);
     }
-  uint8_t *buffer = new uint8_t [std::max (size, g_maxSize) + sizeof (struct ByteTagListData) - 4];
+  uint8_t *buffer = static_cast<uint8_t *> (PacketMemoryPool::Allocate (std::max (size, g_maxSize) + sizeof (struct ByteTagListData) - 4));
   struct ByteTagListData *data = (struct ByteTagListData *)buffer;
   data->count = 1;
   data->size = size;
@@ -382,8 +383,7 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
       if (g_freeList.size () > FREE_LIST_SIZE ||
           data->size < g_maxSize)
         {
-          uint8_t *buffer = (uint8_t *)data;
-          delete [] buffer;
+          PacketMemoryPool::Deallocate (data, data->size + sizeof (struct ByteTagListData) - 4);
         }
       else
         {
@@ -398,10 +398,12 @@ struct ByteTagListData *
 ByteTagList::Allocate (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
-  uint8_t *buffer = new uint8_t [size + sizeof (struct ByteTagListData) - 4];
+  /* use the whole block of the size class */
+  uint32_t blockSize = PacketMemoryPool::GetCapacity (size + sizeof (struct ByteTagListData) - 4);
+  uint8_t *buffer = static_cast<uint8_t *> (PacketMemoryPool::Allocate (blockSize));
   struct ByteTagListData *data = (struct ByteTagListData *)buffer;
   data->count = 1;
-  data->size = size;
+  data->size = blockSize - (sizeof (struct ByteTagListData) - 4);
   data->dirty = 0;
   return data;
 }
@@ -417,8 +419,7 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
   data->count--;
   if (data->count == 0)
     {
-      uint8_t *buffer = (uint8_t *)data;
-      delete [] buffer;
+      PacketMemoryPool::Deallocate (data, data->size + sizeof (struct ByteTagListData) - 4);
     }
 }
 
@@ -0,0 +1,220 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "packet-memory-pool.h"
+#include "ns3/assert.h"
+
+#include <algorithm>
+#include <new>
+
+namespace ns3 {
+
+namespace {
+
+/// Counters of the allocations
+PacketMemoryPool::Stats g_stats;
+
+#ifdef PACKET_MEMORY_POOL
+
+/// Size of the blocks of each class, in bytes
+const uint32_t g_classSize[] = {
+  32, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1280, 1664, 2048,
+  3072, 4096, 6144, 8192, 12288, 16384, 24576, 32768, 49152, 65536
+};
+/// Number of size classes
+const uint32_t N_CLASSES = sizeof (g_classSize) / sizeof (g_classSize[0]);
+/// Bytes kept in the free list of each class, at most
+const uint32_t MAX_POOLED_BYTES_PER_CLASS = 2 << 20;
+/// Blocks kept in the free list of each class, at least
+const uint32_t MIN_POOLED_BLOCKS_PER_CLASS = 64;
+
+/**
+ * \ingroup packet
+ * \brief A released block, linked in the free list of its class
+ */
+struct FreeBlock
+{
+  FreeBlock *next; //!< Next block of the same class
+};
+
+/*
+ * The free lists are plain arrays, which are zero-initialized before any
+ * constructor runs, so that the pool can be used by the constructors and
+ * the destructors of other static objects. After the static destructor
+ * of this compilation unit has run, the blocks go straight to the heap.
+ */
+FreeBlock *g_freeList[N_CLASSES]; //!< Free list of each class
+uint32_t g_freeCount[N_CLASSES];  //!< Length of each free list
+bool g_destroyed = false;         //!< True once the free lists are released
+
+/**
+ * \ingroup packet
+ * \brief Release the free lists when the program exits
+ */
+struct LocalStaticDestructor
+{
+  ~LocalStaticDestructor ()
+  {
+    for (uint32_t c = 0; c < N_CLASSES; ++c)
+      {
+        while (g_freeList[c] != 0)
+          {
+            FreeBlock *block = g_freeList[c];
+            g_freeList[c] = block->next;
+            ::operator delete (block);
+          }
+        g_freeCount[c] = 0;
+      }
+    g_stats.pooledBlocks = 0;
+    g_stats.pooledBytes = 0;
+    g_destroyed = true;
+  }
+} g_localStaticDestructor; //!< Releases the free lists at exit
+
+/**
+ * \param size a requested size, in bytes
+ * \returns the index of the smallest class that fits size, N_CLASSES if
+ *          size is larger than the largest class
+ */
+inline uint32_t
+GetClass (uint32_t size)
+{
+  return std::lower_bound (g_classSize, g_classSize + N_CLASSES, size) - g_classSize;
+}
+
+/**
+ * \param c a class index
+ * \returns the maximum length of the free list of the class
+ */
+inline uint32_t
+GetMaxFreeCount (uint32_t c)
+{
+  return std::max (MIN_POOLED_BLOCKS_PER_CLASS, MAX_POOLED_BYTES_PER_CLASS / g_classSize[c]);
+}
+
+#endif /* PACKET_MEMORY_POOL */
+
+} // anonymous namespace
+
+#ifdef PACKET_MEMORY_POOL
+
+void *
+PacketMemoryPool::Allocate (uint32_t size)
+{
+  g_stats.requests++;
+  uint32_t c = GetClass (size);
+  if (c == N_CLASSES)
+    {
+      g_stats.heapAllocations++;
+      return ::operator new (size);
+    }
+  FreeBlock *block = g_freeList[c];
+  if (block != 0)
+    {
+      g_freeList[c] = block->next;
+      g_freeCount[c]--;
+      g_stats.pooledBlocks--;
+      g_stats.pooledBytes -= g_classSize[c];
+      return block;
+    }
+  g_stats.heapAllocations++;
+  return ::operator new (g_classSize[c]);
+}
+
+void
+PacketMemoryPool::Deallocate (void *block, uint32_t size)
+{
+  if (block == 0)
+    {
+      return;
+    }
+  uint32_t c = GetClass (size);
+  if (c == N_CLASSES || g_destroyed || g_freeCount[c] >= GetMaxFreeCount (c))
+    {
+      g_stats.heapDeallocations++;
+      ::operator delete (block);
+      return;
+    }
+  FreeBlock *freeBlock = static_cast<FreeBlock *> (block);
+  freeBlock->next = g_freeList[c];
+  g_freeList[c] = freeBlock;
+  g_freeCount[c]++;
+  g_stats.pooledBlocks++;
+  g_stats.pooledBytes += g_classSize[c];
+}
+
+uint32_t
+PacketMemoryPool::GetCapacity (uint32_t size)
+{
+  uint32_t c = GetClass (size);
+  return c == N_CLASSES ? size : g_classSize[c];
+}
+
+bool
+PacketMemoryPool::IsEnabled (void)
+{
+  return true;
+}
+
+#else /* PACKET_MEMORY_POOL */
+
+void *
+PacketMemoryPool::Allocate (uint32_t size)
+{
+  g_stats.requests++;
+  g_stats.heapAllocations++;
+  return ::operator new (size);
+}
+
+void
+PacketMemoryPool::Deallocate (void *block, uint32_t size)
+{
+  if (block == 0)
+    {
+      return;
+    }
+  g_stats.heapDeallocations++;
+  ::operator delete (block);
+}
+
+uint32_t
+PacketMemoryPool::GetCapacity (uint32_t size)
+{
+  return size;
+}
+
+bool
+PacketMemoryPool::IsEnabled (void)
+{
+  return false;
+}
+
+#endif /* PACKET_MEMORY_POOL */
+
+PacketMemoryPool::Stats
+PacketMemoryPool::GetStats (void)
+{
+  return g_stats;
+}
+
+void
+PacketMemoryPool::ResetStats (void)
+{
+  g_stats.requests = 0;
+  g_stats.heapAllocations = 0;
+  g_stats.heapDeallocations = 0;
+}
+
+} // namespace ns3
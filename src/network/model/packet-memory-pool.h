@@ -0,0 +1,101 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PACKET_MEMORY_POOL_H
+#define PACKET_MEMORY_POOL_H
+
+#include <stdint.h>
+
+/*
+ * The pool is enabled unless ns-3 is configured with --disable-packet-pool,
+ * which defines NS3_DISABLE_PACKET_POOL. In that case Buffer and ByteTagList
+ * use their own single-size free lists, as before the pool was introduced.
+ */
+#ifndef NS3_DISABLE_PACKET_POOL
+#define PACKET_MEMORY_POOL 1
+#endif
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief Memory of the Buffer data areas and of the ByteTagList and
+ * PacketTagList nodes.
+ *
+ * All these blocks are allocated and released through this class. If
+ * PACKET_MEMORY_POOL is defined, the released blocks are kept in one free
+ * list per size class, and reused by the next allocations of the same class.
+ * The size classes follow the packets of the LTE and mmWave data paths:
+ * small classes for the headers and the tags, 1280 and 1664 bytes for the
+ * 1 kB application payloads and the 1500 bytes IP MTU plus the
+ * GTP/PDCP/RLC/MAC headers, and larger ones, up to 64 kB, for the
+ * transport blocks. Larger blocks are not pooled.
+ *
+ * Otherwise, the blocks are allocated from the heap, and the class only
+ * counts the allocations.
+ *
+ * Like the rest of the packet code, this class is not thread-safe.
+ */
+class PacketMemoryPool
+{
+public:
+  /**
+   * \brief Allocation counters
+   */
+  struct Stats
+  {
+    uint64_t requests;          //!< Number of calls to Allocate
+    uint64_t heapAllocations;   //!< Number of blocks allocated from the heap
+    uint64_t heapDeallocations; //!< Number of blocks returned to the heap
+    uint64_t pooledBlocks;      //!< Number of blocks currently in the free lists
+    uint64_t pooledBytes;       //!< Bytes currently in the free lists
+  };
+
+  /**
+   * \brief Allocate a block of memory
+   * \param size the requested size, in bytes
+   * \returns a block of at least GetCapacity (size) bytes
+   */
+  static void *Allocate (uint32_t size);
+  /**
+   * \brief Release a block of memory
+   * \param block the block, returned by Allocate
+   * \param size the size requested to Allocate, or any value between the
+   *        requested size and the capacity of the block
+   */
+  static void Deallocate (void *block, uint32_t size);
+  /**
+   * \param size a requested size, in bytes
+   * \returns the usable size of the block returned by Allocate (size)
+   */
+  static uint32_t GetCapacity (uint32_t size);
+  /**
+   * \returns true if the pool was enabled at build time
+   */
+  static bool IsEnabled (void);
+  /**
+   * \returns the allocation counters
+   */
+  static Stats GetStats (void);
+  /**
+   * \brief Reset the allocation counters, except the free list ones
+   */
+  static void ResetStats (void);
+};
+
+} // namespace ns3
+
+#endif /* PACKET_MEMORY_POOL_H */
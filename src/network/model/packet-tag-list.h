@@ -252,6 +252,13 @@ private:
    */
   static
   TagData * CreateTagData (size_t dataSize);
+  /**
+   * Destroy a TagData struct created by CreateTagData, and release its memory.
+   *
+   * \param [in] tag The TagData object.
+   */
+  static
+  void FreeTagData (TagData * tag);
   
   /**
    * Typedef of method function pointer for copy-on-write operations
@@ -365,15 +372,13 @@ PacketTagList::RemoveAll (void)
         }
       if (prev != 0) 
         {
-          prev->~TagData ();
-          std::free (prev);
+          FreeTagData (prev);
         }
       prev = cur;
     }
   if (prev != 0) 
     {
-      prev->~TagData ();
-      std::free (prev);
+      FreeTagData (prev);
     }
   m_next = 0;
 }
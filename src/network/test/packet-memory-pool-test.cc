@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/packet-memory-pool.h"
+#include "ns3/packet.h"
+#include "ns3/flow-id-tag.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the size classes and the reuse of the blocks of
+ * PacketMemoryPool
+ */
+class PacketMemoryPoolBlockTest : public TestCase
+{
+public:
+  PacketMemoryPoolBlockTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PacketMemoryPoolBlockTest::PacketMemoryPoolBlockTest ()
+  : TestCase ("Size classes and reuse of the blocks")
+{
+}
+
+void
+PacketMemoryPoolBlockTest::DoRun (void)
+{
+  for (uint32_t size : {1, 32, 33, 1100, 1519, 3100, 65536})
+    {
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (PacketMemoryPool::GetCapacity (size), size, "capacity smaller than size " << size);
+    }
+  // blocks larger than the largest class are not rounded
+  NS_TEST_ASSERT_MSG_EQ (PacketMemoryPool::GetCapacity (100000), 100000, "wrong capacity of a large block");
+
+  void *block = PacketMemoryPool::Allocate (1000);
+  NS_TEST_ASSERT_MSG_NE (block, 0, "allocation failed");
+  PacketMemoryPool::Deallocate (block, 1000);
+  PacketMemoryPool::ResetStats ();
+  void *reused = PacketMemoryPool::Allocate (PacketMemoryPool::GetCapacity (1000));
+  PacketMemoryPool::Stats stats = PacketMemoryPool::GetStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.requests, 1, "wrong number of requests");
+  if (PacketMemoryPool::IsEnabled ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (PacketMemoryPool::GetCapacity (1519), 1664, "a 1500 bytes IP packet must fit the 1664 bytes class");
+      NS_TEST_ASSERT_MSG_EQ (reused, block, "the released block was not reused");
+      NS_TEST_ASSERT_MSG_EQ (stats.heapAllocations, 0, "the block was allocated from the heap");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_EQ (PacketMemoryPool::GetCapacity (1519), 1519, "the capacity must be the size without the pool");
+      NS_TEST_ASSERT_MSG_EQ (stats.heapAllocations, 1, "the block was not allocated from the heap");
+    }
+  PacketMemoryPool::Deallocate (reused, 1000);
+
+  // large blocks always go to the heap
+  PacketMemoryPool::ResetStats ();
+  block = PacketMemoryPool::Allocate (100000);
+  PacketMemoryPool::Deallocate (block, 100000);
+  stats = PacketMemoryPool::GetStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.heapAllocations, 1, "a large block was not allocated from the heap");
+  NS_TEST_ASSERT_MSG_EQ (stats.heapDeallocations, 1, "a large block was not returned to the heap");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that packets with headers and tags can be created and
+ * destroyed repeatedly without heap allocations, once the pool holds the
+ * blocks they need
+ */
+class PacketMemoryPoolPacketTest : public TestCase
+{
+public:
+  PacketMemoryPoolPacketTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Create a packet with a packet tag and a byte tag, copy it, fragment it
+   * and check its content
+   * \param size the size of the payload
+   */
+  void Exercise (uint32_t size);
+};
+
+PacketMemoryPoolPacketTest::PacketMemoryPoolPacketTest ()
+  : TestCase ("Packets reuse the blocks of the pool")
+{
+}
+
+void
+PacketMemoryPoolPacketTest::Exercise (uint32_t size)
+{
+  std::vector<uint8_t> payload (size);
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      payload[i] = i % 251;
+    }
+  Ptr<Packet> p = Create<Packet> (payload.data (), size);
+  p->AddPacketTag (FlowIdTag (7));
+  p->AddByteTag (FlowIdTag (8));
+  Ptr<Packet> copy = p->Copy ();
+  Ptr<Packet> fragment = copy->CreateFragment (10, size / 2);
+  copy->RemoveAtStart (10);
+  fragment->AddAtEnd (copy);
+
+  FlowIdTag tag;
+  NS_TEST_ASSERT_MSG_EQ (p->PeekPacketTag (tag), true, "missing packet tag");
+  NS_TEST_ASSERT_MSG_EQ (tag.GetFlowId (), 7, "wrong packet tag");
+  std::vector<uint8_t> out (size);
+  p->CopyData (out.data (), size);
+  NS_TEST_ASSERT_MSG_EQ ((out == payload), true, "wrong payload");
+  NS_TEST_ASSERT_MSG_EQ (fragment->GetSize (), size / 2 + size - 10, "wrong fragment size");
+}
+
+void
+PacketMemoryPoolPacketTest::DoRun (void)
+{
+  std::vector<uint32_t> sizes = {20, 1024, 1500, 3000, 9000};
+  for (uint32_t size : sizes)
+    {
+      Exercise (size);
+    }
+  PacketMemoryPool::ResetStats ();
+  for (uint32_t round = 0; round < 10; ++round)
+    {
+      for (uint32_t size : sizes)
+        {
+          Exercise (size);
+        }
+    }
+  PacketMemoryPool::Stats stats = PacketMemoryPool::GetStats ();
+  NS_TEST_ASSERT_MSG_GT (stats.requests, 0, "the packets did not use the pool");
+  if (PacketMemoryPool::IsEnabled ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (stats.heapAllocations, 0, "the packets allocated blocks from the heap");
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PacketMemoryPool TestSuite
+ */
+class PacketMemoryPoolTestSuite : public TestSuite
+{
+public:
+  PacketMemoryPoolTestSuite ();
+};
+
+PacketMemoryPoolTestSuite::PacketMemoryPoolTestSuite ()
+  : TestSuite ("packet-memory-pool", UNIT)
+{
+  AddTestCase (new PacketMemoryPoolBlockTest, TestCase::QUICK);
+  AddTestCase (new PacketMemoryPoolPacketTest, TestCase::QUICK);
+}
+
+static PacketMemoryPoolTestSuite g_packetMemoryPoolTestSuite; //!< Static variable for test initialization
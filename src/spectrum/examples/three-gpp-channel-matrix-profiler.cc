@@ -0,0 +1,332 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Measures the memory and the throughput of the channel matrices generated
+ * by the ThreeGppChannelModel between a BS and many UEs.
+ *
+ * The channel matrices are stored in a ChannelTensor, a single aligned block
+ * per channel. For comparison, the program reports the memory and the
+ * number of heap blocks that the same matrices need when stored as nested
+ * vectors H[u][s][n], and times the computation of the long term component
+ * (the product of the matrix of each cluster with the beamforming vectors,
+ * as in ThreeGppSpectrumPropagationLossModel::CalcLongTerm) and of the
+ * narrowband channel (the sum of the clusters, as in
+ * MmWaveSvdBeamforming::ComputeBeamformingVectors) on both layouts.
+ *
+ * Example: ./waf --run "three-gpp-channel-matrix-profiler --numUes=200 --iterations=20"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/node-container.h"
+#include "ns3/channel-condition-model.h"
+#include "ns3/three-gpp-antenna-array-model.h"
+#include "ns3/three-gpp-channel-model.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * Compute the long term component of all the clusters, walking the
+ * contiguous matrix of each cluster
+ *
+ * \param h the channel tensor
+ * \param sW the tx beamforming vector
+ * \param uW the rx beamforming vector
+ * \return the sum of the long term components
+ */
+static std::complex<double>
+LongTermTensor (const ChannelTensor &h,
+                const ThreeGppAntennaArrayModel::ComplexVector &sW,
+                const ThreeGppAntennaArrayModel::ComplexVector &uW)
+{
+  std::complex<double> sum (0, 0);
+  for (size_t cIndex = 0; cIndex < h.GetNumClusters (); cIndex++)
+    {
+      const std::complex<double> *cluster = h.GetCluster (cIndex);
+      for (size_t sIndex = 0; sIndex < sW.size (); sIndex++)
+        {
+          std::complex<double> rxSum (0, 0);
+          for (size_t uIndex = 0; uIndex < uW.size (); uIndex++)
+            {
+              rxSum += uW[uIndex] * cluster[uIndex];
+            }
+          sum += sW[sIndex] * rxSum;
+          cluster += uW.size ();
+        }
+    }
+  return sum;
+}
+
+/**
+ * Compute the long term component of all the clusters on the nested vectors
+ *
+ * \param h the nested vectors H[u][s][n]
+ * \param sW the tx beamforming vector
+ * \param uW the rx beamforming vector
+ * \return the sum of the long term components
+ */
+static std::complex<double>
+LongTermNested (const MatrixBasedChannelModel::Complex3DVector &h,
+                const ThreeGppAntennaArrayModel::ComplexVector &sW,
+                const ThreeGppAntennaArrayModel::ComplexVector &uW)
+{
+  std::complex<double> sum (0, 0);
+  for (size_t cIndex = 0; cIndex < h[0][0].size (); cIndex++)
+    {
+      for (size_t sIndex = 0; sIndex < sW.size (); sIndex++)
+        {
+          std::complex<double> rxSum (0, 0);
+          for (size_t uIndex = 0; uIndex < uW.size (); uIndex++)
+            {
+              rxSum += uW[uIndex] * h[uIndex][sIndex][cIndex];
+            }
+          sum += sW[sIndex] * rxSum;
+        }
+    }
+  return sum;
+}
+
+/**
+ * Compute the narrowband channel, summing the contiguous cluster matrices
+ *
+ * \param h the channel tensor
+ * \param nb the narrowband channel, resized if needed
+ */
+static void
+NarrowbandTensor (const ChannelTensor &h, ThreeGppAntennaArrayModel::ComplexVector &nb)
+{
+  nb.assign (h.GetNumRows () * h.GetNumCols (), std::complex<double> (0, 0));
+  for (size_t cIndex = 0; cIndex < h.GetNumClusters (); cIndex++)
+    {
+      const std::complex<double> *cluster = h.GetCluster (cIndex);
+      for (size_t i = 0; i < nb.size (); i++)
+        {
+          nb[i] += cluster[i];
+        }
+    }
+}
+
+/**
+ * Compute the narrowband channel on the nested vectors
+ *
+ * \param h the nested vectors H[u][s][n]
+ * \param nb the narrowband channel, resized if needed
+ */
+static void
+NarrowbandNested (const MatrixBasedChannelModel::Complex3DVector &h, ThreeGppAntennaArrayModel::ComplexVector &nb)
+{
+  size_t uSize = h.size ();
+  size_t sSize = h[0].size ();
+  nb.assign (uSize * sSize, std::complex<double> (0, 0));
+  for (size_t uIndex = 0; uIndex < uSize; uIndex++)
+    {
+      for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+        {
+          std::complex<double> cSum (0, 0);
+          for (const auto &c : h[uIndex][sIndex])
+            {
+              cSum += c;
+            }
+          nb[sIndex * uSize + uIndex] = cSum;
+        }
+    }
+}
+
+/**
+ * Copy a channel tensor into nested vectors
+ *
+ * \param h the channel tensor
+ * \return the nested vectors H[u][s][n]
+ */
+static MatrixBasedChannelModel::Complex3DVector
+ToNested (const ChannelTensor &h)
+{
+  MatrixBasedChannelModel::Complex3DVector nested (h.GetNumRows ());
+  for (size_t uIndex = 0; uIndex < h.GetNumRows (); uIndex++)
+    {
+      nested[uIndex].resize (h.GetNumCols ());
+      for (size_t sIndex = 0; sIndex < h.GetNumCols (); sIndex++)
+        {
+          nested[uIndex][sIndex].resize (h.GetNumClusters ());
+          for (size_t cIndex = 0; cIndex < h.GetNumClusters (); cIndex++)
+            {
+              nested[uIndex][sIndex][cIndex] = h (uIndex, sIndex, cIndex);
+            }
+        }
+    }
+  return nested;
+}
+
+/**
+ * Print a line of the report
+ *
+ * \param name the name of the measure
+ * \param seconds the measured time
+ * \param ops the number of operations timed
+ * \param unit the unit of the operations
+ */
+static void
+Report (std::string name, double seconds, uint64_t ops, std::string unit)
+{
+  std::cout << std::setw (32) << std::left << name
+            << std::setw (12) << std::right << std::fixed << std::setprecision (3) << seconds << " s"
+            << std::setw (14) << static_cast<uint64_t> (ops / seconds) << " " << unit << "/s" << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t numUes = 100;
+  uint32_t bsRows = 8;
+  uint32_t bsColumns = 8;
+  uint32_t ueRows = 4;
+  uint32_t ueColumns = 4;
+  uint32_t iterations = 10;
+  std::string scenario = "UMi-StreetCanyon";
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("numUes", "Number of UEs connected to the BS", numUes);
+  cmd.AddValue ("bsRows", "Number of rows of the BS antenna array", bsRows);
+  cmd.AddValue ("bsColumns", "Number of columns of the BS antenna array", bsColumns);
+  cmd.AddValue ("ueRows", "Number of rows of the UE antenna arrays", ueRows);
+  cmd.AddValue ("ueColumns", "Number of columns of the UE antenna arrays", ueColumns);
+  cmd.AddValue ("iterations", "Number of times each channel is processed", iterations);
+  cmd.AddValue ("scenario", "The 3GPP scenario (RMa, UMa, UMi-StreetCanyon, InH-OfficeOpen, InH-OfficeMixed)", scenario);
+  cmd.Parse (argc, argv);
+
+  Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel> ();
+  channelModel->SetAttribute ("Frequency", DoubleValue (28e9));
+  channelModel->SetAttribute ("Scenario", StringValue (scenario));
+  channelModel->SetAttribute ("ChannelConditionModel", PointerValue (CreateObject<AlwaysLosChannelConditionModel> ()));
+
+  NodeContainer bs;
+  bs.Create (1);
+  NodeContainer ues;
+  ues.Create (numUes);
+
+  Ptr<MobilityModel> bsMob = CreateObject<ConstantPositionMobilityModel> ();
+  bsMob->SetPosition (Vector (0.0, 0.0, 10.0));
+  bs.Get (0)->AggregateObject (bsMob);
+  Ptr<UniformRandomVariable> position = CreateObject<UniformRandomVariable> ();
+  position->SetStream (1);
+  for (uint32_t i = 0; i < numUes; i++)
+    {
+      Ptr<MobilityModel> ueMob = CreateObject<ConstantPositionMobilityModel> ();
+      ueMob->SetPosition (Vector (position->GetValue (10.0, 200.0), position->GetValue (-100.0, 100.0), 1.5));
+      ues.Get (i)->AggregateObject (ueMob);
+    }
+
+  Ptr<ThreeGppAntennaArrayModel> bsAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumColumns", UintegerValue (bsColumns), "NumRows", UintegerValue (bsRows));
+  Ptr<ThreeGppAntennaArrayModel> ueAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumColumns", UintegerValue (ueColumns), "NumRows", UintegerValue (ueRows));
+
+  // generate the channel matrices, the UEs are the rx (u) nodes
+  std::vector<Ptr<const MatrixBasedChannelModel::ChannelMatrix> > channels;
+  auto start = std::chrono::steady_clock::now ();
+  for (uint32_t i = 0; i < numUes; i++)
+    {
+      channels.push_back (channelModel->GetChannel (bsMob, ues.Get (i)->GetObject<MobilityModel> (), bsAntenna, ueAntenna));
+    }
+  auto stop = std::chrono::steady_clock::now ();
+  Report ("channel generation", std::chrono::duration<double> (stop - start).count (), numUes, "channels");
+
+  // memory of the tensors, and the equivalent memory of the nested vectors
+  uint64_t tensorBytes = 0;
+  uint64_t tensorBlocks = 0;
+  uint64_t nestedBytes = 0;
+  uint64_t nestedBlocks = 0;
+  std::vector<MatrixBasedChannelModel::Complex3DVector> nested;
+  for (const auto &channel : channels)
+    {
+      const ChannelTensor &h = channel->m_channel;
+      tensorBytes += h.GetMemoryUsage () + channel->m_angle.GetMemoryUsage ();
+      tensorBlocks += 2;
+      uint64_t uSize = h.GetNumRows ();
+      uint64_t sSize = h.GetNumCols ();
+      nestedBytes += uSize * sSize * h.GetNumClusters () * sizeof (std::complex<double>)
+        + uSize * sSize * sizeof (ThreeGppAntennaArrayModel::ComplexVector)
+        + uSize * sizeof (MatrixBasedChannelModel::Complex2DVector)
+        + channel->m_angle.GetNumRows () * (sizeof (MatrixBasedChannelModel::DoubleVector) + channel->m_angle.GetNumCols () * sizeof (double));
+      nestedBlocks += 1 + uSize + uSize * sSize + 1 + channel->m_angle.GetNumRows ();
+      nested.push_back (ToNested (h));
+    }
+  std::cout << "channel matrix " << channels[0]->m_channel.GetNumRows () << "x" << channels[0]->m_channel.GetNumCols ()
+            << "x" << channels[0]->m_channel.GetNumClusters () << std::endl;
+  std::cout << "tensor: " << tensorBytes / 1024 << " KiB in " << tensorBlocks << " blocks" << std::endl;
+  std::cout << "nested vectors: " << nestedBytes / 1024 << " KiB in " << nestedBlocks << " blocks" << std::endl;
+
+  ThreeGppAntennaArrayModel::ComplexVector uW = ueAntenna->GetBeamformingVector ();
+  ThreeGppAntennaArrayModel::ComplexVector sW = bsAntenna->GetBeamformingVector ();
+  uW.assign (ueAntenna->GetNumberOfElements (), std::complex<double> (1 / std::sqrt (ueAntenna->GetNumberOfElements ()), 0));
+  sW.assign (bsAntenna->GetNumberOfElements (), std::complex<double> (1 / std::sqrt (bsAntenna->GetNumberOfElements ()), 0));
+
+  std::complex<double> checksum (0, 0);
+  start = std::chrono::steady_clock::now ();
+  for (uint32_t it = 0; it < iterations; it++)
+    {
+      for (const auto &channel : channels)
+        {
+          checksum += LongTermTensor (channel->m_channel, sW, uW);
+        }
+    }
+  stop = std::chrono::steady_clock::now ();
+  Report ("long term (tensor)", std::chrono::duration<double> (stop - start).count (), iterations * numUes, "channels");
+
+  start = std::chrono::steady_clock::now ();
+  for (uint32_t it = 0; it < iterations; it++)
+    {
+      for (const auto &h : nested)
+        {
+          checksum += LongTermNested (h, sW, uW);
+        }
+    }
+  stop = std::chrono::steady_clock::now ();
+  Report ("long term (nested vectors)", std::chrono::duration<double> (stop - start).count (), iterations * numUes, "channels");
+
+  ThreeGppAntennaArrayModel::ComplexVector nb;
+  start = std::chrono::steady_clock::now ();
+  for (uint32_t it = 0; it < iterations; it++)
+    {
+      for (const auto &channel : channels)
+        {
+          NarrowbandTensor (channel->m_channel, nb);
+          checksum += nb[0];
+        }
+    }
+  stop = std::chrono::steady_clock::now ();
+  Report ("narrowband (tensor)", std::chrono::duration<double> (stop - start).count (), iterations * numUes, "channels");
+
+  start = std::chrono::steady_clock::now ();
+  for (uint32_t it = 0; it < iterations; it++)
+    {
+      for (const auto &h : nested)
+        {
+          NarrowbandNested (h, nb);
+          checksum += nb[0];
+        }
+    }
+  stop = std::chrono::steady_clock::now ();
+  Report ("narrowband (nested vectors)", std::chrono::duration<double> (stop - start).count (), iterations * numUes, "channels");
+
+  std::cout << "checksum " << std::setprecision (6) << checksum << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
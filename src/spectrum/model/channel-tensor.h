@@ -0,0 +1,663 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CHANNEL_TENSOR_H
+#define CHANNEL_TENSOR_H
+
+#include <ns3/abort.h>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Allocator of memory blocks aligned to Alignment bytes
+ *
+ * Used by the containers of the channel matrices, so that each block starts
+ * at the beginning of a cache line.
+ *
+ * \tparam T the type of the allocated objects
+ * \tparam Alignment the alignment in bytes, a power of two
+ */
+template <typename T, std::size_t Alignment = 64>
+class AlignedAllocator
+{
+public:
+  typedef T value_type; //!< type of the allocated objects
+
+  /// the same allocator, for objects of type U
+  template <typename U>
+  struct rebind
+  {
+    typedef AlignedAllocator<U, Alignment> other; //!< the rebound allocator
+  };
+
+  AlignedAllocator () = default;
+
+  /**
+   * Copy constructor from an allocator of a different type
+   */
+  template <typename U>
+  AlignedAllocator (const AlignedAllocator<U, Alignment> &)
+  {
+  }
+
+  /**
+   * Allocate an aligned block
+   * \param n the number of objects
+   * \return a pointer to the block
+   */
+  T * allocate (std::size_t n)
+  {
+    static_assert (Alignment % sizeof (void *) == 0 && (Alignment & (Alignment - 1)) == 0,
+                   "the alignment must be a power of two multiple of the size of a pointer");
+    void *p = nullptr;
+    if (posix_memalign (&p, Alignment, n * sizeof (T)) != 0)
+      {
+        // required by the allocator requirements of the standard containers
+        throw std::bad_alloc ();
+      }
+    return static_cast<T *> (p);
+  }
+
+  /**
+   * Release a block returned by allocate
+   * \param p the pointer to the block
+   */
+  void deallocate (T *p, std::size_t)
+  {
+    std::free (p);
+  }
+};
+
+/**
+ * \return true, since all the aligned allocators are interchangeable
+ */
+template <typename T, typename U, std::size_t Alignment>
+bool
+operator== (const AlignedAllocator<T, Alignment> &, const AlignedAllocator<U, Alignment> &)
+{
+  return true;
+}
+
+/**
+ * \return false, since all the aligned allocators are interchangeable
+ */
+template <typename T, typename U, std::size_t Alignment>
+bool
+operator!= (const AlignedAllocator<T, Alignment> &, const AlignedAllocator<U, Alignment> &)
+{
+  return false;
+}
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief View of a strided sequence of elements of a matrix or tensor
+ *
+ * Provides the subset of the std::vector interface used to read and write
+ * the elements (operator[], at, size), so that code written for nested
+ * vectors keeps working on the flat containers.
+ *
+ * \tparam T the type of the elements, const qualified for read-only views
+ */
+template <typename T>
+class StridedView
+{
+public:
+  /**
+   * Constructor
+   * \param data pointer to the first element
+   * \param stride distance between two consecutive elements
+   * \param size number of elements
+   */
+  StridedView (T *data, std::size_t stride, std::size_t size)
+    : m_data (data),
+      m_stride (stride),
+      m_size (size)
+  {
+  }
+
+  /**
+   * \param i the index of the element
+   * \return a reference to the element
+   */
+  T & operator[] (std::size_t i) const
+  {
+    return m_data[i * m_stride];
+  }
+
+  /**
+   * \param i the index of the element
+   * \return a reference to the element, aborts if i is not a valid index
+   */
+  T & at (std::size_t i) const
+  {
+    NS_ABORT_MSG_IF (i >= m_size, "StridedView::at: index " << i << " out of range");
+    return m_data[i * m_stride];
+  }
+
+  /**
+   * \return the number of elements
+   */
+  std::size_t size (void) const
+  {
+    return m_size;
+  }
+
+private:
+  T *m_data; //!< pointer to the first element
+  std::size_t m_stride; //!< distance between two consecutive elements
+  std::size_t m_size; //!< number of elements
+};
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Dense matrix of elements of type T, stored row by row in a single
+ * aligned block
+ *
+ * Used to store the parameters of the clusters of a channel, e.g., the
+ * angles angle[direction][cluster], so that the values of all the clusters
+ * are contiguous. Can be built from and compared as a vector of rows.
+ *
+ * \tparam T the type of the elements
+ */
+template <typename T>
+class AlignedMatrix
+{
+public:
+  typedef std::vector<T, AlignedAllocator<T> > StorageType; //!< type of the storage
+  typedef std::vector<std::vector<T> > NestedType; //!< the equivalent vector of rows
+
+  AlignedMatrix ()
+    : m_numRows (0),
+      m_numCols (0)
+  {
+  }
+
+  /**
+   * Create a matrix with all the elements value-initialized
+   * \param numRows the number of rows
+   * \param numCols the number of columns
+   */
+  AlignedMatrix (std::size_t numRows, std::size_t numCols)
+    : m_numRows (numRows),
+      m_numCols (numCols),
+      m_data (numRows * numCols)
+  {
+  }
+
+  /**
+   * Create a matrix from a vector of rows, which must have the same size
+   * \param rows the rows
+   */
+  AlignedMatrix (const NestedType &rows)
+    : m_numRows (0),
+      m_numCols (0)
+  {
+    for (const auto &row : rows)
+      {
+        push_back (row);
+      }
+  }
+
+  /**
+   * Change the size of the matrix, all the elements are value-initialized
+   * \param numRows the number of rows
+   * \param numCols the number of columns
+   */
+  void Resize (std::size_t numRows, std::size_t numCols)
+  {
+    m_numRows = numRows;
+    m_numCols = numCols;
+    m_data.assign (numRows * numCols, T ());
+  }
+
+  /**
+   * \return the number of rows
+   */
+  std::size_t GetNumRows (void) const
+  {
+    return m_numRows;
+  }
+
+  /**
+   * \return the number of columns
+   */
+  std::size_t GetNumCols (void) const
+  {
+    return m_numCols;
+  }
+
+  /**
+   * \param row the index of the row
+   * \return a pointer to the contiguous elements of the row
+   */
+  T * GetRow (std::size_t row)
+  {
+    return m_data.data () + row * m_numCols;
+  }
+
+  /**
+   * \param row the index of the row
+   * \return a pointer to the contiguous elements of the row
+   */
+  const T * GetRow (std::size_t row) const
+  {
+    return m_data.data () + row * m_numCols;
+  }
+
+  /**
+   * \return the number of rows
+   */
+  std::size_t size (void) const
+  {
+    return m_numRows;
+  }
+
+  /**
+   * \return true if the matrix has no rows
+   */
+  bool empty (void) const
+  {
+    return m_numRows == 0;
+  }
+
+  /**
+   * Remove all the rows
+   */
+  void clear (void)
+  {
+    Resize (0, 0);
+  }
+
+  /**
+   * Append a row, which must have the same size of the other rows
+   * \param row the row
+   */
+  void push_back (const std::vector<T> &row)
+  {
+    if (m_numRows == 0)
+      {
+        m_numCols = row.size ();
+      }
+    else if (row.size () != m_numCols)
+      {
+        NS_ABORT_MSG ("AlignedMatrix::push_back: rows of different size");
+      }
+    m_data.insert (m_data.end (), row.begin (), row.end ());
+    ++m_numRows;
+  }
+
+  /**
+   * \param row the index of the row
+   * \return a view of the row
+   */
+  StridedView<T> operator[] (std::size_t row)
+  {
+    return StridedView<T> (GetRow (row), 1, m_numCols);
+  }
+
+  /**
+   * \param row the index of the row
+   * \return a read-only view of the row
+   */
+  StridedView<const T> operator[] (std::size_t row) const
+  {
+    return StridedView<const T> (GetRow (row), 1, m_numCols);
+  }
+
+  /**
+   * \param row the index of the row
+   * \return a view of the row, aborts if row is not a valid index
+   */
+  StridedView<const T> at (std::size_t row) const
+  {
+    NS_ABORT_MSG_IF (row >= m_numRows, "AlignedMatrix::at: row " << row << " out of range");
+    return (*this)[row];
+  }
+
+  /**
+   * \return the memory used by the elements, in bytes
+   */
+  std::size_t GetMemoryUsage (void) const
+  {
+    return m_data.capacity () * sizeof (T);
+  }
+
+  /**
+   * \param other the other matrix
+   * \return true if the matrices have the same size and elements
+   */
+  bool operator== (const AlignedMatrix<T> &other) const
+  {
+    return m_numRows == other.m_numRows && m_numCols == other.m_numCols && m_data == other.m_data;
+  }
+
+  /**
+   * \param other the other matrix
+   * \return true if the matrices differ
+   */
+  bool operator!= (const AlignedMatrix<T> &other) const
+  {
+    return !(*this == other);
+  }
+
+private:
+  std::size_t m_numRows; //!< number of rows
+  std::size_t m_numCols; //!< number of columns
+  StorageType m_data; //!< the elements, row by row
+};
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Complex channel tensor H[u][s][n], stored in a single aligned
+ * block, cluster by cluster
+ *
+ * The element H[u][s][n] is stored at (n * S + s) * U + u, where U and S are
+ * the number of rx (u) and tx (s) antenna elements: the matrix of each
+ * cluster is contiguous, and the elements of the rx antenna are the fastest
+ * varying index. The consumers which combine the clusters with the antenna
+ * weights can thus walk the memory sequentially, e.g., using GetCluster.
+ *
+ * The tensor can be built from and indexed as the nested vectors previously
+ * used to store the channel, i.e., H[u][s][n], H.at (u).at (s).at (n),
+ * H.size (), H[u].size () and H[u][s].size () keep their meaning, but the
+ * indexing by H (u, s, n) is cheaper.
+ */
+class ChannelTensor
+{
+public:
+  typedef std::complex<double> ValueType; //!< type of the elements
+  typedef std::vector<ValueType, AlignedAllocator<ValueType> > StorageType; //!< type of the storage
+  typedef std::vector<std::vector<std::vector<ValueType> > > NestedType; //!< the equivalent nested vectors H[u][s][n]
+
+  /**
+   * \brief View of the elements H[u][.][.] of a rx antenna element
+   *
+   * \tparam T the type of the elements, const qualified for read-only views
+   */
+  template <typename T>
+  class RowView
+  {
+  public:
+    /**
+     * Constructor
+     * \param data pointer to the element H[u][0][0]
+     * \param numRows the number of rx antenna elements
+     * \param numCols the number of tx antenna elements
+     * \param numClusters the number of clusters
+     */
+    RowView (T *data, std::size_t numRows, std::size_t numCols, std::size_t numClusters)
+      : m_data (data),
+        m_numRows (numRows),
+        m_numCols (numCols),
+        m_numClusters (numClusters)
+    {
+    }
+
+    /**
+     * \param s the index of the tx antenna element
+     * \return a view of the elements H[u][s][.]
+     */
+    StridedView<T> operator[] (std::size_t s) const
+    {
+      return StridedView<T> (m_data + s * m_numRows, m_numRows * m_numCols, m_numClusters);
+    }
+
+    /**
+     * \param s the index of the tx antenna element
+     * \return a view of the elements H[u][s][.], aborts if s is not a
+     *         valid index
+     */
+    StridedView<T> at (std::size_t s) const
+    {
+      NS_ABORT_MSG_IF (s >= m_numCols, "ChannelTensor::RowView::at: column " << s << " out of range");
+      return (*this)[s];
+    }
+
+    /**
+     * \return the number of tx antenna elements
+     */
+    std::size_t size (void) const
+    {
+      return m_numCols;
+    }
+
+  private:
+    T *m_data; //!< pointer to the element H[u][0][0]
+    std::size_t m_numRows; //!< number of rx antenna elements
+    std::size_t m_numCols; //!< number of tx antenna elements
+    std::size_t m_numClusters; //!< number of clusters
+  };
+
+  ChannelTensor ()
+    : m_numRows (0),
+      m_numCols (0),
+      m_numClusters (0)
+  {
+  }
+
+  /**
+   * Create a tensor with all the elements set to zero
+   * \param numRows the number of rx antenna elements
+   * \param numCols the number of tx antenna elements
+   * \param numClusters the number of clusters
+   */
+  ChannelTensor (std::size_t numRows, std::size_t numCols, std::size_t numClusters)
+    : m_numRows (numRows),
+      m_numCols (numCols),
+      m_numClusters (numClusters),
+      m_data (numRows * numCols * numClusters)
+  {
+  }
+
+  /**
+   * Create a tensor from the nested vectors H[u][s][n], in which all the
+   * vectors of the same level must have the same size
+   * \param h the nested vectors
+   */
+  ChannelTensor (const NestedType &h)
+    : ChannelTensor ()
+  {
+    if (h.empty () || h[0].empty ())
+      {
+        return;
+      }
+    Resize (h.size (), h[0].size (), h[0][0].size ());
+    for (std::size_t u = 0; u < m_numRows; u++)
+      {
+        NS_ABORT_MSG_IF (h[u].size () != m_numCols, "ChannelTensor: rows of different size");
+        for (std::size_t s = 0; s < m_numCols; s++)
+          {
+            NS_ABORT_MSG_IF (h[u][s].size () != m_numClusters, "ChannelTensor: different number of clusters");
+            for (std::size_t n = 0; n < m_numClusters; n++)
+              {
+                (*this) (u, s, n) = h[u][s][n];
+              }
+          }
+      }
+  }
+
+  /**
+   * Change the size of the tensor, all the elements are set to zero
+   * \param numRows the number of rx antenna elements
+   * \param numCols the number of tx antenna elements
+   * \param numClusters the number of clusters
+   */
+  void Resize (std::size_t numRows, std::size_t numCols, std::size_t numClusters)
+  {
+    m_numRows = numRows;
+    m_numCols = numCols;
+    m_numClusters = numClusters;
+    m_data.assign (numRows * numCols * numClusters, ValueType (0, 0));
+  }
+
+  /**
+   * \return the number of rx antenna elements
+   */
+  std::size_t GetNumRows (void) const
+  {
+    return m_numRows;
+  }
+
+  /**
+   * \return the number of tx antenna elements
+   */
+  std::size_t GetNumCols (void) const
+  {
+    return m_numCols;
+  }
+
+  /**
+   * \return the number of clusters
+   */
+  std::size_t GetNumClusters (void) const
+  {
+    return m_numClusters;
+  }
+
+  /**
+   * \param u the index of the rx antenna element
+   * \param s the index of the tx antenna element
+   * \param n the index of the cluster
+   * \return a reference to the element H[u][s][n]
+   */
+  ValueType & operator() (std::size_t u, std::size_t s, std::size_t n)
+  {
+    return m_data[(n * m_numCols + s) * m_numRows + u];
+  }
+
+  /**
+   * \param u the index of the rx antenna element
+   * \param s the index of the tx antenna element
+   * \param n the index of the cluster
+   * \return the element H[u][s][n]
+   */
+  const ValueType & operator() (std::size_t u, std::size_t s, std::size_t n) const
+  {
+    return m_data[(n * m_numCols + s) * m_numRows + u];
+  }
+
+  /**
+   * \param n the index of the cluster
+   * \return a pointer to the contiguous matrix of the cluster, in which
+   *         the element H[u][s][n] has index s * GetNumRows () + u
+   */
+  ValueType * GetCluster (std::size_t n)
+  {
+    return m_data.data () + n * m_numCols * m_numRows;
+  }
+
+  /**
+   * \param n the index of the cluster
+   * \return a pointer to the contiguous matrix of the cluster, in which
+   *         the element H[u][s][n] has index s * GetNumRows () + u
+   */
+  const ValueType * GetCluster (std::size_t n) const
+  {
+    return m_data.data () + n * m_numCols * m_numRows;
+  }
+
+  /**
+   * \return the number of rx antenna elements
+   */
+  std::size_t size (void) const
+  {
+    return m_numRows;
+  }
+
+  /**
+   * \return true if the tensor has no elements
+   */
+  bool empty (void) const
+  {
+    return m_data.empty ();
+  }
+
+  /**
+   * \param u the index of the rx antenna element
+   * \return a view of the elements H[u][.][.]
+   */
+  RowView<ValueType> operator[] (std::size_t u)
+  {
+    return RowView<ValueType> (m_data.data () + u, m_numRows, m_numCols, m_numClusters);
+  }
+
+  /**
+   * \param u the index of the rx antenna element
+   * \return a read-only view of the elements H[u][.][.]
+   */
+  RowView<const ValueType> operator[] (std::size_t u) const
+  {
+    return RowView<const ValueType> (m_data.data () + u, m_numRows, m_numCols, m_numClusters);
+  }
+
+  /**
+   * \param u the index of the rx antenna element
+   * \return a read-only view of the elements H[u][.][.], aborts if u is
+   *         not a valid index
+   */
+  RowView<const ValueType> at (std::size_t u) const
+  {
+    NS_ABORT_MSG_IF (u >= m_numRows, "ChannelTensor::at: row " << u << " out of range");
+    return (*this)[u];
+  }
+
+  /**
+   * \return the memory used by the elements, in bytes
+   */
+  std::size_t GetMemoryUsage (void) const
+  {
+    return m_data.capacity () * sizeof (ValueType);
+  }
+
+  /**
+   * \param other the other tensor
+   * \return true if the tensors have the same size and elements
+   */
+  bool operator== (const ChannelTensor &other) const
+  {
+    return m_numRows == other.m_numRows && m_numCols == other.m_numCols
+           && m_numClusters == other.m_numClusters && m_data == other.m_data;
+  }
+
+  /**
+   * \param other the other tensor
+   * \return true if the tensors differ
+   */
+  bool operator!= (const ChannelTensor &other) const
+  {
+    return !(*this == other);
+  }
+
+private:
+  std::size_t m_numRows; //!< number of rx antenna elements
+  std::size_t m_numCols; //!< number of tx antenna elements
+  std::size_t m_numClusters; //!< number of clusters
+  StorageType m_data; //!< the elements, cluster by cluster
+};
+
+} // namespace ns3
+
+#endif /* CHANNEL_TENSOR_H */
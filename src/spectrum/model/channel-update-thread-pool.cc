@@ -0,0 +1,202 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "channel-update-thread-pool.h"
+#include <ns3/log.h>
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#include <pthread.h>
+#endif
+#include <algorithm>
+#include <set>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ChannelUpdateThreadPool");
+
+/**
+ * \return the existing pools, which are created and destroyed by the main
+ *         thread. The set is never destroyed, so that the pools destroyed
+ *         at exit can still remove themselves from it.
+ */
+static std::set<ChannelUpdateThreadPool *> &
+GetThreadPools (void)
+{
+  static std::set<ChannelUpdateThreadPool *> *pools = new std::set<ChannelUpdateThreadPool *> ();
+  return *pools;
+}
+
+ChannelUpdateThreadPool::ChannelUpdateThreadPool (uint32_t numThreads)
+  : m_numThreads (1),
+    m_batch (0),
+    m_startBatch (0),
+    m_stop (false),
+    m_activeWorkers (0),
+    m_numJobs (0),
+    m_nextJob (0)
+{
+  NS_LOG_FUNCTION (this << numThreads);
+#ifdef HAVE_PTHREAD_H
+  static bool atForkRegistered = false;
+  if (!atForkRegistered)
+    {
+      pthread_atfork (&ChannelUpdateThreadPool::StopAllThreads, nullptr, nullptr);
+      atForkRegistered = true;
+    }
+  GetThreadPools ().insert (this);
+  m_numThreads = std::max (numThreads, 1U);
+  StartThreads ();
+#endif
+}
+
+ChannelUpdateThreadPool::~ChannelUpdateThreadPool ()
+{
+  NS_LOG_FUNCTION (this);
+  GetThreadPools ().erase (this);
+  StopThreads ();
+}
+
+void
+ChannelUpdateThreadPool::StartThreads (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  m_startBatch = m_batch;
+  for (uint32_t i = 1; i < m_numThreads; ++i)
+    {
+      Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&ChannelUpdateThreadPool::Worker, this));
+      thread->Start ();
+      m_threads.push_back (thread);
+    }
+#endif
+}
+
+void
+ChannelUpdateThreadPool::StopThreads (void)
+{
+  NS_LOG_FUNCTION (this);
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_stop = true;
+  }
+  m_wakeUp.notify_all ();
+#ifdef HAVE_PTHREAD_H
+  for (auto &thread : m_threads)
+    {
+      thread->Join ();
+    }
+#endif
+  m_threads.clear ();
+  m_stop = false;
+}
+
+void
+ChannelUpdateThreadPool::StopAllThreads (void)
+{
+  // the workers are idle, since Run returns only when the batch is completed
+  for (ChannelUpdateThreadPool *pool : GetThreadPools ())
+    {
+      pool->StopThreads ();
+    }
+}
+
+uint32_t
+ChannelUpdateThreadPool::GetNThreads (void) const
+{
+  return m_numThreads;
+}
+
+void
+ChannelUpdateThreadPool::Run (uint32_t numJobs, Callback<void, uint32_t> job)
+{
+  NS_LOG_FUNCTION (this << numJobs);
+  if (m_numThreads < 2 || numJobs < 2)
+    {
+      for (uint32_t i = 0; i < numJobs; ++i)
+        {
+          job (i);
+        }
+      return;
+    }
+  if (m_threads.empty ())
+    {
+      // the workers were stopped before a fork
+      StartThreads ();
+    }
+
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_job = job;
+    m_numJobs = numJobs;
+    m_nextJob = 0;
+    m_activeWorkers = m_threads.size ();
+    ++m_batch;
+  }
+  m_wakeUp.notify_all ();
+
+  DoJobs ();
+
+  std::unique_lock<std::mutex> lock (m_mutex);
+  m_done.wait (lock, [this] { return m_activeWorkers == 0; });
+  // the workers are idle, the callback can be released by this thread
+  m_job = Callback<void, uint32_t> ();
+}
+
+void
+ChannelUpdateThreadPool::DoJobs (void)
+{
+  // the callback is invoked through a reference, since copying it would
+  // update its reference count from several threads
+  const Callback<void, uint32_t> &job = m_job;
+  for (uint32_t i = m_nextJob++; i < m_numJobs; i = m_nextJob++)
+    {
+      job (i);
+    }
+}
+
+void
+ChannelUpdateThreadPool::Worker (void)
+{
+  uint64_t batch;
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    batch = m_startBatch;
+  }
+  while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock (m_mutex);
+        m_wakeUp.wait (lock, [this, batch] { return m_stop || m_batch != batch; });
+        if (m_stop)
+          {
+            return;
+          }
+        batch = m_batch;
+      }
+
+      DoJobs ();
+
+      {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        if (--m_activeWorkers == 0)
+          {
+            m_done.notify_one ();
+          }
+      }
+    }
+}
+
+} // namespace ns3
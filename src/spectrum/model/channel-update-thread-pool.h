@@ -0,0 +1,122 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CHANNEL_UPDATE_THREAD_POOL_H
+#define CHANNEL_UPDATE_THREAD_POOL_H
+
+#include <ns3/core-config.h>
+#include <ns3/simple-ref-count.h>
+#include <ns3/callback.h>
+#include <ns3/ptr.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace ns3 {
+
+class SystemThread;
+
+/**
+ * \ingroup spectrum
+ * \brief Pool of threads used to generate many channel realizations at once
+ *
+ * Run executes a batch of independent jobs, identified by their index, on
+ * the worker threads and on the calling thread, and returns when all the
+ * jobs are completed. The workers wait for the next batch between two calls
+ * to Run, so that the threads are created only once.
+ *
+ * The jobs must not schedule events, copy Ptr or Callback instances shared
+ * with other jobs, or use random variables shared with other jobs, since
+ * none of them is thread safe. If ns-3 is built without threading support,
+ * the jobs are executed by the calling thread.
+ *
+ * Since fork () copies only the calling thread, the workers of all the
+ * pools are stopped before a fork (see pthread_atfork), and started again
+ * by the next call to Run, in the parent and in the child process.
+ */
+class ChannelUpdateThreadPool : public SimpleRefCount<ChannelUpdateThreadPool>
+{
+public:
+  /**
+   * Constructor
+   * \param numThreads the number of threads executing the jobs, including
+   *        the thread calling Run
+   */
+  ChannelUpdateThreadPool (uint32_t numThreads);
+
+  /**
+   * Destructor, stops the workers
+   */
+  ~ChannelUpdateThreadPool ();
+
+  /**
+   * \return the number of threads executing the jobs, including the thread
+   *         calling Run
+   */
+  uint32_t GetNThreads (void) const;
+
+  /**
+   * Execute a batch of jobs and wait for their completion
+   * \param numJobs the number of jobs
+   * \param job the callback executing the job with the given index
+   */
+  void Run (uint32_t numJobs, Callback<void, uint32_t> job);
+
+private:
+  /**
+   * Main function of the worker threads
+   */
+  void Worker (void);
+
+  /**
+   * Execute the jobs of the current batch which were not taken by other
+   * threads
+   */
+  void DoJobs (void);
+
+  /**
+   * Start the worker threads
+   */
+  void StartThreads (void);
+
+  /**
+   * Stop the worker threads and wait for them to exit
+   */
+  void StopThreads (void);
+
+  /**
+   * Stop the worker threads of all the pools, called before fork ()
+   */
+  static void StopAllThreads (void);
+
+  uint32_t m_numThreads; //!< the number of threads executing the jobs, including the thread calling Run
+  std::vector<Ptr<SystemThread> > m_threads; //!< the worker threads, empty if they are stopped
+  std::mutex m_mutex; //!< protects the state of the batch
+  std::condition_variable m_wakeUp; //!< notifies the workers of a new batch
+  std::condition_variable m_done; //!< notifies Run of the completion of the workers
+  uint64_t m_batch; //!< identifier of the current batch
+  uint64_t m_startBatch; //!< identifier of the batch when the workers were started
+  bool m_stop; //!< true if the workers have to exit
+  uint32_t m_activeWorkers; //!< number of workers still busy with the current batch
+  uint32_t m_numJobs; //!< number of jobs of the current batch
+  std::atomic<uint32_t> m_nextJob; //!< index of the next job to execute
+  Callback<void, uint32_t> m_job; //!< the job of the current batch
+};
+
+} // namespace ns3
+
+#endif /* CHANNEL_UPDATE_THREAD_POOL_H */
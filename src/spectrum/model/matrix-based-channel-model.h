@@ -27,6 +27,7 @@
 #include <ns3/nstime.h>
 #include <ns3/vector.h>
 #include <ns3/three-gpp-antenna-array-model.h>
+#include <ns3/channel-tensor.h>
 #include <tuple>
 
 namespace ns3 {
@@ -53,16 +54,21 @@ public:
   typedef std::vector<Double2DVector> Double3DVector; //!< type definition for 3D matrices of doubles
   typedef std::vector<ThreeGppAntennaArrayModel::ComplexVector> Complex2DVector; //!< type definition for complex matrices
   typedef std::vector<Complex2DVector> Complex3DVector; //!< type definition for complex 3D matrices
-
+  typedef AlignedMatrix<double> ClusterAngles; //!< type definition for the angles of the clusters angle[direction][n]
 
   /**
    * Data structure that stores a channel realization
+   *
+   * The channel coefficients and the angles of the clusters are stored in
+   * flat containers, in which the values of the clusters are contiguous.
+   * Both can still be indexed and assigned as nested vectors, i.e.,
+   * m_channel[u][s][n] and m_angle[direction][n].
    */
   struct ChannelMatrix : public SimpleRefCount<ChannelMatrix>
   {
-    Complex3DVector    m_channel; //!< channel matrix H[u][s][n].
+    ChannelTensor      m_channel; //!< channel matrix H[u][s][n].
     DoubleVector       m_delay; //!< cluster delay in nanoseconds.
-    Double2DVector     m_angle; //!< cluster angle angle[direction][n], where direction = 0(AOA), 1(ZOA), 2(AOD), 3(ZOD) in degree.
+    ClusterAngles      m_angle; //!< cluster angle angle[direction][n], where direction = 0(AOA), 1(ZOA), 2(AOD), 3(ZOD) in degree.
     Time               m_generatedTime; //!< generation time
     std::pair<uint32_t, uint32_t> m_nodeIds; //!< the first element is the s-node ID (the transmitter when the channel was generated), the second element is the u-node ID (the receiver when the channel was generated)
 
@@ -82,6 +82,7 @@ MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
   : m_numDevices {0}
 {
   NS_LOG_FUNCTION (this);
+  ResetCullingStats ();
 }
 
 void
@@ -100,7 +101,17 @@ MultiModelSpectrumChannel::GetTypeId (void)
     .SetParent<SpectrumChannel> ()
     .SetGroupName ("Spectrum")
     .AddConstructor<MultiModelSpectrumChannel> ()
-
+    .AddAttribute ("MaxCullingDistance",
+                   "If positive, the receivers farther than this distance (in m) "
+                   "from the transmitter are culled when a signal is transmitted: "
+                   "the propagation loss is not computed, the signal and its PSD "
+                   "are not copied, and no reception event is scheduled. "
+                   "The receivers beyond MaxLossDb are culled too, after the "
+                   "propagation loss is computed, but before any copy. "
+                   "Zero disables the culling by distance.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxCullingDistance),
+                   MakeDoubleChecker<double> (0.0))
   ;
   return tid;
 }
@@ -267,81 +278,99 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
           NS_ASSERT_MSG ((*rxPhyIterator)->GetRxSpectrumModel ()->GetUid () == rxSpectrumModelUid,
                          "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
 
-          if ((*rxPhyIterator) != txParams->txPhy)
+          if ((*rxPhyIterator) == txParams->txPhy)
             {
-              NS_LOG_LOGIC ("copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
-              Time delay = MicroSeconds (0);
+              continue;
+            }
+
+          Time delay = MicroSeconds (0);
+          double pathGainLinear = 1;
+          Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
 
-              Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+          if (txMobility && receiverMobility)
+            {
+              // the receivers are culled before any copy of the signal and of its PSD
+              if (m_maxCullingDistance > 0
+                  && txMobility->GetDistanceFrom (receiverMobility) > m_maxCullingDistance)
+                {
+                  NS_LOG_LOGIC ("receiver beyond MaxCullingDistance");
+                  ++m_cullingStats.culledByDistance;
+                  continue;
+                }
 
-              if (txMobility && receiverMobility)
+              double txAntennaGain = 0;
+              double rxAntennaGain = 0;
+              double propagationGainDb = 0;
+              double pathLossDb = 0;
+              if (txParams->txAntenna != 0)
                 {
-                  double txAntennaGain = 0;
-                  double rxAntennaGain = 0;
-                  double propagationGainDb = 0;
-                  double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
-                    {
-                      Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
-                      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
-                      pathLossDb -= txAntennaGain;
-                    }
-                  Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
-                  if (rxAntenna != 0)
-                    {
-                      Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
-                      rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
-                      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
-                      pathLossDb -= rxAntennaGain;
-                    }
-                  if (m_propagationLoss)
-                    {
-                      propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
-                      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                      pathLossDb -= propagationGainDb;
-                    }                    
-                  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");
-                  // Gain trace
-                  m_gainTrace (txMobility, receiverMobility, txAntennaGain, rxAntennaGain, propagationGainDb, pathLossDb);
-                  // Pathloss trace
-                  m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
-                  if (pathLossDb > m_maxLossDb)
-                    {
-                      // beyond range
-                      continue;
-                    }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-                  *(rxParams->psd) *= pathGainLinear;              
-
-                  if (m_spectrumPropagationLoss)
-                    {
-                      rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
-                    }
-
-                  if (m_propagationDelay)
-                    {
-                      delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
-                    }
+                  Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
+                  txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
+                  NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+                  pathLossDb -= txAntennaGain;
                 }
+              Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
+              if (rxAntenna != 0)
+                {
+                  Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
+                  rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+                  NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+                  pathLossDb -= rxAntennaGain;
+                }
+              if (m_propagationLoss)
+                {
+                  propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
+                  NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+                  pathLossDb -= propagationGainDb;
+                }
+              NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");
+              // Gain trace
+              m_gainTrace (txMobility, receiverMobility, txAntennaGain, rxAntennaGain, propagationGainDb, pathLossDb);
+              // Pathloss trace
+              m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
+              if (pathLossDb > m_maxLossDb)
+                {
+                  // beyond range
+                  ++m_cullingStats.culledByLoss;
+                  continue;
+                }
+              pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+            }
+
+          NS_LOG_LOGIC ("copying signal parameters " << txParams);
+          Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+          rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
 
-              Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
-              if (netDev)
+          if (txMobility && receiverMobility)
+            {
+              *(rxParams->psd) *= pathGainLinear;
+
+              if (m_spectrumPropagationLoss)
                 {
-                  // the receiver has a NetDevice, so we expect that it is attached to a Node
-                  uint32_t dstNode =  netDev->GetNode ()->GetId ();
-                  Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
-                                                  rxParams, *rxPhyIterator);
+                  rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
                 }
-              else
+
+              if (m_propagationDelay)
                 {
-                  // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
-                  Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
-                                       rxParams, *rxPhyIterator);
+                  delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
                 }
             }
+
+          ++m_cullingStats.scheduledRx;
+          Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
+          if (netDev)
+            {
+              // the receiver has a NetDevice, so we expect that it is attached to a Node
+              uint32_t dstNode =  netDev->GetNode ()->GetId ();
+              Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
+                                              rxParams, *rxPhyIterator);
+            }
+          else
+            {
+              // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
+              Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
+                                   rxParams, *rxPhyIterator);
+            }
         }
 
     }
@@ -355,6 +384,20 @@ MultiModelSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<Sp
   receiver->StartRx (params);
 }
 
+MultiModelSpectrumChannel::CullingStats
+MultiModelSpectrumChannel::GetCullingStats (void) const
+{
+  return m_cullingStats;
+}
+
+void
+MultiModelSpectrumChannel::ResetCullingStats (void)
+{
+  m_cullingStats.scheduledRx = 0;
+  m_cullingStats.culledByDistance = 0;
+  m_cullingStats.culledByLoss = 0;
+}
+
 std::size_t
 MultiModelSpectrumChannel::GetNDevices (void) const
 {
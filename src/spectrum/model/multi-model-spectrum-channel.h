@@ -124,6 +124,31 @@ public:
   virtual std::size_t GetNDevices (void) const;
   virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
 
+  /**
+   * \brief Counters of the receivers of the transmitted signals
+   *
+   * Each culled receiver saves a copy of the SpectrumSignalParameters, a
+   * copy of the PSD, the evaluation of the SpectrumPropagationLossModel and
+   * a reception event. The receivers culled by distance save the
+   * evaluation of the antenna gains and of the PropagationLossModel too.
+   */
+  struct CullingStats
+  {
+    uint64_t scheduledRx;      //!< Number of reception events scheduled
+    uint64_t culledByDistance; //!< Number of receivers beyond MaxCullingDistance
+    uint64_t culledByLoss;     //!< Number of receivers beyond MaxLossDb
+  };
+
+  /**
+   * \returns the counters of the receivers since the creation of the
+   *          channel, or the last call to ResetCullingStats
+   */
+  CullingStats GetCullingStats (void) const;
+  /**
+   * \brief Reset the counters of the receivers
+   */
+  void ResetCullingStats (void);
+
 
 protected:
   void DoDispose ();
@@ -169,6 +194,17 @@ private:
    */
   std::size_t m_numDevices;
 
+  /**
+   * Maximum distance between the transmitter and the receivers [m],
+   * zero to disable the culling by distance.
+   */
+  double m_maxCullingDistance;
+
+  /**
+   * Counters of the receivers.
+   */
+  CullingStats m_cullingStats;
+
 };
 
 
@@ -60,6 +60,12 @@ void SpectrumPropagationLossModel::SetNext (Ptr<SpectrumPropagationLossModel> ne
 }
 
 
+Ptr<SpectrumPropagationLossModel>
+SpectrumPropagationLossModel::GetNext (void) const
+{
+  return m_next;
+}
+
 Ptr<SpectrumValue>
 SpectrumPropagationLossModel::CalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
                                                           Ptr<const MobilityModel> a,
@@ -81,6 +81,11 @@ public:
 protected:
   virtual void DoDispose ();
 
+  /**
+   * \return the SpectrumPropagationLossModel chained to this one, if any
+   */
+  Ptr<SpectrumPropagationLossModel> GetNext (void) const;
+
 
 private:
   /**
@@ -22,13 +22,17 @@
 
 #include "three-gpp-channel-model.h"
 #include "ns3/log.h"
+#include "ns3/abort.h"
 #include "ns3/three-gpp-antenna-array-model.h"
 #include "ns3/node.h"
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/integer.h"
+#include "ns3/uinteger.h"
+#include "ns3/profiler.h"
 #include <algorithm>
 #include <random>
+#include <thread>
 #include "ns3/log.h"
 #include <ns3/simulator.h>
 #include "ns3/mobility-model.h"
@@ -161,14 +165,43 @@ static const double sqrtC_office_NLOS[6][6] = {
 };
 
 ThreeGppChannelModel::ThreeGppChannelModel ()
+  : m_parallelUpdate (false),
+    m_numThreads (0),
+    m_maxChannelPairs (0),
+    m_pairStreamBase (-1),
+    m_numPairStreams (0)
 {
   NS_LOG_FUNCTION (this);
-  m_uniformRv = CreateObject<UniformRandomVariable> ();
-  m_uniformRvShuffle = CreateObject<UniformRandomVariable> ();
+  m_rv = CreateChannelRandomVariables ();
+}
 
-  m_normalRv = CreateObject<NormalRandomVariable> ();
-  m_normalRv->SetAttribute ("Mean", DoubleValue (0.0));
-  m_normalRv->SetAttribute ("Variance", DoubleValue (1.0));
+ThreeGppChannelModel::ChannelRandomVariables
+ThreeGppChannelModel::CreateChannelRandomVariables (void)
+{
+  ChannelRandomVariables rv;
+  rv.m_uniformRv = CreateObject<UniformRandomVariable> ();
+  rv.m_uniformRvShuffle = CreateObject<UniformRandomVariable> ();
+
+  rv.m_normalRv = CreateObject<NormalRandomVariable> ();
+  rv.m_normalRv->SetAttribute ("Mean", DoubleValue (0.0));
+  rv.m_normalRv->SetAttribute ("Variance", DoubleValue (1.0));
+  return rv;
+}
+
+void
+ThreeGppChannelModel::AssignPairStreams (ChannelRandomVariables &rv)
+{
+  if (m_pairStreamBase < 0)
+    {
+      return;
+    }
+  NS_ABORT_MSG_IF (m_numPairStreams >= m_maxChannelPairs,
+                   "More than MaxChannelPairs (" << m_maxChannelPairs << ") pairs of nodes with fixed streams");
+  int64_t stream = m_pairStreamBase + 3 * m_numPairStreams;
+  rv.m_normalRv->SetStream (stream);
+  rv.m_uniformRv->SetStream (stream + 1);
+  rv.m_uniformRvShuffle->SetStream (stream + 2);
+  m_numPairStreams++;
 }
 
 ThreeGppChannelModel::~ThreeGppChannelModel ()
@@ -180,6 +213,9 @@ void
 ThreeGppChannelModel::DoDispose ()
 {
   m_channelMap.clear ();
+  m_channelPairs.clear ();
+  m_jobs.clear ();
+  m_threadPool = nullptr;
   m_channelConditionModel->Dispose ();
   m_channelConditionModel = nullptr;
 }
@@ -215,6 +251,24 @@ ThreeGppChannelModel::GetTypeId (void)
                    TimeValue (MilliSeconds (0)),
                    MakeTimeAccessor (&ThreeGppChannelModel::m_updatePeriod),
                    MakeTimeChecker ())
+    .AddAttribute ("ParallelUpdate",
+                   "If true, the channel matrices are updated at the multiples of UpdatePeriod, "
+                   "all at once and on NumThreads threads",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ThreeGppChannelModel::m_parallelUpdate),
+                   MakeBooleanChecker ())
+    .AddAttribute ("NumThreads",
+                   "The number of threads updating the channel matrices if ParallelUpdate is true "
+                   "(0 to use all the available cores)",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&ThreeGppChannelModel::m_numThreads),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MaxChannelPairs",
+                   "The number of pairs of nodes whose random variables take fixed streams "
+                   "reserved by AssignStreams if ParallelUpdate is true",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&ThreeGppChannelModel::m_maxChannelPairs),
+                   MakeUintegerChecker<uint32_t> ())
     // attributes for the blockage model
     .AddAttribute ("Blockage",
                    "Enable blockage model A (sec 7.6.4.1)",
@@ -958,7 +1012,7 @@ ThreeGppChannelModel::ChannelMatrixNeedsUpdate (Ptr<const ThreeGppChannelMatrix>
     }
 
   // if the coherence time is over the channel has to be updated
-  if (!m_updatePeriod.IsZero () && Simulator::Now () - channelMatrix->m_generatedTime > m_updatePeriod)
+  if (IsUpdatePeriodOver (channelMatrix))
     {
       NS_LOG_DEBUG ("Generation time " << channelMatrix->m_generatedTime.As (Time::NS) << " now " << Now ().As (Time::NS));
       update = true;
@@ -967,6 +1021,22 @@ ThreeGppChannelModel::ChannelMatrixNeedsUpdate (Ptr<const ThreeGppChannelMatrix>
   return update;
 }
 
+bool
+ThreeGppChannelModel::IsUpdatePeriodOver (Ptr<const ThreeGppChannelMatrix> channelMatrix) const
+{
+  if (m_updatePeriod.IsZero ())
+    {
+      return false;
+    }
+  if (m_parallelUpdate)
+    {
+      // the channel matrices are updated at the multiples of the update period
+      int64_t period = m_updatePeriod.GetTimeStep ();
+      return Simulator::Now ().GetTimeStep () / period > channelMatrix->m_generatedTime.GetTimeStep () / period;
+    }
+  return Simulator::Now () - channelMatrix->m_generatedTime > m_updatePeriod;
+}
+
 Ptr<const MatrixBasedChannelModel::ChannelMatrix>
 ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
                                   Ptr<const MobilityModel> bMob,
@@ -980,6 +1050,22 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
   uint32_t x2 = std::max (aMob->GetObject<Node> ()->GetId (), bMob->GetObject<Node> ()->GetId ());
   uint32_t channelId = GetKey (x1, x2);
 
+  // if the channel matrices are updated all at once, the first call after
+  // the end of the update period regenerates the channel matrices of all the
+  // pairs of nodes
+  const ChannelRandomVariables *rv = &m_rv;
+  if (m_parallelUpdate)
+    {
+      ChannelPair &pair = GetChannelPair (channelId, aMob, bMob, aAntenna, bAntenna);
+      auto it = m_channelMap.find (channelId);
+      if (it != m_channelMap.end () && IsUpdatePeriodOver (it->second))
+        {
+          UpdateChannels ();
+        }
+      pair.m_lastAccess = Simulator::Now ();
+      rv = &pair.m_rv;
+    }
+
   // retrieve the channel condition
   Ptr<const ChannelCondition> condition = m_channelConditionModel->GetChannelCondition (aMob, bMob);
 
@@ -1008,42 +1094,159 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
   if (notFound || update)
     {
       // channel matrix not found or has to be updated, generate a new one
-      Angles txAngle (bMob->GetPosition (), aMob->GetPosition ());
-      Angles rxAngle (aMob->GetPosition (), bMob->GetPosition ());
+      ChannelUpdateJob job = PrepareChannelUpdate (aMob, bMob, aAntenna, bAntenna, condition, *rv);
+      job.m_channelId = channelId;
+      RunChannelUpdate (job);
+      channelMatrix = job.m_channel;
 
-      double x = aMob->GetPosition ().x - bMob->GetPosition ().x;
-      double y = aMob->GetPosition ().y - bMob->GetPosition ().y;
-      double distance2D = sqrt (x * x + y * y);
+      // store or replace the channel matrix in the channel map
+      m_channelMap[channelId] = channelMatrix;
+    }
 
-      // NOTE we assume hUT = min (height(a), height(b)) and
-      // hBS = max (height (a), height (b))
-      double hUt = std::min (aMob->GetPosition ().z, bMob->GetPosition ().z);
-      double hBs = std::max (aMob->GetPosition ().z, bMob->GetPosition ().z);
+  return channelMatrix;
+}
 
-      // TODO this is not currently used, it is needed for the computation of the
-      // additional blockage in case of spatial consistent update
-      // I do not know who is the UT, I can use the relative distance between
-      // tx and rx instead
-      Vector locUt = Vector (0.0, 0.0, 0.0);
+ThreeGppChannelModel::ChannelPair &
+ThreeGppChannelModel::GetChannelPair (uint32_t channelId,
+                                      Ptr<const MobilityModel> aMob,
+                                      Ptr<const MobilityModel> bMob,
+                                      Ptr<const ThreeGppAntennaArrayModel> aAntenna,
+                                      Ptr<const ThreeGppAntennaArrayModel> bAntenna)
+{
+  auto it = m_channelPairs.find (channelId);
+  if (it == m_channelPairs.end ())
+    {
+      // the random variables of the pair take the next fixed streams if
+      // AssignStreams was called, the next automatic streams otherwise,
+      // hence they depend only on the order in which the pairs are first seen
+      NS_LOG_DEBUG ("new pair of nodes " << channelId);
+      it = m_channelPairs.emplace (channelId, ChannelPair ()).first;
+      it->second.m_rv = CreateChannelRandomVariables ();
+      AssignPairStreams (it->second.m_rv);
+    }
+  // the latest devices are used for the next update
+  ChannelPair &pair = it->second;
+  pair.m_aMob = aMob;
+  pair.m_bMob = bMob;
+  pair.m_aAntenna = aAntenna;
+  pair.m_bAntenna = bAntenna;
+  return pair;
+}
 
-      channelMatrix = GetNewChannel (locUt, condition, aAntenna, bAntenna, rxAngle, txAngle, distance2D, hBs, hUt);
-      channelMatrix->m_nodeIds = std::make_pair (aMob->GetObject<Node> ()->GetId (), bMob->GetObject<Node> ()->GetId ());
+ThreeGppChannelModel::ChannelUpdateJob
+ThreeGppChannelModel::PrepareChannelUpdate (Ptr<const MobilityModel> aMob,
+                                            Ptr<const MobilityModel> bMob,
+                                            Ptr<const ThreeGppAntennaArrayModel> aAntenna,
+                                            Ptr<const ThreeGppAntennaArrayModel> bAntenna,
+                                            Ptr<const ChannelCondition> condition,
+                                            const ChannelRandomVariables &rv) const
+{
+  ChannelUpdateJob job;
+  job.m_channelId = 0;
+  job.m_condition = condition;
+  job.m_aAntenna = aAntenna;
+  job.m_bAntenna = bAntenna;
+  job.m_rv = &rv;
+  job.m_nodeIds = std::make_pair (aMob->GetObject<Node> ()->GetId (), bMob->GetObject<Node> ()->GetId ());
+  job.m_txAngle = Angles (bMob->GetPosition (), aMob->GetPosition ());
+  job.m_rxAngle = Angles (aMob->GetPosition (), bMob->GetPosition ());
+
+  double x = aMob->GetPosition ().x - bMob->GetPosition ().x;
+  double y = aMob->GetPosition ().y - bMob->GetPosition ().y;
+  job.m_distance2D = sqrt (x * x + y * y);
+
+  // NOTE we assume hUT = min (height(a), height(b)) and
+  // hBS = max (height (a), height (b))
+  job.m_hUt = std::min (aMob->GetPosition ().z, bMob->GetPosition ().z);
+  job.m_hBs = std::max (aMob->GetPosition ().z, bMob->GetPosition ().z);
+  return job;
+}
 
-      // store or replace the channel matrix in the channel map
-      m_channelMap[channelId] = channelMatrix;
+void
+ThreeGppChannelModel::RunChannelUpdate (ChannelUpdateJob &job) const
+{
+  // TODO this is not currently used, it is needed for the computation of the
+  // additional blockage in case of spatial consistent update
+  // I do not know who is the UT, I can use the relative distance between
+  // tx and rx instead
+  Vector locUt = Vector (0.0, 0.0, 0.0);
+
+  job.m_channel = GetNewChannel (locUt, job.m_condition, job.m_aAntenna, job.m_bAntenna,
+                                 job.m_rxAngle, job.m_txAngle, job.m_distance2D,
+                                 job.m_hBs, job.m_hUt, *job.m_rv);
+  job.m_channel->m_nodeIds = job.m_nodeIds;
+}
+
+void
+ThreeGppChannelModel::RunChannelUpdateJob (uint32_t index)
+{
+  RunChannelUpdate (m_jobs[index]);
+}
+
+void
+ThreeGppChannelModel::UpdateChannels (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_PROFILE_SCOPE ("ThreeGppChannelModel::UpdateChannels");
+
+  // update the pairs which were used in the previous period, the other ones
+  // are updated when they are used again
+  int64_t period = m_updatePeriod.GetTimeStep ();
+  int64_t previousPeriodStart = (Simulator::Now ().GetTimeStep () / period - 1) * period;
+
+  // the geometry and the channel conditions are computed by this thread, in
+  // the order of the channel keys
+  m_jobs.clear ();
+  for (auto &it : m_channelPairs)
+    {
+      ChannelPair &pair = it.second;
+      auto channelIt = m_channelMap.find (it.first);
+      if (channelIt == m_channelMap.end ()
+          || !IsUpdatePeriodOver (channelIt->second)
+          || pair.m_lastAccess.GetTimeStep () < previousPeriodStart)
+        {
+          continue;
+        }
+
+      // each job owns a copy of the channel condition, since the reference
+      // count of the shared instance cannot be updated by several threads
+      Ptr<const ChannelCondition> condition = m_channelConditionModel->GetChannelCondition (pair.m_aMob, pair.m_bMob);
+      Ptr<ChannelCondition> conditionCopy = CreateObject<ChannelCondition> (condition->GetLosCondition (),
+                                                                             condition->GetO2iCondition ());
+      m_jobs.push_back (PrepareChannelUpdate (pair.m_aMob, pair.m_bMob, pair.m_aAntenna, pair.m_bAntenna,
+                                              conditionCopy, pair.m_rv));
+      m_jobs.back ().m_channelId = it.first;
     }
+  NS_LOG_DEBUG ("Update " << m_jobs.size () << " channel matrices");
 
-  return channelMatrix;
+  if (!m_threadPool)
+    {
+      uint32_t numThreads = m_numThreads;
+      if (numThreads == 0)
+        {
+          numThreads = std::max (std::thread::hardware_concurrency (), 1U);
+        }
+      m_threadPool = Create<ChannelUpdateThreadPool> (numThreads);
+    }
+  m_threadPool->Run (m_jobs.size (), MakeCallback (&ThreeGppChannelModel::RunChannelUpdateJob, this));
+
+  for (ChannelUpdateJob &job : m_jobs)
+    {
+      m_channelMap[job.m_channelId] = job.m_channel;
+    }
+  m_jobs.clear ();
 }
 
 Ptr<ThreeGppChannelModel::ThreeGppChannelMatrix>
 ThreeGppChannelModel::GetNewChannel (Vector locUT, Ptr<const ChannelCondition> channelCondition,
-                                     Ptr<const ThreeGppAntennaArrayModel> sAntenna,
-                                     Ptr<const ThreeGppAntennaArrayModel> uAntenna,
+                                     const Ptr<const ThreeGppAntennaArrayModel> &sAntenna,
+                                     const Ptr<const ThreeGppAntennaArrayModel> &uAntenna,
                                      Angles &uAngle, Angles &sAngle,
-                                     double dis2D, double hBS, double hUT) const
+                                     double dis2D, double hBS, double hUT,
+                                     const ChannelRandomVariables &rv) const
 {
   NS_LOG_FUNCTION (this);
+  NS_PROFILE_SCOPE ("ThreeGppChannelModel::GetNewChannel");
 
   NS_ASSERT_MSG (m_frequency > 0.0, "Set the operating frequency first!");
 
@@ -1079,7 +1282,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, Ptr<const ChannelCondition> c
   //Generate paramNum independent LSPs.
   for (uint8_t iter = 0; iter < paramNum; iter++)
     {
-      LSPsIndep.push_back (m_normalRv->GetValue ());
+      LSPsIndep.push_back (rv.m_normalRv->GetValue ());
     }
   for (uint8_t row = 0; row < paramNum; row++)
     {
@@ -1127,7 +1330,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, Ptr<const ChannelCondition> c
   double minTau = 100.0;
   for (uint8_t cIndex = 0; cIndex < numOfCluster; cIndex++)
     {
-      double tau = -1 * table3gpp->m_rTau * DS * log (m_uniformRv->GetValue (0,1)); //(7.5-1)
+      double tau = -1 * table3gpp->m_rTau * DS * log (rv.m_uniformRv->GetValue (0,1)); //(7.5-1)
       if (minTau > tau)
         {
           minTau = tau;
@@ -1150,7 +1353,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, Ptr<const ChannelCondition> c
   for (uint8_t cIndex = 0; cIndex < numOfCluster; cIndex++)
     {
       double power = exp (-1 * clusterDelay[cIndex] * (table3gpp->m_rTau - 1) / table3gpp->m_rTau / DS) *
-        pow (10,-1 * m_normalRv->GetValue () * table3gpp->m_perClusterShadowingStd / 10);                       //(7.5-5)
+        pow (10,-1 * rv.m_normalRv->GetValue () * table3gpp->m_perClusterShadowingStd / 10);                       //(7.5-5)
       powerSum += power;
       clusterPower.push_back (power);
     }
@@ -1329,21 +1532,21 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, Ptr<const ChannelCondition> c
   for (uint8_t cIndex = 0; cIndex < numReducedCluster; cIndex++)
     {
       int Xn = 1;
-      if (m_uniformRv->GetValue (0,1) < 0.5)
+      if (rv.m_uniformRv->GetValue (0,1) < 0.5)
         {
           Xn = -1;
         }
-      clusterAoa[cIndex] = clusterAoa[cIndex] * Xn + (m_normalRv->GetValue () * ASA / 7) + uAngle.phi * 180 / M_PI;        //(7.5-11)
-      clusterAod[cIndex] = clusterAod[cIndex] * Xn + (m_normalRv->GetValue () * ASD / 7) + sAngle.phi * 180 / M_PI;
+      clusterAoa[cIndex] = clusterAoa[cIndex] * Xn + (rv.m_normalRv->GetValue () * ASA / 7) + uAngle.phi * 180 / M_PI;        //(7.5-11)
+      clusterAod[cIndex] = clusterAod[cIndex] * Xn + (rv.m_normalRv->GetValue () * ASD / 7) + sAngle.phi * 180 / M_PI;
       if (o2i)
         {
-          clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (m_normalRv->GetValue () * ZSA / 7) + 90;            //(7.5-16)
+          clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (rv.m_normalRv->GetValue () * ZSA / 7) + 90;            //(7.5-16)
         }
       else
         {
-          clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (m_normalRv->GetValue () * ZSA / 7) + uAngle.theta * 180 / M_PI;            //(7.5-16)
+          clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (rv.m_normalRv->GetValue () * ZSA / 7) + uAngle.theta * 180 / M_PI;            //(7.5-16)
         }
-      clusterZod[cIndex] = clusterZod[cIndex] * Xn + (m_normalRv->GetValue () * ZSD / 7) + sAngle.theta * 180 / M_PI + table3gpp->m_offsetZOD;        //(7.5-19)
+      clusterZod[cIndex] = clusterZod[cIndex] * Xn + (rv.m_normalRv->GetValue () * ZSD / 7) + sAngle.theta * 180 / M_PI + table3gpp->m_offsetZOD;        //(7.5-19)
 
     }
 
@@ -1505,7 +1708,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, Ptr<const ChannelCondition> c
   DoubleVector attenuation_dB;
   if (m_blockage)
     {
-      attenuation_dB = CalcAttenuationOfBlockage (channelParams, clusterAoa, clusterZoa);
+      attenuation_dB = CalcAttenuationOfBlockage (channelParams, clusterAoa, clusterZoa, rv);
       for (uint8_t cInd = 0; cInd < numReducedCluster; cInd++)
         {
           clusterPower[cInd] = clusterPower[cInd] / pow (10,attenuation_dB[cInd] / 10);
@@ -1520,10 +1723,10 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, Ptr<const ChannelCondition> c
   //shuffle all the arrays to perform random coupling
   for (uint8_t cIndex = 0; cIndex < numReducedCluster; cIndex++)
     {
-      Shuffle (&rayAod_radian[cIndex][0], &rayAod_radian[cIndex][raysPerCluster]);
-      Shuffle (&rayAoa_radian[cIndex][0], &rayAoa_radian[cIndex][raysPerCluster]);
-      Shuffle (&rayZod_radian[cIndex][0], &rayZod_radian[cIndex][raysPerCluster]);
-      Shuffle (&rayZoa_radian[cIndex][0], &rayZoa_radian[cIndex][raysPerCluster]);
+      Shuffle (&rayAod_radian[cIndex][0], &rayAod_radian[cIndex][raysPerCluster], rv.m_uniformRvShuffle);
+      Shuffle (&rayAoa_radian[cIndex][0], &rayAoa_radian[cIndex][raysPerCluster], rv.m_uniformRvShuffle);
+      Shuffle (&rayZod_radian[cIndex][0], &rayZod_radian[cIndex][raysPerCluster], rv.m_uniformRvShuffle);
+      Shuffle (&rayZoa_radian[cIndex][0], &rayZoa_radian[cIndex][raysPerCluster], rv.m_uniformRvShuffle);
     }
 
   //Step 9: Generate the cross polarization power ratios
@@ -1539,11 +1742,11 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, Ptr<const ChannelCondition> c
           double uXprLinear = pow (10, table3gpp->m_uXpr / 10); // convert to linear
           double sigXprLinear = pow (10, table3gpp->m_sigXpr / 10); // convert to linear
 
-          temp.push_back (std::pow (10, (m_normalRv->GetValue () * sigXprLinear + uXprLinear) / 10));
+          temp.push_back (std::pow (10, (rv.m_normalRv->GetValue () * sigXprLinear + uXprLinear) / 10));
           DoubleVector temp3; // used to store the PHI valuse
           for (uint8_t pInd = 0; pInd < 4; pInd++)
             {
-              temp3.push_back (m_uniformRv->GetValue (-1 * M_PI, M_PI));
+              temp3.push_back (rv.m_uniformRv->GetValue (-1 * M_PI, M_PI));
             }
           temp2.push_back (temp3);
         }
@@ -1582,19 +1785,15 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, Ptr<const ChannelCondition> c
 
   NS_LOG_INFO ("1st strongest cluster:" << (int)cluster1st << ", 2nd strongest cluster:" << (int)cluster2nd);
 
-  Complex3DVector H_usn;  //channel coffecient H_usn[u][s][n];
   // NOTE Since each of the strongest 2 clusters are divided into 3 sub-clusters,
   // the total cluster will be numReducedCLuster + 4.
-
-  H_usn.resize (uSize);
-  for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
-    {
-      H_usn[uIndex].resize (sSize);
-      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
-        {
-          H_usn[uIndex][sIndex].resize (numReducedCluster);
-        }
-    }
+  // The coefficients are written directly in the channel matrix H_usn[u][s][n],
+  // the sub-clusters of the strongest clusters are stored after the
+  // numReducedCluster clusters, in the order of the cluster index.
+  uint8_t numSubClusters = (cluster1st == cluster2nd) ? 2 : 4;
+  uint8_t numTotClusters = numReducedCluster + numSubClusters;
+  ChannelTensor &H_usn = channelParams->m_channel;
+  H_usn.Resize (uSize, sSize, numTotClusters);
 
   // The following for loops computes the channel coefficients
   for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
@@ -1638,7 +1837,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, Ptr<const ChannelCondition> c
                         * exp (std::complex<double> (0, txPhaseDiff));
                     }
                   rays *= sqrt (clusterPower[nIndex] / raysPerCluster);
-                  H_usn[uIndex][sIndex][nIndex] = rays;
+                  H_usn (uIndex, sIndex, nIndex) = rays;
                 }
               else  //(7.5-28)
                 {
@@ -1703,9 +1902,10 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, Ptr<const ChannelCondition> c
                   raysSub1 *= sqrt (clusterPower[nIndex] / raysPerCluster);
                   raysSub2 *= sqrt (clusterPower[nIndex] / raysPerCluster);
                   raysSub3 *= sqrt (clusterPower[nIndex] / raysPerCluster);
-                  H_usn[uIndex][sIndex][nIndex] = raysSub1;
-                  H_usn[uIndex][sIndex].push_back (raysSub2);
-                  H_usn[uIndex][sIndex].push_back (raysSub3);
+                  uint8_t subIndex = numReducedCluster + ((nIndex == std::min (cluster1st, cluster2nd)) ? 0 : 2);
+                  H_usn (uIndex, sIndex, nIndex) = raysSub1;
+                  H_usn (uIndex, sIndex, subIndex) = raysSub2;
+                  H_usn (uIndex, sIndex, subIndex + 1) = raysSub3;
 
                 }
             }
@@ -1732,11 +1932,10 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, Ptr<const ChannelCondition> c
 
               double K_linear = pow (10,K_factor / 10);
               // the LOS path should be attenuated if blockage is enabled.
-              H_usn[uIndex][sIndex][0] = sqrt (1 / (K_linear + 1)) * H_usn[uIndex][sIndex][0] + sqrt (K_linear / (1 + K_linear)) * ray / pow (10,attenuation_dB[0] / 10);           //(7.5-30) for tau = tau1
-              double tempSize = H_usn[uIndex][sIndex].size ();
-              for (uint8_t nIndex = 1; nIndex < tempSize; nIndex++)
+              H_usn (uIndex, sIndex, 0) = sqrt (1 / (K_linear + 1)) * H_usn (uIndex, sIndex, 0) + sqrt (K_linear / (1 + K_linear)) * ray / pow (10,attenuation_dB[0] / 10);           //(7.5-30) for tau = tau1
+              for (uint8_t nIndex = 1; nIndex < numTotClusters; nIndex++)
                 {
-                  H_usn[uIndex][sIndex][nIndex] *= sqrt (1 / (K_linear + 1)); //(7.5-30) for tau = tau2...taunN
+                  H_usn (uIndex, sIndex, nIndex) *= sqrt (1 / (K_linear + 1)); //(7.5-30) for tau = tau2...taunN
                 }
 
             }
@@ -1802,16 +2001,16 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, Ptr<const ChannelCondition> c
 
     }
 
-  NS_LOG_INFO ("size of coefficient matrix =[" << H_usn.size () << "][" << H_usn[0].size () << "][" << H_usn[0][0].size () << "]");
+  NS_LOG_INFO ("size of coefficient matrix =[" << H_usn.GetNumRows () << "][" << H_usn.GetNumCols () << "][" << H_usn.GetNumClusters () << "]");
 
-  channelParams->m_channel = H_usn;
   channelParams->m_delay = clusterDelay;
 
-  channelParams->m_angle.clear ();
-  channelParams->m_angle.push_back (clusterAoa);
-  channelParams->m_angle.push_back (clusterZoa);
-  channelParams->m_angle.push_back (clusterAod);
-  channelParams->m_angle.push_back (clusterZod);
+  NS_ASSERT (clusterDelay.size () == numTotClusters && clusterAoa.size () == numTotClusters);
+  channelParams->m_angle.Resize (4, numTotClusters);
+  std::copy (clusterAoa.begin (), clusterAoa.end (), channelParams->m_angle.GetRow (AOA_INDEX));
+  std::copy (clusterZoa.begin (), clusterZoa.end (), channelParams->m_angle.GetRow (ZOA_INDEX));
+  std::copy (clusterAod.begin (), clusterAod.end (), channelParams->m_angle.GetRow (AOD_INDEX));
+  std::copy (clusterZod.begin (), clusterZod.end (), channelParams->m_angle.GetRow (ZOD_INDEX));
 
   return channelParams;
 }
@@ -1819,7 +2018,8 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, Ptr<const ChannelCondition> c
 MatrixBasedChannelModel::DoubleVector
 ThreeGppChannelModel::CalcAttenuationOfBlockage (Ptr<ThreeGppChannelModel::ThreeGppChannelMatrix> params,
                                                  const DoubleVector &clusterAOA,
-                                                 const DoubleVector &clusterZOA) const
+                                                 const DoubleVector &clusterZOA,
+                                                 const ChannelRandomVariables &rv) const
 {
   NS_LOG_FUNCTION (this);
 
@@ -1857,17 +2057,17 @@ ThreeGppChannelModel::CalcAttenuationOfBlockage (Ptr<ThreeGppChannelModel::Three
         {
           //draw value from table 7.6.4.1-2 Blocking region parameters
           DoubleVector table;
-          table.push_back (m_normalRv->GetValue ()); //phi_k: store the normal RV that will be mapped to uniform (0,360) later.
+          table.push_back (rv.m_normalRv->GetValue ()); //phi_k: store the normal RV that will be mapped to uniform (0,360) later.
           if (m_scenario == "InH-OfficeMixed" || m_scenario == "InH-OfficeOpen")
             {
-              table.push_back (m_uniformRv->GetValue (15, 45)); //x_k
+              table.push_back (rv.m_uniformRv->GetValue (15, 45)); //x_k
               table.push_back (90);  //Theta_k
-              table.push_back (m_uniformRv->GetValue (5, 15)); //y_k
+              table.push_back (rv.m_uniformRv->GetValue (5, 15)); //y_k
               table.push_back (2);  //r
             }
           else
             {
-              table.push_back (m_uniformRv->GetValue (5, 15)); //x_k
+              table.push_back (rv.m_uniformRv->GetValue (5, 15)); //x_k
               table.push_back (90);  //Theta_k
               table.push_back (5);  //y_k
               table.push_back (10);  //r
@@ -1930,7 +2130,7 @@ ThreeGppChannelModel::CalcAttenuationOfBlockage (Ptr<ThreeGppChannelModel::Three
 
               //Generate a new correlated normal RV with the following formula
               params->m_nonSelfBlocking[blockInd][PHI_INDEX] =
-                R * params->m_nonSelfBlocking[blockInd][PHI_INDEX] + sqrt (1 - R * R) * m_normalRv->GetValue ();
+                R * params->m_nonSelfBlocking[blockInd][PHI_INDEX] + sqrt (1 - R * R) * rv.m_normalRv->GetValue ();
             }
         }
 
@@ -2038,11 +2238,11 @@ ThreeGppChannelModel::CalcAttenuationOfBlockage (Ptr<ThreeGppChannelModel::Three
 
 
 void
-ThreeGppChannelModel::Shuffle (double * first, double * last) const
+ThreeGppChannelModel::Shuffle (double * first, double * last, const Ptr<UniformRandomVariable> &uniformRvShuffle) const
 {
   for (auto i = (last - first) - 1; i > 0; --i)
     {
-      std::swap (first[i], first[m_uniformRvShuffle->GetInteger (0, i)]);
+      std::swap (first[i], first[uniformRvShuffle->GetInteger (0, i)]);
     }
 }
 
@@ -2050,10 +2250,22 @@ int64_t
 ThreeGppChannelModel::AssignStreams (int64_t stream)
 {
   NS_LOG_FUNCTION (this << stream);
-  m_normalRv->SetStream (stream);
-  m_uniformRv->SetStream (stream + 1);
-  m_uniformRvShuffle->SetStream (stream + 2);
-  return 3;
+  m_rv.m_normalRv->SetStream (stream);
+  m_rv.m_uniformRv->SetStream (stream + 1);
+  m_rv.m_uniformRvShuffle->SetStream (stream + 2);
+  if (!m_parallelUpdate)
+    {
+      return 3;
+    }
+
+  // the pairs already seen take the first reserved streams
+  m_pairStreamBase = stream + 3;
+  m_numPairStreams = 0;
+  for (auto &pair : m_channelPairs)
+    {
+      AssignPairStreams (pair.second.m_rv);
+    }
+  return 3 + 3 * static_cast<int64_t> (m_maxChannelPairs);
 }
 
 }  // namespace ns3
@@ -29,8 +29,11 @@
 #include <ns3/random-variable-stream.h>
 #include <ns3/boolean.h>
 #include <unordered_map>
+#include <map>
+#include <vector>
 #include <ns3/channel-condition-model.h>
 #include <ns3/matrix-based-channel-model.h>
+#include <ns3/channel-update-thread-pool.h>
 
 namespace ns3 {
 
@@ -43,6 +46,18 @@ class MobilityModel;
  * The class implements the channel matrix generation procedure
  * described in 3GPP TR 38.901.
  *
+ * If the attribute ParallelUpdate is true, the channel matrices are updated
+ * at the multiples of UpdatePeriod, rather than UpdatePeriod after their
+ * generation. The first call to GetChannel after each multiple regenerates
+ * at once, on NumThreads threads, the channel matrices of all the pairs of
+ * nodes for which GetChannel was called in the previous period. Each pair of
+ * nodes uses its own random variables, created when the pair is first
+ * seen, so that the channel realizations do not depend on the number of
+ * threads or on the order in which the matrices are generated. If
+ * AssignStreams is called, the pairs take the fixed streams that follow
+ * those of the model, three per pair in the order in which the pairs are
+ * first seen, up to MaxChannelPairs pairs.
+ *
  * \see GetChannel
  */
 class ThreeGppChannelModel : public MatrixBasedChannelModel
@@ -123,6 +138,10 @@ public:
    * \brief Assign a fixed random variable stream number to the random variables
    * used by this model.
    *
+   * If ParallelUpdate is true, the streams of MaxChannelPairs pairs of
+   * nodes are reserved too, hence ParallelUpdate and MaxChannelPairs must be
+   * set before calling this method.
+   *
    * \param stream first stream index to use
    * \return the number of stream indices assigned by this model
    */
@@ -133,8 +152,34 @@ private:
    * \brief Shuffle the elements of a simple sequence container of type double
    * \param first Pointer to the first element among the elements to be shuffled
    * \param last Pointer to the last element among the elements to be shuffled
+   * \param uniformRvShuffle the random variable used to shuffle the elements
+   */
+  void Shuffle (double * first, double * last, const Ptr<UniformRandomVariable> &uniformRvShuffle) const;
+
+  /**
+   * The random variables used to generate a channel realization
+   */
+  struct ChannelRandomVariables
+  {
+    Ptr<UniformRandomVariable> m_uniformRv; //!< uniform random variable
+    Ptr<NormalRandomVariable> m_normalRv; //!< normal random variable
+    Ptr<UniformRandomVariable> m_uniformRvShuffle; //!< uniform random variable used to shuffle arrays
+  };
+
+  /**
+   * Create the random variables used to generate a channel realization. The
+   * random variables use the next automatic streams.
+   * \return the random variables
+   */
+  static ChannelRandomVariables CreateChannelRandomVariables (void);
+
+  /**
+   * Assign the next fixed streams reserved by AssignStreams, if it was
+   * called, to the random variables of a pair of nodes
+   * \param rv the random variables of the pair
    */
-  void Shuffle (double * first, double * last) const;
+  void AssignPairStreams (ChannelRandomVariables &rv);
+
   /**
    * Extends the struct ChannelMatrix by including information that are used 
    * within the class ThreeGppChannelModel
@@ -214,24 +259,28 @@ private:
    * \param dis2D the 2D distance between tx and rx
    * \param hBS the height of the BS
    * \param hUT the height of the UT
+   * \param rv the random variables used to generate the channel
    * \return the channel realization
    */
   Ptr<ThreeGppChannelMatrix> GetNewChannel (Vector locUT, Ptr<const ChannelCondition> channelCondition,
-                                            Ptr<const ThreeGppAntennaArrayModel> sAntenna,
-                                            Ptr<const ThreeGppAntennaArrayModel> uAntenna,
+                                            const Ptr<const ThreeGppAntennaArrayModel> &sAntenna,
+                                            const Ptr<const ThreeGppAntennaArrayModel> &uAntenna,
                                             Angles &uAngle, Angles &sAngle,
-                                            double dis2D, double hBS, double hUT) const;
+                                            double dis2D, double hBS, double hUT,
+                                            const ChannelRandomVariables &rv) const;
 
   /**
    * Applies the blockage model A described in 3GPP TR 38.901
    * \param params the channel matrix
    * \param clusterAOA vector containing the azimuth angle of arrival for each cluster
    * \param clusterZOA vector containing the zenith angle of arrival for each cluster
+   * \param rv the random variables used to generate the channel
    * \return vector containing the power attenuation for each cluster
    */
   DoubleVector CalcAttenuationOfBlockage (Ptr<ThreeGppChannelMatrix> params,
                                           const DoubleVector &clusterAOA,
-                                          const DoubleVector &clusterZOA) const;
+                                          const DoubleVector &clusterZOA,
+                                          const ChannelRandomVariables &rv) const;
 
   /**
    * Check if the channel matrix has to be updated
@@ -241,14 +290,114 @@ private:
    */
   bool ChannelMatrixNeedsUpdate (Ptr<const ThreeGppChannelMatrix> channelMatrix, Ptr<const ChannelCondition> channelCondition) const;
 
+  /**
+   * Check if the update period of the channel matrix is over
+   * \param channelMatrix channel matrix
+   * \return true if the channel matrix has to be updated
+   */
+  bool IsUpdatePeriodOver (Ptr<const ThreeGppChannelMatrix> channelMatrix) const;
+
+  /**
+   * The devices of a pair of nodes and their random variables, used if
+   * ParallelUpdate is true
+   */
+  struct ChannelPair
+  {
+    Ptr<const MobilityModel> m_aMob; //!< mobility model of the a device
+    Ptr<const MobilityModel> m_bMob; //!< mobility model of the b device
+    Ptr<const ThreeGppAntennaArrayModel> m_aAntenna; //!< antenna of the a device
+    Ptr<const ThreeGppAntennaArrayModel> m_bAntenna; //!< antenna of the b device
+    ChannelRandomVariables m_rv; //!< the random variables of the pair
+    Time m_lastAccess; //!< the last time the channel was requested
+  };
+
+  /**
+   * The inputs and the output of the generation of a channel matrix
+   */
+  struct ChannelUpdateJob
+  {
+    uint32_t m_channelId; //!< the channel key
+    Ptr<const ChannelCondition> m_condition; //!< the channel condition
+    Ptr<const ThreeGppAntennaArrayModel> m_aAntenna; //!< antenna of the a device
+    Ptr<const ThreeGppAntennaArrayModel> m_bAntenna; //!< antenna of the b device
+    const ChannelRandomVariables *m_rv; //!< the random variables used to generate the channel
+    std::pair<uint32_t, uint32_t> m_nodeIds; //!< the IDs of the a and b nodes
+    Angles m_txAngle; //!< the angle of the a device as seen by the b device
+    Angles m_rxAngle; //!< the angle of the b device as seen by the a device
+    double m_distance2D; //!< the 2D distance between the devices
+    double m_hBs; //!< the height of the BS
+    double m_hUt; //!< the height of the UT
+    Ptr<ThreeGppChannelMatrix> m_channel; //!< the generated channel matrix
+  };
+
+  /**
+   * Compute the geometry of the pair of devices needed to generate a
+   * channel matrix
+   * \param aMob mobility model of the a device
+   * \param bMob mobility model of the b device
+   * \param aAntenna antenna of the a device
+   * \param bAntenna antenna of the b device
+   * \param condition the channel condition
+   * \param rv the random variables used to generate the channel
+   * \return the job generating the channel matrix
+   */
+  ChannelUpdateJob PrepareChannelUpdate (Ptr<const MobilityModel> aMob,
+                                         Ptr<const MobilityModel> bMob,
+                                         Ptr<const ThreeGppAntennaArrayModel> aAntenna,
+                                         Ptr<const ThreeGppAntennaArrayModel> bAntenna,
+                                         Ptr<const ChannelCondition> condition,
+                                         const ChannelRandomVariables &rv) const;
+
+  /**
+   * Generate the channel matrix of a job. It does not modify the state of
+   * the model, and can be called by the threads of the pool.
+   * \param job the job
+   */
+  void RunChannelUpdate (ChannelUpdateJob &job) const;
+
+  /**
+   * Generate the channel matrix of the job with the given index in m_jobs
+   * \param index the index of the job
+   */
+  void RunChannelUpdateJob (uint32_t index);
+
+  /**
+   * Get the pair of nodes of a channel, creating it and its random
+   * variables if needed
+   * \param channelId the channel key
+   * \param aMob mobility model of the a device
+   * \param bMob mobility model of the b device
+   * \param aAntenna antenna of the a device
+   * \param bAntenna antenna of the b device
+   * \return the pair of nodes
+   */
+  ChannelPair & GetChannelPair (uint32_t channelId,
+                                Ptr<const MobilityModel> aMob,
+                                Ptr<const MobilityModel> bMob,
+                                Ptr<const ThreeGppAntennaArrayModel> aAntenna,
+                                Ptr<const ThreeGppAntennaArrayModel> bAntenna);
+
+  /**
+   * Regenerate, on the thread pool, the channel matrices whose update period
+   * is over and which were requested in the previous update period
+   */
+  void UpdateChannels (void);
+
   std::unordered_map<uint32_t, Ptr<ThreeGppChannelMatrix> > m_channelMap; //!< map containing the channel realizations
   Time m_updatePeriod; //!< the channel update period
   double m_frequency; //!< the operating frequency
   std::string m_scenario; //!< the 3GPP scenario
   Ptr<ChannelConditionModel> m_channelConditionModel; //!< the channel condition model
-  Ptr<UniformRandomVariable> m_uniformRv; //!< uniform random variable
-  Ptr<NormalRandomVariable> m_normalRv; //!< normal random variable
-  Ptr<UniformRandomVariable> m_uniformRvShuffle; //!< uniform random variable used to shuffle array in GetNewChannel
+  ChannelRandomVariables m_rv; //!< the random variables used if ParallelUpdate is false
+
+  bool m_parallelUpdate; //!< if true, update the channel matrices at once at the multiples of m_updatePeriod
+  uint32_t m_numThreads; //!< the number of threads used to update the channel matrices
+  uint32_t m_maxChannelPairs; //!< the number of pairs of nodes whose streams are reserved by AssignStreams
+  int64_t m_pairStreamBase; //!< the first stream of the pairs of nodes, -1 if AssignStreams was not called
+  uint32_t m_numPairStreams; //!< the number of pairs of nodes which took fixed streams
+  std::map<uint32_t, ChannelPair> m_channelPairs; //!< the pairs of nodes, ordered by channel key
+  std::vector<ChannelUpdateJob> m_jobs; //!< the jobs of the current update
+  Ptr<ChannelUpdateThreadPool> m_threadPool; //!< the threads updating the channel matrices
 
   // parameters for the blockage model
   bool m_blockage; //!< enables the blockage model A
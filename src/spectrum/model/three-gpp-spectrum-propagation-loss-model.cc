@@ -39,6 +39,7 @@ NS_LOG_COMPONENT_DEFINE ("ThreeGppSpectrumPropagationLossModel");
 NS_OBJECT_ENSURE_REGISTERED (ThreeGppSpectrumPropagationLossModel);
 
 ThreeGppSpectrumPropagationLossModel::ThreeGppSpectrumPropagationLossModel ()
+  : m_numLongTermUpdates (0)
 {
   NS_LOG_FUNCTION (this);
   m_uniformRv = CreateObject<UniformRandomVariable> ();
@@ -54,6 +55,7 @@ ThreeGppSpectrumPropagationLossModel::DoDispose ()
 {
   m_deviceAntennaMap.clear ();
   m_longTermMap.clear ();
+  m_beamLongTermMap.clear ();
   m_channelModel->Dispose ();
   m_channelModel = nullptr;
 }
@@ -134,45 +136,100 @@ ThreeGppSpectrumPropagationLossModel::CalcLongTerm (Ptr<const MatrixBasedChannel
   NS_LOG_DEBUG ("CalcLongTerm with sAntenna " << sAntenna << " uAntenna " << uAntenna);
   //store the long term part to reduce computation load
   //only the small scale fading needs to be updated if the large scale parameters and antenna weights remain unchanged.
+  uint8_t numCluster = static_cast<uint8_t> (params->m_channel.GetNumClusters ());
   ThreeGppAntennaArrayModel::ComplexVector longTerm;
-  uint8_t numCluster = static_cast<uint8_t> (params->m_channel[0][0].size ());
+  longTerm.reserve (numCluster);
 
+  // the beamforming vectors are empty until the devices set them, in which
+  // case the long term component is zero
+  NS_ASSERT (numCluster == 0 || sAntenna == 0 || uAntenna == 0
+             || (params->m_channel.GetNumRows () == uAntenna && params->m_channel.GetNumCols () == sAntenna));
   for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
+      // the matrix of each cluster is contiguous, with the rx elements first
+      const std::complex<double> *h = params->m_channel.GetCluster (cIndex);
       std::complex<double> txSum (0,0);
       for (uint16_t sIndex = 0; sIndex < sAntenna; sIndex++)
         {
           std::complex<double> rxSum (0,0);
           for (uint16_t uIndex = 0; uIndex < uAntenna; uIndex++)
             {
-              rxSum = rxSum + uW[uIndex] * params->m_channel[uIndex][sIndex][cIndex];
+              rxSum = rxSum + uW[uIndex] * h[uIndex];
             }
           txSum = txSum + sW[sIndex] * rxSum;
+          h += uAntenna;
         }
       longTerm.push_back (txSum);
     }
   return longTerm;
 }
 
+void
+ThreeGppSpectrumPropagationLossModel::CalcDopplerTerms (Ptr<LongTerm> longTerm) const
+{
+  NS_LOG_FUNCTION (this);
+
+  //cluster angle angle[direction][n], where direction = 0(aoa), 1(zoa), 2(aod), 3(zod).
+  const MatrixBasedChannelModel::ClusterAngles &angle = longTerm->m_channel->m_angle;
+  uint8_t numCluster = static_cast<uint8_t> (longTerm->m_channel->m_channel.GetNumClusters ());
+
+  longTerm->m_sDoppler.resize (numCluster);
+  longTerm->m_uDoppler.resize (numCluster);
+  for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
+    {
+      double zoa = angle[MatrixBasedChannelModel::ZOA_INDEX][cIndex] * M_PI / 180;
+      double aoa = angle[MatrixBasedChannelModel::AOA_INDEX][cIndex] * M_PI / 180;
+      double zod = angle[MatrixBasedChannelModel::ZOD_INDEX][cIndex] * M_PI / 180;
+      double aod = angle[MatrixBasedChannelModel::AOD_INDEX][cIndex] * M_PI / 180;
+      longTerm->m_uDoppler[cIndex] = Vector (sin (zoa) * cos (aoa), sin (zoa) * sin (aoa), cos (zoa));
+      longTerm->m_sDoppler[cIndex] = Vector (sin (zod) * cos (aod), sin (zod) * sin (aod), cos (zod));
+    }
+}
+
+void
+ThreeGppSpectrumPropagationLossModel::UpdateDelayPhasors (Ptr<LongTerm> longTerm, Ptr<const SpectrumModel> sm) const
+{
+  if (longTerm->m_spectrumModelUid == sm->GetUid ())
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << sm->GetUid ());
+
+  const MatrixBasedChannelModel::DoubleVector &delay = longTerm->m_channel->m_delay;
+  size_t numCluster = longTerm->m_longTerm.size ();
+
+  longTerm->m_delayPhasors.clear ();
+  longTerm->m_delayPhasors.reserve (sm->GetNumBands () * numCluster);
+  for (auto sbit = sm->Begin (); sbit != sm->End (); sbit++)
+    {
+      double fsb = (*sbit).fc; // center frequency of the sub-band
+      for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+        {
+          double phase = -2 * M_PI * fsb * delay[cIndex];
+          longTerm->m_delayPhasors.push_back (exp (std::complex<double> (0, phase)));
+        }
+    }
+  longTerm->m_spectrumModelUid = sm->GetUid ();
+}
+
 Ptr<SpectrumValue>
 ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> txPsd,
-                                                           ThreeGppAntennaArrayModel::ComplexVector longTerm,
-                                                           Ptr<const MatrixBasedChannelModel::ChannelMatrix> params,
+                                                           Ptr<LongTerm> longTerm,
                                                            const ns3::Vector &sSpeed, const ns3::Vector &uSpeed) const
 {
   NS_LOG_FUNCTION (this);
 
   Ptr<SpectrumValue> tempPsd = Copy<SpectrumValue> (txPsd);
 
-  //channel[rx][tx][cluster]
-  uint8_t numCluster = static_cast<uint8_t> (params->m_channel[0][0].size ());
+  size_t numCluster = longTerm->m_longTerm.size ();
 
-  // compute the doppler term
+  // compute the doppler term and apply it to the long term component
   // NOTE the update of Doppler is simplified by only taking the center angle of
   // each cluster in to consideration.
   double slotTime = Simulator::Now ().GetSeconds ();
-  ThreeGppAntennaArrayModel::ComplexVector doppler;
-  for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
+  double frequency = GetFrequency ();
+  ThreeGppAntennaArrayModel::ComplexVector weights (numCluster);
+  for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
       // Compute alpha and D as described in 3GPP TR 37.885 v15.3.0, Sec. 6.2.3
       // These terms account for an additional Doppler contribution due to the 
@@ -191,105 +248,137 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
         alpha = m_uniformRv->GetValue (-1, 1);
         D = m_uniformRv->GetValue (-m_vScatt, m_vScatt);
       }
-      
-      //cluster angle angle[direction][n],where, direction = 0(aoa), 1(zoa).
-      double temp_doppler = 2 * M_PI * ((sin (params->m_angle[MatrixBasedChannelModel::ZOA_INDEX][cIndex] * M_PI / 180) * cos (params->m_angle[MatrixBasedChannelModel::AOA_INDEX][cIndex] * M_PI / 180) * uSpeed.x
-                                         + sin (params->m_angle[MatrixBasedChannelModel::ZOA_INDEX][cIndex] * M_PI / 180) * sin (params->m_angle[MatrixBasedChannelModel::AOA_INDEX][cIndex] * M_PI / 180) * uSpeed.y
-                                         + cos (params->m_angle[MatrixBasedChannelModel::ZOA_INDEX][cIndex] * M_PI / 180) * uSpeed.z)
-                                         + (sin (params->m_angle[MatrixBasedChannelModel::ZOD_INDEX][cIndex] * M_PI / 180) * cos (params->m_angle[MatrixBasedChannelModel::AOD_INDEX][cIndex] * M_PI / 180) * sSpeed.x
-                                         + sin (params->m_angle[MatrixBasedChannelModel::ZOD_INDEX][cIndex] * M_PI / 180) * sin (params->m_angle[MatrixBasedChannelModel::AOD_INDEX][cIndex] * M_PI / 180) * sSpeed.y
-                                         + cos (params->m_angle[MatrixBasedChannelModel::ZOD_INDEX][cIndex] * M_PI / 180) * sSpeed.z) + 2 * alpha * D)
-                           * slotTime * GetFrequency () / 3e8;
-      doppler.push_back (exp (std::complex<double> (0, temp_doppler)));
+
+      const Vector &uDoppler = longTerm->m_uDoppler[cIndex];
+      const Vector &sDoppler = longTerm->m_sDoppler[cIndex];
+      double temp_doppler = 2 * M_PI * ((uDoppler.x * uSpeed.x + uDoppler.y * uSpeed.y + uDoppler.z * uSpeed.z)
+                                        + (sDoppler.x * sSpeed.x + sDoppler.y * sSpeed.y + sDoppler.z * sSpeed.z) + 2 * alpha * D)
+                           * slotTime * frequency / 3e8;
+      weights[cIndex] = longTerm->m_longTerm[cIndex] * exp (std::complex<double> (0, temp_doppler));
     }
 
-  // apply the doppler term and the propagation delay to the long term component
-  // to obtain the beamforming gain
-  auto vit = tempPsd->ValuesBegin (); // psd iterator
-  auto sbit = tempPsd->ConstBandsBegin(); // band iterator
-  while (vit != tempPsd->ValuesEnd ())
+  // apply the propagation delay to the long term component to obtain the
+  // beamforming gain
+  UpdateDelayPhasors (longTerm, tempPsd->GetSpectrumModel ());
+  const std::complex<double> *phasor = longTerm->m_delayPhasors.data ();
+  for (auto vit = tempPsd->ValuesBegin (); vit != tempPsd->ValuesEnd (); vit++, phasor += numCluster)
     {
-      std::complex<double> subsbandGain (0.0,0.0);
       if ((*vit) != 0.00)
         {
-          double fsb = (*sbit).fc; // center frequency of the sub-band
-          for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
+          std::complex<double> subsbandGain (0.0,0.0);
+          for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
             {
-              double delay = -2 * M_PI * fsb * (params->m_delay[cIndex]);
-              subsbandGain = subsbandGain + longTerm[cIndex] * doppler[cIndex] * exp (std::complex<double> (0, delay));
+              subsbandGain = subsbandGain + weights[cIndex] * phasor[cIndex];
             }
           *vit = (*vit) * (norm (subsbandGain));
         }
-      vit++;
-      sbit++;
     }
   return tempPsd;
 }
 
-ThreeGppAntennaArrayModel::ComplexVector
-ThreeGppSpectrumPropagationLossModel::GetLongTerm (uint32_t aId, uint32_t bId,
-                                                   Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
-                                                   const ThreeGppAntennaArrayModel::ComplexVector &aW,
-                                                   const ThreeGppAntennaArrayModel::ComplexVector &bW) const
+Ptr<ThreeGppSpectrumPropagationLossModel::LongTerm>
+ThreeGppSpectrumPropagationLossModel::FindLongTerm (std::unordered_map <uint32_t, Ptr<LongTerm> > &map,
+                                                    uint32_t aId, uint32_t bId,
+                                                    Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                                                    bool &channelUpdated) const
 {
-  ThreeGppAntennaArrayModel::ComplexVector longTerm; // vector containing the long term component for each cluster
-
-  // check if the channel matrix was generated considering a as the s-node and
-  // b as the u-node or viceversa
-  ThreeGppAntennaArrayModel::ComplexVector sW, uW;
-  if (!channelMatrix->IsReverse (aId, bId))
-  {
-    sW = aW;
-    uW = bW;
-  }
-  else
-  {
-    sW = bW;
-    uW = aW;
-  }
-
   // compute the long term key, the key is unique for each tx-rx pair
   uint32_t x1 = std::min (aId, bId);
   uint32_t x2 = std::max (aId, bId);
   uint32_t longTermId = MatrixBasedChannelModel::GetKey (x1, x2);
 
-  bool update = false; // indicates whether the long term has to be updated
-  bool notFound = false; // indicates if the long term has not been computed yet
+  Ptr<LongTerm> longTerm;
+  channelUpdated = true;
 
   // look for the long term in the map and check if it is valid
-  if (m_longTermMap.find (longTermId) != m_longTermMap.end ())
+  auto it = map.find (longTermId);
+  if (it != map.end ())
   {
     NS_LOG_DEBUG ("found the long term component in the map");
-    longTerm = m_longTermMap[longTermId]->m_longTerm;
-
-    // check if the channel matrix has been updated
-    // or the s beam has been changed
-    // or the u beam has been changed
-    update = (m_longTermMap[longTermId]->m_channel->m_generatedTime != channelMatrix->m_generatedTime
-              || m_longTermMap[longTermId]->m_sW != sW
-              || m_longTermMap[longTermId]->m_uW != uW);
-
+    longTerm = it->second;
+    channelUpdated = (longTerm->m_channel != channelMatrix);
   }
   else
   {
     NS_LOG_DEBUG ("long term component NOT found");
-    notFound = true;
+    longTerm = Create<LongTerm> ();
+    map[longTermId] = longTerm;
   }
 
-  if (update || notFound)
+  if (channelUpdated)
+    {
+      longTerm->m_channel = channelMatrix;
+      CalcDopplerTerms (longTerm);
+      longTerm->m_spectrumModelUid = 0;
+    }
+
+  return longTerm;
+}
+
+Ptr<ThreeGppSpectrumPropagationLossModel::LongTerm>
+ThreeGppSpectrumPropagationLossModel::GetLongTerm (uint32_t aId, uint32_t bId,
+                                                   Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                                                   Ptr<const ThreeGppAntennaArrayModel> aAntenna,
+                                                   Ptr<const ThreeGppAntennaArrayModel> bAntenna) const
+{
+  // check if the channel matrix was generated considering a as the s-node and
+  // b as the u-node or viceversa
+  Ptr<const ThreeGppAntennaArrayModel> sAntenna = aAntenna;
+  Ptr<const ThreeGppAntennaArrayModel> uAntenna = bAntenna;
+  if (channelMatrix->IsReverse (aId, bId))
+  {
+    sAntenna = bAntenna;
+    uAntenna = aAntenna;
+  }
+
+  bool channelUpdated = true; // indicates whether the channel matrix changed since the last call
+  Ptr<LongTerm> longTerm = FindLongTerm (m_longTermMap, aId, bId, channelMatrix, channelUpdated);
+
+  // check if the channel matrix has been updated
+  // or the s beam has been changed
+  // or the u beam has been changed
+  if (channelUpdated
+      || longTerm->m_sWId != sAntenna->GetBeamformingVectorId ()
+      || longTerm->m_uWId != uAntenna->GetBeamformingVectorId ())
     {
       NS_LOG_DEBUG ("compute the long term");
-      // compute the long term component
-      longTerm = CalcLongTerm (channelMatrix, sW, uW);
+      longTerm->m_longTerm = CalcLongTerm (channelMatrix,
+                                           sAntenna->GetBeamformingVector (),
+                                           uAntenna->GetBeamformingVector ());
+      longTerm->m_sWId = sAntenna->GetBeamformingVectorId ();
+      longTerm->m_uWId = uAntenna->GetBeamformingVectorId ();
+      ++m_numLongTermUpdates;
+    }
 
-      // store the long term
-      Ptr<LongTerm> longTermItem = Create<LongTerm> ();
-      longTermItem->m_longTerm = longTerm;
-      longTermItem->m_channel = channelMatrix;
-      longTermItem->m_sW = sW;
-      longTermItem->m_uW = uW;
+  return longTerm;
+}
 
-      m_longTermMap[longTermId] = longTermItem;
+Ptr<ThreeGppSpectrumPropagationLossModel::LongTerm>
+ThreeGppSpectrumPropagationLossModel::GetLongTerm (uint32_t aId, uint32_t bId,
+                                                   Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                                                   const ThreeGppAntennaArrayModel::ComplexVector &aW,
+                                                   const ThreeGppAntennaArrayModel::ComplexVector &bW) const
+{
+  // check if the channel matrix was generated considering a as the s-node and
+  // b as the u-node or viceversa
+  const ThreeGppAntennaArrayModel::ComplexVector *sW = &aW;
+  const ThreeGppAntennaArrayModel::ComplexVector *uW = &bW;
+  if (channelMatrix->IsReverse (aId, bId))
+  {
+    sW = &bW;
+    uW = &aW;
+  }
+
+  bool channelUpdated = true;
+  Ptr<LongTerm> longTerm = FindLongTerm (m_beamLongTermMap, aId, bId, channelMatrix, channelUpdated);
+
+  if (channelUpdated || longTerm->m_sW != *sW || longTerm->m_uW != *uW)
+    {
+      NS_LOG_DEBUG ("compute the long term with explicit beamforming vectors");
+      longTerm->m_longTerm = CalcLongTerm (channelMatrix, *sW, *uW);
+      longTerm->m_sW = *sW;
+      longTerm->m_uW = *uW;
+      ++m_numLongTermUpdates;
     }
 
   return longTerm;
@@ -327,18 +416,61 @@ ThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const Sp
 
   Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix = m_channelModel->GetChannel (a, b, aAntenna, bAntenna);
 
-  // get the precoding and combining vectors
-  ThreeGppAntennaArrayModel::ComplexVector aW = aAntenna->GetBeamformingVector ();
-  ThreeGppAntennaArrayModel::ComplexVector bW = bAntenna->GetBeamformingVector ();
-
   // retrieve the long term component
-  ThreeGppAntennaArrayModel::ComplexVector longTerm = GetLongTerm (aId, bId, channelMatrix, aW, bW);
+  Ptr<LongTerm> longTerm = GetLongTerm (aId, bId, channelMatrix, aAntenna, bAntenna);
 
   // apply the beamforming gain
-  rxPsd = CalcBeamformingGain (rxPsd, longTerm, channelMatrix, a->GetVelocity (), b->GetVelocity ());
+  rxPsd = CalcBeamformingGain (rxPsd, longTerm, a->GetVelocity (), b->GetVelocity ());
+
+  return rxPsd;
+}
+
+Ptr<SpectrumValue>
+ThreeGppSpectrumPropagationLossModel::CalcRxPowerSpectralDensityWithBeams (Ptr<const SpectrumValue> txPsd,
+                                                                           Ptr<const MobilityModel> a,
+                                                                           Ptr<const MobilityModel> b,
+                                                                           const ThreeGppAntennaArrayModel::ComplexVector &aW,
+                                                                           const ThreeGppAntennaArrayModel::ComplexVector &bW) const
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t aId = a->GetObject<Node> ()->GetId (); // id of the node a
+  uint32_t bId = b->GetObject<Node> ()->GetId (); // id of the node b
+
+  NS_ASSERT (aId != bId);
+  NS_ASSERT_MSG (a->GetDistanceFrom (b) > 0.0, "The position of a and b devices cannot be the same");
 
+  Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue> (txPsd);
+
+  NS_ASSERT_MSG (m_deviceAntennaMap.find (aId) != m_deviceAntennaMap.end (), "Antenna not found for node " << aId);
+  Ptr<const ThreeGppAntennaArrayModel> aAntenna = m_deviceAntennaMap.at (aId);
+  NS_ASSERT_MSG (m_deviceAntennaMap.find (bId) != m_deviceAntennaMap.end (), "Antenna not found for device " << bId);
+  Ptr<const ThreeGppAntennaArrayModel> bAntenna = m_deviceAntennaMap.at (bId);
+  NS_ASSERT_MSG (aW.size () == aAntenna->GetNumberOfElements () && bW.size () == bAntenna->GetNumberOfElements (),
+                 "The size of the beamforming vectors does not match the antenna arrays");
+
+  if (aAntenna->IsOmniTx () || bAntenna->IsOmniTx ())
+    {
+      NS_LOG_LOGIC ("Omni transmission, do nothing.");
+    }
+  else
+    {
+      Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix = m_channelModel->GetChannel (a, b, aAntenna, bAntenna);
+      Ptr<LongTerm> longTerm = GetLongTerm (aId, bId, channelMatrix, aW, bW);
+      rxPsd = CalcBeamformingGain (rxPsd, longTerm, a->GetVelocity (), b->GetVelocity ());
+    }
+
+  Ptr<SpectrumPropagationLossModel> next = GetNext ();
+  if (next != 0)
+    {
+      rxPsd = next->CalcRxPowerSpectralDensity (rxPsd, a, b);
+    }
   return rxPsd;
 }
 
+uint64_t
+ThreeGppSpectrumPropagationLossModel::GetNumLongTermUpdates () const
+{
+  return m_numLongTermUpdates;
+}
 
 }  // namespace ns3
@@ -130,16 +130,57 @@ public:
                                                            Ptr<const MobilityModel> a,
                                                            Ptr<const MobilityModel> b) const override;
 
+  /**
+   * \brief Computes the received PSD with the given beamforming vectors.
+   *
+   * Same as CalcRxPowerSpectralDensity, but the beamforming gain is computed
+   * with the vectors aW and bW instead of the vectors currently configured
+   * in the antenna arrays of the two nodes, which are not modified. This
+   * allows evaluating the link towards several devices without reconfiguring
+   * and restoring the antennas.
+   * The long term components computed with explicit vectors are cached
+   * separately, and recomputed only when the channel realization or one of
+   * the vectors changes.
+   * The models chained through SetNext are applied as well.
+   *
+   * \param txPsd tx PSD
+   * \param a first node mobility model
+   * \param b second node mobility model
+   * \param aW the beamforming vector of the antenna of node a
+   * \param bW the beamforming vector of the antenna of node b
+   *
+   * \return the received PSD
+   */
+  Ptr<SpectrumValue> CalcRxPowerSpectralDensityWithBeams (Ptr<const SpectrumValue> txPsd,
+                                                          Ptr<const MobilityModel> a,
+                                                          Ptr<const MobilityModel> b,
+                                                          const ThreeGppAntennaArrayModel::ComplexVector &aW,
+                                                          const ThreeGppAntennaArrayModel::ComplexVector &bW) const;
+
+  /**
+   * \return the number of times a long term component has been computed
+   *         since the creation of this object
+   */
+  uint64_t GetNumLongTermUpdates () const;
+
 private:
   /**
-   * Data structure that stores the long term component for a tx-rx pair
+   * Data structure that stores the long term component for a tx-rx pair,
+   * together with the terms of the beamforming gain which depend only on the
+   * channel matrix
    */
   struct LongTerm : public SimpleRefCount<LongTerm>
   {
     ThreeGppAntennaArrayModel::ComplexVector m_longTerm; //!< vector containing the long term component for each cluster
     Ptr<const MatrixBasedChannelModel::ChannelMatrix> m_channel; //!< pointer to the channel matrix used to compute the long term
-    ThreeGppAntennaArrayModel::ComplexVector m_sW; //!< the beamforming vector for the node s used to compute the long term
-    ThreeGppAntennaArrayModel::ComplexVector m_uW; //!< the beamforming vector for the node u used to compute the long term
+    uint64_t m_sWId {0}; //!< the id of the beamforming vector of the node s used to compute the long term
+    uint64_t m_uWId {0}; //!< the id of the beamforming vector of the node u used to compute the long term
+    std::vector<Vector> m_sDoppler; //!< for each cluster, the direction cosines of the departure angles, which give the Doppler contribution of the speed of the node s
+    std::vector<Vector> m_uDoppler; //!< for each cluster, the direction cosines of the arrival angles, which give the Doppler contribution of the speed of the node u
+    SpectrumModelUid_t m_spectrumModelUid {0}; //!< the uid of the spectrum model m_delayPhasors refers to, 0 if they have not been computed
+    ThreeGppAntennaArrayModel::ComplexVector m_delayPhasors; //!< the propagation delay term exp (-j 2 pi f tau) at the center of each sub-band (major index) for each cluster
+    ThreeGppAntennaArrayModel::ComplexVector m_sW; //!< the beamforming vector of the node s, only for the long terms computed with explicit vectors
+    ThreeGppAntennaArrayModel::ComplexVector m_uW; //!< the beamforming vector of the node u, only for the long terms computed with explicit vectors
   };
 
   /**
@@ -152,17 +193,56 @@ private:
    * Looks for the long term component in m_longTermMap. If found, checks
    * whether it has to be updated. If not found or if it has to be updated,
    * calls the method CalcLongTerm to compute it.
+   *
+   * The long term component is recomputed when the channel matrix is updated
+   * or when one of the beamforming vectors changes, which is detected through
+   * ThreeGppAntennaArrayModel::GetBeamformingVectorId. When the channel matrix
+   * is updated, the Doppler terms are also recomputed, and the delay phasors
+   * are invalidated.
+   * \param aId id of the first node
+   * \param bId id of the second node
+   * \param channelMatrix the channel matrix
+   * \param aAntenna the antenna array of the first device
+   * \param bAntenna the antenna array of the second device
+   * \return the long term component of the pair
+   */
+  Ptr<LongTerm> GetLongTerm (uint32_t aId, uint32_t bId,
+                             Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                             Ptr<const ThreeGppAntennaArrayModel> aAntenna,
+                             Ptr<const ThreeGppAntennaArrayModel> bAntenna) const;
+  /**
+   * Looks for the long term component computed with explicit beamforming
+   * vectors in m_beamLongTermMap, and computes it if not found or if the
+   * channel matrix or one of the vectors changed
+   * \param aId id of the first node
+   * \param bId id of the second node
+   * \param channelMatrix the channel matrix
+   * \param aW the beamforming vector of the first node
+   * \param bW the beamforming vector of the second node
+   * \return the long term component of the pair
+   */
+  Ptr<LongTerm> GetLongTerm (uint32_t aId, uint32_t bId,
+                             Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                             const ThreeGppAntennaArrayModel::ComplexVector &aW,
+                             const ThreeGppAntennaArrayModel::ComplexVector &bW) const;
+
+  /**
+   * Looks for the long term component of a pair in a map, creates it if
+   * not found, and recomputes the terms depending only on the channel matrix
+   * if it was updated
+   * \param map the map of the long term components
    * \param aId id of the first node
    * \param bId id of the second node
    * \param channelMatrix the channel matrix
-   * \param aW the beamforming vector of the first device
-   * \param bW the beamforming vector of the second device
-   * \return vector containing the long term compoenent for each cluster
+   * \param channelUpdated set to true if the channel matrix changed since
+   *        the last call for this pair
+   * \return the long term component of the pair
    */
-  ThreeGppAntennaArrayModel::ComplexVector GetLongTerm (uint32_t aId, uint32_t bId,
-                                                        Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
-                                                        const ThreeGppAntennaArrayModel::ComplexVector &aW,
-                                                        const ThreeGppAntennaArrayModel::ComplexVector &bW) const;
+  Ptr<LongTerm> FindLongTerm (std::unordered_map <uint32_t, Ptr<LongTerm> > &map,
+                              uint32_t aId, uint32_t bId,
+                              Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                              bool &channelUpdated) const;
+
   /**
    * Computes the long term component
    * \param channelMatrix the channel matrix H
@@ -174,22 +254,39 @@ private:
                                                          const ThreeGppAntennaArrayModel::ComplexVector &sW,
                                                          const ThreeGppAntennaArrayModel::ComplexVector &uW) const;
 
+  /**
+   * Computes the direction cosines of the cluster angles of the channel
+   * matrix, used to compute the Doppler term, and stores them in longTerm
+   * \param longTerm the long term component of the pair
+   */
+  void CalcDopplerTerms (Ptr<LongTerm> longTerm) const;
+
+  /**
+   * Computes the propagation delay term of each cluster at the center of
+   * each sub-band of the spectrum model, if they have not been computed yet
+   * for the current channel matrix and this spectrum model
+   * \param longTerm the long term component of the pair
+   * \param sm the spectrum model
+   */
+  void UpdateDelayPhasors (Ptr<LongTerm> longTerm, Ptr<const SpectrumModel> sm) const;
+
   /**
    * Computes the beamforming gain and applies it to the tx PSD
    * \param txPsd the tx PSD
-   * \param longTerm the long term component
-   * \param params The channel matrix
+   * \param longTerm the long term component, with the terms depending on the
+   *        channel matrix
    * \param sSpeed speed of the first node
    * \param uSpeed speed of the second node
    * \return the rx PSD
    */
   Ptr<SpectrumValue> CalcBeamformingGain (Ptr<SpectrumValue> txPsd,
-                                          ThreeGppAntennaArrayModel::ComplexVector longTerm,
-                                          Ptr<const MatrixBasedChannelModel::ChannelMatrix> params,
+                                          Ptr<LongTerm> longTerm,
                                           const Vector &sSpeed, const Vector &uSpeed) const;
 
   std::unordered_map <uint32_t, Ptr<const ThreeGppAntennaArrayModel> > m_deviceAntennaMap; //!< map containig the <node, antenna> associations
-  mutable std::unordered_map < uint32_t, Ptr<const LongTerm> > m_longTermMap; //!< map containing the long term components
+  mutable std::unordered_map < uint32_t, Ptr<LongTerm> > m_longTermMap; //!< map containing the long term components
+  mutable std::unordered_map < uint32_t, Ptr<LongTerm> > m_beamLongTermMap; //!< map containing the long term components computed with explicit beamforming vectors
+  mutable uint64_t m_numLongTermUpdates; //!< number of long term components computed
   Ptr<MatrixBasedChannelModel> m_channelModel; //!< the model to generate the channel matrix
   
   // Variable used to compute the additional Doppler contribution for the delayed 
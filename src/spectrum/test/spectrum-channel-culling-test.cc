@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/spectrum-model-ism2400MHz-res1MHz.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/net-device.h>
+#include <ns3/antenna-model.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief A SpectrumPhy that counts the received signals
+ */
+class CullingTestSpectrumPhy : public SpectrumPhy
+{
+public:
+  CullingTestSpectrumPhy ()
+    : m_numRx (0)
+  {
+  }
+
+  // inherited from SpectrumPhy
+  virtual void SetDevice (Ptr<NetDevice> d)
+  {
+  }
+  virtual Ptr<NetDevice> GetDevice () const
+  {
+    return 0;
+  }
+  virtual void SetMobility (Ptr<MobilityModel> m)
+  {
+    m_mobility = m;
+  }
+  virtual Ptr<MobilityModel> GetMobility ()
+  {
+    return m_mobility;
+  }
+  virtual void SetChannel (Ptr<SpectrumChannel> c)
+  {
+  }
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const
+  {
+    return SpectrumModelIsm2400MhzRes1Mhz;
+  }
+  virtual Ptr<AntennaModel> GetRxAntenna ()
+  {
+    return 0;
+  }
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params)
+  {
+    m_numRx++;
+  }
+
+  uint32_t m_numRx;                //!< Number of received signals
+  Ptr<MobilityModel> m_mobility;   //!< Mobility model
+};
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Transmits a signal to receivers at 10, 100 and 1000 m, and checks
+ * which ones MultiModelSpectrumChannel culls
+ */
+class SpectrumChannelCullingTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param maxCullingDistance the MaxCullingDistance of the channel [m]
+   * \param maxLossDb the MaxLossDb of the channel
+   * \param culledByDistance the expected number of receivers culled by distance
+   * \param culledByLoss the expected number of receivers culled by loss
+   */
+  SpectrumChannelCullingTestCase (double maxCullingDistance, double maxLossDb,
+                                  uint64_t culledByDistance, uint64_t culledByLoss);
+
+private:
+  virtual void DoRun (void);
+
+  double m_maxCullingDistance;  //!< MaxCullingDistance of the channel [m]
+  double m_maxLossDb;           //!< MaxLossDb of the channel
+  uint64_t m_culledByDistance;  //!< Expected receivers culled by distance
+  uint64_t m_culledByLoss;      //!< Expected receivers culled by loss
+};
+
+SpectrumChannelCullingTestCase::SpectrumChannelCullingTestCase (double maxCullingDistance, double maxLossDb,
+                                                                uint64_t culledByDistance, uint64_t culledByLoss)
+  : TestCase ("Culling with MaxCullingDistance=" + std::to_string (maxCullingDistance)
+              + " MaxLossDb=" + std::to_string (maxLossDb)),
+    m_maxCullingDistance (maxCullingDistance),
+    m_maxLossDb (maxLossDb),
+    m_culledByDistance (culledByDistance),
+    m_culledByLoss (culledByLoss)
+{
+}
+
+void
+SpectrumChannelCullingTestCase::DoRun (void)
+{
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->SetAttribute ("MaxCullingDistance", DoubleValue (m_maxCullingDistance));
+  channel->SetAttribute ("MaxLossDb", DoubleValue (m_maxLossDb));
+  channel->AddPropagationLossModel (CreateObject<FriisPropagationLossModel> ());
+
+  Ptr<CullingTestSpectrumPhy> txPhy = Create<CullingTestSpectrumPhy> ();
+  Ptr<MobilityModel> txMobility = CreateObject<ConstantPositionMobilityModel> ();
+  txPhy->SetMobility (txMobility);
+  channel->AddRx (txPhy);
+
+  std::vector<Ptr<CullingTestSpectrumPhy> > rxPhys;
+  for (double distance : {10.0, 100.0, 1000.0})
+    {
+      Ptr<CullingTestSpectrumPhy> rxPhy = Create<CullingTestSpectrumPhy> ();
+      Ptr<MobilityModel> rxMobility = CreateObject<ConstantPositionMobilityModel> ();
+      rxMobility->SetPosition (Vector (distance, 0, 0));
+      rxPhy->SetMobility (rxMobility);
+      channel->AddRx (rxPhy);
+      rxPhys.push_back (rxPhy);
+    }
+
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->duration = MilliSeconds (1);
+  params->txPhy = txPhy;
+  params->psd = Create<SpectrumValue> (SpectrumModelIsm2400MhzRes1Mhz);
+  *params->psd = 1e-3;
+  Simulator::ScheduleNow (&MultiModelSpectrumChannel::StartTx, channel, params);
+  Simulator::Run ();
+
+  MultiModelSpectrumChannel::CullingStats stats = channel->GetCullingStats ();
+  uint64_t numCulled = m_culledByDistance + m_culledByLoss;
+  NS_TEST_ASSERT_MSG_EQ (stats.culledByDistance, m_culledByDistance, "wrong number of receivers culled by distance");
+  NS_TEST_ASSERT_MSG_EQ (stats.culledByLoss, m_culledByLoss, "wrong number of receivers culled by loss");
+  NS_TEST_ASSERT_MSG_EQ (stats.scheduledRx, rxPhys.size () - numCulled, "wrong number of reception events");
+  NS_TEST_ASSERT_MSG_EQ (txPhy->m_numRx, 0, "the transmitter received its own signal");
+  for (uint32_t i = 0; i < rxPhys.size (); ++i)
+    {
+      // the farthest receivers are culled
+      uint32_t expectedRx = (i < rxPhys.size () - numCulled) ? 1 : 0;
+      NS_TEST_ASSERT_MSG_EQ (rxPhys[i]->m_numRx, expectedRx, "wrong number of signals at receiver " << i);
+    }
+
+  channel->ResetCullingStats ();
+  stats = channel->GetCullingStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.scheduledRx + stats.culledByDistance + stats.culledByLoss, 0, "counters not reset");
+
+  channel->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Test suite of the culling of the receivers of MultiModelSpectrumChannel
+ */
+class SpectrumChannelCullingTestSuite : public TestSuite
+{
+public:
+  SpectrumChannelCullingTestSuite ();
+};
+
+SpectrumChannelCullingTestSuite::SpectrumChannelCullingTestSuite ()
+  : TestSuite ("spectrum-channel-culling", UNIT)
+{
+  // Friis loss at 2.4 GHz: about 60 dB at 10 m, 80 dB at 100 m, 100 dB at 1 km
+  AddTestCase (new SpectrumChannelCullingTestCase (0, 1e9, 0, 0), TestCase::QUICK);
+  AddTestCase (new SpectrumChannelCullingTestCase (500, 1e9, 1, 0), TestCase::QUICK);
+  AddTestCase (new SpectrumChannelCullingTestCase (0, 90, 0, 1), TestCase::QUICK);
+  AddTestCase (new SpectrumChannelCullingTestCase (500, 70, 1, 1), TestCase::QUICK);
+  AddTestCase (new SpectrumChannelCullingTestCase (50, 70, 2, 0), TestCase::QUICK);
+}
+
+static SpectrumChannelCullingTestSuite g_spectrumChannelCullingTestSuite; //!< Static variable for test initialization
@@ -333,6 +333,148 @@ ThreeGppChannelMatrixUpdateTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * Test case for the ParallelUpdate mode of the ThreeGppChannelModel class.
+ * 1) checks if the channel matrices are updated at the multiples of the
+ *    update period
+ * 2) checks if the channel realizations do not depend on the number of
+ *    threads, with the fixed streams set by AssignStreams
+ */
+class ThreeGppChannelMatrixParallelUpdateTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ThreeGppChannelMatrixParallelUpdateTest ();
+
+  /**
+   * Destructor
+   */
+  virtual ~ThreeGppChannelMatrixParallelUpdateTest ();
+
+private:
+  /**
+   * Build the test scenario
+   */
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario and collect the channel matrices
+   * \param numThreads the number of threads updating the channel matrices
+   * \return the channel matrices, indexed by the time instant and the UE
+   */
+  std::vector<std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > > RunScenario (uint32_t numThreads);
+
+  /**
+   * Retrieve the channel matrices between the BS and all the UEs
+   * \param channelModel the ThreeGppChannelModel object used to generate the channel matrix
+   * \param bsMob the mobility model of the BS
+   * \param ueMobs the mobility models of the UEs
+   * \param bsAntenna the antenna object associated to the BS
+   * \param ueAntenna the antenna object associated to the UEs
+   */
+  void DoGetChannels (Ptr<ThreeGppChannelModel> channelModel, Ptr<MobilityModel> bsMob, std::vector<Ptr<MobilityModel> > ueMobs, Ptr<ThreeGppAntennaArrayModel> bsAntenna, Ptr<ThreeGppAntennaArrayModel> ueAntenna);
+
+  std::vector<std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > > m_channels; //!< used by DoGetChannels to store the channel matrices
+};
+
+ThreeGppChannelMatrixParallelUpdateTest::ThreeGppChannelMatrixParallelUpdateTest ()
+  : TestCase ("Check if the channel realizations are correctly updated in parallel")
+{
+}
+
+ThreeGppChannelMatrixParallelUpdateTest::~ThreeGppChannelMatrixParallelUpdateTest ()
+{
+}
+
+void
+ThreeGppChannelMatrixParallelUpdateTest::DoGetChannels (Ptr<ThreeGppChannelModel> channelModel, Ptr<MobilityModel> bsMob, std::vector<Ptr<MobilityModel> > ueMobs, Ptr<ThreeGppAntennaArrayModel> bsAntenna, Ptr<ThreeGppAntennaArrayModel> ueAntenna)
+{
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > channels;
+  for (auto ueMob : ueMobs)
+    {
+      channels.push_back (channelModel->GetChannel (bsMob, ueMob, bsAntenna, ueAntenna));
+    }
+  m_channels.push_back (channels);
+}
+
+std::vector<std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > >
+ThreeGppChannelMatrixParallelUpdateTest::RunScenario (uint32_t numThreads)
+{
+  m_channels.clear ();
+
+  uint32_t numUes = 6;
+
+  // create the ThreeGppChannelModel object used to generate the channel matrix
+  Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel> ();
+  channelModel->SetAttribute ("Frequency", DoubleValue (28.0e9));
+  channelModel->SetAttribute ("Scenario", StringValue ("UMi-StreetCanyon"));
+  channelModel->SetAttribute ("ChannelConditionModel", PointerValue (CreateObject<AlwaysLosChannelConditionModel> ()));
+  channelModel->SetAttribute ("UpdatePeriod", TimeValue (MilliSeconds (100)));
+  channelModel->SetAttribute ("ParallelUpdate", BooleanValue (true));
+  channelModel->SetAttribute ("NumThreads", UintegerValue (numThreads));
+  // the random variables of all the pairs use the same fixed streams in each run
+  channelModel->AssignStreams (1000);
+
+  // create the BS and the UEs
+  NodeContainer nodes;
+  nodes.Create (numUes + 1);
+  Ptr<MobilityModel> bsMob = CreateObject<ConstantPositionMobilityModel> ();
+  bsMob->SetPosition (Vector (0.0, 0.0, 10.0));
+  nodes.Get (0)->AggregateObject (bsMob);
+  std::vector<Ptr<MobilityModel> > ueMobs;
+  for (uint32_t i = 1; i <= numUes; ++i)
+    {
+      Ptr<MobilityModel> ueMob = CreateObject<ConstantPositionMobilityModel> ();
+      ueMob->SetPosition (Vector (20.0 * i, 10.0, 1.6));
+      nodes.Get (i)->AggregateObject (ueMob);
+      ueMobs.push_back (ueMob);
+    }
+
+  Ptr<ThreeGppAntennaArrayModel> bsAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumColumns", UintegerValue (4), "NumRows", UintegerValue (4));
+  Ptr<ThreeGppAntennaArrayModel> ueAntenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumColumns", UintegerValue (2), "NumRows", UintegerValue (2));
+
+  // the channel matrices are generated at 1 ms, and updated when the first
+  // multiple of the update period (100 ms) is crossed
+  std::vector<Time> times {MilliSeconds (1), MilliSeconds (50), MicroSeconds (100500), MilliSeconds (199)};
+  for (Time t : times)
+    {
+      Simulator::Schedule (t, &ThreeGppChannelMatrixParallelUpdateTest::DoGetChannels, this, channelModel, bsMob, ueMobs, bsAntenna, ueAntenna);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  return m_channels;
+}
+
+void
+ThreeGppChannelMatrixParallelUpdateTest::DoRun (void)
+{
+  std::vector<std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > > serial = RunScenario (1);
+  std::vector<std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > > parallel = RunScenario (4);
+
+  NS_TEST_ASSERT_MSG_EQ (serial.size (), 4, "Wrong number of time instants");
+  NS_TEST_ASSERT_MSG_EQ (parallel.size (), 4, "Wrong number of time instants");
+  for (uint32_t ue = 0; ue < serial[0].size (); ++ue)
+    {
+      // check the update of the channel matrices
+      NS_TEST_ASSERT_MSG_EQ ((serial[1][ue] == serial[0][ue]), true, "The channel matrix should not be updated");
+      NS_TEST_ASSERT_MSG_EQ ((serial[2][ue] != serial[1][ue]), true, "The channel matrix should be updated at the end of the period");
+      NS_TEST_ASSERT_MSG_EQ (serial[2][ue]->m_generatedTime, MicroSeconds (100500), "Wrong generation time");
+      NS_TEST_ASSERT_MSG_EQ ((serial[3][ue] == serial[2][ue]), true, "The channel matrix should not be updated");
+
+      // check that the channel realizations do not depend on the number of threads
+      for (uint32_t t = 0; t < serial.size (); ++t)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((serial[t][ue]->m_channel == parallel[t][ue]->m_channel), true,
+                                 "The channel matrix of UE " << ue << " at time instant " << t << " depends on the number of threads");
+          NS_TEST_ASSERT_MSG_EQ ((serial[t][ue]->m_delay == parallel[t][ue]->m_delay), true,
+                                 "The delays of UE " << ue << " at time instant " << t << " depend on the number of threads");
+        }
+    }
+}
+
 /**
  * Test case for the ThreeGppSpectrumPropagationLossModelTest class.
  * 1) checks if the long term components for the direct and the reverse link
@@ -528,7 +670,9 @@ ThreeGppSpectrumPropagationLossModelTest::DoRun ()
   rxMob->SetPosition (Vector (10.0, 5.0, 10.0));
   ThreeGppAntennaArrayModel::ComplexVector txBfVector = txAntenna->GetBeamformingVector ();
   txBfVector [0] = std::complex<double> (0.0, 0.0);
+  uint64_t txBfId = txAntenna->GetBeamformingVectorId ();
   txAntenna->SetBeamformingVector (txBfVector);
+  NS_TEST_ASSERT_MSG_NE (txAntenna->GetBeamformingVectorId (), txBfId, "Changing the BF vector its id does not change");
 
   rxPsdNew = lossModel->DoCalcRxPowerSpectralDensity (txPsd, rxMob, txMob);
   NS_TEST_ASSERT_MSG_EQ (ArePsdEqual (rxPsdOld, rxPsdNew),  false, "Changing the BF vectors the rx PSD does not change");
@@ -536,13 +680,135 @@ ThreeGppSpectrumPropagationLossModelTest::DoRun ()
   // update rxPsdOld
   rxPsdOld = rxPsdNew;
 
-  // 3) check if the long term is updated when the channel matrix is recomputed
+  // 3) check that setting again the same BF vector keeps its id, and the
+  // cached long term
+  txBfId = txAntenna->GetBeamformingVectorId ();
+  txAntenna->SetBeamformingVector (txBfVector);
+  NS_TEST_ASSERT_MSG_EQ (txAntenna->GetBeamformingVectorId (), txBfId, "Setting the same BF vector its id changes");
+  rxPsdNew = lossModel->DoCalcRxPowerSpectralDensity (txPsd, rxMob, txMob);
+  NS_TEST_ASSERT_MSG_EQ (ArePsdEqual (rxPsdOld, rxPsdNew),  true, "Setting the same BF vector the rx PSD changes");
+
+  // 4) check that the rx PSD computed with explicit BF vectors equal to the
+  // configured ones is the same, and that the antennas are not modified when
+  // the explicit BF vectors are different
+  rxPsdNew = lossModel->CalcRxPowerSpectralDensityWithBeams (txPsd, rxMob, txMob, rxAntenna->GetBeamformingVector (), txBfVector);
+  NS_TEST_ASSERT_MSG_EQ (ArePsdEqual (rxPsdOld, rxPsdNew),  true, "The rx PSD computed with the configured BF vectors is different");
+  ThreeGppAntennaArrayModel::ComplexVector otherTxBfVector = txBfVector;
+  otherTxBfVector [1] = std::complex<double> (0.0, 0.0);
+  rxPsdNew = lossModel->CalcRxPowerSpectralDensityWithBeams (txPsd, rxMob, txMob, rxAntenna->GetBeamformingVector (), otherTxBfVector);
+  NS_TEST_ASSERT_MSG_EQ (ArePsdEqual (rxPsdOld, rxPsdNew),  false, "Changing the explicit BF vectors the rx PSD does not change");
+  NS_TEST_ASSERT_MSG_EQ (txAntenna->GetBeamformingVectorId (), txBfId, "Computing the rx PSD with explicit BF vectors changes the antenna");
+  rxPsdNew = lossModel->DoCalcRxPowerSpectralDensity (txPsd, rxMob, txMob);
+  NS_TEST_ASSERT_MSG_EQ (ArePsdEqual (rxPsdOld, rxPsdNew),  true, "Computing the rx PSD with explicit BF vectors changes the cached long term");
+
+  // 5) check if the long term is updated when the channel matrix is recomputed
   Simulator::Schedule (MilliSeconds (101), &ThreeGppSpectrumPropagationLossModelTest::CheckLongTermUpdate, this, lossModel, txPsd, txMob, rxMob, rxPsdOld);
 
   Simulator::Run ();
   Simulator::Destroy ();
 }
 
+/**
+ * Test case for the containers of the channel matrix.
+ * 1) checks if the ChannelTensor built from the nested vectors H[u][s][n]
+ *    gives the same elements through the views, the direct accessor and
+ *    the contiguous cluster matrices
+ * 2) checks if the storage is aligned
+ * 3) checks if the AlignedMatrix of the cluster angles behaves as a vector
+ *    of rows
+ */
+class ChannelTensorTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ChannelTensorTest ();
+
+  /**
+   * Destructor
+   */
+  virtual ~ChannelTensorTest ();
+
+private:
+  /**
+   * Build the test scenario
+   */
+  virtual void DoRun (void);
+};
+
+ChannelTensorTest::ChannelTensorTest ()
+  : TestCase ("Check the flat containers of the channel matrix")
+{
+}
+
+ChannelTensorTest::~ChannelTensorTest ()
+{
+}
+
+void
+ChannelTensorTest::DoRun (void)
+{
+  uint32_t uSize = 3;
+  uint32_t sSize = 5;
+  uint32_t numClusters = 7;
+  MatrixBasedChannelModel::Complex3DVector nested (uSize);
+  for (uint32_t u = 0; u < uSize; u++)
+    {
+      nested[u].resize (sSize);
+      for (uint32_t s = 0; s < sSize; s++)
+        {
+          for (uint32_t n = 0; n < numClusters; n++)
+            {
+              nested[u][s].push_back (std::complex<double> (u * 100 + s * 10 + n, -1.0 * n));
+            }
+        }
+    }
+
+  // 1) check the indexing
+  const ChannelTensor h (nested);
+  NS_TEST_ASSERT_MSG_EQ (h.size (), uSize, "Wrong number of rows");
+  NS_TEST_ASSERT_MSG_EQ (h[0].size (), sSize, "Wrong number of columns");
+  NS_TEST_ASSERT_MSG_EQ (h[0][0].size (), numClusters, "Wrong number of clusters");
+  for (uint32_t n = 0; n < numClusters; n++)
+    {
+      const std::complex<double> *cluster = h.GetCluster (n);
+      for (uint32_t s = 0; s < sSize; s++)
+        {
+          for (uint32_t u = 0; u < uSize; u++)
+            {
+              NS_TEST_ASSERT_MSG_EQ (h[u][s][n], nested[u][s][n], "Wrong element through the views");
+              NS_TEST_ASSERT_MSG_EQ (h.at (u).at (s).at (n), nested[u][s][n], "Wrong element through at");
+              NS_TEST_ASSERT_MSG_EQ (h (u, s, n), nested[u][s][n], "Wrong element through the accessor");
+              NS_TEST_ASSERT_MSG_EQ (cluster[s * uSize + u], nested[u][s][n], "Wrong element of the cluster matrix");
+            }
+        }
+    }
+
+  ChannelTensor copy = h;
+  NS_TEST_ASSERT_MSG_EQ ((copy == h), true, "The copy differs from the original tensor");
+  copy[1][2][3] = 0;
+  NS_TEST_ASSERT_MSG_EQ ((copy == h), false, "The elements of the copy can not be modified through the views");
+
+  // 2) check the alignment
+  NS_TEST_ASSERT_MSG_EQ (reinterpret_cast<uintptr_t> (h.GetCluster (0)) % 64, 0, "The tensor is not aligned");
+
+  // 3) check the angles
+  MatrixBasedChannelModel::Double2DVector angles (4, MatrixBasedChannelModel::DoubleVector (numClusters));
+  for (uint32_t n = 0; n < numClusters; n++)
+    {
+      angles[MatrixBasedChannelModel::AOA_INDEX][n] = n;
+      angles[MatrixBasedChannelModel::ZOD_INDEX][n] = 2.0 * n;
+    }
+  MatrixBasedChannelModel::ClusterAngles clusterAngles;
+  clusterAngles = angles;
+  NS_TEST_ASSERT_MSG_EQ (clusterAngles.size (), 4, "Wrong number of directions");
+  NS_TEST_ASSERT_MSG_EQ (clusterAngles[MatrixBasedChannelModel::ZOD_INDEX].size (), numClusters, "Wrong number of clusters");
+  NS_TEST_ASSERT_MSG_EQ (clusterAngles[MatrixBasedChannelModel::ZOD_INDEX][3], 6.0, "Wrong angle");
+  NS_TEST_ASSERT_MSG_EQ (clusterAngles.GetRow (MatrixBasedChannelModel::AOA_INDEX)[5], 5.0, "Wrong angle");
+  NS_TEST_ASSERT_MSG_EQ (reinterpret_cast<uintptr_t> (clusterAngles.GetRow (0)) % 64, 0, "The angles are not aligned");
+}
+
 /**
  * \ingroup spectrum
  *
@@ -562,7 +828,9 @@ ThreeGppChannelTestSuite::ThreeGppChannelTestSuite ()
 {
   AddTestCase (new ThreeGppChannelMatrixComputationTest, TestCase::QUICK);
   AddTestCase (new ThreeGppChannelMatrixUpdateTest, TestCase::QUICK);
+  AddTestCase (new ThreeGppChannelMatrixParallelUpdateTest, TestCase::QUICK);
   AddTestCase (new ThreeGppSpectrumPropagationLossModelTest, TestCase::QUICK);
+  AddTestCase (new ChannelTensorTest, TestCase::QUICK);
 }
 
 static ThreeGppChannelTestSuite myTestSuite;
@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the resolution of the Config paths
+// of Config::Connect, on a topology of 'nodes' nodes with 'devices' devices
+// each, as the helpers do when they connect their traces.
+// Sample usage:  ./waf --run 'bench-config --nodes=1000 --devices=2'
+
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <limits>
+#include <algorithm>
+
+using namespace ns3;
+
+/// Number of nodes of the topology
+static uint32_t g_nodes;
+/// Number of devices of each node
+static uint32_t g_devices;
+
+/**
+ * Trace sink, never called
+ * \param context the context of the trace
+ * \param p the packet
+ */
+static void
+Sink (std::string context, Ptr<const Packet> p)
+{
+}
+
+/// Connect the trace of all the devices with a wildcard path
+static void
+benchWildcard (void)
+{
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::SimpleNetDevice/PhyRxDrop", MakeCallback (&Sink));
+}
+
+/// Connect the trace of all the devices with a path per device
+static void
+benchExact (void)
+{
+  for (uint32_t i = 0; i < g_nodes; i++)
+    {
+      for (uint32_t j = 0; j < g_devices; j++)
+        {
+          std::ostringstream oss;
+          oss << "/NodeList/" << i << "/DeviceList/" << j << "/$ns3::SimpleNetDevice/PhyRxDrop";
+          Config::Connect (oss.str (), MakeCallback (&Sink));
+        }
+    }
+}
+
+/// Connect a path that matches no trace source
+static void
+benchNoMatch (void)
+{
+  Config::ConnectFailSafe ("/NodeList/*/DeviceList/*/$ns3::SimpleChannel/PhyRxDrop", MakeCallback (&Sink));
+}
+
+static double
+runBenchOneIteration (void (*bench) (void))
+{
+  // SystemWallClockMs is too coarse for the paths with a single match
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  (*bench) ();
+  return std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - start).count ();
+}
+
+static void
+runBench (void (*bench) (void), uint32_t minIterations, char const *name)
+{
+  double minDelay = std::numeric_limits<double>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      double delay = runBenchOneIteration (bench);
+      minDelay = std::min (minDelay, delay);
+    }
+  std::cout << minDelay << " ms elapsed\t"
+            << name
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  g_nodes = 1000;
+  g_devices = 2;
+  uint32_t minIterations = 5;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the resolution of Config paths");
+  cmd.AddValue ("nodes", "number of nodes", g_nodes);
+  cmd.AddValue ("devices", "number of devices of each node", g_devices);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.Parse (argc, argv);
+
+  NodeContainer nodes;
+  nodes.Create (g_nodes);
+  for (uint32_t i = 0; i < g_nodes; i++)
+    {
+      for (uint32_t j = 0; j < g_devices; j++)
+        {
+          nodes.Get (i)->AddDevice (CreateObject<SimpleNetDevice> ());
+        }
+    }
+  std::cout << "Running bench-config with " << g_nodes << " nodes and "
+            << g_devices << " devices per node" << std::endl;
+
+  runBench (&benchWildcard, minIterations, "Connect all the devices with a wildcard path");
+  runBench (&benchExact, minIterations, "Connect each device with its own path");
+  runBench (&benchNoMatch, minIterations, "Connect a path that matches no trace source");
+
+  Simulator::Destroy ();
+  return 0;
+}